@@ -251,7 +251,7 @@ class EE_API Music : public SoundStream {
 /// it, request its parameters (channels, sample rate), change
 /// the way it is played (pitch, volume, 3D position, ...), etc.
 ///
-/// As a sound stream, a music is played in its own thread in order
+/// As a sound stream, a music is played from the audio streaming thread in order
 /// not to block the rest of the program. This means that you can
 /// leave the music alone after calling play(), it will manage itself
 /// very well.
@@ -1,16 +1,22 @@
 #ifndef EE_AUDIO_SOUNDSTREAM_HPP
 #define EE_AUDIO_SOUNDSTREAM_HPP
 
+#include <atomic>
 #include <cstdlib>
 #include <eepp/audio/soundsource.hpp>
 #include <eepp/config.hpp>
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/thread.hpp>
 #include <eepp/system/time.hpp>
+#include <vector>
 using namespace EE::System;
 
 namespace EE { namespace Audio {
 
+namespace Private {
+class SoundStreamService;
+}
+
 /// \brief Abstract base class for streamed audio sources
 class EE_API SoundStream : public SoundSource {
   public:
@@ -31,8 +37,9 @@ class EE_API SoundStream : public SoundSource {
 	/// This function starts the stream if it was stopped, resumes
 	/// it if it was paused, and restarts it from the beginning if
 	/// it was already playing.
-	/// This function uses its own thread so that it doesn't block
-	/// the rest of the program while the stream is played.
+	/// The stream is serviced by the shared audio streaming thread
+	/// so that it doesn't block the rest of the program while the
+	/// stream is played.
 	///
 	/// \see pause, stop
 	///
@@ -175,7 +182,9 @@ class EE_API SoundStream : public SoundSource {
 	///
 	/// This function must be overridden by derived classes to provide
 	/// the audio samples to play. It is called continuously by the
-	/// streaming loop, in a separate thread.
+	/// streaming loop, in a separate thread (one of the audio decoding
+	/// worker threads). The chunk is copied before the next call, so
+	/// the samples only need to be valid until onGetData is called again.
 	/// The source can choose to stop the streaming loop at any time, by
 	/// returning false to the caller.
 	/// If you return true (i.e. continue streaming) it is important that
@@ -213,41 +222,76 @@ class EE_API SoundStream : public SoundSource {
 	virtual Int64 onLoop();
 
   private:
+	friend class Private::SoundStreamService;
+
+	////////////////////////////////////////////////////////////
+	/// \brief Chunk of audio data decoded ahead by the decoding workers
+	///
+	////////////////////////////////////////////////////////////
+	struct DecodedChunk {
+		std::vector<Int16> samples; ///< Copy of the samples provided by onGetData
+		Int64 seek{ NoLoop };		///< Seek position once the buffer has been played, or NoLoop
+		Int64 immediateSeek{ NoLoop }; ///< Seek position to apply as soon as the buffer is queued
+		bool last{ false };			   ///< The source requested to stop after this chunk
+	};
+
 	////////////////////////////////////////////////////////////
-	/// \brief Function called as the entry point of the thread
+	/// \brief Service the stream from the audio streaming thread
 	///
-	/// This function starts the streaming loop, and returns
-	/// only when the sound is stopped.
+	/// Recycles the processed buffers, queues the decoded chunks
+	/// available and requests more data to the decoding workers.
+	///
+	/// \param next Time until the stream needs to be serviced again
+	///
+	/// \return False once the stream has finished and must not be
+	///		 serviced anymore
 	///
 	////////////////////////////////////////////////////////////
-	void streamData();
+	bool serviceStream( Time& next );
 
 	////////////////////////////////////////////////////////////
-	/// \brief Fill a new buffer with audio samples, and append
-	///		it to the playing queue
+	/// \brief Start streaming from the audio streaming thread
 	///
-	/// This function is called as soon as a buffer has been fully
-	/// consumed; it fills it again and inserts it back into the
-	/// playing queue.
+	/// \param startState State the stream starts in (Playing or Paused)
 	///
-	/// \param bufferNum Number of the buffer to fill (in [0, BufferCount])
-	/// \param immediateLoop Treat empty buffers as spent, and act on loops immediately
+	////////////////////////////////////////////////////////////
+	void launch( Status startState );
+
+	////////////////////////////////////////////////////////////
+	/// \brief Stop the playback and release the audio buffers
+	///
+	////////////////////////////////////////////////////////////
+	void serviceFinish();
+
+	////////////////////////////////////////////////////////////
+	/// \brief Decode chunks until the decode-ahead ring is full
+	///
+	/// Called from a decoding worker thread, only one decoding
+	/// task per stream runs at the same time.
+	///
+	////////////////////////////////////////////////////////////
+	void decodeAhead();
+
+	////////////////////////////////////////////////////////////
+	/// \brief Acquire a chunk of audio data from the stream source
+	///
+	/// Handles the stream end and the loops just like a buffer
+	/// fill would do.
 	///
 	/// \return True if the stream source has requested to stop, false otherwise
 	///
 	////////////////////////////////////////////////////////////
-	bool fillAndPushBuffer( unsigned int bufferNum, bool immediateLoop = false );
+	bool decodeChunk( DecodedChunk& chunk );
 
 	////////////////////////////////////////////////////////////
-	/// \brief Fill the audio buffers and put them all into the playing queue
+	/// \brief Queue the next decoded chunk into an audio buffer
 	///
-	/// This function is called when playing starts and the
-	/// playing queue is empty.
+	/// \param bufferNum Number of the buffer to fill (in [0, BufferCount])
 	///
-	/// \return True if the derived class has requested to stop, false otherwise
+	/// \return True if the stream source has requested to stop, false otherwise
 	///
 	////////////////////////////////////////////////////////////
-	bool fillQueue();
+	bool pushDecodedChunk( unsigned int bufferNum );
 
 	////////////////////////////////////////////////////////////
 	/// \brief Clear all the audio buffers and empty the playing queue
@@ -258,25 +302,37 @@ class EE_API SoundStream : public SoundSource {
 	void clearQueue();
 
 	enum {
-		BufferCount = 3,  ///< Number of audio buffers used by the streaming loop
-		BufferRetries = 2 ///< Number of retries (excluding initial try) for onGetData()
+		BufferCount = 3,	   ///< Number of audio buffers used by the streaming loop
+		BufferRetries = 2,	   ///< Number of retries (excluding initial try) for onGetData()
+		DecodeAheadCount = 2 ///< Number of chunks decoded ahead of the audio buffers
 	};
 
 	////////////////////////////////////////////////////////////
 	// Member data
 	////////////////////////////////////////////////////////////
-	Thread mThread;						///< Thread running the background tasks
-	mutable Mutex mThreadMutex;			///< Thread mutex
-	Status mThreadStartState;			///< State the thread starts in (Playing, Paused, Stopped)
+	mutable Mutex mThreadMutex;			///< Streaming state mutex
+	Status mThreadStartState;			///< State the stream starts in (Playing, Paused, Stopped)
 	bool mIsStreaming;					///< Streaming state (true = playing, false = stopped)
 	unsigned int mBuffers[BufferCount]; ///< Sound buffers used to store temporary audio data
 	unsigned int mChannelCount;			///< Number of channels (1 = mono, 2 = stereo, ...)
 	unsigned int mSampleRate;			///< Frequency (samples / second)
 	Uint32 mFormat;						///< Format of the internal sound buffers
-	bool mLoop;							///< Loop flag (true to loop, false to play once)
+	std::atomic<bool> mLoop;			///< Loop flag (true to loop, false to play once)
 	Uint64 mSamplesProcessed;		 ///< Number of buffers processed since beginning of the stream
 	Int64 mBufferSeeks[BufferCount]; ///< If buffer is an "end buffer", holds next seek position,
 									 ///< else NoLoop. For play offset calculation.
+	Uint64 mBufferFrames[BufferCount]; ///< Number of sample frames stored in every buffer
+	unsigned int mQueueHead;		   ///< Number of the first buffer in the playing queue
+	unsigned int mQueueCount;		   ///< Number of buffers queued in the source
+	bool mServiceStarted;			   ///< The audio buffers have been created
+	bool mPlayPending;				   ///< The source has not started playing yet
+	bool mRequestStop;				   ///< The stream source has requested to stop
+	DecodedChunk mDecoded[DecodeAheadCount]; ///< Single producer single consumer ring
+	std::atomic<Uint32> mDecodedHead;		 ///< Chunks produced by the decoding worker
+	std::atomic<Uint32> mDecodedTail;		 ///< Chunks consumed by the streaming thread
+	std::atomic<bool> mDecodeEnd;			 ///< The decoder produced the last chunk
+	std::atomic<bool> mDecoding;			 ///< A decoding task is queued or running
+	bool mFirstChunk; ///< Next decoded chunk is the first one since the stream started
 };
 
 }} // namespace EE::Audio
@@ -307,12 +363,16 @@ class EE_API SoundStream : public SoundSource {
 /// \li onGetData fills a new chunk of audio data to be played
 /// \li onSeek changes the current playing position in the source
 ///
-/// It is important to note that each SoundStream is played in its
-/// own separate thread, so that the streaming loop doesn't block the
-/// rest of the program. In particular, the OnGetData and OnSeek
-/// virtual functions may sometimes be called from this separate thread.
-/// It is important to keep this in mind, because you may have to take
-/// care of synchronization issues if you share data between threads.
+/// It is important to note that the streams are not played from the
+/// main thread, so that the streaming loop doesn't block the rest of
+/// the program. A single audio streaming thread services all the
+/// playing streams, waking up only when the next buffer of a stream
+/// needs to be refilled, while the audio data is decoded ahead by a
+/// small pool of worker threads. In particular, the OnGetData and
+/// OnSeek virtual functions may sometimes be called from these worker
+/// threads. It is important to keep this in mind, because you may have
+/// to take care of synchronization issues if you share data between
+/// threads.
 ///
 /// Usage example:
 /// \code
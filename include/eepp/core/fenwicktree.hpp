@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace EE {
+
+/** @brief Binary indexed tree ( Fenwick tree ) of non-negative values.
+ * Point updates, prefix sums and finding the element that contains a given accumulated offset are
+ * O(log n). Building it from a list of values is O(n).
+ */
+template <typename T> class FenwickTree {
+  public:
+	FenwickTree() = default;
+
+	/** Rebuilds the tree with the values. */
+	void assign( const std::vector<T>& values ) {
+		mTree.assign( values.size() + 1, T{} );
+		for ( std::size_t i = 0; i < values.size(); ++i ) {
+			mTree[i + 1] += values[i];
+			std::size_t parent = ( i + 1 ) + ( ( i + 1 ) & ( ~( i + 1 ) + 1 ) );
+			if ( parent < mTree.size() )
+				mTree[parent] += mTree[i + 1];
+		}
+		mHighBit = 1;
+		while ( ( mHighBit << 1 ) <= values.size() )
+			mHighBit <<= 1;
+	}
+
+	void clear() {
+		mTree.clear();
+		mHighBit = 0;
+	}
+
+	bool empty() const { return mTree.size() <= 1; }
+
+	std::size_t size() const { return mTree.empty() ? 0 : mTree.size() - 1; }
+
+	/** Adds delta to the value at index. */
+	void add( std::size_t index, T delta ) {
+		for ( std::size_t i = index + 1; i < mTree.size(); i += i & ( ~i + 1 ) )
+			mTree[i] += delta;
+	}
+
+	/** @return The sum of the values in the range [0, index) */
+	T prefixSum( std::size_t index ) const {
+		T sum{};
+		for ( std::size_t i = index < mTree.size() ? index : size(); i > 0; i -= i & ( ~i + 1 ) )
+			sum += mTree[i];
+		return sum;
+	}
+
+	/** @return The sum of all the values */
+	T total() const { return prefixSum( size() ); }
+
+	/** @return The index of the element that contains the offset, this is the largest index which
+	 * prefix sum is lower or equal than offset, skipping the elements with a zero value. Returns
+	 * size() if offset is greater or equal than the total. */
+	std::size_t find( T offset ) const {
+		std::size_t pos = 0;
+		for ( std::size_t step = mHighBit; step > 0; step >>= 1 ) {
+			std::size_t next = pos + step;
+			if ( next < mTree.size() && mTree[next] <= offset ) {
+				pos = next;
+				offset -= mTree[next];
+			}
+		}
+		return pos;
+	}
+
+  protected:
+	std::vector<T> mTree;
+	std::size_t mHighBit{ 0 };
+};
+
+} // namespace EE
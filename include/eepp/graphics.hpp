@@ -31,6 +31,7 @@
 #include <eepp/graphics/particle.hpp>
 #include <eepp/graphics/particlesystem.hpp>
 #include <eepp/graphics/pixeldensity.hpp>
+#include <eepp/graphics/pixelkernels.hpp>
 #include <eepp/graphics/primitivedrawable.hpp>
 #include <eepp/graphics/primitives.hpp>
 #include <eepp/graphics/primitivetype.hpp>
@@ -62,6 +63,7 @@
 #include <eepp/graphics/textshaperun.hpp>
 #include <eepp/graphics/texttransform.hpp>
 #include <eepp/graphics/texture.hpp>
+#include <eepp/graphics/textureasyncloader.hpp>
 #include <eepp/graphics/textureatlas.hpp>
 #include <eepp/graphics/textureatlasloader.hpp>
 #include <eepp/graphics/textureatlasmanager.hpp>
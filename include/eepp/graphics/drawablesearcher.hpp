@@ -9,8 +9,12 @@ namespace EE { namespace Graphics {
 
 class EE_API DrawableSearcher {
   public:
+	/** Searches a drawable by its name, path or URI.
+	 * @param asyncLoad If true the images loaded from files are decoded asynchronously by the
+	 * TextureAsyncLoader, returning a placeholder texture until the image is ready. Remote images
+	 * are always loaded asynchronously. */
 	static Drawable* searchByName( const std::string& name, bool firstSearchSprite = false,
-								   Network::URI referer = "" );
+								   Network::URI referer = "", bool asyncLoad = false );
 
 	static Drawable* searchById( const Uint32& id );
 
@@ -421,6 +421,15 @@ class EE_API Image {
 	**	@param y The y position to start drawing the image */
 	void blit( Graphics::Image* image, const Uint32& x = 0, const Uint32& y = 0 );
 
+	/** Multiplies the color components by the alpha component ( only RGBA images ) */
+	void premultiplyAlpha();
+
+	/** Reverts the alpha premultiplication of the color components ( only RGBA images ) */
+	void unpremultiplyAlpha();
+
+	/** Swaps the red and blue components ( RGBA <-> BGRA, only RGBA images ) */
+	void swizzleRedBlue();
+
 	/** @return A copy of the original image */
 	Graphics::Image* copy();
 
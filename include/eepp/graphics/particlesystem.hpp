@@ -5,7 +5,10 @@
 #include <eepp/graphics/blendmode.hpp>
 #include <eepp/graphics/particle.hpp>
 
+#include <eepp/system/threadpool.hpp>
 #include <eepp/system/time.hpp>
+#include <memory>
+#include <vector>
 using namespace EE::System;
 
 namespace EE { namespace Graphics {
@@ -37,11 +40,20 @@ enum class ParticleEffect : Uint32 {
 	Callback //!< Callback defined effect. Set the callback before creating the effect.
 };
 
-/** @brief Basic but powerful Particle System */
+/** @brief Basic but powerful Particle System
+ * The particles can be simulated by two backends:
+ * Backend::SoA ( the default ) stores every particle attribute in its own contiguous array, the
+ * particles are integrated with vectorized kernels, and the dead particles are compacted at the end
+ * of the arrays so only the alive particles are updated and drawn. Very large emitters can also be
+ * updated in parallel chunks in a thread pool ( see setThreadPool ).
+ * Backend::AoS stores an array of Particle objects updated one by one.
+ * The effects and the reset callback work the same way in both backends. */
 class EE_API ParticleSystem {
   public:
 	typedef std::function<void( Particle*, ParticleSystem* )> ParticleCallback;
 
+	enum class Backend { AoS, SoA };
+
 	ParticleSystem();
 
 	virtual ~ParticleSystem();
@@ -153,6 +165,23 @@ class EE_API ParticleSystem {
 	/** Set The Acceleration of the effect */
 	void setAcceleration( const Vector2f& acc );
 
+	/** Sets the simulation backend. Changing it restarts the effect. */
+	void setBackend( const Backend& backend );
+
+	/** @return The simulation backend */
+	const Backend& getBackend() const;
+
+	/** Sets the thread pool used to update the particles in parallel with the SoA backend. Only
+	 * effects with more than 64K alive particles are updated in parallel. By default is not set
+	 * and the particles are updated in the calling thread. */
+	void setThreadPool( const std::shared_ptr<ThreadPool>& threadPool );
+
+	/** @return The thread pool used to update the particles */
+	const std::shared_ptr<ThreadPool>& getThreadPool() const;
+
+	/** @return The number of particles alive ( the ones being simulated and drawn ) */
+	Uint32 getAliveCount() const;
+
   private:
 	Particle* mParticle;
 	Uint32 mPCount;
@@ -181,10 +210,29 @@ class EE_API ParticleSystem {
 	bool mUsed;
 	bool mPointsSup;
 
+	Backend mBackend{ Backend::SoA };
+	std::shared_ptr<ThreadPool> mThreadPool;
+	/** SoA backend storage, the alive particles are kept in [0, mAlive) */
+	std::vector<Vector2f> mPositions;
+	std::vector<Vector2f> mSpeeds;
+	std::vector<Vector2f> mAccelerations;
+	std::vector<ColorAf> mColors;
+	/** Alpha decay stored as ( 0, 0, 0, decay ) so it can be applied to the whole color */
+	std::vector<ColorAf> mDecays;
+	std::vector<Uint32> mIds;
+	Uint32 mAlive{ 0 };
+	std::vector<std::vector<Uint32>> mDeadChunks;
+
 	void begin();
 
 	virtual void reset( Particle* P );
 
+	void resetParticle( const Uint32& index );
+
+	void swapParticles( const Uint32& a, const Uint32& b );
+
+	void updateSoA( const Float& time );
+
 	ParticleCallback mPC;
 };
 
@@ -0,0 +1,77 @@
+#ifndef EE_GRAPHICS_PIXELKERNELS_HPP
+#define EE_GRAPHICS_PIXELKERNELS_HPP
+
+#include <eepp/config.hpp>
+#include <eepp/system/color.hpp>
+
+using namespace EE::System;
+
+namespace EE { namespace Graphics {
+
+/** @brief Bulk pixel operations over raw pixel buffers.
+ * Every kernel has a scalar implementation and vectorized implementations ( SSE2 and AVX2 on
+ * x86-64, NEON on ARM64 ). The best backend supported by the CPU is selected at runtime. All the
+ * backends produce the same results. Unless indicated the pixel buffers are tightly packed and
+ * the count parameter is the number of pixels ( not bytes ).
+ */
+class EE_API PixelKernels {
+  public:
+	enum class Backend { Scalar, SSE2, AVX2, NEON };
+
+	/** @return The best backend supported by the current CPU */
+	static Backend getBestBackend();
+
+	/** @return The backend currently used by the kernels */
+	static Backend getBackend();
+
+	/** Forces the backend used by the kernels ( useful for testing and benchmarking ).
+	 * @return False if the backend is not supported by the current CPU */
+	static bool setBackend( const Backend& backend );
+
+	static bool isBackendSupported( const Backend& backend );
+
+	static const char* backendToString( const Backend& backend );
+
+	/** Replaces every pixel equal to colorKey with newColor. Only the first channels components of
+	 * the colors are used. */
+	static void replaceColor( Uint8* pixels, const size_t& count, const Uint32& channels,
+							  const Color& colorKey, const Color& newColor );
+
+	/** Fills the pixels with the first channels components of color. */
+	static void fill( Uint8* pixels, const size_t& count, const Uint32& channels,
+					  const Color& color );
+
+	/** Alpha blends the RGBA src pixels over the RGBA dst pixels ( same as Color::blend ). */
+	static void blendOver( Uint8* dst, const Uint8* src, const size_t& count );
+
+	/** Multiplies the RGB components of the RGBA pixels by its alpha. */
+	static void premultiplyAlpha( Uint8* pixels, const size_t& count );
+
+	/** Reverts the premultiplication of the RGB components of the RGBA pixels. */
+	static void unpremultiplyAlpha( Uint8* pixels, const size_t& count );
+
+	/** Swaps the red and blue components of RGBA / BGRA pixels ( RGBA <-> BGRA ). */
+	static void swizzleRedBlue( Uint8* pixels, const size_t& count );
+
+	/** Converts RGB pixels into RGBA pixels with the alpha indicated. */
+	static void rgbToRgba( Uint8* dst, const Uint8* src, const size_t& count,
+						   const Uint8& alpha = 255 );
+
+	/** Converts RGBA pixels into RGB pixels discarding the alpha. */
+	static void rgbaToRgb( Uint8* dst, const Uint8* src, const size_t& count );
+
+	/** Converts grayscale pixels into opaque RGBA pixels. */
+	static void grayToRgba( Uint8* dst, const Uint8* src, const size_t& count );
+
+	/** Converts RGBA pixels into grayscale pixels using the Rec. 601 luma. */
+	static void rgbaToGray( Uint8* dst, const Uint8* src, const size_t& count );
+
+	/** Converts between any number of channels copying the common channels and filling the rest
+	 * with 255 ( same behavior as copying the pixels with Image::getPixel / Image::setPixel ). */
+	static void convertChannels( Uint8* dst, const Uint32& dstChannels, const Uint8* src,
+								 const Uint32& srcChannels, const size_t& count );
+};
+
+}} // namespace EE::Graphics
+
+#endif // EE_GRAPHICS_PIXELKERNELS_HPP
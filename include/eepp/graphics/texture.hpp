@@ -157,6 +157,12 @@ class EE_API Texture : public DrawableResource, public Image, private NonCopyabl
 	/** Replaces the current texture with the image provided, reusing the current texture id. */
 	void replace( Image* image );
 
+	/** Replaces the current texture with the image and its already generated mipmap levels, reusing
+	 * the current texture id. Every level must be half the size of the previous one ( rounding
+	 * down, minimum 1 pixel ) down to 1x1. If the mipmaps can't be uploaded directly ( not power
+	 * of two textures not supported ) the mipmaps will be generated during the upload. */
+	void replace( Image* image, const std::vector<Image*>& mipmaps );
+
 	/** Flip the texture ( rotate the texture 90º ). Warning: This is flipped in memory, a real
 	 * flipping. */
 	void flip();
@@ -0,0 +1,128 @@
+#ifndef EE_GRAPHICS_TEXTUREASYNCLOADER_HPP
+#define EE_GRAPHICS_TEXTUREASYNCLOADER_HPP
+
+#include <atomic>
+#include <deque>
+#include <eepp/graphics/image.hpp>
+#include <eepp/graphics/texture.hpp>
+#include <eepp/system/lock.hpp>
+#include <eepp/system/mutex.hpp>
+#include <eepp/system/singleton.hpp>
+#include <eepp/system/threadpool.hpp>
+#include <eepp/system/time.hpp>
+#include <memory>
+
+using namespace EE::System;
+
+namespace EE { namespace Graphics {
+
+/** @brief Two stage asynchronous texture loader.
+ * The images are decoded ( and optionally its mipmaps generated ) in a thread pool, while the GPU
+ * upload is done from the main thread by update(), that is called once per frame by the
+ * SceneManager. Every frame only uploads textures until the upload bytes or time budget is
+ * consumed, so loading many images at once ( for example a markdown or HTML document with many
+ * images ) doesn't produce frame spikes.
+ * The load functions return immediately a transparent placeholder texture that is replaced with
+ * the final image once uploaded, notifying the change as a DrawableResource::Change event.
+ */
+class EE_API TextureAsyncLoader {
+	SINGLETON_DECLARE_HEADERS( TextureAsyncLoader )
+
+  public:
+	typedef std::function<void( Texture* )> OnTextureLoaded;
+
+	~TextureAsyncLoader();
+
+	/** Loads a texture from a file path.
+	 * @param filepath The image path
+	 * @param mipmap Use mipmaps?
+	 * @param clampMode Defines the CLAMP MODE
+	 * @param formatConfiguration The image format configuration used to decode the image
+	 * @param onLoaded Called from the main thread after the texture has been uploaded ( receives
+	 * nullptr if the image could not be decoded ).
+	 * @return The placeholder texture, if a texture with the same file path already exists it will
+	 * return that texture instead.
+	 */
+	Texture* loadFromFile(
+		const std::string& filepath, const bool& mipmap = false,
+		const Texture::ClampMode& clampMode = Texture::ClampMode::ClampToEdge,
+		const Image::FormatConfiguration& formatConfiguration = Image::FormatConfiguration(),
+		const OnTextureLoaded& onLoaded = OnTextureLoaded() );
+
+	/** Decodes an encoded image from memory into an existing texture.
+	 * @param texture The texture that will be replaced with the decoded image
+	 * @param data The image data just as if it were still in a file
+	 * @param formatConfiguration The image format configuration used to decode the image
+	 * @param onLoaded Called from the main thread after the texture has been uploaded
+	 */
+	void loadFromMemory(
+		Texture* texture, std::string&& data,
+		const Image::FormatConfiguration& formatConfiguration = Image::FormatConfiguration(),
+		const OnTextureLoaded& onLoaded = OnTextureLoaded() );
+
+	/** Uploads the decoded images pending respecting the upload budgets. It's called every frame
+	 * by the SceneManager, must be called from the main thread. At least one texture is uploaded
+	 * per call.
+	 * @return The number of textures uploaded */
+	size_t update();
+
+	/** @return The thread pool used to decode the images. The UISceneNode thread pool is used when
+	 * set, if no thread pool was set it falls back to a private thread pool created on demand. */
+	const std::shared_ptr<ThreadPool>& getThreadPool();
+
+	/** Sets the thread pool used to decode the images ( usually the application shared thread
+	 * pool ), nullptr releases it. */
+	void setThreadPool( const std::shared_ptr<ThreadPool>& threadPool );
+
+	/** @return True if a thread pool has been set or created */
+	bool hasThreadPool() const;
+
+	/** Maximum number of bytes uploaded to the GPU per frame ( 8 MiB by default, 0 = unlimited ). */
+	void setUploadBytesBudget( const Uint64& bytes );
+
+	const Uint64& getUploadBytesBudget() const;
+
+	/** Maximum time spent uploading textures per frame ( 4 ms by default, Time::Zero = unlimited ).
+	 */
+	void setUploadTimeBudget( const Time& time );
+
+	const Time& getUploadTimeBudget() const;
+
+	/** When enabled the mipmaps of the textures that use mipmaps are generated in the worker
+	 * threads instead of during the upload. Disabled by default. */
+	void setWorkerMipmaps( const bool& workerMipmaps );
+
+	const bool& getWorkerMipmaps() const;
+
+	/** @return The number of images being decoded or waiting to be uploaded */
+	size_t getPendingCount() const;
+
+  protected:
+	struct Upload {
+		Texture* texture{ nullptr };
+		Uint32 textureId{ 0 };
+		std::unique_ptr<Image> image;
+		std::vector<std::unique_ptr<Image>> mipmaps;
+		OnTextureLoaded onLoaded;
+		Uint64 bytes{ 0 };
+	};
+
+	std::shared_ptr<ThreadPool> mThreadPool;
+	mutable Mutex mMutex;
+	std::deque<std::unique_ptr<Upload>> mUploads;
+	std::atomic<size_t> mDecoding{ 0 };
+	Uint64 mUploadBytesBudget{ 8 * 1024 * 1024 };
+	Time mUploadTimeBudget{ Milliseconds( 4 ) };
+	bool mWorkerMipmaps{ false };
+
+	TextureAsyncLoader();
+
+	void decode( Texture* texture, const std::function<Image*()>& decoder,
+				 const OnTextureLoaded& onLoaded );
+
+	void upload( Upload& upload );
+};
+
+}} // namespace EE::Graphics
+
+#endif
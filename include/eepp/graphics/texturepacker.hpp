@@ -31,6 +31,9 @@
 #include <eepp/graphics/image.hpp>
 #include <eepp/graphics/packerhelper.hpp>
 #include <eepp/graphics/texture.hpp>
+#include <eepp/system/threadpool.hpp>
+#include <functional>
+#include <memory>
 
 namespace EE { namespace Graphics {
 
@@ -119,6 +122,11 @@ class EE_API TexturePacker {
 	 * texture atlas.  */
 	bool addTexturesPath( std::string TexturesPath );
 
+	/** Adds a list of images/textures from its paths to the texture atlas. If a thread pool is set
+	 * the image headers are probed in parallel.
+	 * @return The number of images added. */
+	Uint32 addTextures( const std::vector<std::string>& TexturesPaths );
+
 	/** After adding all the images that will be used to create the texture atlas. Packing the
 	 * textures will generate the texture atlas information ( it will fit the images inside the
 	 * texture atlas, etc ).
@@ -139,9 +147,39 @@ class EE_API TexturePacker {
 			   const Image::SaveType& Format = Image::SaveType::PNG,
 			   const bool& KeepExtensions = false );
 
+	/** Packs the textures ( if not packed yet ) and composes the texture atlas image in memory
+	 * instead of saving it to disk. Only the images placed in this atlas are composed, if the
+	 * packer created children atlases they must be generated from the child packer ( see
+	 * getChild ).
+	 * @return The new texture atlas image ( the caller owns the image ) or nullptr if the packing
+	 * failed.
+	 */
+	Image* generateImage();
+
+	/** Iterates over every image placed in this texture atlas.
+	 *	@param cb The callback receives the image name ( the file path or the name used in
+	 *addImage ), the rectangle occupied by the image in the atlas and if the image was flipped.
+	 */
+	void forEachPlaced(
+		const std::function<void( const std::string&, const Rect&, bool )>& cb ) const;
+
+	/** @return The child texture packer ( the next atlas page ) if the packer needed to create
+	 * one. Only possible if allowChildren is enabled. */
+	TexturePacker* getChild() const;
+
 	/** Clear all the textures added */
 	void close();
 
+	/** Enables the parallel streaming pipeline. When a thread pool is set the image headers of the
+	 * directories and lists added are probed in parallel, the packing only uses the images
+	 * dimensions, and the images are decoded and copied into the atlas page in parallel as soon as
+	 * they are needed. Only the images being decoded and the page being composed stay in memory,
+	 * every page is saved and released before composing the next one.
+	 * Must be set before adding any texture to be used while probing. */
+	void setThreadPool( const std::shared_ptr<ThreadPool>& threadPool );
+
+	const std::shared_ptr<ThreadPool>& getThreadPool() const;
+
 	/** First of all you need to set at least the max dimensions of the texture atlas. If the
 	 *instance of the texture packer was created without indicating this data, this must be called
 	 *before adding any texture or image.
@@ -206,11 +244,12 @@ class EE_API TexturePacker {
 	bool mKeepExtensions;
 	bool mScalableSVG;
 	Image::SaveType mFormat;
-
-	TexturePacker* getChild() const;
+	std::shared_ptr<ThreadPool> mThreadPool;
 
 	TexturePacker* getParent() const;
 
+	void forEachIndex( const size_t& count, const std::function<void( size_t )>& fn );
+
 	std::vector<TexturePackerTex*>* getTexturePackPtr();
 
 	void childSave( const Image::SaveType& Format );
@@ -3,9 +3,13 @@
 
 #include <atomic>
 #include <eepp/config.hpp>
+#include <eepp/core/containers.hpp>
 #include <eepp/scene/action.hpp>
+#include <eepp/scene/actions/runnable.hpp>
+#include <eepp/system/clock.hpp>
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/time.hpp>
+#include <limits>
 #include <vector>
 using namespace EE::System;
 
@@ -14,6 +18,13 @@ namespace EE { namespace Scene {
 class Action;
 class Node;
 
+/** @brief Runs the actions of a scene.
+ * The actions are indexed by target and by ( target, tag ), so the lookups and the removals don't
+ * depend on the number of actions running.
+ * Runnables ( timeouts, intervals, debounces and main thread calls ) are not updated every frame,
+ * they are kept in a timer heap and only updated once they are due. Runnables created with
+ * createRunnable are recycled once finished.
+ */
 class EE_API ActionManager {
   public:
 	static ActionManager* New();
@@ -22,6 +33,8 @@ class EE_API ActionManager {
 
 	~ActionManager();
 
+	/** Adds the action to the manager. The target and the tag of the action must be set before
+	 * adding it, they are indexed. */
 	void addAction( Action* action );
 
 	Action* getActionByTag( const Action::UniqueID& tag );
@@ -43,8 +56,17 @@ class EE_API ActionManager {
 
 	std::vector<Action*> getActionsByTagFromTarget( Node* target, const Action::UniqueID& tag );
 
+	/** Creates a runnable action, reusing a previously finished one when available.
+	 * The runnable must be added to the manager ( usually with Node::runAction ). */
+	Actions::Runnable* createRunnable( Actions::Runnable::RunnableFunc&& callback,
+									   const Time& time = Seconds( 0 ), bool loop = false );
+
 	void update( const Time& time );
 
+	/** @return The time until the next action needs to be updated. The poll timeout if there are
+	 * actions being updated every frame, Time::Infinity if there are no actions. */
+	Time getNextUpdateTimeout( const Time& pollTimeout ) const;
+
 	std::size_t count() const;
 
 	bool isEmpty() const;
@@ -52,12 +74,64 @@ class EE_API ActionManager {
 	void clear();
 
   protected:
+	static constexpr size_t RunnablesPoolSize = 128;
+
+	struct ActionEntry {
+		Node* target{ nullptr };
+		Action::UniqueID tag{ 0 };
+		/** Index in mActions of the actions updated every frame, or Timer */
+		size_t index{ 0 };
+		/** Changes every time the timer is scheduled, invalidates its older heap entries */
+		Uint64 generation{ 0 };
+	};
+
+	struct TimerEntry {
+		Time due;
+		Action* action;
+		Uint64 generation;
+	};
+
+	struct TargetActions {
+		std::vector<Action*> actions;
+		UnorderedMap<Action::UniqueID, std::vector<Action*>> tagged;
+	};
+
+	static constexpr size_t Timer = std::numeric_limits<size_t>::max();
+
 	std::vector<Action*> mActions;
 	std::vector<Action*> mActionsRemoveList;
+	UnorderedMap<Action*, ActionEntry> mEntries;
+	UnorderedMap<Node*, TargetActions> mTargets;
+	std::vector<TimerEntry> mTimers;
+	std::vector<Actions::Runnable*> mRunnablesPool;
+	std::vector<Action*> mDoneList;
+	Clock mClock;
+	Uint64 mGeneration{ 0 };
+	size_t mHoles{ 0 };
+	size_t mStaleTimers{ 0 };
 	mutable Mutex mMutex;
 	std::atomic<bool> mUpdating;
+	std::atomic<Uint64> mRemovals{ 0 };
+
+	static bool timerCompare( const TimerEntry& a, const TimerEntry& b );
 
 	void update( const Time& time, Action** actions, size_t count );
+
+	void updateTimers( const Time& time );
+
+	void finishUpdate();
+
+	void scheduleTimer( Action* action, ActionEntry& entry, const Time& delay );
+
+	bool isActive( Action* action, Uint64 removals );
+
+	/** Removes the action from the indexes, must be called with the mutex locked */
+	void detach( Action* action );
+
+	/** Releases or recycles a detached action */
+	void release( Action* action );
+
+	void compact();
 };
 
 }} // namespace EE::Scene
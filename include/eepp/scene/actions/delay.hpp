@@ -29,6 +29,9 @@ class EE_API Delay : public Action {
 
 	void restart();
 
+	/** @return The time left until the delay is done */
+	Time getRemainingTime() const;
+
   protected:
 	Clock mClock;
 	Time mTime;
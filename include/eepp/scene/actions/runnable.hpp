@@ -5,6 +5,10 @@
 #include <eepp/system/mutex.hpp>
 #include <functional>
 
+namespace EE { namespace Scene {
+class ActionManager;
+}} // namespace EE::Scene
+
 namespace EE { namespace Scene { namespace Actions {
 
 class EE_API Runnable : public Delay {
@@ -25,14 +29,21 @@ class EE_API Runnable : public Delay {
 	void setCallback( RunnableFunc&& callback );
 
   protected:
+	friend class EE::Scene::ActionManager;
+
 	RunnableFunc mCallback;
 	Mutex mCallbackMutex;
 	bool mCalled{ false };
 	bool mLoop{ false };
+	/** Owned by the ActionManager runnables pool, it's recycled instead of released */
+	bool mPooled{ false };
 
 	explicit Runnable( RunnableFunc callback, const Time& time = Seconds( 0 ), bool loop = false );
 
 	void onStart() override;
+
+	/** Resets the runnable to its initial state so it can be reused */
+	void reset( RunnableFunc&& callback, const Time& time, bool loop );
 };
 
 }}} // namespace EE::Scene::Actions
@@ -417,6 +417,18 @@ class EE_API Node : public Transformable {
 	 */
 	virtual void scheduledUpdate( const Time& time );
 
+	/**
+	 * @brief Returns how long the node can wait for its next scheduled update.
+	 *
+	 * Used by the main loop to sleep until the next deadline when nothing needs to be redrawn.
+	 * Nodes that only react to input events can return Time::Infinity, nodes with timed work
+	 * (like a blinking caret) return the time left until it's due.
+	 *
+	 * @param pollTimeout The regular polling interval of the main loop, returned by default.
+	 * @return The maximum time to wait before the next scheduledUpdate() call.
+	 */
+	virtual Time getScheduledUpdateTimeout( const Time& pollTimeout );
+
 	/**
 	 * @brief Gets the next sibling node in the parent's child list.
 	 *
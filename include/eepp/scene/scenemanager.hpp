@@ -10,6 +10,10 @@ using namespace EE::System;
 namespace EE { namespace UI {
 class UISceneNode;
 }} // namespace EE::UI
+
+namespace EE { namespace Window {
+class Window;
+}} // namespace EE::Window
 using namespace EE::UI;
 
 namespace EE { namespace Scene {
@@ -37,6 +41,16 @@ class EE_API SceneManager {
 
 	void update();
 
+	/** @return How long the main loop can sleep waiting for events before the scenes must be
+	 * updated again. Time::Infinity if the scenes only need to be updated when an event arrives.
+	 * @param pollTimeout The regular polling interval of the main loop, used for the work without
+	 * a known deadline. */
+	Time getNextUpdateTimeout( const Time& pollTimeout );
+
+	/** Waits for the window events until the next update deadline of the scenes. Returns right away
+	 * if an update is already due. */
+	void waitForNextUpdate( EE::Window::Window* window, const Time& pollTimeout );
+
 	UISceneNode* getUISceneNode();
 
 	void setCurrentUISceneNode( UISceneNode* uiSceneNode );
@@ -353,6 +353,18 @@ class EE_API SceneNode : public Node {
 	 */
 	bool isSubscribedForScheduledUpdate( Node* node );
 
+	/**
+	 * @brief Returns how long the scene can wait for its next update.
+	 *
+	 * Takes into account the pending actions and timers, and the scheduled updates of the
+	 * subscribed nodes.
+	 *
+	 * @param pollTimeout The regular polling interval of the main loop.
+	 * @return Time::Zero if the scene must be updated right away, Time::Infinity if it only
+	 * needs to be updated when an event arrives, otherwise the time left until the next deadline.
+	 */
+	virtual Time getNextUpdateTimeout( const Time& pollTimeout );
+
 	/**
 	 * @brief Adds a node to the mouse-over tracking list.
 	 *
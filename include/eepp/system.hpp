@@ -1,6 +1,7 @@
 #ifndef EEPP_SYSTEM_HPP
 #define EEPP_SYSTEM_HPP
 
+#include <eepp/system/asyncfileio.hpp>
 #include <eepp/system/base64.hpp>
 #include <eepp/system/bitop.hpp>
 #include <eepp/system/clock.hpp>
@@ -33,6 +34,7 @@
 #include <eepp/system/parsermatcher.hpp>
 #include <eepp/system/patternmatcher.hpp>
 #include <eepp/system/process.hpp>
+#include <eepp/system/profiler.hpp>
 #include <eepp/system/rc4.hpp>
 #include <eepp/system/regex.hpp>
 #include <eepp/system/resourceloader.hpp>
@@ -0,0 +1,93 @@
+#ifndef EE_SYSTEM_ASYNCFILEIO_HPP
+#define EE_SYSTEM_ASYNCFILEIO_HPP
+
+#include <eepp/config.hpp>
+#include <eepp/core/noncopyable.hpp>
+#include <eepp/system/threadpool.hpp>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace EE { namespace System {
+
+class Thread;
+struct AsyncFileIOState;
+
+/** @brief Asynchronous whole file reads and writes.
+ * On Linux the requests are submitted in batches to io_uring from a dedicated I/O thread, keeping
+ * up to the queue depth reads and writes in flight. When io_uring is not available ( other
+ * platforms, old kernels or sandboxes that block it ) every request is served by a blocking
+ * read or write in the thread pool.
+ * The completion callbacks always run in the thread pool, tagged with the request tag. The number
+ * of completed requests waiting for their callback is bounded, so reading faster than the
+ * callbacks can consume doesn't accumulate the files in memory.
+ */
+class EE_API AsyncFileIO : NonCopyable {
+  public:
+	struct Result {
+		std::string path;
+		/** The file contents for reads, empty for writes */
+		std::string data;
+		bool success{ false };
+	};
+
+	/** The callback can take ownership of the result data */
+	using Callback = std::function<void( Result& result )>;
+
+	static std::shared_ptr<AsyncFileIO> New( std::shared_ptr<ThreadPool> pool,
+											 Uint32 queueDepth = 64 );
+
+	AsyncFileIO( std::shared_ptr<ThreadPool> pool, Uint32 queueDepth = 64 );
+
+	/** The requests waiting for io_uring are discarded, the ones in flight or already queued in
+	 * the thread pool still complete their I/O. No callback starts after the destruction begins,
+	 * but a callback that is already running in the thread pool may still be running when the
+	 * destructor returns. The futures of the skipped requests are left with a broken promise. */
+	~AsyncFileIO();
+
+	/** Reads a whole file.
+	 * @return The request id */
+	Uint64 readFile( const std::string& path, Callback callback, const Uint64& tag = 0 );
+
+	/** Reads a batch of files, the callback is called once per file. */
+	void readFiles( const std::vector<std::string>& paths, const Callback& callback,
+					const Uint64& tag = 0 );
+
+	/** Reads a whole file, the future is fulfilled in the thread pool. */
+	std::future<Result> readFileFuture( const std::string& path );
+
+	/** Writes ( or overwrites ) a whole file.
+	 * @return The request id */
+	Uint64 writeFile( const std::string& path, std::string data, Callback callback = nullptr,
+					  const Uint64& tag = 0 );
+
+	/** Writes ( or overwrites ) a whole file, the future is fulfilled in the thread pool. */
+	std::future<Result> writeFileFuture( const std::string& path, std::string data );
+
+	/** Discards the pending requests and the pending callbacks with the tag. Their callbacks are
+	 * never called. Requests already in flight complete, but their callbacks are not called.
+	 * @return True if any request was discarded */
+	bool cancel( const Uint64& tag );
+
+	/** @return If the requests are served by io_uring */
+	bool isUsingIoUring() const;
+
+	Uint32 getQueueDepth() const;
+
+	const std::shared_ptr<ThreadPool>& getThreadPool() const;
+
+  protected:
+	std::shared_ptr<ThreadPool> mPool;
+	std::shared_ptr<AsyncFileIOState> mState;
+	std::unique_ptr<Thread> mThread;
+	Uint32 mQueueDepth;
+
+	Uint64 request( bool write, const std::string& path, std::string&& data, Callback&& callback,
+					const Uint64& tag );
+};
+
+}} // namespace EE::System
+
+#endif
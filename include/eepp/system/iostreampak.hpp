@@ -3,12 +3,15 @@
 
 #include <eepp/system/iostream.hpp>
 #include <eepp/system/pak.hpp>
+#include <eepp/system/scopedbuffer.hpp>
 
 namespace EE { namespace System {
 
 class IOStreamFile;
 
-/** @brief An implementation for a zip file steam */
+/** @brief An implementation for a pak file stream.
+ * Uncompressed files of a memory mapped pak are read directly from the mapping, compressed files
+ * are decompressed into memory when the stream is opened. */
 class EE_API IOStreamPak : public IOStream {
   public:
 	static IOStreamPak* New( Pak* pack, const std::string& path, bool writeMode = false );
@@ -36,8 +39,11 @@ class EE_API IOStreamPak : public IOStream {
 
   protected:
 	IOStreamFile* mFile;
-	Pak::pakEntry mEntry;
-	Int32 mPos;
+	const Uint8* mData;
+	ScopedBuffer mBuffer;
+	Uint64 mPosition;
+	Uint64 mSize;
+	Uint64 mPos;
 	bool mOpen;
 };
 
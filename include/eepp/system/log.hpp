@@ -5,10 +5,13 @@
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/singleton.hpp>
 #include <eepp/system/sys.hpp>
+#include <atomic>
 #include <unordered_map>
 
 namespace EE { namespace System {
 
+struct LogAsyncState;
+
 /** @brief The reader interface is useful if you want to keep track of what is write in the log, for
  * example for a console. */
 class LogReaderInterface {
@@ -83,7 +86,7 @@ class EE_API Log : protected Mutex {
 			return;
 		auto result = String::format(
 			format, FormatArg<std::decay_t<Args>>::get( std::forward<Args>( args ) )... );
-		write( logLevelWithTimestamp( level, result, true ) );
+		writel( level, result );
 	}
 
 	/** @brief Writes a formatted string to the log */
@@ -91,8 +94,7 @@ class EE_API Log : protected Mutex {
 	void writef( std::string_view format, Args&&... args ) {
 		auto result = String::format(
 			format, FormatArg<std::decay_t<Args>>::get( std::forward<Args>( args ) )... );
-		write( result );
-		write( "\n" );
+		writel( result );
 	}
 
 	/** @returns A reference of the current written log. */
@@ -137,6 +139,45 @@ class EE_API Log : protected Mutex {
 	/** Enable/Disable to keep a copy of the logs into memory (disabled by default) */
 	void setKeepLog( bool keepLog );
 
+	/** @return The maximum size in bytes of the log kept in memory, 0 if unlimited */
+	const size_t& getKeepLogMaxSize() const;
+
+	/** Limits the log kept in memory to its last lines that fit in maxSize bytes. 0 means
+	 * unlimited (default). */
+	void setKeepLogMaxSize( const size_t& maxSize );
+
+	/** @return True if the log is written asynchronously */
+	bool isAsync() const;
+
+	/** @brief Enables or disables the asynchronous mode (disabled by default).
+	 * In asynchronous mode a write only copies the message into a lock-free ring buffer owned by
+	 * the calling thread. A background thread merges the buffers in order, formats the timestamps
+	 * and writes the messages in batches to the log file, the standard output, the memory log and
+	 * the readers, so the readers are called from the background thread.
+	 * When a thread buffer is full the message is discarded, except for errors and more severe
+	 * messages that wait for room. Critical and assert messages are written before returning.
+	 * @param threadBufferSize Number of messages that each thread buffer can hold ( rounded up to
+	 * a power of two ). */
+	void setAsync( bool async, size_t threadBufferSize = 1024 );
+
+	/** Blocks until the messages written before the call are written. Only needed in asynchronous
+	 * mode. */
+	void flush();
+
+	/** @return The number of messages discarded because a thread buffer was full */
+	Uint64 getDroppedMessages() const;
+
+	/** @brief Enables the rotation of the log file.
+	 * When a write would make the log file bigger than maxFileSize the file is renamed to
+	 * "path.1" ( the previous "path.1" to "path.2" and so on ) and a new log file is started.
+	 * @param maxFileSize The maximum file size in bytes, 0 disables the rotation (default).
+	 * @param maxRotatedFiles The number of old log files to keep. */
+	void setFileRotation( const Uint64& maxFileSize, const Uint32& maxRotatedFiles = 3 );
+
+	const Uint64& getMaxFileSize() const;
+
+	const Uint32& getMaxRotatedFiles() const;
+
 	static void debug( const std::string_view& text ) {
 		Log::instance()->writel( LogLevel::Debug, text );
 	}
@@ -221,13 +262,35 @@ class EE_API Log : protected Mutex {
 	LogLevel mLogLevelThreshold{ getDefaultLogLevel() };
 	IOStreamFile* mFS;
 	std::vector<LogReaderInterface*> mReaders;
+	Mutex mReadersMutex;
+	size_t mKeepLogMaxSize{ 0 };
+	Uint64 mFileSize{ 0 };
+	Uint64 mMaxFileSize{ 0 };
+	Uint32 mMaxRotatedFiles{ 3 };
+	std::atomic<bool> mAsync{ false };
+	LogAsyncState* mAsyncState{ nullptr };
 
 	void openFS();
 
 	void closeFS();
 
+	void rotateFS();
+
 	void writeToReaders( const std::string_view& text );
 
+	void writeToStdOut( const std::string_view& text, bool appendNewLine );
+
+	void writeToFile( const std::string_view& text, bool flush );
+
+	void keepLog( const std::string_view& text, bool appendNewLine );
+
+	/** Queues the message in the calling thread buffer, formatting is done by the writer thread */
+	void enqueue( const LogLevel* level, const std::string_view& text, bool appendNewLine );
+
+	void asyncWriterLoop();
+
+	void asyncDrain();
+
 	std::string logLevelWithTimestamp( const LogLevel& level, const std::string_view& text,
 									   bool appendNewLine );
 };
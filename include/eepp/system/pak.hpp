@@ -1,23 +1,40 @@
 #ifndef EE_SYSTEMCPAK_HPP
 #define EE_SYSTEMCPAK_HPP
 
+#include <eepp/core/string.hpp>
 #include <eepp/system/iostreamfile.hpp>
 #include <eepp/system/pack.hpp>
 
 namespace EE { namespace System {
 
-/** @brief Quake 2 PAK handler */
+struct PakMappedFile;
+
+/** @brief PAK file handler.
+ * Supports the classic Quake 2 PAK format ( version 1 ) and the version 2 format.
+ * Version 2 packs store a directory sorted by the hash of the file paths, support long file paths,
+ * files bigger than 4 GiB and optional per-file compression.
+ * The files are looked up in O(log n) in both formats, and the opened packs are memory mapped
+ * when possible, so uncompressed files can be read without copying them ( see getFileData ).
+ */
 class EE_API Pak : public Pack {
   public:
+	enum class Version : Uint32 { V1 = 1, V2 = 2 };
+
+	/** Compression used to store the files added to a version 2 pack */
+	enum class FileCompression : Uint8 { None = 0, Deflate = 1, Brotli = 2 };
+
 	static Pak* New();
 
 	Pak();
 
 	~Pak();
 
-	/** Creates a new pakFile */
+	/** Creates a new pakFile ( version 1 ) */
 	bool create( const std::string& path );
 
+	/** Creates a new pakFile in the requested format version */
+	bool create( const std::string& path, const Version& version );
+
 	/** Open a pakFile */
 	bool open( const std::string& path );
 
@@ -37,7 +54,8 @@ class EE_API Pak : public Pack {
 	/** Add a new file from memory */
 	bool addFile( const Uint8* data, const Uint32& dataSize, const std::string& inpack );
 
-	/** Add a map of files to the pakFile ( myMap[ myFilepath ] = myInPakFilepath ) */
+	/** Add a map of files to the pakFile ( myMap[ myFilepath ] = myInPakFilepath ). Version 2
+	 * packs write the directory only once for all the files. */
 	bool addFiles( std::map<std::string, std::string> paths );
 
 	/** Erase a file from the pakFile. ( This will create a new pakFile without that file, so, can
@@ -74,8 +92,28 @@ class EE_API Pak : public Pack {
 	/** @return The file path of the opened package */
 	std::string getPackPath();
 
+	/** Open a file stream for reading. Streams of uncompressed files read straight from the mapped
+	 * pack. The streams must not be used after the pack is modified or closed. */
 	IOStream* getFileStream( const std::string& path );
 
+	/** @return A pointer to the contents of an uncompressed file inside the memory mapped pack, or
+	 * NULL if the file doesn't exists, is compressed or the pack couldn't be mapped. The pointer is
+	 * valid until the pack is modified or closed.
+	 * @param size Returns the file size */
+	const Uint8* getFileData( const std::string& path, Uint64* size = NULL );
+
+	/** @return The format version of the opened pack */
+	const Version& getVersion() const;
+
+	/** Sets the compression used for the files added to a version 2 pack. Files that don't shrink
+	 * are stored uncompressed. Version 1 packs always store the files uncompressed. */
+	void setCompression( const FileCompression& compression );
+
+	const FileCompression& getCompression() const;
+
+	/** @return If the opened pack is memory mapped */
+	bool isMapped() const;
+
   protected:
 	friend class IOStreamPak;
 
@@ -92,6 +130,25 @@ class EE_API Pak : public Pack {
 		Uint32 file_length;	  //! THe file length ( in bytes )
 	}; //! The stored file info
 
+	struct pakHeaderV2 {
+		char head[4];		 //! Header of the file ( 'PAK2' )
+		Uint32 version;		 //! Format version ( 2 )
+		Uint64 dir_offset;	 //! Offset to the directory
+		Uint32 entries;		 //! Number of pakEntryV2 in the directory
+		Uint32 names_length; //! Size of the file names table stored after the directory
+	};
+
+	struct pakEntryV2 {
+		Uint64 file_position;	  //! The file position on the file ( in bytes )
+		Uint64 file_length;		  //! The stored file length ( in bytes )
+		Uint64 uncompressed_size; //! The file length once decompressed ( in bytes )
+		Uint32 hash;			  //! String::hash of the file name, the directory is sorted by it
+		Uint32 name_offset;		  //! Offset of the file name in the names table
+		Uint16 name_length;		  //! File name length
+		Uint8 compression;		  //! FileCompression
+		Uint8 padding[5];
+	};
+
 	struct pakFile {
 		IOStreamFile* fs;
 		pakHeader header;
@@ -99,10 +156,51 @@ class EE_API Pak : public Pack {
 		std::string pakPath;
 	};
 
+	/** The directory of the pack, common to both format versions */
+	struct Entry {
+		std::string path;
+		String::HashType hash;
+		Uint64 position;
+		Uint64 length;
+		Uint64 uncompressedSize;
+		FileCompression compression;
+	};
+
 	pakFile mPak;
 	std::vector<pakEntry> mPakFiles;
+	std::vector<Entry> mEntries;
+	/** Indexes of mEntries sorted by hash and path */
+	std::vector<Uint32> mIndex;
+	Version mVersion{ Version::V1 };
+	FileCompression mCompression{ FileCompression::None };
+	PakMappedFile* mMapped{ nullptr };
+	Uint64 mDataEnd{ 0 };
 
 	pakEntry getPackEntry( Uint32 index );
+
+	const Entry* getEntry( const std::string& path );
+
+	void indexEntry( Uint32 index );
+
+	bool openV2();
+
+	bool addFileV2( const Uint8* data, const Uint64& dataSize, const std::string& inpack,
+					bool writeDirectory );
+
+	bool writeDirectoryV2();
+
+	bool eraseFilesV2( const std::vector<Int32>& files );
+
+	bool readStoredData( const Entry& entry, ScopedBuffer& data );
+
+	bool decompressEntry( const Entry& entry, const Uint8* src, Uint8* dst );
+
+	/** @return The stored data of the entry in the mapped pack, or NULL if not mapped */
+	const Uint8* getMappedData( const Entry& entry ) const;
+
+	void mapFile();
+
+	void unmapFile();
 };
 
 }} // namespace EE::System
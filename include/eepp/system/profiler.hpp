@@ -0,0 +1,154 @@
+#ifndef EE_SYSTEM_PROFILER_HPP
+#define EE_SYSTEM_PROFILER_HPP
+
+#include <atomic>
+#include <eepp/config.hpp>
+#include <eepp/system/mutex.hpp>
+#include <eepp/system/singleton.hpp>
+#include <eepp/system/time.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace EE { namespace System {
+
+/** @brief Low overhead scoped zones profiler.
+ * Every thread records its zones in its own ring buffer, so recording a zone never locks or
+ * allocates ( the buffer is allocated the first time the thread records a zone ). The oldest zones
+ * are overwritten once the ring buffer is full.
+ * The profiler is disabled by default, while disabled the cost of a zone is a single atomic load.
+ * The zones are declared with the EE_PROFILE_* macros, that are compiled only when
+ * EE_PROFILER_ENABLED is defined ( it can be removed with the "without-profiler" build option ).
+ * The recorded zones can be exported as Chrome trace event JSON ( open it with chrome://tracing or
+ * https://ui.perfetto.dev ) and the zones of the last frame can be displayed in a UISceneNode
+ * overlay ( see UISceneNode::setProfilerOverlayVisible ).
+ */
+class EE_API Profiler {
+	SINGLETON_DECLARE_HEADERS( Profiler )
+
+  public:
+	struct Zone {
+		const char* name{ nullptr };
+		const char* category{ nullptr };
+		/** Start time in nanoseconds since the profiler epoch */
+		Uint64 start{ 0 };
+		/** Duration in nanoseconds */
+		Uint64 duration{ 0 };
+		Uint32 depth{ 0 };
+	};
+
+	struct ZoneStats {
+		const char* name{ nullptr };
+		Uint32 depth{ 0 };
+		Uint32 calls{ 0 };
+		Time time;
+	};
+
+	/** Scoped zone, measures the time since its construction until its destruction. name and
+	 * category must be string literals ( or live as long as the profiler ). */
+	class EE_API ScopedZone {
+	  public:
+		explicit ScopedZone( const char* name, const char* category = "eepp" );
+
+		~ScopedZone();
+
+	  protected:
+		const char* mName;
+		const char* mCategory;
+		Uint64 mStart{ 0 };
+		bool mActive;
+	};
+
+	/** Number of zones stored per thread before starting overwriting the oldest ones */
+	static constexpr size_t ThreadBufferCapacity = 1 << 16;
+
+	~Profiler();
+
+	static bool isEnabled() {
+		return sEnabled.load( std::memory_order_relaxed );
+	}
+
+	static void setEnabled( bool enabled );
+
+	/** @return The nanoseconds elapsed since the profiler epoch */
+	static Uint64 now();
+
+	/** Sets the name of the current thread displayed in the trace */
+	static void setThreadName( const std::string& name );
+
+	/** Marks the end of a frame, it must be called from the main thread ( Window::display calls
+	 * it ). Computes the zones statistics of the frame. */
+	void frameMark();
+
+	/** @return The zones statistics of the thread that calls frameMark of the last complete frame,
+	 * aggregated by zone name and sorted in order of appearance. */
+	std::vector<ZoneStats> getLastFrameStats() const;
+
+	/** @return The time of the last complete frame */
+	Time getLastFrameTime() const;
+
+	/** @return The recorded zones of all threads as Chrome trace event JSON */
+	std::string toChromeTraceJSON() const;
+
+	/** Writes the recorded zones as Chrome trace event JSON into a file */
+	bool exportChromeTrace( const std::string& path ) const;
+
+	/** Discards all the recorded zones */
+	void clear();
+
+  protected:
+	struct ThreadBuffer {
+		std::vector<Zone> zones;
+		std::atomic<Uint64> head{ 0 };
+		/** Index of the first valid zone after a clear */
+		std::atomic<Uint64> tail{ 0 };
+		Uint32 depth{ 0 };
+		Uint64 threadId{ 0 };
+		std::string name;
+	};
+
+	static std::atomic<bool> sEnabled;
+
+	mutable Mutex mMutex;
+	std::vector<std::shared_ptr<ThreadBuffer>> mBuffers;
+	std::vector<ZoneStats> mLastFrameStats;
+	Uint64 mFrameStart{ 0 };
+	Time mLastFrameTime;
+
+	Profiler();
+
+	static ThreadBuffer* getThreadBuffer();
+
+	void registerBuffer( const std::shared_ptr<ThreadBuffer>& buffer );
+};
+
+}} // namespace EE::System
+
+#ifdef EE_PROFILER_ENABLED
+#define EE_PROFILE_CONCAT_IMPL( a, b ) a##b
+#define EE_PROFILE_CONCAT( a, b ) EE_PROFILE_CONCAT_IMPL( a, b )
+/** Profiles the current scope with the name indicated */
+#define EE_PROFILE_ZONE( name ) \
+	::EE::System::Profiler::ScopedZone EE_PROFILE_CONCAT( eeProfileZone, __LINE__ )( name )
+/** Profiles the current scope with the name and category indicated */
+#define EE_PROFILE_ZONE_CATEGORY( name, category )                                          \
+	::EE::System::Profiler::ScopedZone EE_PROFILE_CONCAT( eeProfileZone, __LINE__ )( name, \
+																					  category )
+/** Profiles the current function */
+#define EE_PROFILE_FUNCTION() EE_PROFILE_ZONE( __func__ )
+/** Marks the end of a frame */
+#define EE_PROFILE_FRAME_MARK()                             \
+	do {                                                    \
+		if ( ::EE::System::Profiler::isEnabled() )          \
+			::EE::System::Profiler::instance()->frameMark(); \
+	} while ( 0 )
+#define EE_PROFILE_THREAD_NAME( name ) ::EE::System::Profiler::setThreadName( name )
+#else
+#define EE_PROFILE_ZONE( name )
+#define EE_PROFILE_ZONE_CATEGORY( name, category )
+#define EE_PROFILE_FUNCTION()
+#define EE_PROFILE_FRAME_MARK()
+#define EE_PROFILE_THREAD_NAME( name )
+#endif
+
+#endif
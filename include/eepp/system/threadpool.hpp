@@ -33,6 +33,11 @@ class EE_API ThreadPool : NonCopyable {
 		const std::function<void( const Uint64& )>& doneCallback = []( const Uint64& ) {},
 		const Uint64& tag = 0 );
 
+	/** Runs fn( index ) for every index in [0, count) distributing the work across the pool
+	 * threads. The calling thread also consumes work and the call blocks until every index has
+	 * been processed, so it can be called even when the pool is busy with other tasks. */
+	void parallelFor( const size_t& count, const std::function<void( size_t )>& fn );
+
 	Uint32 numThreads() const;
 
 	bool terminateOnClose() const;
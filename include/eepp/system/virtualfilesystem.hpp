@@ -2,6 +2,7 @@
 #define EE_VIRTUALFILESYSTEM_HPP
 
 #include <cstddef>
+#include <eepp/core/containers.hpp>
 #include <eepp/system/container.hpp>
 #include <eepp/system/iostream.hpp>
 #include <eepp/system/pack.hpp>
@@ -53,6 +54,8 @@ class EE_API VirtualFileSystem : protected Container<Pack> {
 	void removePackFromDirectory( Pack* resource, vfsDirectory& directory );
 
 	vfsDirectory mRoot;
+	/** Flat index of the files by their normalized path, used for the file lookups */
+	UnorderedMap<std::string, Pack*> mFiles;
 };
 
 class EE_API VFS {
@@ -43,6 +43,7 @@
 #include <eepp/ui/doc/syntaxtokenizer.hpp>
 #include <eepp/ui/doc/textdocument.hpp>
 #include <eepp/ui/doc/textdocumentline.hpp>
+#include <eepp/ui/doc/textdocumentlinedata.hpp>
 #include <eepp/ui/doc/textformat.hpp>
 #include <eepp/ui/doc/textposition.hpp>
 #include <eepp/ui/doc/textrange.hpp>
@@ -54,6 +55,7 @@
 #include <eepp/ui/models/filesystemmodel.hpp>
 #include <eepp/ui/models/itemlistmodel.hpp>
 #include <eepp/ui/models/model.hpp>
+#include <eepp/ui/models/modeldatarange.hpp>
 #include <eepp/ui/models/modeleditingdelegate.hpp>
 #include <eepp/ui/models/modelindex.hpp>
 #include <eepp/ui/models/modelrole.hpp>
@@ -109,6 +111,7 @@
 #include <eepp/ui/uilayout.hpp>
 #include <eepp/ui/uilayouter.hpp>
 #include <eepp/ui/uilayoutermanager.hpp>
+#include <eepp/ui/uilayouttemplate.hpp>
 #include <eepp/ui/uilinearlayout.hpp>
 #include <eepp/ui/uilistbox.hpp>
 #include <eepp/ui/uilistboxitem.hpp>
@@ -153,6 +156,7 @@
 #include <eepp/ui/uistate.hpp>
 #include <eepp/ui/uistyle.hpp>
 #include <eepp/ui/uisvg.hpp>
+#include <eepp/ui/uisvgiconatlas.hpp>
 #include <eepp/ui/uitab.hpp>
 #include <eepp/ui/uitablecell.hpp>
 #include <eepp/ui/uitableheadercolumn.hpp>
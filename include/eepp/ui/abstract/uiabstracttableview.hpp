@@ -3,6 +3,7 @@
 
 #include <eepp/math/rect.hpp>
 #include <eepp/ui/abstract/uiabstractview.hpp>
+#include <eepp/ui/models/modeldatarange.hpp>
 #include <eepp/ui/uitablecell.hpp>
 #include <eepp/ui/uitableheadercolumn.hpp>
 #include <eepp/ui/uitablerow.hpp>
@@ -169,6 +170,11 @@ class EE_API UIAbstractTableView : public UIAbstractView {
 	mutable std::vector<UITableRow*> mRows;
 	mutable std::vector<ColumnData> mColumn;
 	mutable std::vector<UnorderedMap<int, UIWidget*>> mWidgets;
+	/** Cell widgets released from their slot, per row and cell type */
+	mutable std::vector<UnorderedMap<Uint32, std::vector<UIWidget*>>> mCellPool;
+	UnorderedMap<UIWidget*, Uint32> mCellTypes;
+	/** The display data of the visible cells, prefetched while drawing */
+	ModelDataRange mDisplayData;
 	UILinearLayout* mHeader{ nullptr };
 	UILinearLayout* mRowHeader{ nullptr };
 	Float mDragBorderDistance{ 8 };
@@ -223,6 +229,16 @@ class EE_API UIAbstractTableView : public UIAbstractView {
 
 	virtual UIWidget* createCell( UIWidget* rowWidget, const ModelIndex& index );
 
+	/** @return The type of the cell widget that createCell creates for the index. Cell widgets are
+	 * only reused for cells of the same type. By default every column has its own type. */
+	virtual Uint32 getCellType( const ModelIndex& index ) const;
+
+	/** @return The cell widget of the slot. The current widget of the slot is kept if it has the
+	 * type of the index cell, otherwise it's released to the row pool and replaced by a pooled
+	 * widget of the right type, or by a new one. */
+	UIWidget* acquireCell( const Vector2<Int64>& posIndex, const ModelIndex& index,
+						   const Float& yOffset );
+
 	virtual UIWidget* setupCell( UITableCell* widget, UIWidget* rowWidget,
 								 const ModelIndex& index );
 
@@ -249,6 +265,16 @@ class EE_API UIAbstractTableView : public UIAbstractView {
 	void buildRowHeader();
 
 	void updateRowHeader( int realRowIndex, const ModelIndex& index, Float yOffset );
+
+	/** Fetches the display data of a block of cells with a single Model::dataRange call, the cells
+	 * updated until releaseDisplayData is called read their text from it. */
+	void prefetchDisplayData( const ModelIndex& parent, Int64 firstRow, Int64 rowCount,
+							  Int64 firstColumn, Int64 columnCount );
+
+	void releaseDisplayData();
+
+	/** @return The display data of the cell, from the prefetched data when available. */
+	const Variant& getDisplayData( const ModelIndex& index, Variant& storage ) const;
 };
 
 }}} // namespace EE::UI::Abstract
@@ -1,8 +1,10 @@
 #ifndef EE_UI_DOCUMENTVIEW_HPP
 #define EE_UI_DOCUMENTVIEW_HPP
 
+#include <eepp/core/fenwicktree.hpp>
 #include <eepp/graphics/fontstyleconfig.hpp>
 #include <eepp/graphics/linewrap.hpp>
+#include <eepp/system/time.hpp>
 #include <eepp/ui/doc/textdocument.hpp>
 #include <eepp/ui/doc/textposition.hpp>
 #include <optional>
@@ -59,6 +61,9 @@ class EE_API DocumentView {
 
 	const Config& config() const { return mConfig; }
 
+	/** Resets the line breaks of the document. The line breaks are computed lazily: every line
+	 * gets an estimated number of visual lines until it's measured, either on demand when it's
+	 * accessed, by measureVisibleRegion or by measurePendingLines. */
 	void invalidateCache();
 
 	void updateCache( Int64 fromLine, Int64 toLine, Int64 numLines );
@@ -94,6 +99,19 @@ class EE_API DocumentView {
 
 	bool isPendingReconstruction() const;
 
+	/** Computes the line breaks of the lines needed to fill visibleCount visual lines starting
+	 * from fromVisibleIndex, so the region can be drawn with exact line breaks.
+	 * @return True if the number of visual lines changed */
+	bool measureVisibleRegion( VisibleIndex fromVisibleIndex, Int64 visibleCount );
+
+	/** Computes the line breaks of the lines still using an estimation, until the time budget is
+	 * consumed or every line has been measured.
+	 * @return True if the number of visual lines changed */
+	bool measurePendingLines( const Time& budget );
+
+	/** @return True if there are lines with an estimated number of visual lines */
+	bool hasPendingLines() const { return mPendingLines > 0; }
+
 	void setPendingReconstruction( bool pendingReconstruction );
 
 	void clear();
@@ -139,19 +157,34 @@ class EE_API DocumentView {
 
 	bool usesTabStops() const { return mConfig.tabStops; }
 
-	const std::vector<Int64> getDocLineToVisibleIndex() const { return mDocLineToVisibleIndex; }
+	/** Measures every pending line, meant for debugging and tests. */
+	const std::vector<Int64> getDocLineToVisibleIndex() const;
 
-	const std::vector<Float> getVisibleLinesOffset() const { return mVisibleLinesOffset; }
+	/** Measures every pending line, meant for debugging and tests. */
+	const std::vector<Float> getVisibleLinesOffset() const;
 
   protected:
+	struct LineBreaks {
+		// Columns where the line wraps, the first visual line always starts at column 0 and it's
+		// not stored
+		std::vector<Int64> wraps;
+		Float paddingStart{ 0 };
+		// Number of visual lines of the line in the tree, 0 when hidden
+		Int64 visualLines{ 1 };
+		bool measured{ false };
+		bool hidden{ false };
+	};
+
 	std::shared_ptr<TextDocument> mDoc;
 	FontStyleConfig mFontStyle;
 	Config mConfig;
 	Float mMaxWidth{ 0 };
 	Float mWhiteSpaceWidth{ 0 };
-	std::vector<TextPosition> mVisibleLines;
-	std::vector<Float> mVisibleLinesOffset;
-	std::vector<Int64> mDocLineToVisibleIndex;
+	Float mEstimatedCharWidth{ 0 };
+	mutable std::vector<LineBreaks> mLines;
+	mutable FenwickTree<Int64> mVisualLines;
+	mutable Int64 mPendingLines{ 0 };
+	mutable Int64 mPendingLinesCursor{ 0 };
 	std::vector<TextRange> mFoldedRegions;
 	bool mPendingReconstruction{ false };
 	bool mUnderConstruction{ false };
@@ -159,8 +192,7 @@ class EE_API DocumentView {
 	std::function<void()> mOnVisibleLineCountChange;
 	std::function<void( Int64 docIdx, bool unfolded )> mOnFoldUnfoldCb;
 
-	void changeVisibility( Int64 fromDocIdx, Int64 toDocIdx, bool visible,
-						   bool recomputeOffset = true, bool recomputeLineToVisibleIndex = true );
+	void changeVisibility( Int64 fromDocIdx, Int64 toDocIdx, bool visible );
 
 	void removeFoldedRegion( const TextRange& region );
 
@@ -168,10 +200,21 @@ class EE_API DocumentView {
 
 	void verifyStructuralConsistency();
 
-	void recomputeDocLineToVisibleIndex( Int64 fromVisibleIndex, bool ensureDocSize = true );
+	void unfoldRegion( Int64 foldDocIdx, bool verifyConsistency );
+
+	Int64 estimateVisualLines( Int64 docIdx ) const;
+
+	/** Resets the line to its estimated state, it will be measured again when needed. */
+	void resetLine( Int64 docIdx, bool hidden );
+
+	/** Computes the line breaks of the line if they are still estimated. */
+	const LineBreaks& measureLine( Int64 docIdx ) const;
+
+	void setLineVisualLines( Int64 docIdx, Int64 visualLines ) const;
+
+	void measureAllLines() const;
 
-	void unfoldRegion( Int64 foldDocIdx, bool verifyConsistency, bool recomputeOffset = true,
-					   bool recomputeLineToVisibleIndex = true );
+	Int64 lineStartVisibleIndex( Int64 docIdx ) const;
 
 	void moveCursorToVisibleArea();
 
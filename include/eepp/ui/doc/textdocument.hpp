@@ -17,6 +17,7 @@
 #include <eepp/ui/doc/hextlanguagetype.hpp>
 #include <eepp/ui/doc/syntaxdefinition.hpp>
 #include <eepp/ui/doc/textdocumentline.hpp>
+#include <eepp/ui/doc/textdocumentlinedata.hpp>
 #include <eepp/ui/doc/textformat.hpp>
 #include <eepp/ui/doc/textposition.hpp>
 #include <eepp/ui/doc/textrange.hpp>
@@ -329,6 +330,12 @@ class EE_API TextDocument {
 
 	void unregisterClient( Client* client );
 
+	/** Registers a per-line side table. The document keeps its entries aligned with the document
+	 * lines until it's unregistered. The table is accessed under the lines mutex. */
+	void registerLineData( TextDocumentLineDataBase* lineData );
+
+	void unregisterLineData( TextDocumentLineDataBase* lineData );
+
 	std::size_t clientOfTypeCount( Client::Type type );
 
 	void moveToPreviousChar();
@@ -456,9 +463,27 @@ class EE_API TextDocument {
 						   FindReplaceType type = FindReplaceType::Normal,
 						   TextRange restrictRange = TextRange(), size_t maxResults = 0 );
 
+	/** Same as findAll but the line range is split in chunks searched in the thread pool, the
+	 * calling thread also searches and the call blocks until every chunk has been searched.
+	 * onResults is called with the results of each chunk as soon as the chunk is done, from any
+	 * thread and in any chunk order ( calls are never concurrent ). The search can be cancelled
+	 * with stopActiveFindAll. Searches spanning several lines, small documents or a null pool
+	 * fall back to the sequential search. The document must not be modified during the search. */
+	SearchResults findAllParallel( const std::shared_ptr<ThreadPool>& pool, const String& text,
+								   bool caseSensitive = true, bool wholeWord = false,
+								   FindReplaceType type = FindReplaceType::Normal,
+								   TextRange restrictRange = TextRange(),
+								   const std::function<void( const SearchResults& )>& onResults =
+									   nullptr );
+
+	/** Replaces all the occurrences. The occurrences are found first ( in parallel if a pool is
+	 * provided ) and then replaced in a single edit of the affected lines, that is undone and
+	 * redone as a single step.
+	 * @return The number of replacements */
 	int replaceAll( const String& text, const String& replace, const bool& caseSensitive = true,
 					const bool& wholeWord = false, FindReplaceType type = FindReplaceType::Normal,
-					TextRange restrictRange = TextRange() );
+					TextRange restrictRange = TextRange(),
+					const std::shared_ptr<ThreadPool>& pool = nullptr );
 
 	TextPosition replaceSelection( const String& replace );
 
@@ -572,6 +597,15 @@ class EE_API TextDocument {
 
 	bool isLoading() const;
 
+	/** Interrupts the document being loaded. The load returns LoadStatus::Interrupted, the
+	 * document is reset and it's not bound to the file. The document is flagged as loading until
+	 * the loader finishes. */
+	void stopLoading();
+
+	/** While loading, the lines are published in batches from the loading thread. Lock this mutex
+	 * to keep the lines still while reading the loaded lines from other thread. */
+	Mutex& getLinesMutex() const;
+
 	bool isDeleteOnClose() const;
 
 	void setDeleteOnClose( bool deleteOnClose );
@@ -710,6 +744,15 @@ class EE_API TextDocument {
 
 	void unserializeUndoRedo( const std::string& jsonString );
 
+	/** Serializes the undo / redo history in the compact binary format of TextUndoStack. */
+	std::string serializeUndoRedoBinary( bool inverted );
+
+	bool unserializeUndoRedoBinary( const std::string& data );
+
+	TextUndoStack& getUndoStack();
+
+	const TextUndoStack& getUndoStack() const;
+
 	void changeFilePath( const std::string& filePath );
 
 	void setDirtyUntilSave();
@@ -764,12 +807,14 @@ class EE_API TextDocument {
 	std::vector<TextDocumentLine> mLines;
 	TextRanges mSelection;
 	UnorderedSet<Client*> mClients;
+	std::vector<TextDocumentLineDataBase*> mLineData;
 	Mutex mClientsMutex;
 	mutable Mutex mLinesMutex;
 	mutable std::shared_ptr<Mutex> mDocumentMutex;
 	TextFormat::Encoding mEncoding{ TextFormat::Encoding::UTF8 };
 	TextFormat::LineEnding mLineEnding{ TextFormat::LineEnding::LF };
 	std::atomic<bool> mLoading{ false };
+	std::atomic<bool> mStopLoading{ false };
 	std::atomic<bool> mRunningTransaction{ false };
 	std::atomic<bool> mLoadingAsync{ false };
 	bool mIsBOM{ false };
@@ -832,6 +877,12 @@ class EE_API TextDocument {
 
 	void notifyLineChanged( const Int64& lineIndex );
 
+	void insertLineData( Int64 line, Int64 count );
+
+	void removeLineData( Int64 line, Int64 count );
+
+	void resetLineData();
+
 	void notifyUndoRedo( const UndoRedo& eventType );
 
 	void notifyDirtyOnFileSystem();
@@ -878,6 +929,17 @@ class EE_API TextDocument {
 							   FindReplaceType type = FindReplaceType::Normal,
 							   TextRange restrictRange = TextRange() );
 
+	void findAllInRange( SearchResults& all, const String& text, bool caseSensitive,
+						 bool wholeWord, FindReplaceType type, TextRange restrictRange,
+						 size_t maxResults, bool* stopFlag );
+
+	bool* addStopFlag();
+
+	void removeStopFlag( bool* stopFlag );
+
+	void replaceLines( Int64 fromLine, Int64 toLine, const String& oldText,
+					   const String& newText );
+
 	void changeFilePath( const std::string& filePath, bool notify );
 
 	TextPosition findPreviousEmptyLines( size_t selIdx );
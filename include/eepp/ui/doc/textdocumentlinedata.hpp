@@ -0,0 +1,184 @@
+#ifndef EE_UI_DOC_TEXTDOCUMENTLINEDATA_HPP
+#define EE_UI_DOC_TEXTDOCUMENTLINEDATA_HPP
+
+#include <eepp/config.hpp>
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+namespace EE { namespace UI { namespace Doc {
+
+/** @brief Base class of the per-line side tables attached to a TextDocument.
+ * The document keeps the registered tables aligned with its lines: inserting or removing lines
+ * inserts or removes the table entries, and modifying a line resets its entry.
+ * @see TextDocument::registerLineData */
+class EE_API TextDocumentLineDataBase {
+  public:
+	virtual ~TextDocumentLineDataBase() {}
+
+	/** Inserts count empty entries starting at line. */
+	virtual void insertLines( Int64 line, Int64 count ) = 0;
+
+	/** Removes count entries starting at line. */
+	virtual void removeLines( Int64 line, Int64 count ) = 0;
+
+	/** Resets the entry of the line. */
+	virtual void resetLine( Int64 line ) = 0;
+
+	/** Resets the table to linesCount empty entries. */
+	virtual void reset( Int64 linesCount ) = 0;
+};
+
+/** @brief Dense per-line storage of optional values, indexed by document line.
+ * The entries are stored in chunks of contiguous lines, so inserting or removing lines only moves
+ * the entries of one chunk plus the chunk offsets. Sequential access ( as when drawing ) resolves
+ * the chunk in O(1), random access in O(log chunks).
+ */
+template <typename T> class TextDocumentLineData : public TextDocumentLineDataBase {
+  public:
+	static constexpr size_t CHUNK_SIZE = 1024;
+
+	TextDocumentLineData() { reset( 0 ); }
+
+	/** @return The number of entries, it's the number of lines of the document. */
+	Int64 size() const { return mSize; }
+
+	/** @return The value of the line or nullptr if the line has no value. */
+	T* get( Int64 line ) {
+		if ( line < 0 || line >= mSize )
+			return nullptr;
+		auto& entry = at( line );
+		return entry ? &*entry : nullptr;
+	}
+
+	const T* get( Int64 line ) const {
+		if ( line < 0 || line >= mSize )
+			return nullptr;
+		size_t idx = chunkIndex( line );
+		const auto& entry = mChunks[idx][line - mChunkStart[idx]];
+		return entry ? &*entry : nullptr;
+	}
+
+	/** Sets the value of the line.
+	 * @return The stored value or nullptr if the line doesn't exist. */
+	T* set( Int64 line, T&& value ) {
+		if ( line < 0 || line >= mSize )
+			return nullptr;
+		auto& entry = at( line );
+		entry = std::move( value );
+		return &*entry;
+	}
+
+	T* set( Int64 line, const T& value ) { return set( line, T( value ) ); }
+
+	void insertLines( Int64 line, Int64 count ) override {
+		if ( count <= 0 )
+			return;
+		line = std::clamp<Int64>( line, 0, mSize );
+		size_t idx = line == mSize ? mChunks.size() - 1 : chunkIndex( line );
+		auto& entries = mChunks[idx];
+		entries.insert( entries.begin() + ( line - mChunkStart[idx] ), count, std::nullopt );
+		mSize += count;
+		for ( size_t i = idx + 1; i < mChunks.size(); i++ )
+			mChunkStart[i] += count;
+		if ( entries.size() > CHUNK_SIZE * 2 )
+			split( idx );
+	}
+
+	void removeLines( Int64 line, Int64 count ) override {
+		if ( line < 0 || line >= mSize || count <= 0 )
+			return;
+		count = std::min( count, mSize - line );
+		size_t first = chunkIndex( line );
+		size_t idx = first;
+		Int64 offset = line - mChunkStart[idx];
+		Int64 pending = count;
+		while ( pending > 0 ) {
+			auto& entries = mChunks[idx];
+			Int64 erase = std::min<Int64>( pending, entries.size() - offset );
+			entries.erase( entries.begin() + offset, entries.begin() + offset + erase );
+			pending -= erase;
+			offset = 0;
+			if ( entries.empty() && mChunks.size() > 1 ) {
+				mChunks.erase( mChunks.begin() + idx );
+				mChunkStart.erase( mChunkStart.begin() + idx );
+			} else {
+				idx++;
+			}
+		}
+		mSize -= count;
+		for ( size_t i = first; i < mChunks.size(); i++ )
+			mChunkStart[i] = i == 0 ? 0 : mChunkStart[i - 1] + mChunks[i - 1].size();
+		mLastChunk = 0;
+	}
+
+	void resetLine( Int64 line ) override {
+		if ( line >= 0 && line < mSize )
+			at( line ).reset();
+	}
+
+	void reset( Int64 linesCount ) override {
+		mChunks.clear();
+		mChunkStart.clear();
+		mSize = std::max<Int64>( 0, linesCount );
+		Int64 start = 0;
+		do {
+			Int64 count = std::min<Int64>( CHUNK_SIZE, mSize - start );
+			mChunks.emplace_back( count );
+			mChunkStart.push_back( start );
+			start += count;
+		} while ( start < mSize );
+		mLastChunk = 0;
+	}
+
+	/** Resets all the entries keeping the number of lines. */
+	void clear() { reset( mSize ); }
+
+  protected:
+	using Chunk = std::vector<std::optional<T>>;
+
+	std::vector<Chunk> mChunks;
+	std::vector<Int64> mChunkStart;
+	Int64 mSize{ 0 };
+	mutable size_t mLastChunk{ 0 };
+
+	size_t chunkIndex( Int64 line ) const {
+		// Lines are usually accessed sequentially, try the last chunk used and the next one
+		for ( size_t idx = mLastChunk; idx < mChunks.size() && idx <= mLastChunk + 1; idx++ ) {
+			if ( line >= mChunkStart[idx] &&
+				 line < mChunkStart[idx] + static_cast<Int64>( mChunks[idx].size() ) )
+				return mLastChunk = idx;
+		}
+		auto it = std::upper_bound( mChunkStart.begin(), mChunkStart.end(), line );
+		return mLastChunk = std::distance( mChunkStart.begin(), it ) - 1;
+	}
+
+	std::optional<T>& at( Int64 line ) {
+		size_t idx = chunkIndex( line );
+		return mChunks[idx][line - mChunkStart[idx]];
+	}
+
+	void split( size_t idx ) {
+		Chunk entries( std::move( mChunks[idx] ) );
+		Int64 start = mChunkStart[idx];
+		std::vector<Chunk> chunks;
+		std::vector<Int64> starts;
+		for ( size_t pos = 0; pos < entries.size(); pos += CHUNK_SIZE ) {
+			size_t end = std::min( pos + CHUNK_SIZE, entries.size() );
+			chunks.emplace_back( std::make_move_iterator( entries.begin() + pos ),
+								 std::make_move_iterator( entries.begin() + end ) );
+			starts.push_back( start + pos );
+		}
+		mChunks.erase( mChunks.begin() + idx );
+		mChunkStart.erase( mChunkStart.begin() + idx );
+		mChunks.insert( mChunks.begin() + idx, std::make_move_iterator( chunks.begin() ),
+						std::make_move_iterator( chunks.end() ) );
+		mChunkStart.insert( mChunkStart.begin() + idx, starts.begin(), starts.end() );
+		mLastChunk = idx;
+	}
+};
+
+}}} // namespace EE::UI::Doc
+
+#endif // EE_UI_DOC_TEXTDOCUMENTLINEDATA_HPP
@@ -30,14 +30,22 @@ class TextUndoCommand {
 
 	const TextUndoCommandType& getType() const;
 
+	/** @return The time of the last edit recorded by the command */
 	const Time& getTimestamp() const;
 
+	/** @return The time of the first edit recorded by the command, it's only different from the
+	 * timestamp when consecutive edits were merged into the command */
+	const Time& getFirstTimestamp() const;
+
 	virtual nlohmann::json toJSON() const = 0;
 
   protected:
+	friend class TextUndoStack;
+
 	Uint64 mId;
 	TextUndoCommandType mType;
 	Time mTimestamp;
+	Time mFirstTimestamp;
 
 	nlohmann::json baseJSON() const;
 };
@@ -47,7 +55,12 @@ class TextUndoCommandInsert : public TextUndoCommand {
 	TextUndoCommandInsert( const Uint64& id, const size_t& cursorIdx, const String& text,
 						   const TextPosition& position, const Time& timestamp );
 
-	const String& getText() const;
+	TextUndoCommandInsert( const Uint64& id, const size_t& cursorIdx, std::string&& textUtf8,
+						   const TextPosition& position, const Time& timestamp );
+
+	String getText() const;
+
+	const std::string& getTextUtf8() const;
 
 	const TextPosition& getPosition() const;
 
@@ -58,7 +71,10 @@ class TextUndoCommandInsert : public TextUndoCommand {
 	static TextUndoCommandInsert fromJSON( nlohmann::json j, Uint64 id );
 
   protected:
-	String mText;
+	friend class TextUndoStack;
+
+	// Stored as UTF-8, a quarter of the size of the UTF-32 string for most of the texts
+	std::string mText;
 	TextPosition mPosition;
 	size_t mCursorIdx;
 };
@@ -77,6 +93,8 @@ class TextUndoCommandRemove : public TextUndoCommand {
 	static TextUndoCommandRemove fromJSON( nlohmann::json j, Uint64 id );
 
   protected:
+	friend class TextUndoStack;
+
 	TextRange mRange;
 	size_t mCursorIdx;
 };
@@ -106,7 +124,10 @@ using UndoStackContainer = std::deque<UndoCommandVariant>;
 
 class EE_API TextUndoStack {
   public:
-	TextUndoStack( TextDocument* owner, const Uint32& maxStackSize = 20000 );
+	static constexpr size_t DEFAULT_MAX_MEMORY = 64 * 1024 * 1024;
+
+	TextUndoStack( TextDocument* owner, const Uint32& maxStackSize = 20000,
+				   const size_t& maxMemory = DEFAULT_MAX_MEMORY );
 
 	~TextUndoStack();
 
@@ -130,12 +151,27 @@ class EE_API TextUndoStack {
 
 	void setMergeTimeout( const Time& mergeTimeout );
 
+	/** @return The approximate memory used by the undo and redo stacks, in bytes */
+	size_t getMemoryUsage() const;
+
+	const size_t& getMaxMemory() const;
+
+	/** Sets the approximate memory limit of each stack, in bytes. When a stack exceeds it, its
+	 * oldest undo steps are discarded. The last edit is always kept. */
+	void setMaxMemory( const size_t& maxMemory );
+
 	Uint64 getCurrentChangeId() const;
 
 	std::string toJSON( bool inverted );
 
 	void fromJSON( const std::string& json );
 
+	/** Same as toJSON but in a compact binary format, much faster to write and read. */
+	std::string toBinary( bool inverted );
+
+	/** @return False if the data is not a valid binary undo stack */
+	bool fromBinary( const std::string& data );
+
   protected:
 	friend class TextDocument;
 
@@ -145,6 +181,17 @@ class EE_API TextUndoStack {
 	UndoStackContainer mUndoStack;
 	UndoStackContainer mRedoStack;
 	Time mMergeTimeout;
+	size_t mMaxMemory;
+	size_t mUndoMemory{ 0 };
+	size_t mRedoMemory{ 0 };
+
+	size_t& memoryUsage( const UndoStackContainer& stack );
+
+	bool mergeInsert( UndoStackContainer& undoStack, const String& string,
+					  const size_t& cursorIdx, const TextPosition& position, const Time& time );
+
+	bool mergeRemove( UndoStackContainer& undoStack, const size_t& cursorIdx,
+					  const TextRange& range, const Time& time );
 
 	void pushUndo( UndoStackContainer& undoStack, UndoCommandVariant&& cmd );
 
@@ -35,6 +35,14 @@ template <typename T> class ItemListModel final : public Model {
 		return {};
 	}
 
+	virtual void dataRange( ModelDataRange& range ) const {
+		if ( range.role() != ModelRole::Display || !range.containsColumn( 0 ) )
+			return;
+		Int64 lastRow = eemin<Int64>( range.firstRow() + range.rowCount(), mData.size() );
+		for ( Int64 row = eemax<Int64>( 0, range.firstRow() ); row < lastRow; row++ )
+			range.set( row, 0, mData[row] );
+	}
+
   private:
 	const std::vector<T>& mData;
 };
@@ -82,6 +90,18 @@ template <typename K, typename V> class ItemPairListModel final : public Model {
 		return {};
 	}
 
+	virtual void dataRange( ModelDataRange& range ) const {
+		if ( range.role() != ModelRole::Display )
+			return;
+		Int64 lastRow = eemin<Int64>( range.firstRow() + range.rowCount(), mData.size() );
+		for ( Int64 row = eemax<Int64>( 0, range.firstRow() ); row < lastRow; row++ ) {
+			if ( range.containsColumn( 0 ) )
+				range.set( row, 0, mData[row].first );
+			if ( range.containsColumn( 1 ) )
+				range.set( row, 1, mData[row].second );
+		}
+	}
+
 	virtual bool isEditable( const ModelIndex& ) const { return mIsEditable; }
 
 	void setIsEditable( bool isEditable ) { mIsEditable = isEditable; }
@@ -133,6 +153,14 @@ template <typename T> class ItemListOwnerModel final : public Model {
 		return {};
 	}
 
+	virtual void dataRange( ModelDataRange& range ) const {
+		if ( range.role() != ModelRole::Display || !range.containsColumn( 0 ) )
+			return;
+		Int64 lastRow = eemin<Int64>( range.firstRow() + range.rowCount(), mData.size() );
+		for ( Int64 row = eemax<Int64>( 0, range.firstRow() ); row < lastRow; row++ )
+			range.set( row, 0, mData[row] );
+	}
+
 	virtual bool isEditable( const ModelIndex& ) const { return mIsEditable; }
 
 	void setIsEditable( bool isEditable ) { mIsEditable = isEditable; }
@@ -199,6 +227,18 @@ template <typename K, typename V> class ItemPairListOwnerModel final : public Mo
 		return {};
 	}
 
+	virtual void dataRange( ModelDataRange& range ) const {
+		if ( range.role() != ModelRole::Display )
+			return;
+		Int64 lastRow = eemin<Int64>( range.firstRow() + range.rowCount(), mData.size() );
+		for ( Int64 row = eemax<Int64>( 0, range.firstRow() ); row < lastRow; row++ ) {
+			if ( range.containsColumn( 0 ) )
+				range.set( row, 0, mData[row].first );
+			if ( range.containsColumn( 1 ) )
+				range.set( row, 1, mData[row].second );
+		}
+	}
+
 	virtual bool isEditable( const ModelIndex& ) const { return mIsEditable; }
 
 	void setIsEditable( bool isEditable ) { mIsEditable = isEditable; }
@@ -268,6 +308,19 @@ template <typename V> class ItemVectorListOwnerModel final : public Model {
 		return {};
 	}
 
+	virtual void dataRange( ModelDataRange& range ) const {
+		if ( range.role() != ModelRole::Display )
+			return;
+		Int64 lastRow = eemin<Int64>( range.firstRow() + range.rowCount(), mData.size() );
+		for ( Int64 row = eemax<Int64>( 0, range.firstRow() ); row < lastRow; row++ ) {
+			const auto& rowData = mData[row];
+			Int64 lastCol =
+				eemin<Int64>( range.firstColumn() + range.columnCount(), rowData.size() );
+			for ( Int64 col = eemax<Int64>( 0, range.firstColumn() ); col < lastCol; col++ )
+				range.set( row, col, rowData[col] );
+		}
+	}
+
 	virtual bool isEditable( const ModelIndex& ) const { return mIsEditable; }
 
 	void setIsEditable( bool isEditable ) { mIsEditable = isEditable; }
@@ -3,6 +3,7 @@
 
 #include <eepp/system/lock.hpp>
 #include <eepp/system/mutex.hpp>
+#include <eepp/ui/models/modeldatarange.hpp>
 #include <eepp/ui/models/modelindex.hpp>
 #include <eepp/ui/models/modelrole.hpp>
 #include <eepp/ui/models/variant.hpp>
@@ -78,6 +79,11 @@ class EE_API Model {
 
 	virtual Variant data( const ModelIndex&, ModelRole = ModelRole::Display ) const = 0;
 
+	/** Fills the block of cells of the range ( previously set with ModelDataRange::reset ) with
+	 * the data of its role. The default implementation calls data() for every cell, models that
+	 * can provide their data without creating a Variant per cell should override it. */
+	virtual void dataRange( ModelDataRange& range ) const;
+
 	virtual void update() { onModelUpdate(); }
 
 	virtual ModelIndex parentIndex( const ModelIndex& ) const { return {}; }
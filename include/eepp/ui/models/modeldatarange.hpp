@@ -0,0 +1,94 @@
+#ifndef EE_UI_MODELS_MODELDATARANGE_HPP
+#define EE_UI_MODELS_MODELDATARANGE_HPP
+
+#include <eepp/ui/models/modelindex.hpp>
+#include <eepp/ui/models/modelrole.hpp>
+#include <eepp/ui/models/variant.hpp>
+#include <string_view>
+#include <vector>
+
+namespace EE { namespace UI { namespace Models {
+
+/** @brief The data of a block of cells of a model for a single role, filled by Model::dataRange.
+ * The range is meant to be reused: the string values are stored in string slots owned by the
+ * range that keep their capacity between resets, so once the range is warmed up filling it with
+ * strings doesn't allocate. The values are valid until the range is reset.
+ */
+class EE_API ModelDataRange {
+  public:
+	ModelDataRange() {}
+
+	ModelDataRange( const ModelDataRange& ) = delete;
+
+	ModelDataRange& operator=( const ModelDataRange& ) = delete;
+
+	/** Clears the values and sets the new block of cells. */
+	void reset( const ModelIndex& parent, Int64 firstRow, Int64 rowCount, Int64 firstColumn,
+				Int64 columnCount, ModelRole role = ModelRole::Display );
+
+	/** Clears the values keeping the capacity, the range becomes empty. */
+	void clear();
+
+	bool empty() const { return mData.empty(); }
+
+	/** @return True if the index belongs to the block of cells of the range. */
+	bool contains( const ModelIndex& index ) const;
+
+	bool containsColumn( Int64 column ) const {
+		return column >= mFirstColumn && column < mFirstColumn + mColumnCount;
+	}
+
+	/** @return The value of the cell, the cell must be contained in the range. */
+	const Variant& get( const ModelIndex& index ) const {
+		return at( index.row(), index.column() );
+	}
+
+	/** @return The value of the cell, the cell must be contained in the range. */
+	const Variant& at( Int64 row, Int64 column ) const { return mData[offset( row, column )]; }
+
+	void set( Int64 row, Int64 column, Variant&& value );
+
+	/** Stores a copy of the UTF-8 string converted to a String in the cell string slot. */
+	void set( Int64 row, Int64 column, std::string_view value );
+
+	void set( Int64 row, Int64 column, const std::string& value ) {
+		set( row, column, std::string_view{ value } );
+	}
+
+	/** Stores a copy of the string in the cell string slot. */
+	void set( Int64 row, Int64 column, const String& value );
+
+	template <typename T> void set( Int64 row, Int64 column, const T& value ) {
+		set( row, column, Variant( value ) );
+	}
+
+	const ModelIndex& parent() const { return mParent; }
+
+	const Int64& firstRow() const { return mFirstRow; }
+
+	const Int64& rowCount() const { return mRowCount; }
+
+	const Int64& firstColumn() const { return mFirstColumn; }
+
+	const Int64& columnCount() const { return mColumnCount; }
+
+	const ModelRole& role() const { return mRole; }
+
+  protected:
+	ModelIndex mParent;
+	Int64 mFirstRow{ 0 };
+	Int64 mRowCount{ 0 };
+	Int64 mFirstColumn{ 0 };
+	Int64 mColumnCount{ 0 };
+	ModelRole mRole{ ModelRole::Display };
+	std::vector<Variant> mData;
+	std::vector<String> mStrings;
+
+	size_t offset( Int64 row, Int64 column ) const {
+		return ( row - mFirstRow ) * mColumnCount + ( column - mFirstColumn );
+	}
+};
+
+}}} // namespace EE::UI::Models
+
+#endif // EE_UI_MODELS_MODELDATARANGE_HPP
@@ -50,6 +50,13 @@ class EE_API UIDiffView : public UIWidget, public WidgetCommandExecuter {
 		std::vector<TextRange> subLineChanges;
 	};
 
+	/** Computes the line diff of two texts. The common prefix and suffix are skipped, the lines
+	 * are hashed into ids, the lines that are unique in both sides anchor the diff ( patience
+	 * diff ) and the gaps between the anchors are diffed with Myers. Gaps that are too costly for
+	 * Myers are reported as completely replaced. */
+	static std::vector<DiffLine> diffLines( const std::vector<std::string>& oldLines,
+											const std::vector<std::string>& newLines );
+
 	const std::vector<DiffLine>& getDiffLines() const { return mLines; }
 	const std::vector<size_t>& getViewLines() const { return mViewLines; }
 
@@ -110,6 +117,7 @@ class EE_API UIDiffView : public UIWidget, public WidgetCommandExecuter {
 	void syncScroll( UICodeEditor* source, UICodeEditor* target, bool emitEvent = false );
 	void updateModeButton();
 	void computeSubLineDiff( DiffLine& oldLine, DiffLine& newLine );
+	void computeSubLineDiffs();
 	void updateEditorsText();
 	void updateButtonsText();
 };
@@ -69,6 +69,13 @@ class EE_API UIApplication {
 
 	bool showMemoryManagerResult() const;
 
+	//! When enabled (the default) the main loop sleeps while idle until the next deadline of the
+	//! scene (pending timers, animations, caret blink, etc) or the next event, instead of polling
+	//! at a fixed rate. Background threads wake it up when they post work to the main thread.
+	void setIdleUntilDeadline( bool idleUntilDeadline );
+
+	bool isIdleUntilDeadline() const;
+
 	String::HashType getStyleSheetDefaultMarker() const { return mStyleSheetMarker; }
   protected:
 	UISceneNode* mUISceneNode{ nullptr };
@@ -76,6 +83,7 @@ class EE_API UIApplication {
 	String::HashType mStyleSheetMarker{ 0 };
 	bool mDidRun{ false };
 	bool mShowMemoryManagerResult{ false };
+	bool mIdleUntilDeadline{ true };
 };
 
 }} // namespace EE::UI
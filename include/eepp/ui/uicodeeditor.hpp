@@ -60,6 +60,12 @@ class UICodeEditorPlugin {
 	virtual bool onKeyUp( UICodeEditor*, const KeyEvent& ) { return false; }
 	virtual bool onTextInput( UICodeEditor*, const TextInputEvent& ) { return false; }
 	virtual void update( UICodeEditor* ) {}
+	/** @return The maximum time the plugin can wait for its next update call. Plugins doing
+	 * timed work in update must report it, otherwise the editor could sleep until the next event.
+	 */
+	virtual Time getUpdateTimeout( UICodeEditor*, const Time& /*pollTimeout*/ ) {
+		return Time::Infinity;
+	}
 	virtual void preDraw( UICodeEditor*, const Vector2f& /*startScroll*/,
 						  const Float& /*lineHeight*/, const TextPosition& /*cursor*/ ) {}
 	virtual void postDraw( UICodeEditor*, const Vector2f& /*startScroll*/,
@@ -210,6 +216,8 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 
 	virtual void scheduledUpdate( const Time& time );
 
+	virtual Time getScheduledUpdateTimeout( const Time& pollTimeout );
+
 	void reset();
 
 	TextDocument::LoadStatus loadFromFile( const std::string& path );
@@ -588,6 +596,12 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 
 	void setDisplayLoaderIfDocumentLoading( bool newDisplayLoaderIfDocumentLoading );
 
+	bool getDisplayDocumentWhileLoading() const;
+
+	/** Displays the lines already loaded while the document is being loaded in background. The
+	 * editor is read only until the document finishes loading. */
+	void setDisplayDocumentWhileLoading( bool displayDocumentWhileLoading );
+
 	size_t getMenuIconSize() const;
 
 	void setMenuIconSize( size_t menuIconSize );
@@ -886,6 +900,7 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 	bool mInteractiveLinks{ true };
 	bool mHandShown{ false };
 	bool mDisplayLoaderIfDocumentLoading{ true };
+	bool mDisplayDocumentWhileLoading{ true };
 	bool mCreateDefaultContextMenuOptions{ true };
 	bool mMinimapEnabled{ false };
 	bool mMinimapDragging{ false };
@@ -951,6 +966,7 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 	TextRange mMatchingBrackets;
 	Float mLongestLineWidth{ 0 };
 	size_t mLongestLineIndex{ 0 };
+	size_t mLoadingLinesCount{ 0 };
 	Time mFindLongestLineWidthUpdateFrequency;
 	Clock mLongestLineWidthLastUpdate;
 	Clock mLastActivity;
@@ -966,15 +982,14 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 	UIPopUpMenu* mCurrentMenu{ nullptr };
 	MinimapConfig mMinimapConfig;
 	Int64 mMinimapScrollOffset{ 0 };
-	std::unordered_map<Int64, std::pair<String::HashType, Float>> mLinesWidthCache;
+	TextDocumentLineData<Float> mLinesWidthCache;
 
 	struct ColorBoxData {
 		Int64 startColumn;
 		Int64 endColumn;
 		Color color;
 	};
-	std::unordered_map<Int64, std::pair<String::HashType, std::vector<ColorBoxData>>>
-		mColorBoxesCache;
+	TextDocumentLineData<std::vector<ColorBoxData>> mColorBoxesCache;
 
 	Tools::UIDocFindReplace* mFindReplace{ nullptr };
 	struct PluginRequestedSpace {
@@ -1167,6 +1182,8 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 
 	bool checkAutoCloseXMLTag( const String& text );
 
+	bool isDisplayingLoadingDocument() const;
+
 	bool gutterSpaceExists( UICodeEditorPlugin* plugin ) const;
 
 	Float getTotalTopSpace() const;
@@ -129,6 +129,8 @@ class EE_API UIFileDialog : public UIWindow {
 
 	virtual void scheduledUpdate( const Time& time );
 
+	virtual Time getScheduledUpdateTimeout( const Time& pollTimeout );
+
   protected:
 	std::string mCurPath;
 	std::string mFilePatterns;
@@ -12,14 +12,20 @@ using namespace EE::Graphics;
 
 namespace EE { namespace UI {
 
+class UISVGIconAtlas;
+
 class EE_API UIIcon {
   public:
+	enum class Type { Icon, Glyph, SVG };
+
 	static UIIcon* New( const std::string& name );
 
 	virtual ~UIIcon();
 
 	const std::string& getName() const;
 
+	virtual Type getType() const { return Type::Icon; }
+
 	virtual Drawable* getSize( const int& size ) const;
 
 	virtual void setSize( const int& size, Drawable* drawable );
@@ -37,6 +43,8 @@ class EE_API UIGlyphIcon : public UIIcon {
 
 	virtual ~UIGlyphIcon();
 
+	virtual Type getType() const { return Type::Glyph; }
+
 	virtual Drawable* getSize( const int& size ) const;
 
   protected:
@@ -53,12 +61,24 @@ class EE_API UISVGIcon : public UIIcon {
 
 	virtual ~UISVGIcon();
 
+	virtual Type getType() const { return Type::SVG; }
+
 	virtual Drawable* getSize( const int& size ) const;
 
+	const std::string& getSVGXml() const;
+
+	/** @return The atlas where the icon is rasterized, if any. */
+	UISVGIconAtlas* getAtlas() const;
+
+	/** Sets the atlas where the icon will be rasterized. Use UISVGIconAtlas::add to register an
+	 * icon into an atlas. */
+	void setAtlas( UISVGIconAtlas* atlas );
+
   protected:
 	UISVGIcon( const std::string& name, const std::string& svgXML );
 
 	std::string mSVGXml;
+	UISVGIconAtlas* mAtlas{ nullptr };
 	mutable UnorderedMap<int, Texture*> mSVGs;
 	mutable Sizei mOriSize;
 	mutable int mOriChannels{ 0 };
@@ -3,6 +3,7 @@
 
 #include <eepp/graphics/drawable.hpp>
 #include <eepp/ui/uiicon.hpp>
+#include <eepp/ui/uisvgiconatlas.hpp>
 #include <unordered_map>
 
 using namespace EE::Graphics;
@@ -23,9 +24,17 @@ class EE_API UIIconTheme {
 
 	UIIcon* getIcon( const std::string& name ) const;
 
+	/** Sets the atlas used to rasterize the SVG icons of the theme. The theme takes the ownership
+	 * of the atlas. Every SVG icon present and added later into the theme will be rasterized into
+	 * the atlas. */
+	UIIconTheme* setSVGIconAtlas( UISVGIconAtlas* atlas );
+
+	UISVGIconAtlas* getSVGIconAtlas() const;
+
   protected:
 	std::string mName;
 	std::unordered_map<std::string, UIIcon*> mIcons;
+	UISVGIconAtlas* mSVGIconAtlas{ nullptr };
 
 	UIIconTheme( const std::string& name );
 };
@@ -0,0 +1,46 @@
+#ifndef EE_UI_UILAYOUTTEMPLATE_HPP
+#define EE_UI_UILAYOUTTEMPLATE_HPP
+
+#include <eepp/core/containers.hpp>
+#include <eepp/core/noncopyable.hpp>
+#include <eepp/ui/css/stylesheetproperty.hpp>
+#include <memory>
+#include <vector>
+
+namespace pugi {
+class xml_document;
+class xml_node;
+} // namespace pugi
+
+namespace EE { namespace UI {
+
+/** @brief A layout parsed once to be instantiated many times.
+ * The XML is parsed a single time, the attributes of every element are converted to style sheet
+ * properties ( inline styles and shorthands already expanded ). Instantiating it with
+ * UISceneNode::loadLayoutFromTemplate skips the XML parsing and the attributes parsing. The
+ * template is immutable once compiled, it can be shared and used from any scene node.
+ */
+class EE_API UILayoutTemplate : NonCopyable {
+  public:
+	/** Compiles the parsed document, the template takes ownership of it. */
+	explicit UILayoutTemplate( std::unique_ptr<pugi::xml_document> document );
+
+	~UILayoutTemplate();
+
+	/** @return The first node of the layout */
+	pugi::xml_node getFirstNode() const;
+
+	/** @return The properties of the element attributes, or nullptr if the node doesn't belong to
+	 * the template */
+	const std::vector<CSS::StyleSheetProperty>* getAttributes( const pugi::xml_node& node ) const;
+
+  protected:
+	std::unique_ptr<pugi::xml_document> mDocument;
+	UnorderedMap<const void*, std::vector<CSS::StyleSheetProperty>> mAttributes;
+
+	void compile( const pugi::xml_node& firstNode );
+};
+
+}} // namespace EE::UI
+
+#endif
@@ -17,7 +17,23 @@ class EE_API UIMarkdownView : public UILinearLayout {
 
 	void loadFromString( std::string_view markdown );
 
+	/** Appends markdown to the current document. Only the last block that can still change
+	 * ( the last paragraph, list, code fence, etc ) is parsed and created again, the finished
+	 * blocks stay in place. Meant to display streamed documents. */
+	void appendMarkdown( std::string_view markdown );
+
+	const std::string& getMarkdown() const { return mMarkdown; }
+
 	virtual void loadFromXmlNode( const pugi::xml_node& node );
+
+  protected:
+	std::string mMarkdown;
+	size_t mOpenBlockStart{ 0 };
+	std::vector<Node*> mOpenBlockNodes;
+
+	std::vector<Node*> loadBlocks( std::string_view markdown );
+
+	void closeOpenBlockNodes();
 };
 
 }} // namespace EE::UI
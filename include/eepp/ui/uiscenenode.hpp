@@ -14,6 +14,7 @@ using namespace EE::Network;
 
 namespace EE { namespace Graphics {
 class Font;
+class Text;
 }} // namespace EE::Graphics
 
 namespace EE { namespace UI {
@@ -25,6 +26,7 @@ class UIEventDispatcher;
 class UIWidget;
 class UIWindow;
 class UIWidget;
+class UILayoutTemplate;
 class UILayout;
 class UIIcon;
 
@@ -117,6 +119,15 @@ class EE_API UISceneNode : public SceneNode {
 	 */
 	virtual void update( const Time& elapsed );
 
+	/**
+	 * @brief Returns how long the scene can wait for its next update.
+	 *
+	 * Also accounts for the pending dirty styles and layouts and the profiler overlay refresh.
+	 *
+	 * @param pollTimeout The regular polling interval of the main loop.
+	 */
+	virtual Time getNextUpdateTimeout( const Time& pollTimeout );
+
 	/**
 	 * @brief Sets the translator for internationalization.
 	 *
@@ -285,6 +296,41 @@ class EE_API UISceneNode : public SceneNode {
 	UIWidget* loadLayoutFromPack( Pack* pack, const std::string& FilePackPath,
 								  Node* parent = NULL );
 
+	/**
+	 * @brief Compiles a UI layout from a string.
+	 *
+	 * Parses the XML and the attributes of every element once, the template can be instantiated
+	 * many times with loadLayoutFromTemplate without parsing them again.
+	 *
+	 * @param layoutString The XML layout string.
+	 * @return The compiled template, or nullptr if parsing failed.
+	 */
+	static std::shared_ptr<UILayoutTemplate>
+	compileLayoutFromString( const std::string& layoutString );
+
+	/**
+	 * @brief Compiles a UI layout from a file.
+	 *
+	 * @param layoutPath Path to the layout file.
+	 * @return The compiled template, or nullptr if loading failed.
+	 */
+	static std::shared_ptr<UILayoutTemplate>
+	compileLayoutFromFile( const std::string& layoutPath );
+
+	/**
+	 * @brief Instantiates a compiled UI layout.
+	 *
+	 * Creates the UI hierarchy of the template, producing the same result than loading the
+	 * layout source.
+	 *
+	 * @param layoutTemplate The compiled layout.
+	 * @param parent Parent node for the layout (default: this).
+	 * @param marker Marker for style association.
+	 * @return The root widget, or NULL if the template is empty.
+	 */
+	UIWidget* loadLayoutFromTemplate( const UILayoutTemplate& layoutTemplate, Node* parent = NULL,
+									  const Uint32& marker = 0 );
+
 	/**
 	 * @brief Sets the stylesheet for this UISceneNode.
 	 *
@@ -355,6 +401,10 @@ class EE_API UISceneNode : public SceneNode {
 	 */
 	bool isLoading() const;
 
+	/** @return The template being instantiated, or nullptr if the layout being loaded ( if any )
+	 * is not a compiled one */
+	const UILayoutTemplate* getLoadingLayoutTemplate() const { return mLayoutTemplate; }
+
 	/**
 	 * @brief Gets the UIThemeManager.
 	 *
@@ -736,6 +786,23 @@ class EE_API UISceneNode : public SceneNode {
 
 	Font* getFontFromNamesList( std::string_view names ) const;
 
+	/**
+	 * @brief Shows an overlay with the profiler zones of the last frame.
+	 *
+	 * Enables the Profiler when shown. The engine stages are only displayed if the engine was
+	 * compiled with the profiler zones (EE_PROFILER_ENABLED).
+	 *
+	 * @param visible True to show the overlay.
+	 */
+	void setProfilerOverlayVisible( bool visible );
+
+	/**
+	 * @brief Checks if the profiler overlay is visible.
+	 *
+	 * @return True if the profiler overlay is being displayed.
+	 */
+	bool isProfilerOverlayVisible() const;
+
   protected:
 	friend class EE::UI::UIWindow;
 	friend class EE::UI::UIWidget;
@@ -747,6 +814,7 @@ class EE_API UISceneNode : public SceneNode {
 	std::vector<UIWindow*> mWindowsList;
 	CSS::StyleSheet mStyleSheet;
 	bool mIsLoading{ false };
+	const UILayoutTemplate* mLayoutTemplate{ nullptr };
 	bool mUpdatingLayouts{ false };
 	bool mStyleDuringLoad{ false };
 	UIThemeManager* mUIThemeManager{ nullptr };
@@ -758,6 +826,8 @@ class EE_API UISceneNode : public SceneNode {
 	UnorderedSet<UIWidget*> mDirtyStyleState;
 	UnorderedMap<UIWidget*, bool> mDirtyStyleStateCSSAnimations;
 	UnorderedSet<UILayout*> mDirtyLayouts;
+	Text* mProfilerOverlayText{ nullptr };
+	Clock mProfilerOverlayClock;
 	std::vector<std::pair<Float, std::string>> mTimes;
 	ColorSchemePreference mColorSchemePreference{ ColorSchemePreference::Dark };
 	Uint32 mMaxInvalidationDepth{ 2 };
@@ -794,6 +864,16 @@ class EE_API UISceneNode : public SceneNode {
 	 */
 	virtual void onDrawDebugDataChange();
 
+	/**
+	 * @brief Draws the overlays over the scene (the profiler overlay).
+	 */
+	virtual void postDraw();
+
+	/**
+	 * @brief Updates the profiler overlay text with the last frame statistics.
+	 */
+	void updateProfilerOverlay();
+
 	/**
 	 * @brief Requests focus for this scene node.
 	 *
@@ -0,0 +1,101 @@
+#ifndef EE_UI_UISVGICONATLAS_HPP
+#define EE_UI_UISVGICONATLAS_HPP
+
+#include <eepp/core/core.hpp>
+#include <eepp/graphics/texture.hpp>
+#include <eepp/graphics/textureregion.hpp>
+#include <eepp/system/threadpool.hpp>
+#include <memory>
+#include <vector>
+
+struct NSVGimage;
+
+using namespace EE::Graphics;
+using namespace EE::System;
+
+namespace EE { namespace UI {
+
+class UISVGIcon;
+
+/** @brief Rasterizes SVG icons into shared texture atlas pages.
+ * Every registered SVG is parsed only once. When a size is requested every registered icon
+ * missing that size is rasterized in a single batch ( in parallel if a thread pool is provided )
+ * and packed into atlas pages with the TexturePacker, so icons of the same size share a texture
+ * and can be batched together.
+ * Optionally the rasterized pages can be persisted into a disk cache keyed by the hash of the
+ * registered icons, avoiding the rasterization in the next run.
+ */
+class EE_API UISVGIconAtlas {
+  public:
+	static UISVGIconAtlas* New( const std::string& name,
+								std::shared_ptr<ThreadPool> threadPool = nullptr,
+								const std::string& cacheDirectory = "" );
+
+	~UISVGIconAtlas();
+
+	const std::string& getName() const;
+
+	/** Registers an icon into the atlas. The icon must be unregistered before being destroyed. */
+	void add( UISVGIcon* icon );
+
+	/** Unregisters an icon from the atlas */
+	void remove( UISVGIcon* icon );
+
+	/** @return The atlas texture region of the icon in the requested size. If the size is not
+	 * present in the atlas it will rasterize all the registered icons in that size. */
+	TextureRegion* getRegion( UISVGIcon* icon, const int& size );
+
+	/** Rasterizes and packs all the registered icons for all the requested sizes at once. */
+	void build( const std::vector<int>& sizes );
+
+	const std::shared_ptr<ThreadPool>& getThreadPool() const;
+
+	void setThreadPool( const std::shared_ptr<ThreadPool>& threadPool );
+
+	const std::string& getCacheDirectory() const;
+
+	/** Sets the directory where the rasterized atlases will be persisted. Empty disables the disk
+	 * cache. */
+	void setCacheDirectory( const std::string& cacheDirectory );
+
+	/** Maximum width and height of each atlas page ( 1024 by default ). */
+	void setMaxPageSize( const Uint32& maxPageSize );
+
+	const Uint32& getMaxPageSize() const;
+
+	/** @return A hash of all the registered icons ( names and SVG sources ) */
+	Uint64 getThemeHash() const;
+
+  protected:
+	struct Entry {
+		NSVGimage* image{ nullptr };
+		bool parsed{ false };
+		UnorderedMap<int, TextureRegion*> regions;
+	};
+
+	std::string mName;
+	std::shared_ptr<ThreadPool> mThreadPool;
+	std::string mCacheDirectory;
+	Uint32 mMaxPageSize{ 1024 };
+	UnorderedMap<UISVGIcon*, Entry> mEntries;
+	std::vector<Texture*> mPages;
+	std::vector<TextureRegion*> mRegions;
+	mutable Uint64 mThemeHash{ 0 };
+
+	UISVGIconAtlas( const std::string& name, std::shared_ptr<ThreadPool> threadPool,
+					const std::string& cacheDirectory );
+
+	void buildSize( const int& size, std::vector<UISVGIcon*>&& icons );
+
+	std::string getCachePath( const int& size, const size_t& page,
+							  const std::string& extension ) const;
+
+	bool loadFromCache( const int& size, const std::vector<UISVGIcon*>& icons );
+
+	TextureRegion* addRegion( Texture* texture, const Rect& rect, UISVGIcon* icon,
+							  const int& size );
+};
+
+}} // namespace EE::UI
+
+#endif // EE_UI_UISVGICONATLAS_HPP
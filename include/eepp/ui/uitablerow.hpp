@@ -48,7 +48,8 @@ class EE_API UITableRow : public UIWidget {
 		Node* mouseDownNode = eventDispatcher->getMouseDownNode();
 		Node* draggingNode = eventDispatcher->getNodeDragging();
 		auto eventType = isMouseEvent( msg->getMsg() );
-		if ( eventType != Event::NoEvent &&
+		// The row already sent the event if the message comes from itself
+		if ( eventType != Event::NoEvent && msg->getSender() != this &&
 			 ( mouseDownNode == nullptr || mouseDownNode == this || isParentOf( mouseDownNode ) ) &&
 			 ( draggingNode == nullptr || mouseDownNode == draggingNode ) ) {
 			sendMouseEvent( eventType, eventDispatcher->getMousePos(), msg->getFlags() );
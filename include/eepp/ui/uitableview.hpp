@@ -1,7 +1,9 @@
 #ifndef EE_UI_UITABLEVIEW_HPP
 #define EE_UI_UITABLEVIEW_HPP
 
+#include <eepp/graphics/text.hpp>
 #include <eepp/ui/abstract/uiabstracttableview.hpp>
+#include <memory>
 
 using namespace EE::UI::Abstract;
 
@@ -25,8 +27,20 @@ class EE_API UITableView : public UIAbstractTableView {
 		const std::string& text, const bool& caseSensitive = false,
 		FindRowWithTextMatchKind matchKind = FindRowWithTextMatchKind::StartsWith ) const;
 
+	/** Text only columns draw the text of their cells with the style of the table cells without
+	 * creating a cell widget for them. Their cells only display the model text: icons, classes,
+	 * tooltips, editing and the cell callbacks are not available. */
+	void setColumnTextOnly( const size_t& column, bool textOnly );
+
+	bool isColumnTextOnly( const size_t& column ) const;
+
   protected:
 	Sizef mContentSize;
+	std::vector<bool> mColumnTextOnly;
+	std::vector<UnorderedMap<Int64, std::unique_ptr<Text>>> mTextCells;
+	std::vector<size_t> mTextColumnsToDraw;
+	UITableCell* mTextCellStyle{ nullptr };
+	UITableCell* mTextCellSelectedStyle{ nullptr };
 
 	UITableView();
 
@@ -39,6 +53,20 @@ class EE_API UITableView : public UIAbstractTableView {
 	void onColumnSizeChange( const size_t&, bool );
 
 	virtual Uint32 onKeyDown( const KeyEvent& event );
+
+	virtual void onRowCreated( UITableRow* row );
+
+	void prefetchVisibleDisplayData( size_t startRow, size_t endRow );
+
+	/** @return A hidden cell used to read the style of the text only cells */
+	UITableCell* getTextCellStyle( bool selected );
+
+	void drawTextCell( UITableRow* rowNode, const int& realRowIndex, const ModelIndex& index,
+					   bool selected );
+
+	ModelIndex getTextCellIndexAt( UITableRow* row, const Vector2f& position );
+
+	void onTextCellMouseEvent( const Event* event );
 };
 
 }} // namespace EE::UI
@@ -31,6 +31,8 @@ class EE_API UITextInput : public UITextView, public TextDocument::Client {
 
 	virtual void scheduledUpdate( const Time& time );
 
+	virtual Time getScheduledUpdateTimeout( const Time& pollTimeout );
+
 	virtual void draw();
 
 	virtual void setTheme( UITheme* Theme );
@@ -107,6 +107,8 @@ class EE_API UIWindow : public UIWidget {
 
 	virtual void scheduledUpdate( const Time& time );
 
+	virtual Time getScheduledUpdateTimeout( const Time& pollTimeout );
+
 	virtual void closeWindow();
 
 	virtual void close();
@@ -29,6 +29,10 @@ class EE_API Input {
 	 */
 	virtual void waitEvent( const Time& timeout = Time::Zero ) = 0;
 
+	/** Wakes up the thread waiting for events in waitEvent. It's safe to call from any thread.
+	 * The wake-up event is not dispatched to the input listeners. */
+	virtual void wakeUp() {}
+
 	/** @return If the mouse and keyboard are grabbed. */
 	virtual bool grabInput() = 0;
 
@@ -19,6 +19,7 @@ newoption { trigger = "address-sanitizer", description = "Compile with AddressSa
 newoption { trigger = "time-trace", description = "Compile with time tracing." }
 newoption { trigger = "disable-static-build", description = "Disables eepp static build project, this is just a helper to avoid rebuilding twice eepp while developing the library." }
 newoption { trigger = "without-text-shaper", description = "Disables text-shaping capabilities." }
+newoption { trigger = "without-profiler", description = "Removes the profiler zones instrumentation at compile time." }
 newoption {
 	trigger = "with-backend",
 	description = "Select the backend to use for window and input handling.\n\t\t\tIf no backend is selected or if the selected is not installed the script will search for a backend present in the system, and will use it.",
@@ -391,6 +392,10 @@ function build_link_configuration( package_name, use_ee_icon )
 		defines { "EE_TEXT_SHAPER_ENABLED" }
 	end
 
+	if not _OPTIONS["without-profiler"] then
+		defines { "EE_PROFILER_ENABLED" }
+	end
+
 	if _OPTIONS["with-static-cpp"] then
 		linkoptions { "-static-libgcc -static-libstdc++" }
 	end
@@ -592,6 +597,10 @@ function add_static_links()
 		defines { "EE_TEXT_SHAPER_ENABLED" }
 	end
 
+	if not _OPTIONS["without-profiler"] then
+		defines { "EE_PROFILER_ENABLED" }
+	end
+
 	links { "SOIL2-static",
 			"chipmunk-static",
 			"libzip-static",
@@ -1745,6 +1754,24 @@ workspace "eepp"
 		incdirs { "src/thirdparty" }
 		build_link_configuration( "eepp-ui-perf-test", true )
 
+	project "eepp-image-kernels-benchmark"
+		kind "ConsoleApp"
+		language "C++"
+		files { "src/tests/image_kernels_benchmark/*.cpp" }
+		build_link_configuration( "eepp-image-kernels-benchmark", true )
+
+	project "eepp-particles-benchmark"
+		kind "ConsoleApp"
+		language "C++"
+		files { "src/tests/particles_benchmark/*.cpp" }
+		build_link_configuration( "eepp-particles-benchmark", true )
+
+	project "eepp-layout-benchmark"
+		kind "ConsoleApp"
+		language "C++"
+		files { "src/tests/layout_benchmark/*.cpp" }
+		build_link_configuration( "eepp-layout-benchmark", true )
+
 	project "eepp-unit_tests"
 		kind "ConsoleApp"
 		targetdir(_MAIN_SCRIPT_DIR .. "/bin/unit_tests")
@@ -1,6 +1,7 @@
 #include <eepp/audio/alcheck.hpp>
 #include <eepp/audio/audiodevice.hpp>
 #include <eepp/audio/soundstream.hpp>
+#include <eepp/audio/soundstreamservice.hpp>
 #include <eepp/core/debug.hpp>
 #include <eepp/system/lock.hpp>
 #include <eepp/system/log.hpp>
@@ -13,7 +14,6 @@
 namespace EE { namespace Audio {
 
 SoundStream::SoundStream() :
-	mThread( &SoundStream::streamData, this ),
 	mThreadMutex(),
 	mThreadStartState( Stopped ),
 	mIsStreaming( false ),
@@ -23,19 +23,30 @@ SoundStream::SoundStream() :
 	mFormat( 0 ),
 	mLoop( false ),
 	mSamplesProcessed( 0 ),
-	mBufferSeeks() {}
+	mBufferSeeks(),
+	mBufferFrames(),
+	mQueueHead( 0 ),
+	mQueueCount( 0 ),
+	mServiceStarted( false ),
+	mPlayPending( false ),
+	mRequestStop( false ),
+	mDecodedHead( 0 ),
+	mDecodedTail( 0 ),
+	mDecodeEnd( false ),
+	mDecoding( false ),
+	mFirstChunk( true ) {}
 
 SoundStream::~SoundStream() {
 	// Stop the sound if it was playing
 
-	// Request the thread to terminate
+	// Request the streaming to terminate
 	{
 		Lock lock( mThreadMutex );
 		mIsStreaming = false;
 	}
 
-	// Wait for the thread to terminate
-	mThread.wait();
+	// Wait for the streaming to terminate
+	Private::SoundStreamService::instance()->remove( this );
 }
 
 void SoundStream::initialize( unsigned int channelCount, unsigned int sampleRate ) {
@@ -75,23 +86,25 @@ void SoundStream::play() {
 
 	if ( isStreaming && ( threadStartState == Paused ) ) {
 		// If the sound is paused, resume it
-		Lock lock( mThreadMutex );
-		mThreadStartState = Playing;
-		alCheck( alSourcePlay( mSource ) );
+		{
+			Lock lock( mThreadMutex );
+			mThreadStartState = Playing;
+			alCheck( alSourcePlay( mSource ) );
+		}
+
+		Private::SoundStreamService::instance()->wakeUp( this );
 		return;
 	} else if ( isStreaming && ( threadStartState == Playing ) ) {
 		// If the sound is playing, stop it and continue as if it was stopped
 		stop();
 	}
 
-	// Start updating the stream in a separate thread to avoid blocking the application
-	mIsStreaming = true;
-	mThreadStartState = Playing;
-	mThread.launch();
+	// Start updating the stream from the streaming thread to avoid blocking the application
+	launch( Playing );
 }
 
 void SoundStream::pause() {
-	// Handle pause() being called before the thread has started
+	// Handle pause() being called before the stream has started
 	{
 		Lock lock( mThreadMutex );
 
@@ -105,14 +118,14 @@ void SoundStream::pause() {
 }
 
 void SoundStream::stop() {
-	// Request the thread to terminate
+	// Request the streaming to terminate
 	{
 		Lock lock( mThreadMutex );
 		mIsStreaming = false;
 	}
 
-	// Wait for the thread to terminate
-	mThread.wait();
+	// Wait for the streaming to terminate
+	Private::SoundStreamService::instance()->remove( this );
 
 	// Move to the beginning
 	onSeek( Time::Zero );
@@ -156,9 +169,7 @@ void SoundStream::setPlayingOffset( Time timeOffset ) {
 	if ( oldStatus == Stopped )
 		return;
 
-	mIsStreaming = true;
-	mThreadStartState = oldStatus;
-	mThread.launch();
+	launch( oldStatus );
 }
 
 Time SoundStream::getPlayingOffset() const {
@@ -173,6 +184,27 @@ Time SoundStream::getPlayingOffset() const {
 	}
 }
 
+void SoundStream::launch( Status startState ) {
+	Private::SoundStreamService* service = Private::SoundStreamService::instance();
+
+	// Make sure that the previous streaming has completely finished
+	service->remove( this );
+
+	{
+		Lock lock( mThreadMutex );
+		mIsStreaming = true;
+		mThreadStartState = startState;
+	}
+
+	// Nothing is decoding, the decode-ahead ring can be safely reset
+	mDecodedHead = 0;
+	mDecodedTail = 0;
+	mDecodeEnd = false;
+	mFirstChunk = true;
+
+	service->add( this );
+}
+
 void SoundStream::setLoop( bool loop ) {
 	mLoop = loop;
 }
@@ -186,122 +218,175 @@ Int64 SoundStream::onLoop() {
 	return 0;
 }
 
-void SoundStream::streamData() {
-	bool requestStop = false;
+bool SoundStream::serviceStream( Time& next ) {
+	bool isStreaming = false;
+	Status startState = Stopped;
 
 	{
 		Lock lock( mThreadMutex );
+		isStreaming = mIsStreaming;
+		startState = mThreadStartState;
+	}
 
-		// Check if the thread was launched Stopped
-		if ( mThreadStartState == Stopped ) {
+	if ( !mServiceStarted ) {
+		// Check if the stream was launched Stopped
+		if ( !isStreaming || startState == Stopped ) {
+			Lock lock( mThreadMutex );
 			mIsStreaming = false;
-			return;
+			return false;
 		}
-	}
-
-	// Create the buffers
-	alCheck( alGenBuffers( BufferCount, mBuffers ) );
-	for ( int i = 0; i < BufferCount; ++i )
-		mBufferSeeks[i] = NoLoop;
-
-	// Fill the queue
-	requestStop = fillQueue();
 
-	// Play the sound
-	alCheck( alSourcePlay( mSource ) );
+		// Create the buffers
+		alCheck( alGenBuffers( BufferCount, mBuffers ) );
+		for ( int i = 0; i < BufferCount; ++i )
+			mBufferSeeks[i] = NoLoop;
 
-	{
-		Lock lock( mThreadMutex );
+		mQueueHead = 0;
+		mQueueCount = 0;
+		mRequestStop = false;
+		mPlayPending = true;
+		mServiceStarted = true;
+	}
 
-		// Check if the thread was launched Paused
-		if ( mThreadStartState == Paused )
-			alCheck( alSourcePause( mSource ) );
+	if ( !isStreaming ) {
+		serviceFinish();
+		return false;
 	}
 
-	for ( ;; ) {
-		{
-			Lock lock( mThreadMutex );
-			if ( !mIsStreaming )
-				break;
-		}
+	// Get the number of buffers that have been processed (i.e. ready for reuse)
+	ALint nbProcessed = 0;
+	alCheck( alGetSourcei( mSource, AL_BUFFERS_PROCESSED, &nbProcessed ) );
 
-		// The stream has been interrupted!
-		if ( SoundSource::getStatus() == Stopped ) {
-			if ( !requestStop ) {
-				// Just continue
-				alCheck( alSourcePlay( mSource ) );
-			} else {
-				// End streaming
-				Lock lock( mThreadMutex );
-				mIsStreaming = false;
+	while ( nbProcessed-- && mQueueCount > 0 ) {
+		// Pop the first unused buffer from the queue
+		ALuint buffer;
+		alCheck( alSourceUnqueueBuffers( mSource, 1, &buffer ) );
+		mQueueHead = ( mQueueHead + 1 ) % BufferCount;
+		mQueueCount--;
+
+		// Find its number
+		unsigned int bufferNum = 0;
+		for ( int i = 0; i < BufferCount; ++i )
+			if ( mBuffers[i] == buffer ) {
+				bufferNum = i;
+				break;
 			}
-		}
 
-		// Get the number of buffers that have been processed (i.e. ready for reuse)
-		ALint nbProcessed = 0;
-		alCheck( alGetSourcei( mSource, AL_BUFFERS_PROCESSED, &nbProcessed ) );
-
-		while ( nbProcessed-- ) {
-			// Pop the first unused buffer from the queue
-			ALuint buffer;
-			alCheck( alSourceUnqueueBuffers( mSource, 1, &buffer ) );
-
-			// Find its number
-			unsigned int bufferNum = 0;
-			for ( int i = 0; i < BufferCount; ++i )
-				if ( mBuffers[i] == buffer ) {
-					bufferNum = i;
-					break;
-				}
-
-			// Retrieve its size and add it to the samples count
-			if ( mBufferSeeks[bufferNum] != NoLoop ) {
-				// This was the last buffer before EOF or Loop End: reset the sample count
-				mSamplesProcessed = mBufferSeeks[bufferNum];
-				mBufferSeeks[bufferNum] = NoLoop;
-			} else {
-				ALint size, bits;
-				alCheck( alGetBufferi( buffer, AL_SIZE, &size ) );
+		// Retrieve its size and add it to the samples count
+		if ( mBufferSeeks[bufferNum] != NoLoop ) {
+			// This was the last buffer before EOF or Loop End: reset the sample count
+			mSamplesProcessed = mBufferSeeks[bufferNum];
+			mBufferSeeks[bufferNum] = NoLoop;
+		} else {
+			ALint size, bits;
+			alCheck( alGetBufferi( buffer, AL_SIZE, &size ) );
 
 #ifdef EE_MOJOAL
-				// IMPORTANT! mojoAL is *LYING* about buffer bitness, because it reports the one
-				// passed to alBufferData, but internally always works with Float32; therefore
-				// final samples found in the buffer are in float32!
-				// Reference:
-				// https://github.com/adventuregamestudio/ags/commit/48542c69960c6bbd418d50937b836313819b55eb#diff-c776bdf2d0b75ff838097e0c28a1307484ce91bb2b23d1b23ddd54888d49589eR51-R67
-				bits = sizeof( ALfloat ) * 8;
+			// IMPORTANT! mojoAL is *LYING* about buffer bitness, because it reports the one
+			// passed to alBufferData, but internally always works with Float32; therefore
+			// final samples found in the buffer are in float32!
+			// Reference:
+			// https://github.com/adventuregamestudio/ags/commit/48542c69960c6bbd418d50937b836313819b55eb#diff-c776bdf2d0b75ff838097e0c28a1307484ce91bb2b23d1b23ddd54888d49589eR51-R67
+			bits = sizeof( ALfloat ) * 8;
 #else
-				alCheck( alGetBufferi( buffer, AL_BITS, &bits ) );
+			alCheck( alGetBufferi( buffer, AL_BITS, &bits ) );
 #endif
 
-				// Bits can be 0 if the format or parameters are corrupt, avoid division by zero
-				if ( bits == 0 ) {
-					Log::warning(
-						"SoundStream: Bits in sound stream are 0: make sure that the "
-						"audio format is not corrupt and initialize() has been called correctly." );
+			// Bits can be 0 if the format or parameters are corrupt, avoid division by zero
+			if ( bits == 0 ) {
+				Log::warning(
+					"SoundStream: Bits in sound stream are 0: make sure that the "
+					"audio format is not corrupt and initialize() has been called correctly." );
 
-					// Abort streaming (exit main loop)
+				// Abort streaming
+				{
 					Lock lock( mThreadMutex );
 					mIsStreaming = false;
-					requestStop = true;
-					break;
-				} else {
-					mSamplesProcessed += size / ( bits / 8 );
 				}
-			}
 
-			// Fill it and push it back into the playing queue
-			if ( !requestStop ) {
-				if ( fillAndPushBuffer( bufferNum ) )
-					requestStop = true;
+				serviceFinish();
+				return false;
+			} else {
+				mSamplesProcessed += size / ( bits / 8 );
 			}
 		}
+	}
 
-		// Leave some time for the other threads if the stream is still playing
-		if ( SoundSource::getStatus() != Stopped )
-			Sys::sleep( Milliseconds( 10 ) );
+	// Fill the free buffers with the chunks already decoded and push them into the playing queue
+	while ( !mRequestStop && mQueueCount < BufferCount &&
+			mDecodedTail.load( std::memory_order_relaxed ) !=
+				mDecodedHead.load( std::memory_order_acquire ) ) {
+		// The buffers are recycled in the same order they are queued, the free ones are the ones
+		// after the queued ones
+		unsigned int bufferNum = ( mQueueHead + mQueueCount ) % BufferCount;
+
+		if ( pushDecodedChunk( bufferNum ) )
+			mRequestStop = true;
+	}
+
+	if ( mPlayPending ) {
+		if ( mQueueCount > 0 ) {
+			// Play the sound
+			alCheck( alSourcePlay( mSource ) );
+
+			// Check if the stream was launched Paused
+			Lock lock( mThreadMutex );
+			if ( mThreadStartState == Paused )
+				alCheck( alSourcePause( mSource ) );
+
+			mPlayPending = false;
+		} else if ( mRequestStop ) {
+			Lock lock( mThreadMutex );
+			mIsStreaming = false;
+		}
+	} else if ( SoundSource::getStatus() == Stopped ) {
+		// The stream has been interrupted!
+		if ( mQueueCount > 0 ) {
+			// Just continue
+			alCheck( alSourcePlay( mSource ) );
+		} else if ( mRequestStop ) {
+			// End streaming
+			Lock lock( mThreadMutex );
+			mIsStreaming = false;
+		}
 	}
 
+	{
+		Lock lock( mThreadMutex );
+		isStreaming = mIsStreaming;
+	}
+
+	if ( !isStreaming ) {
+		serviceFinish();
+		return false;
+	}
+
+	// Decode ahead the next chunks
+	if ( !mRequestStop && !mDecodeEnd )
+		Private::SoundStreamService::instance()->requestDecode( this );
+
+	// Wait until the first queued buffer has been played, the decoding task wakes up the stream if
+	// it's waiting for data
+	if ( mQueueCount == 0 || SoundSource::getStatus() != Playing ) {
+		next = Milliseconds( 100 );
+	} else {
+		ALint sampleOffset = 0;
+		alCheck( alGetSourcei( mSource, AL_SAMPLE_OFFSET, &sampleOffset ) );
+
+		Uint64 frames = mBufferFrames[mQueueHead];
+		Uint64 remaining = frames > (Uint64)sampleOffset ? frames - sampleOffset : 0;
+
+		next = Microseconds( remaining * 1000000 / mSampleRate );
+		next = eemax( Milliseconds( 2 ), eemin( Milliseconds( 250 ), next ) );
+	}
+
+	return true;
+}
+
+void SoundStream::serviceFinish() {
+	if ( !mServiceStarted )
+		return;
+
 	// Stop the playback
 	alCheck( alSourceStop( mSource ) );
 
@@ -314,10 +399,41 @@ void SoundStream::streamData() {
 	// Delete the buffers
 	alCheck( alSourcei( mSource, AL_BUFFER, 0 ) );
 	alCheck( alDeleteBuffers( BufferCount, mBuffers ) );
+
+	mQueueCount = 0;
+	mServiceStarted = false;
 }
 
-bool SoundStream::fillAndPushBuffer( unsigned int bufferNum, bool immediateLoop ) {
-	bool requestStop = false;
+void SoundStream::decodeAhead() {
+	for ( ;; ) {
+		{
+			Lock lock( mThreadMutex );
+			if ( !mIsStreaming )
+				break;
+		}
+
+		Uint32 head = mDecodedHead.load( std::memory_order_relaxed );
+
+		if ( mDecodeEnd || head - mDecodedTail.load( std::memory_order_acquire ) >=
+							   (Uint32)DecodeAheadCount )
+			break;
+
+		bool end = decodeChunk( mDecoded[head % DecodeAheadCount] );
+
+		mDecodedHead.store( head + 1, std::memory_order_release );
+
+		if ( end ) {
+			mDecodeEnd = true;
+			break;
+		}
+	}
+}
+
+bool SoundStream::decodeChunk( DecodedChunk& chunk ) {
+	chunk.samples.clear();
+	chunk.seek = NoLoop;
+	chunk.immediateSeek = NoLoop;
+	chunk.last = false;
 
 	// Acquire audio data, also address EOF and error cases if they occur
 	Chunk data = { NULL, 0 };
@@ -327,58 +443,70 @@ bool SoundStream::fillAndPushBuffer( unsigned int bufferNum, bool immediateLoop
 		if ( !mLoop ) {
 			// Not looping: Mark this buffer as ending with 0 and request stop
 			if ( data.samples != NULL && data.sampleCount != 0 )
-				mBufferSeeks[bufferNum] = 0;
-			requestStop = true;
+				chunk.seek = 0;
+			chunk.last = true;
 			break;
 		}
 
 		// Return to the beginning or loop-start of the stream source using onLoop(), and store the
-		// result in the buffer seek array This marks the buffer as the "last" one (so that we know
-		// where to reset the playing position)
-		mBufferSeeks[bufferNum] = onLoop();
+		// result in the chunk seek. This marks the buffer as the "last" one (so that we know where
+		// to reset the playing position)
+		chunk.seek = onLoop();
 
 		// If we got data, break and process it, else try to fill the buffer once again
 		if ( data.samples != NULL && data.sampleCount != 0 )
 			break;
 
-		// If immediateLoop is specified, we have to immediately adjust the sample count
-		if ( immediateLoop && ( mBufferSeeks[bufferNum] != NoLoop ) ) {
-			// We just tried to begin preloading at EOF or Loop End: reset the sample count
-			mSamplesProcessed = mBufferSeeks[bufferNum];
-			mBufferSeeks[bufferNum] = NoLoop;
+		// Since no sound has been loaded yet, we can't schedule loop seeks preemptively,
+		// so if we start on EOF or Loop End the sample count is adjusted immediately
+		if ( mFirstChunk && ( chunk.seek != NoLoop ) ) {
+			chunk.immediateSeek = chunk.seek;
+			chunk.seek = NoLoop;
 		}
 
 		// We're a looping sound that got no data, so we retry onGetData()
 	}
 
-	// Fill the buffer if some data was returned
+	mFirstChunk = false;
+
+	// Copy the data since the source can reuse its samples buffer in the next call
 	if ( data.samples && data.sampleCount ) {
+		chunk.samples.assign( data.samples, data.samples + data.sampleCount );
+	} else {
+		// If we get here, we most likely ran out of retries
+		chunk.last = true;
+	}
+
+	return chunk.last;
+}
+
+bool SoundStream::pushDecodedChunk( unsigned int bufferNum ) {
+	Uint32 tail = mDecodedTail.load( std::memory_order_relaxed );
+	DecodedChunk& chunk = mDecoded[tail % DecodeAheadCount];
+	bool requestStop = chunk.last;
+
+	if ( chunk.immediateSeek != NoLoop )
+		mSamplesProcessed = chunk.immediateSeek;
+
+	mBufferSeeks[bufferNum] = chunk.seek;
+
+	// Fill the buffer if some data was returned
+	if ( !chunk.samples.empty() ) {
 		unsigned int buffer = mBuffers[bufferNum];
 
 		// Fill the buffer
-		ALsizei size = static_cast<ALsizei>( data.sampleCount ) * sizeof( Int16 );
-		alCheck( alBufferData( buffer, mFormat, data.samples, size, mSampleRate ) );
+		ALsizei size = static_cast<ALsizei>( chunk.samples.size() ) * sizeof( Int16 );
+		alCheck( alBufferData( buffer, mFormat, chunk.samples.data(), size, mSampleRate ) );
 
 		// Push it into the sound queue
 		alCheck( alSourceQueueBuffers( mSource, 1, &buffer ) );
-	} else {
-		// If we get here, we most likely ran out of retries
-		requestStop = true;
-	}
 
-	return requestStop;
-}
-
-bool SoundStream::fillQueue() {
-	// Fill and enqueue all the available buffers
-	bool requestStop = false;
-	for ( int i = 0; ( i < BufferCount ) && !requestStop; ++i ) {
-		// Since no sound has been loaded yet, we can't schedule loop seeks preemptively,
-		// So if we start on EOF or Loop End, we let fillAndPushBuffer() adjust the sample count
-		if ( fillAndPushBuffer( i, ( i == 0 ) ) )
-			requestStop = true;
+		mBufferFrames[bufferNum] = chunk.samples.size() / mChannelCount;
+		mQueueCount++;
 	}
 
+	mDecodedTail.store( tail + 1, std::memory_order_release );
+
 	return requestStop;
 }
 
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <eepp/audio/soundstream.hpp>
+#include <eepp/audio/soundstreamservice.hpp>
+#include <eepp/system/sys.hpp>
+
+namespace EE { namespace Audio { namespace Private {
+
+SoundStreamService* SoundStreamService::instance() {
+	// Intentionally leaked: streams destroyed during the static deinitialization still unregister
+	// from it, and its threads must not be joined at exit
+	static SoundStreamService* sInstance = new SoundStreamService();
+	return sInstance;
+}
+
+SoundStreamService::SoundStreamService() :
+	mThread( &SoundStreamService::run, this ), mRunning( false ), mWakeUp( false ) {}
+
+SoundStreamService::~SoundStreamService() {
+	mThread.wait();
+	mDecodePool.reset();
+}
+
+bool SoundStreamService::isServiced( SoundStream* stream ) const {
+	return std::find_if( mStreams.begin(), mStreams.end(), [stream]( const Entry& entry ) {
+			   return entry.stream == stream;
+		   } ) != mStreams.end();
+}
+
+void SoundStreamService::add( SoundStream* stream ) {
+	std::lock_guard<std::mutex> lock( mMutex );
+
+	if ( !mDecodePool )
+		mDecodePool = ThreadPool::createShared( eemin( 2, eemax( 1, Sys::getCPUCount() - 1 ) ) );
+
+	mStreams.push_back( { stream, std::chrono::steady_clock::now() } );
+	mWakeUp = true;
+
+	if ( !mRunning ) {
+		// The previous streaming thread already left its loop, launch waits for it to exit
+		mRunning = true;
+		mThread.launch();
+	} else {
+		mWakeUpCondition.notify_one();
+	}
+}
+
+void SoundStreamService::remove( SoundStream* stream ) {
+	std::unique_lock<std::mutex> lock( mMutex );
+
+	auto it = std::find_if( mStreams.begin(), mStreams.end(),
+							[stream]( const Entry& entry ) { return entry.stream == stream; } );
+
+	if ( it != mStreams.end() ) {
+		it->deadline = std::chrono::steady_clock::now();
+		mWakeUp = true;
+		mWakeUpCondition.notify_one();
+	}
+
+	mFinishedCondition.wait(
+		lock, [this, stream] { return !isServiced( stream ) && !stream->mDecoding.load(); } );
+}
+
+void SoundStreamService::wakeUp( SoundStream* stream ) {
+	std::lock_guard<std::mutex> lock( mMutex );
+
+	for ( auto& entry : mStreams ) {
+		if ( entry.stream == stream ) {
+			entry.deadline = std::chrono::steady_clock::now();
+			mWakeUp = true;
+			mWakeUpCondition.notify_one();
+			break;
+		}
+	}
+}
+
+void SoundStreamService::requestDecode( SoundStream* stream ) {
+	if ( stream->mDecoding.exchange( true ) )
+		return;
+
+	mDecodePool->run( [this, stream] {
+		stream->decodeAhead();
+		onDecoded( stream );
+	} );
+}
+
+void SoundStreamService::onDecoded( SoundStream* stream ) {
+	std::lock_guard<std::mutex> lock( mMutex );
+
+	stream->mDecoding = false;
+
+	// The stream is waiting for the decoded chunks
+	for ( auto& entry : mStreams ) {
+		if ( entry.stream == stream ) {
+			entry.deadline = std::chrono::steady_clock::now();
+			mWakeUp = true;
+			mWakeUpCondition.notify_one();
+			break;
+		}
+	}
+
+	mFinishedCondition.notify_all();
+}
+
+void SoundStreamService::run() {
+	std::unique_lock<std::mutex> lock( mMutex );
+
+	while ( !mStreams.empty() ) {
+		mWakeUp = false;
+
+		// Only this thread erases entries, so the indexes stay valid while unlocked
+		for ( size_t i = 0; i < mStreams.size(); ) {
+			if ( mStreams[i].deadline > std::chrono::steady_clock::now() ) {
+				++i;
+				continue;
+			}
+
+			SoundStream* stream = mStreams[i].stream;
+			Time next;
+
+			lock.unlock();
+			bool serviced = stream->serviceStream( next );
+			lock.lock();
+
+			if ( serviced ) {
+				mStreams[i].deadline = std::chrono::steady_clock::now() +
+									   std::chrono::microseconds( next.asMicroseconds() );
+				++i;
+			} else {
+				mStreams.erase( mStreams.begin() + i );
+				mFinishedCondition.notify_all();
+			}
+		}
+
+		if ( mStreams.empty() )
+			break;
+
+		TimePoint deadline = mStreams.front().deadline;
+
+		for ( const auto& entry : mStreams )
+			deadline = std::min( deadline, entry.deadline );
+
+		mWakeUpCondition.wait_until( lock, deadline, [this] { return mWakeUp; } );
+	}
+
+	mRunning = false;
+}
+
+}}} // namespace EE::Audio::Private
@@ -0,0 +1,99 @@
+#ifndef EE_AUDIO_SOUNDSTREAMSERVICE_HPP
+#define EE_AUDIO_SOUNDSTREAMSERVICE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <eepp/system/thread.hpp>
+#include <eepp/system/threadpool.hpp>
+#include <eepp/system/time.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+using namespace EE::System;
+
+namespace EE { namespace Audio {
+
+class SoundStream;
+
+namespace Private {
+
+////////////////////////////////////////////////////////////
+/// \brief Services all the playing sound streams from a single
+///		thread
+///
+/// Every stream is serviced when its next buffer-fill deadline
+/// expires (or when it's woken up), the thread sleeps until the
+/// nearest deadline. The audio data is decoded ahead by a small
+/// pool of worker threads, so a slow decoder never delays the
+/// buffers of the other streams.
+/// The streaming thread only runs while there are streams playing.
+/// The service is never destroyed, so it outlives every stream.
+///
+////////////////////////////////////////////////////////////
+class SoundStreamService {
+  public:
+	static SoundStreamService* instance();
+
+	~SoundStreamService();
+
+	////////////////////////////////////////////////////////////
+	/// \brief Start servicing a stream
+	///
+	/// The stream must not be serviced nor decoding.
+	///
+	////////////////////////////////////////////////////////////
+	void add( SoundStream* stream );
+
+	////////////////////////////////////////////////////////////
+	/// \brief Wait until a stream is no longer serviced
+	///
+	/// The stream must have been requested to stop streaming. Blocks
+	/// until the streaming thread released its buffers and its
+	/// decoding task finished.
+	///
+	////////////////////////////////////////////////////////////
+	void remove( SoundStream* stream );
+
+	////////////////////////////////////////////////////////////
+	/// \brief Service a stream as soon as possible
+	///
+	////////////////////////////////////////////////////////////
+	void wakeUp( SoundStream* stream );
+
+	////////////////////////////////////////////////////////////
+	/// \brief Queue a decoding task for the stream if none is running
+	///
+	////////////////////////////////////////////////////////////
+	void requestDecode( SoundStream* stream );
+
+  protected:
+	typedef std::chrono::steady_clock::time_point TimePoint;
+
+	struct Entry {
+		SoundStream* stream;
+		TimePoint deadline;
+	};
+
+	std::mutex mMutex;
+	std::condition_variable mWakeUpCondition;
+	std::condition_variable mFinishedCondition;
+	std::vector<Entry> mStreams;
+	Thread mThread;
+	bool mRunning;
+	bool mWakeUp;
+	std::shared_ptr<ThreadPool> mDecodePool;
+
+	SoundStreamService();
+
+	void run();
+
+	void onDecoded( SoundStream* stream );
+
+	bool isServiced( SoundStream* stream ) const;
+};
+
+} // namespace Private
+
+}} // namespace EE::Audio
+
+#endif
@@ -3,6 +3,7 @@
 #include <eepp/graphics/renderer/openglext.hpp>
 #include <eepp/graphics/renderer/renderer.hpp>
 #include <eepp/graphics/texture.hpp>
+#include <eepp/system/profiler.hpp>
 
 namespace EE { namespace Graphics {
 
@@ -90,6 +91,8 @@ void BatchRenderer::flush() {
 	if ( mNumVertex == 0 )
 		return;
 
+	EE_PROFILE_ZONE( "BatchRenderer::flush" );
+
 	if ( GlobalBatchRenderer::instance() != this )
 		GlobalBatchRenderer::instance()->draw();
 
@@ -2,6 +2,7 @@
 #include <eepp/graphics/globaltextureatlas.hpp>
 #include <eepp/graphics/ninepatchmanager.hpp>
 #include <eepp/graphics/sprite.hpp>
+#include <eepp/graphics/textureasyncloader.hpp>
 #include <eepp/graphics/textureatlasmanager.hpp>
 #include <eepp/graphics/texturefactory.hpp>
 #include <eepp/system/base64.hpp>
@@ -106,7 +107,7 @@ static Drawable* parseDataURI( const std::string& name ) {
 }
 
 Drawable* DrawableSearcher::searchByName( const std::string& name, bool firstSearchSprite,
-										  Network::URI referer ) {
+										  Network::URI referer, bool asyncLoad ) {
 	Drawable* drawable = NULL;
 
 	if ( name.size() ) {
@@ -156,7 +157,9 @@ Drawable* DrawableSearcher::searchByName( const std::string& name, bool firstSea
 			drawable = TextureFactory::instance()->getByName( filePath );
 
 			if ( NULL == drawable ) {
-				Texture* tex = TextureFactory::instance()->loadFromFile( filePath );
+				Texture* tex = asyncLoad
+								   ? TextureAsyncLoader::instance()->loadFromFile( filePath )
+								   : TextureFactory::instance()->loadFromFile( filePath );
 
 				if ( tex )
 					drawable = tex;
@@ -165,7 +168,7 @@ Drawable* DrawableSearcher::searchByName( const std::string& name, bool firstSea
 					String::startsWith( name, "https://" ) ) {
 			Texture* texture = TextureFactory::instance()->getByName( name );
 
-			if ( NULL == texture && Engine::instance()->isSharedGLContextEnabled() ) {
+			if ( NULL == texture ) {
 				texture = TextureFactory::instance()->createEmptyTexture(
 					1, 1, 4, Color::Transparent, false, Texture::ClampMode::ClampToEdge, false,
 					false, name );
@@ -174,14 +177,16 @@ Drawable* DrawableSearcher::searchByName( const std::string& name, bool firstSea
 				if ( !referer.empty() )
 					headers["referer"] = referer.toString();
 
+				// The image is decoded in the loader thread pool and uploaded from the main
+				// thread, so it doesn't need a shared GL context
+				TextureAsyncLoader* loader = TextureAsyncLoader::instance();
+				loader->getThreadPool();
+
 				Http::getAsync(
-					[texture, name]( const Http&, Http::Request&, Http::Response& response ) {
+					[loader, texture, name]( const Http&, Http::Request&,
+											 Http::Response& response ) {
 						if ( response.isOK() && !response.getBody().empty() ) {
-							Image image( (const Uint8*)&response.getBody()[0],
-										 response.getBody().size() );
-
-							if ( image.getPixels() != NULL )
-								texture->replace( &image );
+							loader->loadFromMemory( texture, std::string( response.getBody() ) );
 						} else {
 							Log::debug( "DrawableSearcher::searchByName: could not download image: "
 										"%s. Error: %d\n%s",
@@ -4,6 +4,7 @@
 
 #include <eepp/graphics/image.hpp>
 #include <eepp/graphics/pixeldensity.hpp>
+#include <eepp/graphics/pixelkernels.hpp>
 #include <eepp/graphics/stbi_iocb.hpp>
 #include <eepp/system/filesystem.hpp>
 #include <eepp/system/log.hpp>
@@ -1190,61 +1191,10 @@ bool Image::saveToFile( const std::string& filepath, const SaveType& Format ) {
 }
 
 void Image::replaceColor( const Color& ColorKey, const Color& NewColor ) {
-	unsigned int Pos = 0;
-
 	if ( NULL == mPixels )
 		return;
 
-	unsigned int size = mWidth * mHeight;
-
-	switch ( mChannels ) {
-		case 4: {
-			for ( unsigned int i = 0; i < size; i++ ) {
-				Pos = i * mChannels;
-				if ( mPixels[Pos] == ColorKey.r && mPixels[Pos + 1] == ColorKey.g &&
-					 mPixels[Pos + 2] == ColorKey.b && mPixels[Pos + 3] == ColorKey.a ) {
-					mPixels[Pos] = NewColor.r;
-					mPixels[Pos + 1] = NewColor.g;
-					mPixels[Pos + 2] = NewColor.b;
-					mPixels[Pos + 3] = NewColor.a;
-				}
-			}
-			break;
-		}
-		case 3: {
-			for ( unsigned int i = 0; i < size; i++ ) {
-				Pos = i * mChannels;
-				if ( mPixels[Pos] == ColorKey.r && mPixels[Pos + 1] == ColorKey.g &&
-					 mPixels[Pos + 2] == ColorKey.b ) {
-					mPixels[Pos] = NewColor.r;
-					mPixels[Pos + 1] = NewColor.g;
-					mPixels[Pos + 2] = NewColor.b;
-				}
-			}
-			break;
-		}
-		case 2: {
-			for ( unsigned int i = 0; i < size; i++ ) {
-				Pos = i * mChannels;
-				if ( mPixels[Pos] == ColorKey.r && mPixels[Pos + 1] == ColorKey.g ) {
-					mPixels[Pos] = NewColor.r;
-					mPixels[Pos + 1] = NewColor.g;
-				}
-			}
-			break;
-		}
-		case 1: {
-			for ( unsigned int i = 0; i < size; i++ ) {
-				Pos = i * mChannels;
-				if ( mPixels[Pos] == ColorKey.r ) {
-					mPixels[Pos] = NewColor.r;
-				}
-			}
-			break;
-		}
-		default:
-			break;
-	}
+	PixelKernels::replaceColor( mPixels, (size_t)mWidth * mHeight, mChannels, ColorKey, NewColor );
 }
 
 void Image::createMaskFromColor( const Color& ColorKey, Uint8 Alpha ) {
@@ -1259,40 +1209,7 @@ void Image::fillWithColor( const Color& Color ) {
 	if ( NULL == mPixels )
 		return;
 
-	Uint64 size = mWidth * mHeight;
-
-	switch ( mChannels ) {
-		case 4: {
-			for ( Uint64 i = 0; i < size; i += mChannels ) {
-				mPixels[i + 0] = Color.r;
-				mPixels[i + 1] = Color.g;
-				mPixels[i + 2] = Color.b;
-				mPixels[i + 3] = Color.a;
-			}
-			break;
-		}
-		case 3: {
-			for ( Uint64 i = 0; i < size; i += mChannels ) {
-				mPixels[i + 0] = Color.r;
-				mPixels[i + 1] = Color.g;
-				mPixels[i + 2] = Color.b;
-			}
-			break;
-		}
-		case 2: {
-			for ( Uint64 i = 0; i < size; i += mChannels ) {
-				mPixels[i + 0] = Color.r;
-				mPixels[i + 1] = Color.g;
-			}
-			break;
-		}
-		case 1: {
-			for ( Uint64 i = 0; i < size; i += mChannels ) {
-				mPixels[i] = Color.r;
-			}
-			break;
-		}
-	}
+	PixelKernels::fill( mPixels, (size_t)mWidth * mHeight, mChannels, Color );
 }
 
 void Image::copyImage( Graphics::Image* image, const Uint32& x, const Uint32& y ) {
@@ -1302,10 +1219,14 @@ void Image::copyImage( Graphics::Image* image, const Uint32& x, const Uint32& y
 		unsigned int dHeight = image->getHeight();
 
 		if ( mChannels != image->getChannels() ) {
+			// Convert per row
+			unsigned int sChannels = image->getChannels();
+
 			for ( unsigned int ty = 0; ty < dHeight; ty++ ) {
-				for ( unsigned int tx = 0; tx < dWidth; tx++ ) {
-					setPixel( x + tx, y + ty, image->getPixel( tx, ty ) );
-				}
+				Uint8* pDst = &mPixels[( x + ( ( ty + y ) * mWidth ) ) * mChannels];
+				const Uint8* pSrc = &( ( image->getPixelsPtr() )[( ty * dWidth ) * sChannels] );
+
+				PixelKernels::convertChannels( pDst, mChannels, pSrc, sChannels, dWidth );
 			}
 		} else {
 			// Copy per row
@@ -1391,10 +1312,24 @@ Graphics::Image* Image::crop( Rect rect ) {
 void Image::flip() {
 	if ( NULL != mPixels ) {
 		Image tImg( mHeight, mWidth, mChannels );
+		Uint8* dst = tImg.getPixels();
+		const unsigned int tile = 32;
+
+		// Transpose in tiles to keep both the source and the destination rows in cache
+		for ( unsigned int by = 0; by < mHeight; by += tile ) {
+			unsigned int ey = eemin( mHeight, by + tile );
 
-		for ( unsigned int y = 0; y < mHeight; y++ )
-			for ( unsigned int x = 0; x < mWidth; x++ )
-				tImg.setPixel( y, x, getPixel( x, mHeight - 1 - y ) );
+			for ( unsigned int bx = 0; bx < mWidth; bx += tile ) {
+				unsigned int ex = eemin( mWidth, bx + tile );
+
+				for ( unsigned int y = by; y < ey; y++ ) {
+					const Uint8* src = &mPixels[( ( mHeight - 1 - y ) * mWidth + bx ) * mChannels];
+
+					for ( unsigned int x = bx; x < ex; x++, src += mChannels )
+						memcpy( &dst[( x * mHeight + y ) * mChannels], src, mChannels );
+				}
+			}
+		}
 
 		clearCache();
 
@@ -1416,6 +1351,19 @@ void Image::blit( Graphics::Image* image, const Uint32& x, const Uint32& y ) {
 		unsigned int dh = eemin( mHeight, y + image->getHeight() );
 		unsigned int dw = eemin( mWidth, x + image->getWidth() );
 
+		if ( mChannels == 4 && image->getChannels() == 4 ) {
+			// Blend per row
+			for ( unsigned int ty = y; ty < dh; ty++ ) {
+				Uint8* pDst = &mPixels[( x + ty * mWidth ) * 4];
+				const Uint8* pSrc =
+					&( ( image->getPixelsPtr() )[( ( ty - y ) * image->getWidth() ) * 4] );
+
+				PixelKernels::blendOver( pDst, pSrc, dw - x );
+			}
+
+			return;
+		}
+
 		for ( unsigned int ty = y; ty < dh; ty++ ) {
 			for ( unsigned int tx = x; tx < dw; tx++ ) {
 				Color ts( image->getPixel( tx - x, ty - y ) );
@@ -1427,6 +1375,21 @@ void Image::blit( Graphics::Image* image, const Uint32& x, const Uint32& y ) {
 	}
 }
 
+void Image::premultiplyAlpha() {
+	if ( NULL != mPixels && mChannels == 4 )
+		PixelKernels::premultiplyAlpha( mPixels, (size_t)mWidth * mHeight );
+}
+
+void Image::unpremultiplyAlpha() {
+	if ( NULL != mPixels && mChannels == 4 )
+		PixelKernels::unpremultiplyAlpha( mPixels, (size_t)mWidth * mHeight );
+}
+
+void Image::swizzleRedBlue() {
+	if ( NULL != mPixels && mChannels == 4 )
+		PixelKernels::swizzleRedBlue( mPixels, (size_t)mWidth * mHeight );
+}
+
 Graphics::Image* Image::copy() {
 	return eeNew( Graphics::Image, ( this ) );
 }
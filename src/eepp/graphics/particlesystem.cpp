@@ -7,10 +7,63 @@
 #include <eepp/graphics/texturefactory.hpp>
 #include <eepp/window/engine.hpp>
 
+#if defined( EE_ARCH_X86_64 )
+#if defined( _MSC_VER )
+#include <intrin.h>
+#else
+#include <emmintrin.h>
+#endif
+#elif defined( EE_ARCH_ARM64 )
+#include <arm_neon.h>
+#endif
+
 using namespace EE::Window;
 
 namespace EE { namespace Graphics {
 
+// Particles integrated per task by the SoA backend
+static constexpr Uint32 ParticlesChunkSize = 16384;
+
+// Minimum alive particles to update the SoA backend in parallel
+static constexpr Uint32 ParticlesParallelThreshold = 65536;
+
+// dst[i] += src[i] * t
+static void particlesIntegrate( Float* dst, const Float* src, const Float& t, size_t count ) {
+	size_t i = 0;
+#if defined( EE_ARCH_X86_64 )
+	const __m128 vt = _mm_set1_ps( t );
+	for ( ; i + 4 <= count; i += 4 )
+		_mm_storeu_ps( dst + i, _mm_add_ps( _mm_loadu_ps( dst + i ),
+											_mm_mul_ps( _mm_loadu_ps( src + i ), vt ) ) );
+#elif defined( EE_ARCH_ARM64 )
+	for ( ; i + 4 <= count; i += 4 )
+		vst1q_f32( dst + i, vmlaq_n_f32( vld1q_f32( dst + i ), vld1q_f32( src + i ), t ) );
+#endif
+	for ( ; i < count; i++ )
+		dst[i] += src[i] * t;
+}
+
+// dst[i] = max( 0, dst[i] - src[i] * t )
+static void particlesDecay( Float* dst, const Float* src, const Float& t, size_t count ) {
+	size_t i = 0;
+#if defined( EE_ARCH_X86_64 )
+	const __m128 vt = _mm_set1_ps( t );
+	const __m128 zero = _mm_setzero_ps();
+	for ( ; i + 4 <= count; i += 4 ) {
+		__m128 v = _mm_sub_ps( _mm_loadu_ps( dst + i ), _mm_mul_ps( _mm_loadu_ps( src + i ), vt ) );
+		_mm_storeu_ps( dst + i, _mm_max_ps( zero, v ) );
+	}
+#elif defined( EE_ARCH_ARM64 )
+	const float32x4_t zero = vdupq_n_f32( 0.f );
+	for ( ; i + 4 <= count; i += 4 ) {
+		float32x4_t v = vmlsq_n_f32( vld1q_f32( dst + i ), vld1q_f32( src + i ), t );
+		vst1q_f32( dst + i, vmaxq_f32( zero, v ) );
+	}
+#endif
+	for ( ; i < count; i++ )
+		dst[i] = eemax( (Float)0, dst[i] - src[i] * t );
+}
+
 ParticleSystem::ParticleSystem() :
 	mParticle( NULL ),
 	mPCount( 0 ),
@@ -43,7 +96,7 @@ void ParticleSystem::create( const ParticleEffect& Effect, const Uint32& NumPart
 							 const bool& AnimLoop, const Uint32& NumLoops, const ColorAf& Color,
 							 const Vector2f& Pos2, const Float& AlphaDecay, const Vector2f& Speed,
 							 const Vector2f& Acc ) {
-	mPointsSup = GLi->pointSpriteSupported();
+	mPointsSup = NULL != GLi && GLi->pointSpriteSupported();
 	mEffect = Effect;
 	mPos = Pos;
 	mPCount = NumParticles;
@@ -79,6 +132,31 @@ void ParticleSystem::begin() {
 
 	eeSAFE_DELETE_ARRAY( mParticle );
 
+	if ( mBackend == Backend::SoA ) {
+		mPositions.resize( mPCount );
+		mSpeeds.resize( mPCount );
+		mAccelerations.resize( mPCount );
+		mColors.resize( mPCount );
+		mDecays.resize( mPCount );
+		mIds.resize( mPCount );
+		mAlive = mPCount;
+
+		for ( Uint32 i = 0; i < mPCount; i++ ) {
+			mIds[i] = i + 1;
+			resetParticle( i );
+		}
+
+		return;
+	}
+
+	mPositions.clear();
+	mSpeeds.clear();
+	mAccelerations.clear();
+	mColors.clear();
+	mDecays.clear();
+	mIds.clear();
+	mAlive = 0;
+
 	mParticle = eeNewArray( Particle, mPCount );
 
 	Particle* P;
@@ -316,6 +394,30 @@ void ParticleSystem::reset( Particle* P ) {
 	}
 }
 
+void ParticleSystem::resetParticle( const Uint32& index ) {
+	// The effects are defined over a Particle, so the callbacks work the same way in both backends
+	Particle P;
+	P.setUsed( true );
+	P.setId( mIds[index] );
+
+	reset( &P );
+
+	mPositions[index] = Vector2f( P.getX(), P.getY() );
+	mSpeeds[index] = Vector2f( P.getXSpeed(), P.getYSpeed() );
+	mAccelerations[index] = Vector2f( P.getXAcc(), P.getYAcc() );
+	mColors[index] = P.getColor();
+	mDecays[index] = ColorAf( 0.f, 0.f, 0.f, P.getAlphaDecay() );
+}
+
+void ParticleSystem::swapParticles( const Uint32& a, const Uint32& b ) {
+	std::swap( mPositions[a], mPositions[b] );
+	std::swap( mSpeeds[a], mSpeeds[b] );
+	std::swap( mAccelerations[a], mAccelerations[b] );
+	std::swap( mColors[a], mColors[b] );
+	std::swap( mDecays[a], mDecays[b] );
+	std::swap( mIds[a], mIds[b] );
+}
+
 void ParticleSystem::draw() {
 	if ( !mUsed )
 		return;
@@ -333,14 +435,24 @@ void ParticleSystem::draw() {
 		GLi->enable( GL_POINT_SPRITE );
 		GLi->pointSize( mSize );
 
-		Uint32 alloc = mPCount * sizeof( Particle );
+		if ( mBackend == Backend::SoA ) {
+			GLi->colorPointer( 4, GL_FP, sizeof( ColorAf ), mColors.data(),
+							   mAlive * sizeof( ColorAf ) );
+			GLi->vertexPointer( 2, GL_FP, sizeof( Vector2f ), mPositions.data(),
+								mAlive * sizeof( Vector2f ) );
 
-		GLi->colorPointer( 4, GL_FP, sizeof( Particle ),
-						   reinterpret_cast<char*>( &mParticle[0] ) + sizeof( Float ) * 2, alloc );
-		GLi->vertexPointer( 2, GL_FP, sizeof( Particle ), reinterpret_cast<char*>( &mParticle[0] ),
-							alloc );
+			GLi->drawArrays( GL_POINTS, 0, (int)mAlive );
+		} else {
+			Uint32 alloc = mPCount * sizeof( Particle );
 
-		GLi->drawArrays( GL_POINTS, 0, (int)mPCount );
+			GLi->colorPointer( 4, GL_FP, sizeof( Particle ),
+							   reinterpret_cast<char*>( &mParticle[0] ) + sizeof( Float ) * 2,
+							   alloc );
+			GLi->vertexPointer( 2, GL_FP, sizeof( Particle ),
+								reinterpret_cast<char*>( &mParticle[0] ), alloc );
+
+			GLi->drawArrays( GL_POINTS, 0, (int)mPCount );
+		}
 
 		GLi->disable( GL_POINT_SPRITE );
 		GLi->enable( GL_TEXTURE_2D );
@@ -353,14 +465,25 @@ void ParticleSystem::draw() {
 		BR->setBlendMode( mBlend );
 		BR->quadsBegin();
 
-		for ( Uint32 i = 0; i < mPCount; i++ ) {
-			P = &mParticle[i];
-
-			if ( P->isUsed() ) {
+		if ( mBackend == Backend::SoA ) {
+			for ( Uint32 i = 0; i < mAlive; i++ ) {
+				const ColorAf& C = mColors[i];
 				BR->quadsSetColor( Color(
-					static_cast<Uint8>( P->r() * 255 ), static_cast<Uint8>( P->g() * 255 ),
-					static_cast<Uint8>( P->b() * 255 ), static_cast<Uint8>( P->a() * 255 ) ) );
-				BR->batchQuad( P->getX() - mHSize, P->getY() - mHSize, mSize, mSize );
+					static_cast<Uint8>( C.r * 255 ), static_cast<Uint8>( C.g * 255 ),
+					static_cast<Uint8>( C.b * 255 ), static_cast<Uint8>( C.a * 255 ) ) );
+				BR->batchQuad( mPositions[i].x - mHSize, mPositions[i].y - mHSize, mSize, mSize );
+			}
+		} else {
+			for ( Uint32 i = 0; i < mPCount; i++ ) {
+				P = &mParticle[i];
+
+				if ( P->isUsed() ) {
+					BR->quadsSetColor( Color( static_cast<Uint8>( P->r() * 255 ),
+											  static_cast<Uint8>( P->g() * 255 ),
+											  static_cast<Uint8>( P->b() * 255 ),
+											  static_cast<Uint8>( P->a() * 255 ) ) );
+					BR->batchQuad( P->getX() - mHSize, P->getY() - mHSize, mSize, mSize );
+				}
 			}
 		}
 
@@ -376,6 +499,11 @@ void ParticleSystem::update( const System::Time& time ) {
 	if ( !mUsed )
 		return;
 
+	if ( mBackend == Backend::SoA ) {
+		updateSoA( time.asMilliseconds() * mTime );
+		return;
+	}
+
 	Particle* P;
 
 	for ( Uint32 i = 0; i < mPCount; i++ ) {
@@ -408,6 +536,68 @@ void ParticleSystem::update( const System::Time& time ) {
 	}
 }
 
+void ParticleSystem::updateSoA( const Float& time ) {
+	if ( mAlive == 0 )
+		return;
+
+	Uint32 chunks = ( mAlive + ParticlesChunkSize - 1 ) / ParticlesChunkSize;
+
+	if ( mDeadChunks.size() < chunks )
+		mDeadChunks.resize( chunks );
+
+	auto integrate = [this, time]( size_t chunk ) {
+		Uint32 start = chunk * ParticlesChunkSize;
+		Uint32 count = eemin( ParticlesChunkSize, mAlive - start );
+		std::vector<Uint32>& dead = mDeadChunks[chunk];
+
+		// The position is integrated with the previous speed, as Particle::update does
+		particlesIntegrate( &mPositions[start].x, &mSpeeds[start].x, time, count * 2 );
+		particlesIntegrate( &mSpeeds[start].x, &mAccelerations[start].x, time, count * 2 );
+		particlesDecay( &mColors[start].r, &mDecays[start].r, time, count * 4 );
+
+		dead.clear();
+
+		for ( Uint32 i = start; i < start + count; i++ )
+			if ( mColors[i].a <= 0.f )
+				dead.push_back( i );
+	};
+
+	if ( mThreadPool && mAlive > ParticlesParallelThreshold ) {
+		mThreadPool->parallelFor( chunks, integrate );
+	} else {
+		for ( Uint32 chunk = 0; chunk < chunks; chunk++ )
+			integrate( chunk );
+	}
+
+	// The dead particles are processed from the last one, so when a dead particle is swapped with
+	// the last alive particle, the swapped particle was already processed
+	for ( Uint32 chunk = chunks; chunk-- > 0; ) {
+		const std::vector<Uint32>& dead = mDeadChunks[chunk];
+
+		for ( auto it = dead.rbegin(); it != dead.rend(); ++it ) {
+			Uint32 i = *it;
+
+			if ( !mLoop ) {
+				if ( mLoops == 1 ) {
+					mAlive--;
+					swapParticles( i, mAlive );
+					mPLeft--;
+				} else {
+					if ( mIds[i] == 1 && mLoops > 0 )
+						mLoops--;
+
+					resetParticle( i );
+				}
+
+				if ( mPLeft == 0 )
+					mUsed = false;
+			} else {
+				resetParticle( i );
+			}
+		}
+	}
+}
+
 void ParticleSystem::end() {
 	mLoop = false;
 	mLoops = 1;
@@ -417,6 +607,12 @@ void ParticleSystem::reuse() {
 	mLoop = true;
 	mLoops = 0;
 
+	if ( mBackend == Backend::SoA ) {
+		// The dead particles are still stored after the alive ones
+		mAlive = mPCount;
+		return;
+	}
+
 	for ( Uint32 i = 0; i < mPCount; i++ )
 		mParticle[i].setUsed( true );
 }
@@ -509,4 +705,39 @@ void ParticleSystem::setAcceleration( const Vector2f& acc ) {
 	mAcc = acc;
 }
 
+void ParticleSystem::setBackend( const Backend& backend ) {
+	if ( backend == mBackend )
+		return;
+
+	mBackend = backend;
+
+	if ( mPCount > 0 )
+		begin();
+}
+
+const ParticleSystem::Backend& ParticleSystem::getBackend() const {
+	return mBackend;
+}
+
+void ParticleSystem::setThreadPool( const std::shared_ptr<ThreadPool>& threadPool ) {
+	mThreadPool = threadPool;
+}
+
+const std::shared_ptr<ThreadPool>& ParticleSystem::getThreadPool() const {
+	return mThreadPool;
+}
+
+Uint32 ParticleSystem::getAliveCount() const {
+	if ( mBackend == Backend::SoA )
+		return mAlive;
+
+	Uint32 alive = 0;
+
+	for ( Uint32 i = 0; NULL != mParticle && i < mPCount; i++ )
+		if ( mParticle[i].isUsed() )
+			alive++;
+
+	return alive;
+}
+
 }} // namespace EE::Graphics
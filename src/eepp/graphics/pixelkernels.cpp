@@ -0,0 +1,831 @@
+#include <cstring>
+#include <eepp/graphics/pixelkernels.hpp>
+#include <eepp/system/cpu.hpp>
+
+#if defined( EE_ARCH_X86_64 )
+#if defined( _MSC_VER )
+#include <intrin.h>
+#elif defined( __GNUC__ ) || defined( __clang__ )
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+#elif defined( EE_ARCH_ARM64 )
+#include <arm_neon.h>
+#endif
+
+#if defined( EE_ARCH_X86_64 ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+#define EE_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#else
+#define EE_TARGET_AVX2
+#endif
+
+namespace EE { namespace Graphics {
+
+static PixelKernels::Backend sBackend = PixelKernels::getBestBackend();
+
+PixelKernels::Backend PixelKernels::getBestBackend() {
+#if defined( EE_ARCH_X86_64 )
+	return CPU::hasAVX2() ? Backend::AVX2 : Backend::SSE2;
+#elif defined( EE_ARCH_ARM64 )
+	return CPU::hasNEON() ? Backend::NEON : Backend::Scalar;
+#else
+	return Backend::Scalar;
+#endif
+}
+
+PixelKernels::Backend PixelKernels::getBackend() {
+	return sBackend;
+}
+
+bool PixelKernels::isBackendSupported( const Backend& backend ) {
+	switch ( backend ) {
+		case Backend::Scalar:
+			return true;
+#if defined( EE_ARCH_X86_64 )
+		case Backend::SSE2:
+			return true;
+		case Backend::AVX2:
+			return CPU::hasAVX2();
+#elif defined( EE_ARCH_ARM64 )
+		case Backend::NEON:
+			return CPU::hasNEON();
+#endif
+		default:
+			return false;
+	}
+}
+
+bool PixelKernels::setBackend( const Backend& backend ) {
+	if ( !isBackendSupported( backend ) )
+		return false;
+	sBackend = backend;
+	return true;
+}
+
+const char* PixelKernels::backendToString( const Backend& backend ) {
+	switch ( backend ) {
+		case Backend::SSE2:
+			return "SSE2";
+		case Backend::AVX2:
+			return "AVX2";
+		case Backend::NEON:
+			return "NEON";
+		case Backend::Scalar:
+		default:
+			return "Scalar";
+	}
+}
+
+// Scalar kernels. They also process the tails left by the vectorized kernels.
+
+static inline Uint8 blendToU8( const Float& color ) {
+	return (Uint8)( color == 1.f ? 255 : ( color * 255.99f ) );
+}
+
+static void blendOverScalar( Uint8* dst, const Uint8* src, size_t count ) {
+	for ( size_t i = 0; i < count; i++, dst += 4, src += 4 ) {
+		Float sa = src[3] / 255.f;
+		Float da = dst[3] / 255.f;
+		Float alpha = sa + da * ( 1.f - sa );
+
+		if ( alpha == 0.f ) {
+			dst[0] = dst[1] = dst[2] = dst[3] = 0;
+			continue;
+		}
+
+		for ( int c = 0; c < 3; c++ ) {
+			Float sc = src[c] / 255.f;
+			Float dc = dst[c] / 255.f;
+			dst[c] = blendToU8( ( sc * sa + dc * da * ( 1.f - sa ) ) / alpha );
+		}
+
+		dst[3] = blendToU8( alpha );
+	}
+}
+
+static inline Uint8 premultiplyComponent( const Uint32& c, const Uint32& a ) {
+	Uint32 t = c * a + 128;
+	return (Uint8)( ( t + ( t >> 8 ) ) >> 8 );
+}
+
+static void premultiplyScalar( Uint8* pixels, size_t count ) {
+	for ( size_t i = 0; i < count; i++, pixels += 4 ) {
+		pixels[0] = premultiplyComponent( pixels[0], pixels[3] );
+		pixels[1] = premultiplyComponent( pixels[1], pixels[3] );
+		pixels[2] = premultiplyComponent( pixels[2], pixels[3] );
+	}
+}
+
+static inline Uint8 unpremultiplyComponent( const Uint8& c, const Uint8& a ) {
+	Float v = ( c * 255.f ) / a + 0.5f;
+	return (Uint8)( v > 255.f ? 255.f : v );
+}
+
+static void unpremultiplyScalar( Uint8* pixels, size_t count ) {
+	for ( size_t i = 0; i < count; i++, pixels += 4 ) {
+		Uint8 a = pixels[3];
+		if ( a == 0 ) {
+			pixels[0] = pixels[1] = pixels[2] = 0;
+		} else if ( a != 255 ) {
+			pixels[0] = unpremultiplyComponent( pixels[0], a );
+			pixels[1] = unpremultiplyComponent( pixels[1], a );
+			pixels[2] = unpremultiplyComponent( pixels[2], a );
+		}
+	}
+}
+
+static void replaceColor32Scalar( Uint8* pixels, size_t count, Uint32 key, Uint32 newColor ) {
+	for ( size_t i = 0; i < count; i++, pixels += 4 ) {
+		Uint32 px;
+		memcpy( &px, pixels, 4 );
+		if ( px == key )
+			memcpy( pixels, &newColor, 4 );
+	}
+}
+
+static void replaceColor8Scalar( Uint8* pixels, size_t count, Uint8 key, Uint8 newColor ) {
+	for ( size_t i = 0; i < count; i++ ) {
+		if ( pixels[i] == key )
+			pixels[i] = newColor;
+	}
+}
+
+static void swizzleScalar( Uint8* pixels, size_t count ) {
+	for ( size_t i = 0; i < count; i++, pixels += 4 ) {
+		Uint8 t = pixels[0];
+		pixels[0] = pixels[2];
+		pixels[2] = t;
+	}
+}
+
+static void rgbToRgbaScalar( Uint8* dst, const Uint8* src, size_t count, Uint8 alpha ) {
+	for ( size_t i = 0; i < count; i++, dst += 4, src += 3 ) {
+		dst[0] = src[0];
+		dst[1] = src[1];
+		dst[2] = src[2];
+		dst[3] = alpha;
+	}
+}
+
+static void rgbaToRgbScalar( Uint8* dst, const Uint8* src, size_t count ) {
+	for ( size_t i = 0; i < count; i++, dst += 3, src += 4 ) {
+		dst[0] = src[0];
+		dst[1] = src[1];
+		dst[2] = src[2];
+	}
+}
+
+static void grayToRgbaScalar( Uint8* dst, const Uint8* src, size_t count ) {
+	for ( size_t i = 0; i < count; i++, dst += 4 ) {
+		dst[0] = dst[1] = dst[2] = src[i];
+		dst[3] = 255;
+	}
+}
+
+static inline Uint8 luma( const Uint32& r, const Uint32& g, const Uint32& b ) {
+	return (Uint8)( ( r * 77 + g * 150 + b * 29 + 128 ) >> 8 );
+}
+
+static void rgbaToGrayScalar( Uint8* dst, const Uint8* src, size_t count ) {
+	for ( size_t i = 0; i < count; i++, src += 4 )
+		dst[i] = luma( src[0], src[1], src[2] );
+}
+
+#if defined( EE_ARCH_X86_64 )
+
+// SSE2 kernels ( always available in x86-64 )
+
+static void replaceColor32SSE2( Uint8* pixels, size_t count, Uint32 key, Uint32 newColor ) {
+	const __m128i keyVec = _mm_set1_epi32( (int)key );
+	const __m128i newVec = _mm_set1_epi32( (int)newColor );
+	size_t i = 0;
+	for ( ; i + 4 <= count; i += 4 ) {
+		__m128i px = _mm_loadu_si128( (const __m128i*)( pixels + i * 4 ) );
+		__m128i eq = _mm_cmpeq_epi32( px, keyVec );
+		px = _mm_or_si128( _mm_andnot_si128( eq, px ), _mm_and_si128( eq, newVec ) );
+		_mm_storeu_si128( (__m128i*)( pixels + i * 4 ), px );
+	}
+	replaceColor32Scalar( pixels + i * 4, count - i, key, newColor );
+}
+
+static void replaceColor8SSE2( Uint8* pixels, size_t count, Uint8 key, Uint8 newColor ) {
+	const __m128i keyVec = _mm_set1_epi8( (char)key );
+	const __m128i newVec = _mm_set1_epi8( (char)newColor );
+	size_t i = 0;
+	for ( ; i + 16 <= count; i += 16 ) {
+		__m128i px = _mm_loadu_si128( (const __m128i*)( pixels + i ) );
+		__m128i eq = _mm_cmpeq_epi8( px, keyVec );
+		px = _mm_or_si128( _mm_andnot_si128( eq, px ), _mm_and_si128( eq, newVec ) );
+		_mm_storeu_si128( (__m128i*)( pixels + i ), px );
+	}
+	replaceColor8Scalar( pixels + i, count - i, key, newColor );
+}
+
+static inline __m128 loadPixelSSE2( const Uint8* p ) {
+	int v;
+	memcpy( &v, p, 4 );
+	const __m128i zero = _mm_setzero_si128();
+	__m128i px = _mm_unpacklo_epi16( _mm_unpacklo_epi8( _mm_cvtsi32_si128( v ), zero ), zero );
+	return _mm_div_ps( _mm_cvtepi32_ps( px ), _mm_set1_ps( 255.f ) );
+}
+
+static void blendOverSSE2( Uint8* dst, const Uint8* src, size_t count ) {
+	const __m128 one = _mm_set1_ps( 1.f );
+	const __m128 scale = _mm_set1_ps( 255.99f );
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 alphaLane = _mm_castsi128_ps( _mm_set_epi32( -1, 0, 0, 0 ) );
+	const __m128i maxVal = _mm_set1_epi32( 255 );
+
+	for ( size_t i = 0; i < count; i++, dst += 4, src += 4 ) {
+		__m128 s = loadPixelSSE2( src );
+		__m128 d = loadPixelSSE2( dst );
+		__m128 sa = _mm_shuffle_ps( s, s, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+		__m128 da = _mm_shuffle_ps( d, d, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+		__m128 invSa = _mm_sub_ps( one, sa );
+		__m128 alpha = _mm_add_ps( sa, _mm_mul_ps( da, invSa ) );
+		__m128 res = _mm_div_ps(
+			_mm_add_ps( _mm_mul_ps( s, sa ), _mm_mul_ps( _mm_mul_ps( d, da ), invSa ) ), alpha );
+		res = _mm_or_ps( _mm_and_ps( alphaLane, alpha ), _mm_andnot_ps( alphaLane, res ) );
+		__m128i out = _mm_cvttps_epi32( _mm_mul_ps( res, scale ) );
+		__m128i isOne = _mm_castps_si128( _mm_cmpeq_ps( res, one ) );
+		out = _mm_or_si128( _mm_and_si128( isOne, maxVal ), _mm_andnot_si128( isOne, out ) );
+		out = _mm_andnot_si128( _mm_castps_si128( _mm_cmpeq_ps( alpha, zero ) ), out );
+		out = _mm_packus_epi16( _mm_packs_epi32( out, out ), out );
+		int v = _mm_cvtsi128_si32( out );
+		memcpy( dst, &v, 4 );
+	}
+}
+
+// Multiplies the 16 bit components by the 16 bit factors rounding the result as x / 255
+static inline __m128i mulDiv255SSE2( __m128i c, __m128i f ) {
+	__m128i t = _mm_add_epi16( _mm_mullo_epi16( c, f ), _mm_set1_epi16( 128 ) );
+	return _mm_srli_epi16( _mm_add_epi16( t, _mm_srli_epi16( t, 8 ) ), 8 );
+}
+
+static inline __m128i alphaFactorsSSE2( __m128i px16 ) {
+	// Broadcast the alpha of each pixel and keep the alpha component multiplied by 255
+	__m128i a = _mm_shufflehi_epi16( _mm_shufflelo_epi16( px16, _MM_SHUFFLE( 3, 3, 3, 3 ) ),
+									 _MM_SHUFFLE( 3, 3, 3, 3 ) );
+	const __m128i alphaMask = _mm_set_epi16( -1, 0, 0, 0, -1, 0, 0, 0 );
+	return _mm_or_si128( _mm_andnot_si128( alphaMask, a ),
+						 _mm_and_si128( alphaMask, _mm_set1_epi16( 255 ) ) );
+}
+
+static void premultiplySSE2( Uint8* pixels, size_t count ) {
+	const __m128i zero = _mm_setzero_si128();
+	size_t i = 0;
+	for ( ; i + 4 <= count; i += 4 ) {
+		__m128i px = _mm_loadu_si128( (const __m128i*)( pixels + i * 4 ) );
+		__m128i lo = _mm_unpacklo_epi8( px, zero );
+		__m128i hi = _mm_unpackhi_epi8( px, zero );
+		lo = mulDiv255SSE2( lo, alphaFactorsSSE2( lo ) );
+		hi = mulDiv255SSE2( hi, alphaFactorsSSE2( hi ) );
+		_mm_storeu_si128( (__m128i*)( pixels + i * 4 ), _mm_packus_epi16( lo, hi ) );
+	}
+	premultiplyScalar( pixels + i * 4, count - i );
+}
+
+static void unpremultiplySSE2( Uint8* pixels, size_t count ) {
+	const __m128 half = _mm_set1_ps( 0.5f );
+	const __m128 max = _mm_set1_ps( 255.f );
+	const __m128 alphaLane = _mm_castsi128_ps( _mm_set_epi32( -1, 0, 0, 0 ) );
+	const __m128i zero = _mm_setzero_si128();
+
+	for ( size_t i = 0; i < count; i++, pixels += 4 ) {
+		Uint8 a = pixels[3];
+		if ( a == 255 )
+			continue;
+		if ( a == 0 ) {
+			pixels[0] = pixels[1] = pixels[2] = 0;
+			continue;
+		}
+		int v;
+		memcpy( &v, pixels, 4 );
+		__m128 px = _mm_cvtepi32_ps(
+			_mm_unpacklo_epi16( _mm_unpacklo_epi8( _mm_cvtsi32_si128( v ), zero ), zero ) );
+		__m128 res = _mm_add_ps( _mm_div_ps( _mm_mul_ps( px, max ), _mm_set1_ps( (float)a ) ),
+								 half );
+		res = _mm_min_ps( res, max );
+		res = _mm_or_ps( _mm_and_ps( alphaLane, px ), _mm_andnot_ps( alphaLane, res ) );
+		__m128i out = _mm_cvttps_epi32( res );
+		out = _mm_packus_epi16( _mm_packs_epi32( out, out ), out );
+		v = _mm_cvtsi128_si32( out );
+		memcpy( pixels, &v, 4 );
+	}
+}
+
+static void swizzleSSE2( Uint8* pixels, size_t count ) {
+	const __m128i keep = _mm_set1_epi32( (int)0xFF00FF00 );
+	const __m128i low = _mm_set1_epi32( 0x000000FF );
+	size_t i = 0;
+	for ( ; i + 4 <= count; i += 4 ) {
+		__m128i px = _mm_loadu_si128( (const __m128i*)( pixels + i * 4 ) );
+		__m128i r = _mm_slli_epi32( _mm_and_si128( px, low ), 16 );
+		__m128i b = _mm_and_si128( _mm_srli_epi32( px, 16 ), low );
+		px = _mm_or_si128( _mm_and_si128( px, keep ), _mm_or_si128( r, b ) );
+		_mm_storeu_si128( (__m128i*)( pixels + i * 4 ), px );
+	}
+	swizzleScalar( pixels + i * 4, count - i );
+}
+
+static void grayToRgbaSSE2( Uint8* dst, const Uint8* src, size_t count ) {
+	const __m128i alpha = _mm_set1_epi32( (int)0xFF000000 );
+	size_t i = 0;
+	for ( ; i + 16 <= count; i += 16 ) {
+		__m128i g = _mm_loadu_si128( (const __m128i*)( src + i ) );
+		__m128i gg0 = _mm_unpacklo_epi8( g, g );
+		__m128i gg1 = _mm_unpackhi_epi8( g, g );
+		__m128i* out = (__m128i*)( dst + i * 4 );
+		_mm_storeu_si128( out + 0, _mm_or_si128( _mm_unpacklo_epi16( gg0, gg0 ), alpha ) );
+		_mm_storeu_si128( out + 1, _mm_or_si128( _mm_unpackhi_epi16( gg0, gg0 ), alpha ) );
+		_mm_storeu_si128( out + 2, _mm_or_si128( _mm_unpacklo_epi16( gg1, gg1 ), alpha ) );
+		_mm_storeu_si128( out + 3, _mm_or_si128( _mm_unpackhi_epi16( gg1, gg1 ), alpha ) );
+	}
+	grayToRgbaScalar( dst + i * 4, src + i, count - i );
+}
+
+static inline __m128i lumaSSE2( __m128i px ) {
+	// Returns the luma of 4 pixels in the 32 bits lanes
+	const __m128i low = _mm_set1_epi32( 0xFF );
+	__m128i r = _mm_and_si128( px, low );
+	__m128i g = _mm_and_si128( _mm_srli_epi32( px, 8 ), low );
+	__m128i b = _mm_and_si128( _mm_srli_epi32( px, 16 ), low );
+	// Every product and the sum fit in 16 bits, and the upper 16 bits of each lane are zero
+	__m128i y = _mm_add_epi16( _mm_mullo_epi16( r, _mm_set1_epi32( 77 ) ),
+							   _mm_mullo_epi16( g, _mm_set1_epi32( 150 ) ) );
+	y = _mm_add_epi16( y, _mm_mullo_epi16( b, _mm_set1_epi32( 29 ) ) );
+	y = _mm_add_epi16( y, _mm_set1_epi32( 128 ) );
+	return _mm_srli_epi32( y, 8 );
+}
+
+static void rgbaToGraySSE2( Uint8* dst, const Uint8* src, size_t count ) {
+	size_t i = 0;
+	for ( ; i + 16 <= count; i += 16 ) {
+		const __m128i* in = (const __m128i*)( src + i * 4 );
+		__m128i y0 = lumaSSE2( _mm_loadu_si128( in + 0 ) );
+		__m128i y1 = lumaSSE2( _mm_loadu_si128( in + 1 ) );
+		__m128i y2 = lumaSSE2( _mm_loadu_si128( in + 2 ) );
+		__m128i y3 = lumaSSE2( _mm_loadu_si128( in + 3 ) );
+		__m128i y01 = _mm_packs_epi32( y0, y1 );
+		__m128i y23 = _mm_packs_epi32( y2, y3 );
+		_mm_storeu_si128( (__m128i*)( dst + i ), _mm_packus_epi16( y01, y23 ) );
+	}
+	rgbaToGrayScalar( dst + i, src + i * 4, count - i );
+}
+
+// AVX2 kernels ( runtime dispatched )
+
+EE_TARGET_AVX2 static void replaceColor32AVX2( Uint8* pixels, size_t count, Uint32 key,
+											   Uint32 newColor ) {
+	const __m256i keyVec = _mm256_set1_epi32( (int)key );
+	const __m256i newVec = _mm256_set1_epi32( (int)newColor );
+	size_t i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		__m256i px = _mm256_loadu_si256( (const __m256i*)( pixels + i * 4 ) );
+		__m256i eq = _mm256_cmpeq_epi32( px, keyVec );
+		_mm256_storeu_si256( (__m256i*)( pixels + i * 4 ), _mm256_blendv_epi8( px, newVec, eq ) );
+	}
+	replaceColor32Scalar( pixels + i * 4, count - i, key, newColor );
+}
+
+EE_TARGET_AVX2 static void replaceColor8AVX2( Uint8* pixels, size_t count, Uint8 key,
+											  Uint8 newColor ) {
+	const __m256i keyVec = _mm256_set1_epi8( (char)key );
+	const __m256i newVec = _mm256_set1_epi8( (char)newColor );
+	size_t i = 0;
+	for ( ; i + 32 <= count; i += 32 ) {
+		__m256i px = _mm256_loadu_si256( (const __m256i*)( pixels + i ) );
+		__m256i eq = _mm256_cmpeq_epi8( px, keyVec );
+		_mm256_storeu_si256( (__m256i*)( pixels + i ), _mm256_blendv_epi8( px, newVec, eq ) );
+	}
+	replaceColor8Scalar( pixels + i, count - i, key, newColor );
+}
+
+EE_TARGET_AVX2 static void blendOverAVX2( Uint8* dst, const Uint8* src, size_t count ) {
+	const __m256 one = _mm256_set1_ps( 1.f );
+	const __m256 inv = _mm256_set1_ps( 255.f );
+	const __m256 scale = _mm256_set1_ps( 255.99f );
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 alphaLane = _mm256_castsi256_ps( _mm256_set_epi32( -1, 0, 0, 0, -1, 0, 0, 0 ) );
+	const __m256i maxVal = _mm256_set1_epi32( 255 );
+	size_t i = 0;
+
+	for ( ; i + 2 <= count; i += 2, dst += 8, src += 8 ) {
+		__m256 s = _mm256_div_ps(
+			_mm256_cvtepi32_ps( _mm256_cvtepu8_epi32( _mm_loadl_epi64( (const __m128i*)src ) ) ),
+			inv );
+		__m256 d = _mm256_div_ps(
+			_mm256_cvtepi32_ps( _mm256_cvtepu8_epi32( _mm_loadl_epi64( (const __m128i*)dst ) ) ),
+			inv );
+		__m256 sa = _mm256_permute_ps( s, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+		__m256 da = _mm256_permute_ps( d, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+		__m256 invSa = _mm256_sub_ps( one, sa );
+		__m256 alpha = _mm256_add_ps( sa, _mm256_mul_ps( da, invSa ) );
+		__m256 res = _mm256_div_ps( _mm256_add_ps( _mm256_mul_ps( s, sa ),
+												   _mm256_mul_ps( _mm256_mul_ps( d, da ), invSa ) ),
+									alpha );
+		res = _mm256_blendv_ps( res, alpha, alphaLane );
+		__m256i out = _mm256_cvttps_epi32( _mm256_mul_ps( res, scale ) );
+		out = _mm256_blendv_epi8( out, maxVal,
+								  _mm256_castps_si256( _mm256_cmp_ps( res, one, _CMP_EQ_OQ ) ) );
+		out = _mm256_andnot_si256(
+			_mm256_castps_si256( _mm256_cmp_ps( alpha, zero, _CMP_EQ_OQ ) ), out );
+		__m128i packed = _mm_packs_epi32( _mm256_castsi256_si128( out ),
+										  _mm256_extracti128_si256( out, 1 ) );
+		_mm_storel_epi64( (__m128i*)dst, _mm_packus_epi16( packed, packed ) );
+	}
+
+	blendOverSSE2( dst, src, count - i );
+}
+
+EE_TARGET_AVX2 static void premultiplyAVX2( Uint8* pixels, size_t count ) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i alphaShuffle =
+		_mm256_setr_epi8( 6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15, 6, 7, 6, 7, 6, 7,
+						  6, 7, 14, 15, 14, 15, 14, 15, 14, 15 );
+	const __m256i alphaMask = _mm256_set_epi16( -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0 );
+	const __m256i max = _mm256_set1_epi16( 255 );
+	const __m256i round = _mm256_set1_epi16( 128 );
+	size_t i = 0;
+
+	for ( ; i + 8 <= count; i += 8 ) {
+		__m256i px = _mm256_loadu_si256( (const __m256i*)( pixels + i * 4 ) );
+		__m256i halves[2] = { _mm256_unpacklo_epi8( px, zero ), _mm256_unpackhi_epi8( px, zero ) };
+		for ( auto& c : halves ) {
+			__m256i f = _mm256_shuffle_epi8( c, alphaShuffle );
+			f = _mm256_blendv_epi8( f, max, alphaMask );
+			__m256i t = _mm256_add_epi16( _mm256_mullo_epi16( c, f ), round );
+			c = _mm256_srli_epi16( _mm256_add_epi16( t, _mm256_srli_epi16( t, 8 ) ), 8 );
+		}
+		_mm256_storeu_si256( (__m256i*)( pixels + i * 4 ),
+							 _mm256_packus_epi16( halves[0], halves[1] ) );
+	}
+
+	premultiplySSE2( pixels + i * 4, count - i );
+}
+
+EE_TARGET_AVX2 static void swizzleAVX2( Uint8* pixels, size_t count ) {
+	const __m256i mask = _mm256_setr_epi8( 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15, 2,
+										   1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15 );
+	size_t i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		__m256i px = _mm256_loadu_si256( (const __m256i*)( pixels + i * 4 ) );
+		_mm256_storeu_si256( (__m256i*)( pixels + i * 4 ), _mm256_shuffle_epi8( px, mask ) );
+	}
+	swizzleScalar( pixels + i * 4, count - i );
+}
+
+EE_TARGET_AVX2 static void rgbToRgbaAVX2( Uint8* dst, const Uint8* src, size_t count,
+										  Uint8 alpha ) {
+	// Each 128 bits lane converts 4 RGB pixels ( 12 bytes ) into 4 RGBA pixels
+	const __m256i mask = _mm256_setr_epi8( 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1, 0,
+										   1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1 );
+	const __m256i alphaVec = _mm256_set1_epi32( (int)( (Uint32)alpha << 24 ) );
+	size_t i = 0;
+	// The second lane reads 16 bytes starting at the 12th byte, keep enough input bytes left
+	for ( ; i + 10 <= count; i += 8 ) {
+		__m256i px = _mm256_loadu2_m128i( (const __m128i*)( src + i * 3 + 12 ),
+										  (const __m128i*)( src + i * 3 ) );
+		px = _mm256_or_si256( _mm256_shuffle_epi8( px, mask ), alphaVec );
+		_mm256_storeu_si256( (__m256i*)( dst + i * 4 ), px );
+	}
+	rgbToRgbaScalar( dst + i * 4, src + i * 3, count - i, alpha );
+}
+
+EE_TARGET_AVX2 static void rgbaToRgbAVX2( Uint8* dst, const Uint8* src, size_t count ) {
+	const __m256i mask = _mm256_setr_epi8( 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+										   0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1 );
+	size_t i = 0;
+	// Each lane stores 16 bytes where only 12 are valid, the next store overwrites the rest
+	for ( ; i + 10 <= count; i += 8 ) {
+		__m256i px = _mm256_loadu_si256( (const __m256i*)( src + i * 4 ) );
+		px = _mm256_shuffle_epi8( px, mask );
+		_mm_storeu_si128( (__m128i*)( dst + i * 3 ), _mm256_castsi256_si128( px ) );
+		_mm_storeu_si128( (__m128i*)( dst + i * 3 + 12 ), _mm256_extracti128_si256( px, 1 ) );
+	}
+	rgbaToRgbScalar( dst + i * 3, src + i * 4, count - i );
+}
+
+EE_TARGET_AVX2 static void grayToRgbaAVX2( Uint8* dst, const Uint8* src, size_t count ) {
+	const __m256i spread = _mm256_set1_epi32( 0x00010101 );
+	const __m256i alpha = _mm256_set1_epi32( (int)0xFF000000 );
+	size_t i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		__m256i g = _mm256_cvtepu8_epi32( _mm_loadl_epi64( (const __m128i*)( src + i ) ) );
+		g = _mm256_or_si256( _mm256_mullo_epi32( g, spread ), alpha );
+		_mm256_storeu_si256( (__m256i*)( dst + i * 4 ), g );
+	}
+	grayToRgbaScalar( dst + i * 4, src + i, count - i );
+}
+
+#elif defined( EE_ARCH_ARM64 )
+
+// NEON kernels ( mandatory in AArch64 )
+
+static void replaceColor32NEON( Uint8* pixels, size_t count, Uint32 key, Uint32 newColor ) {
+	const uint32x4_t keyVec = vdupq_n_u32( key );
+	const uint32x4_t newVec = vdupq_n_u32( newColor );
+	size_t i = 0;
+	for ( ; i + 4 <= count; i += 4 ) {
+		uint32x4_t px = vreinterpretq_u32_u8( vld1q_u8( pixels + i * 4 ) );
+		px = vbslq_u32( vceqq_u32( px, keyVec ), newVec, px );
+		vst1q_u8( pixels + i * 4, vreinterpretq_u8_u32( px ) );
+	}
+	replaceColor32Scalar( pixels + i * 4, count - i, key, newColor );
+}
+
+static void replaceColor8NEON( Uint8* pixels, size_t count, Uint8 key, Uint8 newColor ) {
+	const uint8x16_t keyVec = vdupq_n_u8( key );
+	const uint8x16_t newVec = vdupq_n_u8( newColor );
+	size_t i = 0;
+	for ( ; i + 16 <= count; i += 16 ) {
+		uint8x16_t px = vld1q_u8( pixels + i );
+		vst1q_u8( pixels + i, vbslq_u8( vceqq_u8( px, keyVec ), newVec, px ) );
+	}
+	replaceColor8Scalar( pixels + i, count - i, key, newColor );
+}
+
+static inline float32x4_t loadPixelNEON( const Uint8* p ) {
+	Uint32 v;
+	memcpy( &v, p, 4 );
+	uint16x4_t px = vget_low_u16( vmovl_u8( vreinterpret_u8_u32( vdup_n_u32( v ) ) ) );
+	return vdivq_f32( vcvtq_f32_u32( vmovl_u16( px ) ), vdupq_n_f32( 255.f ) );
+}
+
+static void blendOverNEON( Uint8* dst, const Uint8* src, size_t count ) {
+	const float32x4_t one = vdupq_n_f32( 1.f );
+	const float32x4_t scale = vdupq_n_f32( 255.99f );
+	const uint32x4_t alphaLane = { 0, 0, 0, 0xFFFFFFFF };
+	const uint32x4_t maxVal = vdupq_n_u32( 255 );
+
+	for ( size_t i = 0; i < count; i++, dst += 4, src += 4 ) {
+		float32x4_t s = loadPixelNEON( src );
+		float32x4_t d = loadPixelNEON( dst );
+		float32x4_t sa = vdupq_laneq_f32( s, 3 );
+		float32x4_t da = vdupq_laneq_f32( d, 3 );
+		float32x4_t invSa = vsubq_f32( one, sa );
+		float32x4_t alpha = vaddq_f32( sa, vmulq_f32( da, invSa ) );
+		float32x4_t res = vdivq_f32(
+			vaddq_f32( vmulq_f32( s, sa ), vmulq_f32( vmulq_f32( d, da ), invSa ) ), alpha );
+		res = vbslq_f32( alphaLane, alpha, res );
+		uint32x4_t out = vcvtq_u32_f32( vmulq_f32( res, scale ) );
+		out = vbslq_u32( vceqq_f32( res, one ), maxVal, out );
+		out = vbicq_u32( out, vceqq_f32( alpha, vdupq_n_f32( 0.f ) ) );
+		uint8x8_t packed = vmovn_u16( vcombine_u16( vmovn_u32( out ), vmovn_u32( out ) ) );
+		vst1_lane_u32( (uint32_t*)dst, vreinterpret_u32_u8( packed ), 0 );
+	}
+}
+
+static void premultiplyNEON( Uint8* pixels, size_t count ) {
+	size_t i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		uint8x8x4_t px = vld4_u8( pixels + i * 4 );
+		for ( int c = 0; c < 3; c++ ) {
+			uint16x8_t t = vmull_u8( px.val[c], px.val[3] );
+			px.val[c] = vrshrn_n_u16( vrsraq_n_u16( t, t, 8 ), 8 );
+		}
+		vst4_u8( pixels + i * 4, px );
+	}
+	premultiplyScalar( pixels + i * 4, count - i );
+}
+
+static void swizzleNEON( Uint8* pixels, size_t count ) {
+	size_t i = 0;
+	for ( ; i + 16 <= count; i += 16 ) {
+		uint8x16x4_t px = vld4q_u8( pixels + i * 4 );
+		uint8x16_t t = px.val[0];
+		px.val[0] = px.val[2];
+		px.val[2] = t;
+		vst4q_u8( pixels + i * 4, px );
+	}
+	swizzleScalar( pixels + i * 4, count - i );
+}
+
+static void rgbToRgbaNEON( Uint8* dst, const Uint8* src, size_t count, Uint8 alpha ) {
+	size_t i = 0;
+	for ( ; i + 16 <= count; i += 16 ) {
+		uint8x16x3_t rgb = vld3q_u8( src + i * 3 );
+		uint8x16x4_t rgba = { { rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8( alpha ) } };
+		vst4q_u8( dst + i * 4, rgba );
+	}
+	rgbToRgbaScalar( dst + i * 4, src + i * 3, count - i, alpha );
+}
+
+static void rgbaToRgbNEON( Uint8* dst, const Uint8* src, size_t count ) {
+	size_t i = 0;
+	for ( ; i + 16 <= count; i += 16 ) {
+		uint8x16x4_t rgba = vld4q_u8( src + i * 4 );
+		uint8x16x3_t rgb = { { rgba.val[0], rgba.val[1], rgba.val[2] } };
+		vst3q_u8( dst + i * 3, rgb );
+	}
+	rgbaToRgbScalar( dst + i * 3, src + i * 4, count - i );
+}
+
+static void grayToRgbaNEON( Uint8* dst, const Uint8* src, size_t count ) {
+	size_t i = 0;
+	for ( ; i + 16 <= count; i += 16 ) {
+		uint8x16_t g = vld1q_u8( src + i );
+		uint8x16x4_t rgba = { { g, g, g, vdupq_n_u8( 255 ) } };
+		vst4q_u8( dst + i * 4, rgba );
+	}
+	grayToRgbaScalar( dst + i * 4, src + i, count - i );
+}
+
+static void rgbaToGrayNEON( Uint8* dst, const Uint8* src, size_t count ) {
+	size_t i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		uint8x8x4_t px = vld4_u8( src + i * 4 );
+		uint16x8_t y = vmull_u8( px.val[0], vdup_n_u8( 77 ) );
+		y = vmlal_u8( y, px.val[1], vdup_n_u8( 150 ) );
+		y = vmlal_u8( y, px.val[2], vdup_n_u8( 29 ) );
+		vst1_u8( dst + i, vshrn_n_u16( vaddq_u16( y, vdupq_n_u16( 128 ) ), 8 ) );
+	}
+	rgbaToGrayScalar( dst + i, src + i * 4, count - i );
+}
+
+#endif
+
+void PixelKernels::replaceColor( Uint8* pixels, const size_t& count, const Uint32& channels,
+								 const Color& colorKey, const Color& newColor ) {
+	if ( NULL == pixels )
+		return;
+
+	switch ( channels ) {
+		case 4: {
+			Uint32 key = colorKey.Value;
+			Uint32 val = newColor.Value;
+#if defined( EE_ARCH_X86_64 )
+			if ( sBackend == Backend::AVX2 )
+				return replaceColor32AVX2( pixels, count, key, val );
+			if ( sBackend == Backend::SSE2 )
+				return replaceColor32SSE2( pixels, count, key, val );
+#elif defined( EE_ARCH_ARM64 )
+			if ( sBackend == Backend::NEON )
+				return replaceColor32NEON( pixels, count, key, val );
+#endif
+			return replaceColor32Scalar( pixels, count, key, val );
+		}
+		case 1: {
+#if defined( EE_ARCH_X86_64 )
+			if ( sBackend == Backend::AVX2 )
+				return replaceColor8AVX2( pixels, count, colorKey.r, newColor.r );
+			if ( sBackend == Backend::SSE2 )
+				return replaceColor8SSE2( pixels, count, colorKey.r, newColor.r );
+#elif defined( EE_ARCH_ARM64 )
+			if ( sBackend == Backend::NEON )
+				return replaceColor8NEON( pixels, count, colorKey.r, newColor.r );
+#endif
+			return replaceColor8Scalar( pixels, count, colorKey.r, newColor.r );
+		}
+		case 3:
+		case 2: {
+			const Uint8* key = &colorKey.r;
+			const Uint8* val = &newColor.r;
+			for ( size_t i = 0; i < count; i++, pixels += channels ) {
+				if ( memcmp( pixels, key, channels ) == 0 )
+					memcpy( pixels, val, channels );
+			}
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+void PixelKernels::fill( Uint8* pixels, const size_t& count, const Uint32& channels,
+						 const Color& color ) {
+	if ( NULL == pixels || 0 == count || channels == 0 || channels > 4 )
+		return;
+
+	const Uint8* c = &color.r;
+
+	if ( channels == 1 ) {
+		memset( pixels, c[0], count );
+		return;
+	}
+
+	// Fill the first pixel and keep doubling the filled region
+	memcpy( pixels, c, channels );
+	size_t total = count * channels;
+	size_t filled = channels;
+	while ( filled < total ) {
+		size_t len = eemin( filled, total - filled );
+		memcpy( pixels + filled, pixels, len );
+		filled += len;
+	}
+}
+
+void PixelKernels::blendOver( Uint8* dst, const Uint8* src, const size_t& count ) {
+#if defined( EE_ARCH_X86_64 )
+	if ( sBackend == Backend::AVX2 )
+		return blendOverAVX2( dst, src, count );
+	if ( sBackend == Backend::SSE2 )
+		return blendOverSSE2( dst, src, count );
+#elif defined( EE_ARCH_ARM64 )
+	if ( sBackend == Backend::NEON )
+		return blendOverNEON( dst, src, count );
+#endif
+	blendOverScalar( dst, src, count );
+}
+
+void PixelKernels::premultiplyAlpha( Uint8* pixels, const size_t& count ) {
+#if defined( EE_ARCH_X86_64 )
+	if ( sBackend == Backend::AVX2 )
+		return premultiplyAVX2( pixels, count );
+	if ( sBackend == Backend::SSE2 )
+		return premultiplySSE2( pixels, count );
+#elif defined( EE_ARCH_ARM64 )
+	if ( sBackend == Backend::NEON )
+		return premultiplyNEON( pixels, count );
+#endif
+	premultiplyScalar( pixels, count );
+}
+
+void PixelKernels::unpremultiplyAlpha( Uint8* pixels, const size_t& count ) {
+	// The division dominates the cost, the AVX2 and NEON backends use the SSE2 / scalar path
+#if defined( EE_ARCH_X86_64 )
+	if ( sBackend != Backend::Scalar )
+		return unpremultiplySSE2( pixels, count );
+#endif
+	unpremultiplyScalar( pixels, count );
+}
+
+void PixelKernels::swizzleRedBlue( Uint8* pixels, const size_t& count ) {
+#if defined( EE_ARCH_X86_64 )
+	if ( sBackend == Backend::AVX2 )
+		return swizzleAVX2( pixels, count );
+	if ( sBackend == Backend::SSE2 )
+		return swizzleSSE2( pixels, count );
+#elif defined( EE_ARCH_ARM64 )
+	if ( sBackend == Backend::NEON )
+		return swizzleNEON( pixels, count );
+#endif
+	swizzleScalar( pixels, count );
+}
+
+void PixelKernels::rgbToRgba( Uint8* dst, const Uint8* src, const size_t& count,
+							  const Uint8& alpha ) {
+#if defined( EE_ARCH_X86_64 )
+	if ( sBackend == Backend::AVX2 )
+		return rgbToRgbaAVX2( dst, src, count, alpha );
+#elif defined( EE_ARCH_ARM64 )
+	if ( sBackend == Backend::NEON )
+		return rgbToRgbaNEON( dst, src, count, alpha );
+#endif
+	rgbToRgbaScalar( dst, src, count, alpha );
+}
+
+void PixelKernels::rgbaToRgb( Uint8* dst, const Uint8* src, const size_t& count ) {
+#if defined( EE_ARCH_X86_64 )
+	if ( sBackend == Backend::AVX2 )
+		return rgbaToRgbAVX2( dst, src, count );
+#elif defined( EE_ARCH_ARM64 )
+	if ( sBackend == Backend::NEON )
+		return rgbaToRgbNEON( dst, src, count );
+#endif
+	rgbaToRgbScalar( dst, src, count );
+}
+
+void PixelKernels::grayToRgba( Uint8* dst, const Uint8* src, const size_t& count ) {
+#if defined( EE_ARCH_X86_64 )
+	if ( sBackend == Backend::AVX2 )
+		return grayToRgbaAVX2( dst, src, count );
+	if ( sBackend == Backend::SSE2 )
+		return grayToRgbaSSE2( dst, src, count );
+#elif defined( EE_ARCH_ARM64 )
+	if ( sBackend == Backend::NEON )
+		return grayToRgbaNEON( dst, src, count );
+#endif
+	grayToRgbaScalar( dst, src, count );
+}
+
+void PixelKernels::rgbaToGray( Uint8* dst, const Uint8* src, const size_t& count ) {
+#if defined( EE_ARCH_X86_64 )
+	if ( sBackend != Backend::Scalar )
+		return rgbaToGraySSE2( dst, src, count );
+#elif defined( EE_ARCH_ARM64 )
+	if ( sBackend == Backend::NEON )
+		return rgbaToGrayNEON( dst, src, count );
+#endif
+	rgbaToGrayScalar( dst, src, count );
+}
+
+void PixelKernels::convertChannels( Uint8* dst, const Uint32& dstChannels, const Uint8* src,
+									const Uint32& srcChannels, const size_t& count ) {
+	if ( dstChannels == srcChannels ) {
+		memcpy( dst, src, count * srcChannels );
+	} else if ( srcChannels == 3 && dstChannels == 4 ) {
+		rgbToRgba( dst, src, count );
+	} else if ( srcChannels == 4 && dstChannels == 3 ) {
+		rgbaToRgb( dst, src, count );
+	} else {
+		Uint32 common = eemin( srcChannels, dstChannels );
+		for ( size_t i = 0; i < count; i++, dst += dstChannels, src += srcChannels ) {
+			memcpy( dst, src, common );
+			for ( Uint32 c = common; c < dstChannels; c++ )
+				dst[c] = 255;
+		}
+	}
+}
+
+}} // namespace EE::Graphics
@@ -3,6 +3,7 @@
 #include <eepp/graphics/text.hpp>
 #include <eepp/graphics/textlayout.hpp>
 #include <eepp/graphics/textshaperun.hpp>
+#include <atomic>
 
 #ifdef EE_TEXT_SHAPER_ENABLED
 #include <SheenBidi/SheenBidi.h>
@@ -141,12 +142,68 @@ static void segmentString( TextLayout& result, String::View input, Callable cb,
 	SBAlgorithmRelease( algorithm );
 }
 
+// Words longer than this are shaped but not cached, they are rarely repeated.
+static constexpr std::size_t ShapedWordMaxLength = 128;
+
+struct ShapedWord {
+	String text;
+	std::vector<hb_glyph_info_t> infos;
+	std::vector<hb_glyph_position_t> positions;
+};
+
+using ShapedWordCache = LRUCache<4096, Uint64, std::shared_ptr<const ShapedWord>>;
+
+// Incremented by clearLayoutCache, the per-thread word caches compare it to know they are stale.
+static std::atomic<Uint64> sShapedWordCacheGeneration{ 0 };
+
+// Editing a word only reshapes that word, the rest of the line is a cache hit. The cache is kept
+// per thread so it never needs locking, but the layouts are still computed from the main thread,
+// since FontTrueType loads the glyphs there.
+static ShapedWordCache& getShapedWordCache() {
+	thread_local static std::unique_ptr<ShapedWordCache> sCache(
+		std::make_unique<ShapedWordCache>() );
+	thread_local static Uint64 sGeneration = 0;
+	Uint64 generation = sShapedWordCacheGeneration.load( std::memory_order_relaxed );
+	if ( sGeneration != generation ) {
+		sCache->clear();
+		sGeneration = generation;
+	}
+	return *sCache;
+}
+
+struct ShapedRunBuffer {
+	std::vector<hb_glyph_info_t> infos;
+	std::vector<hb_glyph_position_t> positions;
+};
+
+static ShapedRunBuffer& getShapedRunBuffer() {
+	thread_local static ShapedRunBuffer sBuffer;
+	return sBuffer;
+}
+
+static inline bool isWordSeparator( String::StringBaseType ch ) {
+	return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+static inline Uint64 shapedWordHash( const String::View& word, FontTrueType* font,
+									 Uint32 characterSize, const hb_segment_properties_t& props,
+									 bool featuresEnabled ) {
+	return hashCombine( std::hash<String::View>()( word ), std::hash<FontTrueType*>()( font ),
+						std::hash<Uint32>()( characterSize ),
+						std::hash<Uint32>()( static_cast<Uint32>( props.direction ) ),
+						std::hash<Uint32>()( static_cast<Uint32>( props.script ) ),
+						std::hash<const void*>()( props.language ),
+						std::hash<bool>()( featuresEnabled ) );
+}
+
 template <typename Callable>
-static void shapeAndRun( TextLayout& result, const String& string, FontTrueType* font,
+static void shapeAndRun( TextLayout& result, String::View input, FontTrueType* font,
 						 Uint32 characterSize, Uint32 style, Float outlineThickness,
 						 TextDirection baseDirection, Callable cb ) {
-	String::View input = string.view();
 	hb_buffer_t* hbBuffer = getThreadLocalHbBuffer();
+	ShapedWordCache& wordCache = getShapedWordCache();
+	ShapedRunBuffer& runBuffer = getShapedRunBuffer();
+	SmallVector<std::pair<std::size_t, std::size_t>, 32> words;
 
 	segmentString(
 		result, input,
@@ -160,14 +217,16 @@ static void shapeAndRun( TextLayout& result, const String& string, FontTrueType*
 					run.next();
 					continue;
 				}
+
+				if ( !font || !font->hb() ) {
+					eeASSERT( font && font->hb() );
+					break;
+				}
+
 				String::View curRun( run.curRun() );
 				font->setCurrentSize( characterSize );
-				hb_buffer_reset( hbBuffer );
-				hb_buffer_set_cluster_level( hbBuffer,
-											 HB_BUFFER_CLUSTER_LEVEL_MONOTONE_CHARACTERS );
-				hb_buffer_add_utf32( hbBuffer, (Uint32*)curRun.data(), curRun.size(), 0,
-									 curRun.size() );
 
+				hb_buffer_reset( hbBuffer );
 				hb_buffer_set_direction( hbBuffer, segment.direction );
 				hb_buffer_set_script( hbBuffer, segment.script );
 				hb_buffer_guess_segment_properties( hbBuffer );
@@ -190,21 +249,81 @@ static void shapeAndRun( TextLayout& result, const String& string, FontTrueType*
 				// whitelist cross-platforms shapers only
 				static const char* shaper_list[] = { "ot", "graphite2", "fallback", nullptr };
 
-				if ( !font || !font->hb() ) {
-					eeASSERT( font && font->hb() );
-					break;
+				// Split the run in words and separators, the shaping doesn't cross them
+				words.clear();
+				for ( std::size_t start = 0; start < curRun.size(); ) {
+					bool separator = isWordSeparator( curRun[start] );
+					std::size_t end = start + 1;
+					while ( end < curRun.size() && isWordSeparator( curRun[end] ) == separator )
+						++end;
+					words.push_back( { start, end - start } );
+					start = end;
 				}
 
-				hb_shape_full( static_cast<hb_font_t*>( font->hb() ), hbBuffer, features,
-							   eeARRAY_SIZE( features ), shaper_list );
+				runBuffer.infos.clear();
+				runBuffer.positions.clear();
+
+				// Backward runs are in visual order, so the last word goes first
+				bool backward = HB_DIRECTION_IS_BACKWARD( props.direction );
+				for ( std::size_t w = 0; w < words.size(); ++w ) {
+					const auto& word = words[backward ? words.size() - 1 - w : w];
+					String::View wordText( curRun.substr( word.first, word.second ) );
+					bool cacheable = wordText.size() <= ShapedWordMaxLength;
+					Uint64 hash = 0;
+					std::shared_ptr<const ShapedWord> shaped;
+
+					if ( cacheable ) {
+						hash = shapedWordHash( wordText, font, characterSize, props,
+											   featuresEnabled != 0 );
+						auto cacheHit = wordCache.get( hash );
+						if ( cacheHit.has_value() && ( *cacheHit )->text.view() == wordText )
+							shaped = *cacheHit;
+					}
+
+					const hb_glyph_info_t* glyphInfo;
+					const hb_glyph_position_t* glyphPos;
+					unsigned int glyphCount;
+
+					if ( shaped ) {
+						glyphInfo = shaped->infos.data();
+						glyphPos = shaped->positions.data();
+						glyphCount = shaped->infos.size();
+					} else {
+						hb_buffer_reset( hbBuffer );
+						hb_buffer_set_cluster_level( hbBuffer,
+													 HB_BUFFER_CLUSTER_LEVEL_MONOTONE_CHARACTERS );
+						hb_buffer_add_utf32( hbBuffer, (Uint32*)wordText.data(), wordText.size(),
+											 0, wordText.size() );
+						hb_buffer_set_segment_properties( hbBuffer, &props );
+						hb_shape_full( static_cast<hb_font_t*>( font->hb() ), hbBuffer, features,
+									   eeARRAY_SIZE( features ), shaper_list );
+
+						// from the shaped text we get the glyphs and positions
+						glyphInfo = hb_buffer_get_glyph_infos( hbBuffer, &glyphCount );
+						glyphPos = hb_buffer_get_glyph_positions( hbBuffer, &glyphCount );
+
+						if ( cacheable ) {
+							auto newWord = std::make_shared<ShapedWord>();
+							newWord->text = String( wordText );
+							newWord->infos.assign( glyphInfo, glyphInfo + glyphCount );
+							newWord->positions.assign( glyphPos, glyphPos + glyphCount );
+							wordCache.put( hash, newWord );
+						}
+					}
 
-				// from the shaped text we get the glyphs and positions
-				unsigned int glyphCount;
-				hb_glyph_info_t* glyphInfo = hb_buffer_get_glyph_infos( hbBuffer, &glyphCount );
-				hb_glyph_position_t* glyphPos =
-					hb_buffer_get_glyph_positions( hbBuffer, &glyphCount );
+					// The clusters are relative to the word, the callback expects them relative
+					// to the run
+					std::size_t first = runBuffer.infos.size();
+					runBuffer.infos.insert( runBuffer.infos.end(), glyphInfo,
+											glyphInfo + glyphCount );
+					runBuffer.positions.insert( runBuffer.positions.end(), glyphPos,
+												glyphPos + glyphCount );
+					for ( std::size_t i = first; i < runBuffer.infos.size(); ++i )
+						runBuffer.infos[i].cluster += word.first;
+				}
 
-				if ( cb( glyphInfo, glyphPos, glyphCount, props, segment, run ) )
+				if ( cb( runBuffer.infos.data(), runBuffer.positions.data(),
+						 runBuffer.infos.size(), props, segment, run ) )
 					run.next();
 				else {
 					return false;
@@ -245,6 +364,9 @@ static LRULayoutCache& getLayoutCache( bool invalidate = false ) {
 
 void TextLayout::clearLayoutCache() {
 	getLayoutCache( true );
+#ifdef EE_TEXT_SHAPER_ENABLED
+	sShapedWordCacheGeneration.fetch_add( 1, std::memory_order_relaxed );
+#endif
 }
 
 TextLayout::Cache TextLayout::layout( const String::View& string, Font* font,
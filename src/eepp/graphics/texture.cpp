@@ -611,6 +611,70 @@ void Texture::replace( Image* image ) {
 	onResourceChange();
 }
 
+void Texture::replace( Image* image, const std::vector<Image*>& mipmaps ) {
+	if ( mipmaps.empty() || ( !GLi->isExtension( EEGL_ARB_texture_non_power_of_two ) &&
+							  ( !Math::isPow2( image->getWidth() ) ||
+								!Math::isPow2( image->getHeight() ) ) ) ) {
+		setMipmap( !mipmaps.empty() || getMipmap() );
+		replace( image );
+		return;
+	}
+
+	bool threaded =
+		Engine::instance()->isSharedGLContextEnabled() && !Engine::instance()->isMainThread();
+
+	if ( threaded )
+		Engine::instance()->getCurrentWindow()->setGLContextThread();
+
+	{
+		if ( 0 == mTexture ) {
+			unsigned int texture = 0;
+			glGenTextures( 1, &texture );
+			mTexture = texture;
+		}
+
+		ScopedTexture saver( mTexture );
+
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+
+		for ( size_t level = 0; level <= mipmaps.size(); level++ ) {
+			Image* img = level == 0 ? image : mipmaps[level - 1];
+			unsigned int format = convertPixelFormatToGLFormat(
+				channelsToPixelFormat( img->getChannels() ) );
+
+			glTexImage2D( GL_TEXTURE_2D, (GLint)level, format, img->getWidth(), img->getHeight(),
+						  0, format, GL_UNSIGNED_BYTE, img->getPixelsPtr() );
+		}
+
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+
+		mWidth = mImgWidth = image->getWidth();
+		mHeight = mImgHeight = image->getHeight();
+		mChannels = image->getChannels();
+		mFlags |= TEX_FLAG_MIPMAP;
+
+		TextureFactory::instance()->mMemSize -= mSize;
+		mSize = 0;
+		for ( size_t level = 0; level <= mipmaps.size(); level++ )
+			mSize += ( level == 0 ? image : mipmaps[level - 1] )->getMemSize();
+		TextureFactory::instance()->mMemSize += mSize;
+
+		applyClampMode();
+		iTextureFilter( mFilter );
+
+		if ( hasLocalCopy() ) {
+			// Renew the local copy
+			allocate( image->getMemSize(), Color( 0, 0, 0, 0 ), false );
+			Image::copyImage( image );
+		}
+	}
+
+	if ( threaded )
+		Engine::instance()->getCurrentWindow()->unsetGLContextThread();
+
+	onResourceChange();
+}
+
 const String::HashType& Texture::getHashName() const {
 	return mId;
 }
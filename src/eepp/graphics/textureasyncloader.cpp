@@ -0,0 +1,245 @@
+#include <eepp/graphics/textureasyncloader.hpp>
+#include <eepp/graphics/texturefactory.hpp>
+#include <eepp/system/clock.hpp>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/log.hpp>
+#include <eepp/system/profiler.hpp>
+#include <eepp/system/sys.hpp>
+
+namespace EE { namespace Graphics {
+
+SINGLETON_DECLARE_IMPLEMENTATION( TextureAsyncLoader )
+
+// Generates the next mipmap level averaging every 2x2 block of pixels
+static Image* halfSize( const Image* src ) {
+	Uint32 sw = src->getWidth();
+	Uint32 sh = src->getHeight();
+	Uint32 ch = src->getChannels();
+	Uint32 dw = eemax( 1u, sw / 2 );
+	Uint32 dh = eemax( 1u, sh / 2 );
+	Image* dst = Image::New( dw, dh, ch );
+	const Uint8* sp = src->getPixelsPtr();
+	Uint8* dp = dst->getPixels();
+
+	for ( Uint32 y = 0; y < dh; y++ ) {
+		const Uint8* row0 = &sp[( eemin( y * 2, sh - 1 ) * sw ) * ch];
+		const Uint8* row1 = &sp[( eemin( y * 2 + 1, sh - 1 ) * sw ) * ch];
+
+		for ( Uint32 x = 0; x < dw; x++ ) {
+			Uint32 x0 = eemin( x * 2, sw - 1 ) * ch;
+			Uint32 x1 = eemin( x * 2 + 1, sw - 1 ) * ch;
+
+			for ( Uint32 c = 0; c < ch; c++ ) {
+				*dp++ = (Uint8)( ( row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2 ) >>
+								 2 );
+			}
+		}
+	}
+
+	return dst;
+}
+
+TextureAsyncLoader::TextureAsyncLoader() {}
+
+TextureAsyncLoader::~TextureAsyncLoader() {
+	// Wait for the decoding tasks still running, they reference this instance
+	while ( mDecoding > 0 )
+		Sys::sleep( Milliseconds( 1 ) );
+
+	Lock l( mMutex );
+	mUploads.clear();
+}
+
+Texture* TextureAsyncLoader::loadFromFile( const std::string& filepath, const bool& mipmap,
+										   const Texture::ClampMode& clampMode,
+										   const Image::FormatConfiguration& formatConfiguration,
+										   const OnTextureLoaded& onLoaded ) {
+	Texture* texture = TextureFactory::instance()->getByName( filepath );
+
+	if ( NULL != texture )
+		return texture;
+
+	if ( !FileSystem::fileExists( filepath ) )
+		return NULL;
+
+	texture = TextureFactory::instance()->createEmptyTexture(
+		1, 1, 4, Color::Transparent, mipmap, clampMode, false, false, filepath );
+
+	decode(
+		texture,
+		[filepath, formatConfiguration]() -> Image* {
+			return Image::New( filepath, 0, formatConfiguration );
+		},
+		onLoaded );
+
+	return texture;
+}
+
+void TextureAsyncLoader::loadFromMemory( Texture* texture, std::string&& data,
+										 const Image::FormatConfiguration& formatConfiguration,
+										 const OnTextureLoaded& onLoaded ) {
+	if ( NULL == texture || data.empty() )
+		return;
+
+	auto buffer = std::make_shared<std::string>( std::move( data ) );
+
+	decode(
+		texture,
+		[buffer, formatConfiguration]() -> Image* {
+			return Image::New( (const Uint8*)buffer->data(), buffer->size(), 0,
+							   formatConfiguration );
+		},
+		onLoaded );
+}
+
+void TextureAsyncLoader::decode( Texture* texture, const std::function<Image*()>& decoder,
+								 const OnTextureLoaded& onLoaded ) {
+	auto upload = std::make_shared<Upload>();
+	upload->texture = texture;
+	upload->textureId = texture->getTextureId();
+	upload->onLoaded = onLoaded;
+	bool mipmaps = mWorkerMipmaps && texture->getMipmap();
+
+	mDecoding++;
+
+	getThreadPool()->run( [this, upload, decoder, mipmaps] {
+		EE_PROFILE_ZONE_CATEGORY( "TextureAsyncLoader::decode", "io" );
+		Image* image = decoder();
+
+		if ( NULL != image && NULL != image->getPixelsPtr() ) {
+			upload->image.reset( image );
+			upload->bytes = image->getMemSize();
+
+			if ( mipmaps ) {
+				const Image* level = image;
+
+				while ( level->getWidth() > 1 || level->getHeight() > 1 ) {
+					upload->mipmaps.emplace_back( halfSize( level ) );
+					level = upload->mipmaps.back().get();
+					upload->bytes += level->getMemSize();
+				}
+			}
+		} else {
+			eeSAFE_DELETE( image );
+		}
+
+		{
+			Lock l( mMutex );
+			mUploads.emplace_back( std::make_unique<Upload>( std::move( *upload ) ) );
+		}
+
+		mDecoding--;
+	} );
+}
+
+void TextureAsyncLoader::upload( Upload& upload ) {
+	// The placeholder could had been released while the image was being decoded
+	if ( TextureFactory::instance()->getTexture( upload.textureId ) != upload.texture ) {
+		if ( upload.onLoaded )
+			upload.onLoaded( nullptr );
+		return;
+	}
+
+	if ( !upload.image ) {
+		Log::warning( "TextureAsyncLoader: failed to decode texture \"%s\": %s",
+					  upload.texture->getName().c_str(), Image::getLastFailureReason().c_str() );
+
+		if ( upload.onLoaded )
+			upload.onLoaded( nullptr );
+		return;
+	}
+
+	if ( upload.mipmaps.empty() ) {
+		upload.texture->replace( upload.image.get() );
+	} else {
+		std::vector<Image*> mipmaps;
+		mipmaps.reserve( upload.mipmaps.size() );
+		for ( auto& mipmap : upload.mipmaps )
+			mipmaps.push_back( mipmap.get() );
+		upload.texture->replace( upload.image.get(), mipmaps );
+	}
+
+	if ( upload.onLoaded )
+		upload.onLoaded( upload.texture );
+}
+
+size_t TextureAsyncLoader::update() {
+	EE_PROFILE_ZONE( "TextureAsyncLoader::update" );
+	size_t uploaded = 0;
+	Uint64 bytes = 0;
+	Clock clock;
+
+	while ( true ) {
+		std::unique_ptr<Upload> next;
+
+		{
+			Lock l( mMutex );
+
+			if ( mUploads.empty() )
+				break;
+
+			// Always upload at least one texture per frame, even if it's bigger than the budget
+			if ( uploaded > 0 &&
+				 ( ( mUploadBytesBudget > 0 &&
+					 bytes + mUploads.front()->bytes > mUploadBytesBudget ) ||
+				   ( mUploadTimeBudget != Time::Zero &&
+					 clock.getElapsedTime() >= mUploadTimeBudget ) ) )
+				break;
+
+			next = std::move( mUploads.front() );
+			mUploads.pop_front();
+		}
+
+		bytes += next->bytes;
+		upload( *next );
+		uploaded++;
+	}
+
+	return uploaded;
+}
+
+const std::shared_ptr<ThreadPool>& TextureAsyncLoader::getThreadPool() {
+	// Fallback for applications that don't share a thread pool
+	if ( !mThreadPool )
+		mThreadPool = ThreadPool::createShared( eemax( 1, Sys::getCPUCount() - 1 ) );
+	return mThreadPool;
+}
+
+void TextureAsyncLoader::setThreadPool( const std::shared_ptr<ThreadPool>& threadPool ) {
+	mThreadPool = threadPool;
+}
+
+bool TextureAsyncLoader::hasThreadPool() const {
+	return mThreadPool != nullptr;
+}
+
+void TextureAsyncLoader::setUploadBytesBudget( const Uint64& bytes ) {
+	mUploadBytesBudget = bytes;
+}
+
+const Uint64& TextureAsyncLoader::getUploadBytesBudget() const {
+	return mUploadBytesBudget;
+}
+
+void TextureAsyncLoader::setUploadTimeBudget( const Time& time ) {
+	mUploadTimeBudget = time;
+}
+
+const Time& TextureAsyncLoader::getUploadTimeBudget() const {
+	return mUploadTimeBudget;
+}
+
+void TextureAsyncLoader::setWorkerMipmaps( const bool& workerMipmaps ) {
+	mWorkerMipmaps = workerMipmaps;
+}
+
+const bool& TextureAsyncLoader::getWorkerMipmaps() const {
+	return mWorkerMipmaps;
+}
+
+size_t TextureAsyncLoader::getPendingCount() const {
+	Lock l( mMutex );
+	return mDecoding + mUploads.size();
+}
+
+}} // namespace EE::Graphics
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <atomic>
 #include <eepp/graphics/texturepacker.hpp>
 #include <eepp/graphics/texturepackernode.hpp>
 #include <eepp/graphics/texturepackertex.hpp>
@@ -402,34 +403,36 @@ void TexturePacker::insertTexture( TexturePackerTex* t, TexturePackerNode* bestF
 
 void TexturePacker::createChild() {
 	mChild = TexturePacker::New( mWidth, mHeight, mPixelDensity / 100.f, mForcePowOfTwo,
-								 mScalableSVG, mPixelBorder, mTextureFilter, mAllowFlipping );
+								 mScalableSVG, mPixelBorder, mTextureFilter, mAllowChildren,
+								 mAllowFlipping );
+	mChild->mParent = this;
+	mChild->mThreadPool = mThreadPool;
 
-	std::vector<TexturePackerTex*>::iterator it;
-	std::vector<std::vector<TexturePackerTex*>::iterator> remove;
-
-	TexturePackerTex* t = NULL;
-
-	for ( it = mTextures.begin(); it != mTextures.end(); ++it ) {
-		t = ( *it );
+	std::vector<TexturePackerTex*> textures;
+	textures.reserve( mTextures.size() );
 
-		if ( !t->placed() ) {
-			mChild->addTexture( t->name() );
-			mChild->mParent = this;
+	for ( TexturePackerTex* t : mTextures ) {
+		if ( t->placed() ) {
+			textures.push_back( t );
+			continue;
+		}
 
-			t->disabled( true );
+		if ( NULL != t->getImage() ) {
+			mChild->addImage( t->getImage(), t->name() );
+		} else {
+			// The image was already probed, no need to read the header again
+			mChild->addPackerTex( eeNew( TexturePackerTex,
+										 ( t->name(), t->width() - mPixelBorder,
+										   t->height() - mPixelBorder, t->channels() ) ) );
+		}
 
-			remove.push_back( it );
+		mCount--;
 
-			mCount--;
-		}
+		eeDelete( t );
 	}
 
 	// Removes the non-placed textures from the pack
-	std::vector<std::vector<TexturePackerTex*>::iterator>::iterator itit;
-
-	for ( itit = remove.begin(); itit != remove.end(); ++itit ) {
-		mTextures.erase( *itit );
-	}
+	mTextures = std::move( textures );
 
 	mChild->packTextures();
 }
@@ -441,18 +444,99 @@ bool TexturePacker::addTexturesPath( std::string TexturesPath ) {
 		std::vector<std::string> files = FileSystem::filesGetInPath( TexturesPath );
 		std::sort( files.begin(), files.end() );
 
+		std::vector<std::string> paths;
+		paths.reserve( files.size() );
+
 		for ( Uint32 i = 0; i < files.size(); i++ ) {
 			std::string path( TexturesPath + files[i] );
 			if ( !FileSystem::isDirectory( path ) && Image::isImageExtension( path ) )
-				addTexture( path );
+				paths.emplace_back( std::move( path ) );
 		}
 
+		addTextures( paths );
+
 		return true;
 	}
 
 	return false;
 }
 
+Uint32 TexturePacker::addTextures( const std::vector<std::string>& TexturesPaths ) {
+	if ( !mThreadPool ) {
+		Uint32 added = 0;
+
+		for ( const auto& path : TexturesPaths )
+			added += addTexture( path ) ? 1 : 0;
+
+		return added;
+	}
+
+	Image::FormatConfiguration imageFormatConfiguration;
+	imageFormatConfiguration.svgScale( mScalableSVG ? mPixelDensity / 100.f : 1.f );
+
+	// Probe the headers in parallel, the packing only needs the images dimensions
+	std::vector<TexturePackerTex*> probed( TexturesPaths.size(), nullptr );
+
+	forEachIndex( TexturesPaths.size(), [&]( size_t i ) {
+		if ( FileSystem::fileExists( TexturesPaths[i] ) )
+			probed[i] = eeNew( TexturePackerTex, ( TexturesPaths[i], imageFormatConfiguration ) );
+	} );
+
+	// Keep the same order that sequential insertions would produce
+	size_t first = mTextures.size();
+	Uint32 added = 0;
+
+	for ( TexturePackerTex* t : probed ) {
+		if ( NULL == t )
+			continue;
+
+		if ( t->loadedInfo() &&
+			 ( ( t->width() + mPixelBorder <= mMaxSize.getWidth() &&
+				 t->height() + mPixelBorder <= mMaxSize.getHeight() ) ||
+			   ( mAllowFlipping && ( t->width() + mPixelBorder <= mMaxSize.getHeight() &&
+									 t->height() + mPixelBorder <= mMaxSize.getWidth() ) ) ) ) {
+			mTotalArea += t->area();
+			mTextures.push_back( t );
+			added++;
+		} else {
+			eeDelete( t );
+		}
+	}
+
+	if ( added ) {
+		std::stable_sort( mTextures.begin() + first, mTextures.end(),
+						  []( const TexturePackerTex* a, const TexturePackerTex* b ) {
+							  return a->area() > b->area();
+						  } );
+		std::inplace_merge( mTextures.begin(), mTextures.begin() + first, mTextures.end(),
+							[]( const TexturePackerTex* a, const TexturePackerTex* b ) {
+								return a->area() > b->area();
+							} );
+	}
+
+	return added;
+}
+
+void TexturePacker::setThreadPool( const std::shared_ptr<ThreadPool>& threadPool ) {
+	mThreadPool = threadPool;
+
+	if ( NULL != mChild )
+		mChild->setThreadPool( threadPool );
+}
+
+const std::shared_ptr<ThreadPool>& TexturePacker::getThreadPool() const {
+	return mThreadPool;
+}
+
+void TexturePacker::forEachIndex( const size_t& count, const std::function<void( size_t )>& fn ) {
+	if ( mThreadPool && count > 1 ) {
+		mThreadPool->parallelFor( count, fn );
+	} else {
+		for ( size_t i = 0; i < count; i++ )
+			fn( i );
+	}
+}
+
 bool TexturePacker::addPackerTex( TexturePackerTex* TPack ) {
 	if ( TPack->loadedInfo() ) {
 		// Only add the texture if can fit inside the atlas, otherwise it will ignore it
@@ -475,11 +559,10 @@ bool TexturePacker::addPackerTex( TexturePackerTex* TPack ) {
 				}
 			}
 
-			if ( !Added ) {
+			if ( !Added )
 				mTextures.push_back( TPack );
 
-				return true;
-			}
+			return true;
 		}
 	}
 
@@ -489,7 +572,12 @@ bool TexturePacker::addPackerTex( TexturePackerTex* TPack ) {
 bool TexturePacker::addImage( Image* Img, const std::string& Name ) {
 	TexturePackerTex* TPack = eeNew( TexturePackerTex, ( Img, Name ) );
 
-	return addPackerTex( TPack );
+	if ( !addPackerTex( TPack ) ) {
+		eeDelete( TPack );
+		return false;
+	}
+
+	return true;
 }
 
 bool TexturePacker::addTexture( const std::string& TexturePath ) {
@@ -501,7 +589,12 @@ bool TexturePacker::addTexture( const std::string& TexturePath ) {
 		TexturePackerTex* TPack =
 			eeNew( TexturePackerTex, ( TexturePath, imageFormatConfiguration ) );
 
-		return addPackerTex( TPack );
+		if ( !addPackerTex( TPack ) ) {
+			eeDelete( TPack );
+			return false;
+		}
+
+		return true;
 	}
 
 	return false;
@@ -609,63 +702,88 @@ Int32 TexturePacker::packTextures() {
 
 void TexturePacker::save( const std::string& Filepath, const Image::SaveType& Format,
 						  const bool& KeepExtensions ) {
-	if ( !mPacked )
-		packTextures();
+	mFilepath = Filepath;
+	mKeepExtensions = KeepExtensions;
 
-	if ( !mTextures.size() )
+	Image* Img = generateImage();
+
+	if ( NULL == Img )
 		return;
 
-	mFilepath = Filepath;
-	mKeepExtensions = KeepExtensions;
+	mFormat = Format;
 
-	Image Img( (Uint32)mWidth, (Uint32)mHeight, getAtlasNumChannels() );
+	Img->saveToFile( Filepath, Format );
 
-	Img.fillWithColor( Color( 0, 0, 0, 0 ) );
+	eeSAFE_DELETE( Img );
 
-	TexturePackerTex* t = NULL;
-	std::vector<TexturePackerTex*>::iterator it;
+	childSave( Format );
 
-	for ( it = mTextures.begin(); it != mTextures.end(); ++it ) {
-		t = ( *it );
+	saveTextureRegions();
+}
 
-		if ( t->placed() ) {
-			Uint8* data;
+Image* TexturePacker::generateImage() {
+	if ( !mPacked )
+		packTextures();
 
-			if ( NULL == t->getImage() ) {
-				Image imageLoaded( t->name() );
+	if ( !mTextures.size() )
+		return NULL;
 
-				if ( NULL != imageLoaded.getPixelsPtr() &&
-					 t->width() == (int)imageLoaded.getWidth() &&
-					 t->height() == (int)imageLoaded.getHeight() ) {
-					if ( t->flipped() )
-						imageLoaded.flip();
+	Image* Img = Image::New( (Uint32)mWidth, (Uint32)mHeight, getAtlasNumChannels() );
 
-					Img.copyImage( &imageLoaded, t->x(), t->y() );
+	Img->fillWithColor( Color( 0, 0, 0, 0 ) );
 
-					mPlacedCount++;
-				}
-			} else {
-				data = t->getImage()->getPixels();
+	std::vector<TexturePackerTex*> placed;
+	placed.reserve( mTextures.size() );
 
-				if ( NULL != data ) {
-					if ( t->flipped() )
-						t->getImage()->flip();
+	for ( TexturePackerTex* t : mTextures ) {
+		if ( t->placed() )
+			placed.push_back( t );
+	}
 
-					Img.copyImage( t->getImage(), t->x(), t->y() );
+	// Every image occupies a different region of the atlas, so they can be decoded and copied
+	// concurrently. Each decoded image is released as soon as it's copied.
+	std::atomic<Int32> placedCount( 0 );
 
-					mPlacedCount++;
-				}
+	forEachIndex( placed.size(), [&]( size_t i ) {
+		TexturePackerTex* t = placed[i];
+
+		if ( NULL == t->getImage() ) {
+			Image imageLoaded( t->name() );
+
+			if ( NULL != imageLoaded.getPixelsPtr() &&
+				 t->width() == (int)imageLoaded.getWidth() &&
+				 t->height() == (int)imageLoaded.getHeight() ) {
+				if ( t->flipped() )
+					imageLoaded.flip();
+
+				Img->copyImage( &imageLoaded, t->x(), t->y() );
+
+				placedCount++;
 			}
-		}
-	}
+		} else if ( NULL != t->getImage()->getPixels() ) {
+			if ( t->flipped() )
+				t->getImage()->flip();
 
-	mFormat = Format;
+			Img->copyImage( t->getImage(), t->x(), t->y() );
 
-	Img.saveToFile( Filepath, Format );
+			placedCount++;
+		}
+	} );
 
-	childSave( Format );
+	mPlacedCount += placedCount;
 
-	saveTextureRegions();
+	return Img;
+}
+
+void TexturePacker::forEachPlaced(
+	const std::function<void( const std::string&, const Rect&, bool )>& cb ) const {
+	for ( const TexturePackerTex* t : mTextures ) {
+		if ( t->placed() ) {
+			Int32 w = t->flipped() ? t->height() : t->width();
+			Int32 h = t->flipped() ? t->width() : t->height();
+			cb( t->name(), Rect( t->x(), t->y(), t->x() + w, t->y() + h ), t->flipped() );
+		}
+	}
 }
 
 Int32 TexturePacker::getChildCount() {
@@ -744,6 +862,14 @@ void TexturePacker::createTextureRegionsHdr( TexturePacker* Packer,
 
 	TextureRegions.resize( tTextures.size() );
 
+	// Hashing the source files is the most expensive part, do it in parallel if possible
+	std::vector<MD5::Result> hashes( tTextures.size() );
+
+	forEachIndex( tTextures.size(), [&]( size_t i ) {
+		if ( tTextures[i]->placed() )
+			hashes[i] = MD5::fromFile( tTextures[i]->name() );
+	} );
+
 	for ( it = tTextures.begin(); it != tTextures.end(); ++it ) {
 		tTex = ( *it );
 
@@ -773,7 +899,7 @@ void TexturePacker::createTextureRegionsHdr( TexturePacker* Packer,
 			tTextureRegionHdr.Date = FileSystem::fileGetModificationDate( tTex->name() );
 			tTextureRegionHdr.Flags = 0;
 			tTextureRegionHdr.PixelDensity = mPixelDensity;
-			MD5::Result md5Result = MD5::fromFile( tTex->name() );
+			const MD5::Result& md5Result = hashes[it - tTextures.begin()];
 			memcpy( tTextureRegionHdr.Hash, &md5Result.digest[0], HDR_HASH_SIZE );
 
 			if ( tTex->flipped() )
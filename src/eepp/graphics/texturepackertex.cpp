@@ -44,6 +44,25 @@ TexturePackerTex::TexturePackerTex( EE::Graphics::Image* Img, const std::string&
 	mLoadedInfo = true;
 }
 
+TexturePackerTex::TexturePackerTex( const std::string& Name, const Int32& width,
+									const Int32& height, const Int32& channels ) :
+	mName( Name ),
+	mWidth( width ),
+	mHeight( height ),
+	mChannels( channels ),
+	mX( 0 ),
+	mY( 0 ),
+	mLongestEdge( 0 ),
+	mArea( 0 ),
+	mFlipped( false ),
+	mPlaced( false ),
+	mLoadedInfo( true ),
+	mDisabled( false ),
+	mImg( NULL ) {
+	mArea = mWidth * mHeight;
+	mLongestEdge = ( mWidth >= mHeight ) ? mWidth : mHeight;
+}
+
 void TexturePackerTex::place( Int32 x, Int32 y, bool flipped ) {
 	if ( !mPlaced ) {
 		mX = x;
@@ -17,6 +17,10 @@ class TexturePackerTex {
 
 	TexturePackerTex( EE::Graphics::Image* Img, const std::string& name );
 
+	/** Creates the texture from an image file already probed */
+	TexturePackerTex( const std::string& name, const Int32& width, const Int32& height,
+					  const Int32& channels );
+
 	void place( Int32 x, Int32 y, bool flipped );
 
 	inline const std::string& name() const { return mName; }
@@ -6,6 +6,17 @@
 
 namespace EE { namespace Scene {
 
+static void eraseAction( std::vector<Action*>& actions, Action* action ) {
+	auto it = std::find( actions.begin(), actions.end(), action );
+	if ( it != actions.end() )
+		actions.erase( it );
+}
+
+bool ActionManager::timerCompare( const TimerEntry& a, const TimerEntry& b ) {
+	// Min-heap by due time
+	return a.due > b.due;
+}
+
 ActionManager* ActionManager::New() {
 	return eeNew( ActionManager, () );
 }
@@ -14,25 +25,78 @@ ActionManager::ActionManager() : mUpdating( false ) {}
 
 ActionManager::~ActionManager() {
 	clear();
+
+	for ( auto runnable : mRunnablesPool )
+		eeDelete( runnable );
+
+	mRunnablesPool.clear();
 }
 
 void ActionManager::addAction( Action* action ) {
 	Lock l( mMutex );
 
-	bool found = ( std::find( mActions.begin(), mActions.end(), action ) != mActions.end() );
+	if ( mEntries.find( action ) != mEntries.end() )
+		return;
+
+	ActionEntry entry;
+	entry.target = action->getTarget();
+	entry.tag = action->getTag();
+
+	TargetActions& target = mTargets[entry.target];
+	target.actions.emplace_back( action );
+
+	if ( entry.tag != 0 )
+		target.tagged[entry.tag].emplace_back( action );
 
-	if ( !found )
+	// Runnables only need to be updated once they are due
+	Actions::Runnable* runnable = dynamic_cast<Actions::Runnable*>( action );
+
+	if ( NULL != runnable ) {
+		entry.index = Timer;
+		scheduleTimer( action, entry, runnable->getRemainingTime() );
+	} else {
+		entry.index = mActions.size();
 		mActions.emplace_back( action );
+	}
+
+	mEntries[action] = entry;
+}
+
+Actions::Runnable* ActionManager::createRunnable( Actions::Runnable::RunnableFunc&& callback,
+												  const Time& time, bool loop ) {
+	Actions::Runnable* runnable = NULL;
+
+	{
+		Lock l( mMutex );
+
+		if ( !mRunnablesPool.empty() ) {
+			runnable = mRunnablesPool.back();
+			mRunnablesPool.pop_back();
+		}
+	}
+
+	if ( NULL != runnable ) {
+		runnable->reset( std::move( callback ), time, loop );
+	} else {
+		runnable = Actions::Runnable::New( std::move( callback ), time, loop );
+		runnable->mPooled = true;
+	}
+
+	return runnable;
+}
+
+void ActionManager::scheduleTimer( Action* action, ActionEntry& entry, const Time& delay ) {
+	entry.generation = ++mGeneration;
+	mTimers.push_back( { mClock.getElapsedTime() + delay, action, entry.generation } );
+	std::push_heap( mTimers.begin(), mTimers.end(), timerCompare );
 }
 
 Action* ActionManager::getActionByTag( const Action::UniqueID& tag ) {
 	Lock l( mMutex );
 
-	for ( auto it = mActions.begin(); it != mActions.end(); ++it ) {
-		Action* action = *it;
-
-		if ( action->getTag() == tag )
-			return action;
+	for ( const auto& entry : mEntries ) {
+		if ( entry.second.tag == tag )
+			return entry.first;
 	}
 
 	return NULL;
@@ -42,9 +106,27 @@ Action* ActionManager::getActionByTagFromTarget( Node* target, const Action::Uni
 												 bool mustBePending ) {
 	Lock l( mMutex );
 
-	for ( Action* action : mActions ) {
-		if ( action->getTarget() == target && action->getTag() == tag &&
-			 ( !mustBePending || !action->isDone() ) )
+	auto targetIt = mTargets.find( target );
+
+	if ( targetIt == mTargets.end() )
+		return NULL;
+
+	if ( tag != 0 ) {
+		auto tagIt = targetIt->second.tagged.find( tag );
+
+		if ( tagIt == targetIt->second.tagged.end() )
+			return NULL;
+
+		for ( Action* action : tagIt->second ) {
+			if ( !mustBePending || !action->isDone() )
+				return action;
+		}
+
+		return NULL;
+	}
+
+	for ( Action* action : targetIt->second.actions ) {
+		if ( action->getTag() == tag && ( !mustBePending || !action->isDone() ) )
 			return action;
 	}
 
@@ -54,16 +136,9 @@ Action* ActionManager::getActionByTagFromTarget( Node* target, const Action::Uni
 std::vector<Action*> ActionManager::getActionsFromTarget( Node* target ) {
 	Lock l( mMutex );
 
-	std::vector<Action*> actions;
-
-	for ( auto it = mActions.begin(); it != mActions.end(); ++it ) {
-		Action* action = *it;
-
-		if ( action->getTarget() == target )
-			actions.emplace_back( action );
-	}
+	auto targetIt = mTargets.find( target );
 
-	return actions;
+	return targetIt != mTargets.end() ? targetIt->second.actions : std::vector<Action*>();
 }
 
 std::vector<Action*> ActionManager::getActionsByTagFromTarget( Node* target,
@@ -71,10 +146,22 @@ std::vector<Action*> ActionManager::getActionsByTagFromTarget( Node* target,
 	Lock l( mMutex );
 	std::vector<Action*> actions;
 
-	for ( auto it = mActions.begin(); it != mActions.end(); ++it ) {
-		Action* action = *it;
+	auto targetIt = mTargets.find( target );
+
+	if ( targetIt == mTargets.end() )
+		return actions;
+
+	if ( tag != 0 ) {
+		auto tagIt = targetIt->second.tagged.find( tag );
+
+		if ( tagIt != targetIt->second.tagged.end() )
+			actions = tagIt->second;
 
-		if ( action->getTarget() == target && action->getTag() == tag )
+		return actions;
+	}
+
+	for ( Action* action : targetIt->second.actions ) {
+		if ( action->getTag() == tag )
 			actions.emplace_back( action );
 	}
 
@@ -86,18 +173,7 @@ bool ActionManager::removeActionByTag( const Action::UniqueID& tag ) {
 }
 
 bool ActionManager::removeActionsByTagFromTarget( Node* target, const Action::UniqueID& tag ) {
-	std::vector<Action*> removeList;
-
-	{
-		Lock l( mMutex );
-		for ( auto it = mActions.begin(); it != mActions.end(); ++it ) {
-			Action* action = *it;
-
-			if ( action->getTarget() == target && action->getTag() == tag ) {
-				removeList.emplace_back( *it );
-			}
-		}
-	}
+	std::vector<Action*> removeList( getActionsByTagFromTarget( target, tag ) );
 
 	for ( auto it = removeList.begin(); it != removeList.end(); ++it )
 		removeAction( *it );
@@ -105,22 +181,71 @@ bool ActionManager::removeActionsByTagFromTarget( Node* target, const Action::Un
 	return !removeList.empty();
 }
 
-void ActionManager::update( const Time& time, Action** actions, size_t count ) {
-	std::vector<Action*> removeList;
-	std::vector<Action*> deferredRemoveList;
+bool ActionManager::isActive( Action* action, Uint64 removals ) {
+	// Nothing has been removed since the update started
+	if ( mRemovals.load( std::memory_order_relaxed ) == removals )
+		return true;
 
-	// Copy the deferred remove list under lock to avoid data races during the loop.
-	{
+	Lock l( mMutex );
+	return mEntries.find( action ) != mEntries.end();
+}
+
+void ActionManager::updateTimers( const Time& time ) {
+	Time now = mClock.getElapsedTime();
+
+	for ( ;; ) {
+		Action* action = NULL;
+
+		{
+			Lock l( mMutex );
+
+			if ( mTimers.empty() || mTimers.front().due > now )
+				break;
+
+			std::pop_heap( mTimers.begin(), mTimers.end(), timerCompare );
+			TimerEntry timer = mTimers.back();
+			mTimers.pop_back();
+
+			auto it = mEntries.find( timer.action );
+
+			// The timer was removed or rescheduled
+			if ( it == mEntries.end() || it->second.generation != timer.generation ) {
+				if ( mStaleTimers > 0 )
+					mStaleTimers--;
+				continue;
+			}
+
+			action = timer.action;
+		}
+
+		action->update( time );
+
+		if ( action->isDone() ) {
+			action->sendEvent( Action::ActionType::OnDone );
+			mDoneList.emplace_back( action );
+			continue;
+		}
+
+		// Not done yet ( an interval, or a restarted debounce ), schedule it again. The new due
+		// time is always later than now so it can't be updated twice in the same frame.
 		Lock l( mMutex );
-		if ( !mActionsRemoveList.empty() )
-			deferredRemoveList = mActionsRemoveList;
+		auto it = mEntries.find( action );
+
+		if ( it != mEntries.end() && it->second.index == Timer ) {
+			Time remaining = static_cast<Actions::Runnable*>( action )->getRemainingTime();
+			scheduleTimer( action, it->second, eemax( remaining, Microseconds( 1 ) ) );
+		}
 	}
+}
+
+void ActionManager::update( const Time& time, Action** actions, size_t count ) {
+	Uint64 removals = mRemovals.load( std::memory_order_relaxed );
 
 	for ( size_t i = 0; i < count; i++ ) {
 		Action* action = actions[i];
 
-		if ( std::find( deferredRemoveList.begin(), deferredRemoveList.end(), action ) !=
-			 deferredRemoveList.end() )
+		// Removed actions leave a hole until the list is compacted
+		if ( NULL == action || !isActive( action, removals ) )
 			continue;
 
 		action->update( time );
@@ -128,26 +253,37 @@ void ActionManager::update( const Time& time, Action** actions, size_t count ) {
 		if ( action->isDone() ) {
 			action->sendEvent( Action::ActionType::OnDone );
 
-			removeList.emplace_back( action );
+			mDoneList.emplace_back( action );
 		}
 	}
+}
 
-	mUpdating = false;
+void ActionManager::finishUpdate() {
+	std::vector<Action*> releaseList;
 
-	// Atomically get the list of deferred removals and clear the shared list.
 	{
 		Lock l( mMutex );
-		deferredRemoveList.clear(); // Reuse the vector
-		deferredRemoveList.swap( mActionsRemoveList );
-	}
 
-	// Process actions that were queued for removal.
-	for ( auto it = deferredRemoveList.begin(); it != deferredRemoveList.end(); ++it )
-		removeAction( *it );
+		mUpdating = false;
 
-	// Process actions that finished during this update.
-	for ( auto it = removeList.begin(); it != removeList.end(); ++it )
-		removeAction( *it );
+		// Actions removed during the update were already detached, they only need to be released.
+		releaseList.swap( mActionsRemoveList );
+
+		// Process actions that finished during this update.
+		for ( Action* action : mDoneList ) {
+			if ( mEntries.find( action ) != mEntries.end() ) {
+				detach( action );
+				releaseList.emplace_back( action );
+			}
+		}
+
+		mDoneList.clear();
+
+		for ( Action* action : releaseList )
+			release( action );
+
+		compact();
+	}
 }
 
 void ActionManager::update( const Time& time ) {
@@ -155,6 +291,9 @@ void ActionManager::update( const Time& time ) {
 		return;
 
 	mUpdating = true;
+
+	updateTimers( time );
+
 	size_t size;
 
 	{
@@ -163,7 +302,9 @@ void ActionManager::update( const Time& time ) {
 	}
 
 	// Micro-optimization to avoid heap allocations during updates (which are done usually at 60 hz)
-	if ( size <= 8 ) {
+	if ( size == 0 ) {
+		// Only timers
+	} else if ( size <= 8 ) {
 		Action* actions[8];
 		{
 			Lock l( mMutex );
@@ -193,45 +334,150 @@ void ActionManager::update( const Time& time ) {
 		}
 		update( time, actions.data(), size );
 	}
+
+	finishUpdate();
+}
+
+Time ActionManager::getNextUpdateTimeout( const Time& pollTimeout ) const {
+	Lock l( mMutex );
+
+	if ( mActions.size() > mHoles )
+		return pollTimeout;
+
+	// The first timer could be stale, waking up earlier is harmless
+	if ( mTimers.empty() )
+		return Time::Infinity;
+
+	Time now = mClock.getElapsedTime();
+
+	return mTimers.front().due > now ? mTimers.front().due - now : Time::Zero;
 }
 
 std::size_t ActionManager::count() const {
 	Lock l( mMutex );
-	return mActions.size();
+	return mEntries.size();
 }
 
 bool ActionManager::isEmpty() const {
 	Lock l( mMutex );
-	return mActions.empty();
+	return mEntries.empty();
 }
 
 void ActionManager::clear() {
 	Lock l( mMutex );
 
-	for ( auto it = mActions.begin(); it != mActions.end(); ++it ) {
-		Action* action = *it;
+	for ( auto& entry : mEntries ) {
+		Action* action = entry.first;
 
 		eeSAFE_DELETE( action );
 	}
 
+	mEntries.clear();
+	mTargets.clear();
 	mActions.clear();
+	mTimers.clear();
+	mHoles = 0;
+	mStaleTimers = 0;
+	mRemovals++;
+}
+
+void ActionManager::detach( Action* action ) {
+	auto it = mEntries.find( action );
+
+	if ( it == mEntries.end() )
+		return;
+
+	const ActionEntry& entry = it->second;
+
+	if ( entry.index != Timer ) {
+		mActions[entry.index] = NULL;
+		mHoles++;
+	} else {
+		mStaleTimers++;
+	}
+
+	auto targetIt = mTargets.find( entry.target );
+
+	if ( targetIt != mTargets.end() ) {
+		TargetActions& target = targetIt->second;
+
+		eraseAction( target.actions, action );
+
+		if ( entry.tag != 0 ) {
+			auto tagIt = target.tagged.find( entry.tag );
+
+			if ( tagIt != target.tagged.end() ) {
+				eraseAction( tagIt->second, action );
+
+				if ( tagIt->second.empty() )
+					target.tagged.erase( tagIt );
+			}
+		}
+
+		if ( target.actions.empty() )
+			mTargets.erase( targetIt );
+	}
+
+	mEntries.erase( it );
+	mRemovals++;
+}
+
+void ActionManager::release( Action* action ) {
+	Actions::Runnable* runnable = dynamic_cast<Actions::Runnable*>( action );
+
+	if ( NULL != runnable && runnable->mPooled && mRunnablesPool.size() < RunnablesPoolSize ) {
+		runnable->sendEvent( Action::ActionType::OnDelete );
+		runnable->reset( Actions::Runnable::RunnableFunc(), Time::Zero, false );
+		mRunnablesPool.emplace_back( runnable );
+	} else {
+		eeSAFE_DELETE( action );
+	}
+}
+
+void ActionManager::compact() {
+	if ( mHoles > 32 && mHoles * 2 > mActions.size() ) {
+		size_t index = 0;
+
+		for ( Action* action : mActions ) {
+			if ( NULL != action ) {
+				mEntries[action].index = index;
+				mActions[index++] = action;
+			}
+		}
+
+		mActions.resize( index );
+		mHoles = 0;
+	}
+
+	// Drop the timers of removed actions when they are the majority of the heap
+	if ( mStaleTimers > 32 && mStaleTimers * 2 > mTimers.size() ) {
+		mTimers.erase( std::remove_if( mTimers.begin(), mTimers.end(),
+									   [this]( const TimerEntry& timer ) {
+										   auto it = mEntries.find( timer.action );
+										   return it == mEntries.end() ||
+												  it->second.generation != timer.generation;
+									   } ),
+					   mTimers.end() );
+		std::make_heap( mTimers.begin(), mTimers.end(), timerCompare );
+		mStaleTimers = 0;
+	}
 }
 
 bool ActionManager::removeAction( Action* action ) {
 	if ( NULL != action ) {
 		Lock l( mMutex );
 
-		if ( !mUpdating ) {
-			auto actionIt = std::find( mActions.begin(), mActions.end(), action );
+		if ( mEntries.find( action ) == mEntries.end() )
+			return true;
 
-			if ( actionIt != mActions.end() ) {
-				mActions.erase( actionIt );
+		detach( action );
 
-				eeSAFE_DELETE( action );
-			}
-		} else if ( std::find( mActionsRemoveList.begin(), mActionsRemoveList.end(), action ) ==
-					mActionsRemoveList.end() ) {
+		// The action could be being updated, release it once the update finishes
+		if ( mUpdating ) {
 			mActionsRemoveList.emplace_back( action );
+		} else {
+			release( action );
+			compact();
 		}
 
 		return true;
@@ -250,18 +496,7 @@ bool ActionManager::removeActions( const std::vector<Action*>& actions ) {
 }
 
 bool ActionManager::removeAllActionsFromTarget( Node* target ) {
-	std::vector<Action*> removeList;
-
-	{
-		Lock l( mMutex );
-		for ( auto it = mActions.begin(); it != mActions.end(); ++it ) {
-			Action* action = *it;
-
-			if ( action->getTarget() == target ) {
-				removeList.emplace_back( *it );
-			}
-		}
-	}
+	std::vector<Action*> removeList( getActionsFromTarget( target ) );
 
 	for ( auto it = removeList.begin(); it != removeList.end(); ++it )
 		removeAction( *it );
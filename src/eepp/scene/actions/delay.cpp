@@ -47,6 +47,11 @@ void Delay::restart() {
 	mClock.restart();
 }
 
+Time Delay::getRemainingTime() const {
+	Time elapsed = mClock.getElapsedTime();
+	return elapsed < mTime ? mTime - elapsed : Time::Zero;
+}
+
 Delay::Delay( const Time& time ) : mTime( time ) {}
 
 }}} // namespace EE::Scene::Actions
@@ -43,4 +43,21 @@ void Runnable::setCallback( RunnableFunc&& callback ) {
 
 void Runnable::onStart() {}
 
+void Runnable::reset( RunnableFunc&& callback, const Time& time, bool loop ) {
+	{
+		Lock l( mCallbackMutex );
+		mCallback = std::move( callback );
+	}
+	mTime = time;
+	mLoop = loop;
+	mCalled = false;
+	mNode = nullptr;
+	mId = 0;
+	mTag = 0;
+	mFlags = 0;
+	mNumCallBacks = 0;
+	mCallbacks.clear();
+	mClock.restart();
+}
+
 }}} // namespace EE::Scene::Actions
@@ -7,6 +7,7 @@
 #include <eepp/scene/scenemanager.hpp>
 #include <eepp/scene/scenenode.hpp>
 #include <eepp/window/engine.hpp>
+#include <eepp/window/input.hpp>
 
 namespace EE { namespace Scene {
 
@@ -145,6 +146,10 @@ void Node::setInternalSize( const Sizef& size ) {
 
 void Node::scheduledUpdate( const Time& ) {}
 
+Time Node::getScheduledUpdateTimeout( const Time& pollTimeout ) {
+	return pollTimeout;
+}
+
 Node* Node::setSize( const Sizef& size ) {
 	if ( size != mSize )
 		setInternalSize( size );
@@ -1614,6 +1619,10 @@ Node* Node::runAction( Action* action ) {
 		action->start();
 
 		getActionManager()->addAction( action );
+
+		// The main thread could be sleeping until its next deadline
+		if ( !Engine::isMainThread() && NULL != mSceneNode->getWindow() )
+			mSceneNode->getWindow()->getInput()->wakeUp();
 	}
 
 	return this;
@@ -1645,7 +1654,7 @@ void Node::clearActions() {
 
 void Node::runOnMainThread( Actions::Runnable::RunnableFunc runnable, const Time& delay,
 							const Action::UniqueID& uniqueIdentifier ) {
-	Action* action = Actions::Runnable::New( std::move( runnable ), delay );
+	Action* action = getActionManager()->createRunnable( std::move( runnable ), delay );
 	action->setTag( uniqueIdentifier );
 	runAction( action );
 }
@@ -1656,7 +1665,7 @@ bool Node::ensureMainThread( Actions::Runnable::RunnableFunc runnable,
 		runnable();
 		return true;
 	} else {
-		Action* action = Actions::Runnable::New( std::move( runnable ) );
+		Action* action = getActionManager()->createRunnable( std::move( runnable ) );
 		action->setTag( uniqueIdentifier );
 		runAction( action );
 	}
@@ -1665,7 +1674,7 @@ bool Node::ensureMainThread( Actions::Runnable::RunnableFunc runnable,
 
 void Node::setTimeout( Actions::Runnable::RunnableFunc runnable, const Time& delay,
 					   const Action::UniqueID& uniqueIdentifier ) {
-	Action* action = Actions::Runnable::New( std::move( runnable ), delay );
+	Action* action = getActionManager()->createRunnable( std::move( runnable ), delay );
 	action->setTag( uniqueIdentifier );
 	runAction( action );
 }
@@ -1685,7 +1694,7 @@ void Node::debounce( Actions::Runnable::RunnableFunc runnable, const Time& delay
 
 void Node::setInterval( Actions::Runnable::RunnableFunc runnable, const Time& interval,
 						const Action::UniqueID& uniqueIdentifier ) {
-	Action* action = Actions::Runnable::New( std::move( runnable ), interval, true );
+	Action* action = getActionManager()->createRunnable( std::move( runnable ), interval, true );
 	action->setTag( uniqueIdentifier );
 	runAction( action );
 }
@@ -1,8 +1,12 @@
 #include <algorithm>
+#include <cmath>
+#include <eepp/graphics/textureasyncloader.hpp>
 #include <eepp/scene/scenemanager.hpp>
 #include <eepp/scene/scenenode.hpp>
+#include <eepp/system/profiler.hpp>
 #include <eepp/ui/uiscenenode.hpp>
 #include <eepp/window/engine.hpp>
+#include <eepp/window/input.hpp>
 
 namespace EE { namespace Scene {
 
@@ -43,12 +47,17 @@ size_t SceneManager::count() const {
 }
 
 void SceneManager::draw() {
+	EE_PROFILE_ZONE( "SceneManager::draw" );
 	for ( auto& sceneNode : mSceneNodes ) {
 		sceneNode->draw();
 	}
 }
 
 void SceneManager::update( const Time& elapsed ) {
+	EE_PROFILE_ZONE( "SceneManager::update" );
+	if ( Graphics::TextureAsyncLoader::existsSingleton() )
+		Graphics::TextureAsyncLoader::instance()->update();
+
 	for ( auto& sceneNode : mSceneNodes ) {
 		sceneNode->update( elapsed );
 	}
@@ -58,6 +67,38 @@ void SceneManager::update() {
 	update( mClock.getElapsedTimeAndReset() );
 }
 
+Time SceneManager::getNextUpdateTimeout( const Time& pollTimeout ) {
+	// Decoded textures are waiting to be uploaded
+	if ( Graphics::TextureAsyncLoader::existsSingleton() &&
+		 Graphics::TextureAsyncLoader::instance()->getPendingCount() > 0 )
+		return pollTimeout;
+
+	Time timeout = Time::Infinity;
+
+	for ( auto& sceneNode : mSceneNodes ) {
+		timeout = eemin( timeout, sceneNode->getNextUpdateTimeout( pollTimeout ) );
+
+		if ( timeout == Time::Zero )
+			break;
+	}
+
+	return timeout;
+}
+
+void SceneManager::waitForNextUpdate( EE::Window::Window* window, const Time& pollTimeout ) {
+	Time timeout = getNextUpdateTimeout( pollTimeout );
+
+	if ( timeout == Time::Zero )
+		return;
+
+	if ( timeout == Time::Infinity ) {
+		window->getInput()->waitEvent();
+	} else {
+		// The events are waited with millisecond precision, don't wake up before the deadline
+		window->getInput()->waitEvent( Milliseconds( std::ceil( timeout.asMilliseconds() ) ) );
+	}
+}
+
 UISceneNode* SceneManager::getUISceneNode() {
 	if ( NULL == mUISceneNode ) {
 		for ( auto& sceneNode : mSceneNodes ) {
@@ -4,6 +4,7 @@
 #include <eepp/graphics/textureregion.hpp>
 #include <eepp/scene/actionmanager.hpp>
 #include <eepp/scene/scenenode.hpp>
+#include <eepp/system/profiler.hpp>
 #include <eepp/window/cursormanager.hpp>
 #include <eepp/window/engine.hpp>
 #include <eepp/window/window.hpp>
@@ -84,6 +85,7 @@ bool SceneNode::ownsFrameBuffer() const {
 }
 
 void SceneNode::draw() {
+	EE_PROFILE_ZONE( "SceneNode::draw" );
 	GlobalBatchRenderer::instance()->draw();
 
 	const View& prevView = mWindow->getView();
@@ -488,6 +490,23 @@ bool SceneNode::isSubscribedForScheduledUpdate( Node* node ) {
 	return mScheduledUpdate.count( node ) > 0;
 }
 
+Time SceneNode::getNextUpdateTimeout( const Time& pollTimeout ) {
+	if ( mUpdateAllChildren )
+		return pollTimeout;
+
+	Time timeout = mActionManager->getNextUpdateTimeout( pollTimeout );
+
+	for ( auto& node : mScheduledUpdate ) {
+		if ( timeout == Time::Zero )
+			break;
+
+		if ( mScheduledUpdateRemove.find( node ) == mScheduledUpdateRemove.end() )
+			timeout = eemin( timeout, node->getScheduledUpdateTimeout( pollTimeout ) );
+	}
+
+	return timeout;
+}
+
 void SceneNode::addMouseOverNode( Node* node ) {
 	mMouseOverNodes.insert( node );
 }
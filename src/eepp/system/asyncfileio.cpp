@@ -0,0 +1,609 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <eepp/system/asyncfileio.hpp>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/log.hpp>
+#include <eepp/system/profiler.hpp>
+#include <eepp/system/thread.hpp>
+#include <mutex>
+
+#if EE_PLATFORM == EE_PLATFORM_LINUX && defined( __has_include )
+#if __has_include( <linux/io_uring.h> )
+#define EE_ASYNC_FILE_IO_URING
+#endif
+#endif
+
+#ifdef EE_ASYNC_FILE_IO_URING
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace EE { namespace System {
+
+namespace {
+
+struct AsyncFileIORequest {
+	Uint64 id{ 0 };
+	Uint64 tag{ 0 };
+	bool write{ false };
+	std::string path;
+	std::string data;
+	AsyncFileIO::Callback callback;
+	/** Shared with the AsyncFileIO, cleared when it's destroyed */
+	std::shared_ptr<std::atomic<bool>> alive;
+	std::atomic<bool> canceled{ false };
+	bool success{ false };
+	int fd{ -1 };
+	size_t size{ 0 };
+	size_t done{ 0 };
+#ifdef EE_ASYNC_FILE_IO_URING
+	struct iovec iov;
+#endif
+};
+
+using RequestPtr = std::shared_ptr<AsyncFileIORequest>;
+
+#ifdef EE_ASYNC_FILE_IO_URING
+
+/** Minimal io_uring wrapper over the raw syscalls, so no liburing dependency is needed */
+class IoUring {
+  public:
+	~IoUring() { close(); }
+
+	bool init( Uint32 entries ) {
+		struct io_uring_params params;
+		std::memset( &params, 0, sizeof( params ) );
+
+		mFd = (int)syscall( __NR_io_uring_setup, entries, &params );
+
+		if ( mFd < 0 )
+			return false;
+
+		mSqSize = params.sq_off.array + params.sq_entries * sizeof( unsigned );
+		mCqSize = params.cq_off.cqes + params.cq_entries * sizeof( struct io_uring_cqe );
+		bool singleMmap = ( params.features & IORING_FEAT_SINGLE_MMAP ) != 0;
+
+		if ( singleMmap )
+			mSqSize = mCqSize = eemax( mSqSize, mCqSize );
+
+		mSqPtr = mmap( NULL, mSqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mFd,
+					   IORING_OFF_SQ_RING );
+
+		if ( mSqPtr == MAP_FAILED ) {
+			mSqPtr = NULL;
+			close();
+			return false;
+		}
+
+		if ( singleMmap ) {
+			mCqPtr = mSqPtr;
+		} else {
+			mCqPtr = mmap( NULL, mCqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mFd,
+						   IORING_OFF_CQ_RING );
+
+			if ( mCqPtr == MAP_FAILED ) {
+				mCqPtr = NULL;
+				close();
+				return false;
+			}
+		}
+
+		mSqesSize = params.sq_entries * sizeof( struct io_uring_sqe );
+		void* sqes = mmap( NULL, mSqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+						   mFd, IORING_OFF_SQES );
+
+		if ( sqes == MAP_FAILED ) {
+			close();
+			return false;
+		}
+
+		Uint8* sq = static_cast<Uint8*>( mSqPtr );
+		Uint8* cq = static_cast<Uint8*>( mCqPtr );
+		mSqHead = reinterpret_cast<unsigned*>( sq + params.sq_off.head );
+		mSqTail = reinterpret_cast<unsigned*>( sq + params.sq_off.tail );
+		mSqMask = *reinterpret_cast<unsigned*>( sq + params.sq_off.ring_mask );
+		mSqArray = reinterpret_cast<unsigned*>( sq + params.sq_off.array );
+		mSqes = static_cast<struct io_uring_sqe*>( sqes );
+		mCqHead = reinterpret_cast<unsigned*>( cq + params.cq_off.head );
+		mCqTail = reinterpret_cast<unsigned*>( cq + params.cq_off.tail );
+		mCqMask = *reinterpret_cast<unsigned*>( cq + params.cq_off.ring_mask );
+		mCqes = reinterpret_cast<struct io_uring_cqe*>( cq + params.cq_off.cqes );
+		mEntries = params.sq_entries;
+
+		return true;
+	}
+
+	void close() {
+		if ( NULL != mSqes )
+			munmap( mSqes, mSqesSize );
+		if ( NULL != mCqPtr && mCqPtr != mSqPtr )
+			munmap( mCqPtr, mCqSize );
+		if ( NULL != mSqPtr )
+			munmap( mSqPtr, mSqSize );
+		if ( mFd >= 0 )
+			::close( mFd );
+		mSqes = NULL;
+		mCqPtr = mSqPtr = NULL;
+		mFd = -1;
+	}
+
+	/** Queues a readv / writev of the request, submitted on the next enter call */
+	bool queue( AsyncFileIORequest* req ) {
+		unsigned tail = *mSqTail;
+
+		if ( tail - __atomic_load_n( mSqHead, __ATOMIC_ACQUIRE ) >= mEntries )
+			return false;
+
+		unsigned index = tail & mSqMask;
+		struct io_uring_sqe* sqe = &mSqes[index];
+		std::memset( sqe, 0, sizeof( *sqe ) );
+
+		req->iov.iov_base = &req->data[req->done];
+		req->iov.iov_len = req->size - req->done;
+
+		sqe->opcode = req->write ? IORING_OP_WRITEV : IORING_OP_READV;
+		sqe->fd = req->fd;
+		sqe->off = req->done;
+		sqe->addr = reinterpret_cast<Uint64>( &req->iov );
+		sqe->len = 1;
+		sqe->user_data = reinterpret_cast<Uint64>( req );
+
+		mSqArray[index] = index;
+		__atomic_store_n( mSqTail, tail + 1, __ATOMIC_RELEASE );
+		mToSubmit++;
+
+		return true;
+	}
+
+	/** Submits the queued requests and waits for at least waitCount completions */
+	bool enter( unsigned waitCount ) {
+		while ( true ) {
+			int ret = (int)syscall( __NR_io_uring_enter, mFd, mToSubmit, waitCount,
+									waitCount > 0 ? IORING_ENTER_GETEVENTS : 0, NULL, 0 );
+
+			if ( ret >= 0 ) {
+				mToSubmit -= eemin<unsigned>( ret, mToSubmit );
+				return true;
+			}
+
+			if ( errno != EINTR && errno != EAGAIN && errno != EBUSY )
+				return false;
+		}
+	}
+
+	template <typename F> void reap( F onCompletion ) {
+		unsigned head = *mCqHead;
+		unsigned tail = __atomic_load_n( mCqTail, __ATOMIC_ACQUIRE );
+
+		while ( head != tail ) {
+			struct io_uring_cqe* cqe = &mCqes[head & mCqMask];
+			onCompletion( reinterpret_cast<AsyncFileIORequest*>( cqe->user_data ), cqe->res );
+			head++;
+		}
+
+		__atomic_store_n( mCqHead, head, __ATOMIC_RELEASE );
+	}
+
+	unsigned entries() const { return mEntries; }
+
+  protected:
+	int mFd{ -1 };
+	void* mSqPtr{ NULL };
+	void* mCqPtr{ NULL };
+	size_t mSqSize{ 0 };
+	size_t mCqSize{ 0 };
+	size_t mSqesSize{ 0 };
+	unsigned* mSqHead{ NULL };
+	unsigned* mSqTail{ NULL };
+	unsigned mSqMask{ 0 };
+	unsigned* mSqArray{ NULL };
+	struct io_uring_sqe* mSqes{ NULL };
+	unsigned* mCqHead{ NULL };
+	unsigned* mCqTail{ NULL };
+	unsigned mCqMask{ 0 };
+	struct io_uring_cqe* mCqes{ NULL };
+	unsigned mEntries{ 0 };
+	unsigned mToSubmit{ 0 };
+};
+
+#endif
+
+static void performBlocking( AsyncFileIORequest& req ) {
+	if ( req.write ) {
+		req.success = FileSystem::fileWrite( req.path, req.data );
+		req.data.clear();
+	} else {
+		req.success = FileSystem::fileGet( req.path, req.data );
+	}
+}
+
+static void runCallback( AsyncFileIORequest& req ) {
+	if ( req.canceled || !req.callback || !*req.alive )
+		return;
+
+	AsyncFileIO::Result res;
+	res.path = std::move( req.path );
+	res.data = std::move( req.data );
+	res.success = req.success;
+	req.callback( res );
+}
+
+} // namespace
+
+struct AsyncFileIOState {
+	std::mutex mutex;
+	std::condition_variable cond;
+	std::deque<RequestPtr> pending;
+	std::vector<RequestPtr> active;
+	/** Requests taken from the pending queue whose callback didn't finish yet */
+	size_t outstanding{ 0 };
+	size_t maxOutstanding{ 0 };
+	bool shuttingDown{ false };
+	std::atomic<Uint64> lastId{ 0 };
+	/** The callbacks dispatched to the pool can outlive the AsyncFileIO, they check it first */
+	std::shared_ptr<std::atomic<bool>> alive{ std::make_shared<std::atomic<bool>>( true ) };
+	/** Not owned, the pool outlives the I/O thread ( the only user ) */
+	ThreadPool* pool{ nullptr };
+#ifdef EE_ASYNC_FILE_IO_URING
+	IoUring ring;
+#endif
+
+	/** Releases the outstanding slot of a request once the pool work that holds it is done or
+	 * discarded by the pool */
+	static std::shared_ptr<void> slotGuard( const std::shared_ptr<AsyncFileIOState>& state ) {
+		return std::shared_ptr<void>( nullptr, [state]( void* ) {
+			{
+				std::lock_guard<std::mutex> lock( state->mutex );
+				state->outstanding--;
+			}
+			state->cond.notify_all();
+		} );
+	}
+
+	static void dispatch( const std::shared_ptr<AsyncFileIOState>& state, RequestPtr req ) {
+		Uint64 tag = req->tag;
+
+		state->pool->run(
+			[req = std::move( req ), guard = slotGuard( state )] { runCallback( *req ); },
+			[]( const Uint64& ) {}, tag );
+	}
+
+#ifdef EE_ASYNC_FILE_IO_URING
+	/** Opens the file of the request, returns false if it must be served by a blocking call */
+	static bool prepare( AsyncFileIORequest& req ) {
+		if ( req.write ) {
+			req.fd = ::open( req.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666 );
+			req.size = req.data.size();
+			return req.fd >= 0;
+		}
+
+		req.fd = ::open( req.path.c_str(), O_RDONLY | O_CLOEXEC );
+
+		if ( req.fd < 0 )
+			return false;
+
+		struct stat st;
+
+		// Files without a known size ( as procfs files ) are read by a blocking read
+		if ( fstat( req.fd, &st ) != 0 || !S_ISREG( st.st_mode ) || st.st_size <= 0 ) {
+			::close( req.fd );
+			req.fd = -1;
+			return false;
+		}
+
+		req.size = st.st_size;
+		req.data.resize( req.size );
+		return true;
+	}
+
+	static void finish( const std::shared_ptr<AsyncFileIOState>& state, RequestPtr req,
+						bool success ) {
+		if ( req->fd >= 0 ) {
+			::close( req->fd );
+			req->fd = -1;
+		}
+
+		req->success = success;
+
+		if ( req->write )
+			req->data.clear();
+		else
+			req->data.resize( req->done );
+
+		dispatch( state, std::move( req ) );
+	}
+
+	static void ioThread( std::shared_ptr<AsyncFileIOState> state ) {
+		EE_PROFILE_THREAD_NAME( "AsyncFileIO" );
+
+		std::vector<RequestPtr> inFlight;
+		std::vector<RequestPtr> blocking;
+		size_t capacity = state->ring.entries();
+
+		while ( true ) {
+			std::vector<RequestPtr> submit;
+
+			{
+				std::unique_lock<std::mutex> lock( state->mutex );
+
+				if ( inFlight.empty() ) {
+					state->cond.wait( lock, [&state] {
+						return state->shuttingDown ||
+							   ( !state->pending.empty() &&
+								 state->outstanding < state->maxOutstanding );
+					} );
+
+					if ( state->shuttingDown )
+						break;
+				}
+
+				while ( !state->shuttingDown && !state->pending.empty() &&
+						inFlight.size() + submit.size() < capacity &&
+						state->outstanding < state->maxOutstanding ) {
+					submit.emplace_back( std::move( state->pending.front() ) );
+					state->pending.pop_front();
+					state->outstanding++;
+				}
+			}
+
+			for ( auto& req : submit ) {
+				if ( !prepare( *req ) ) {
+					blocking.emplace_back( std::move( req ) );
+					continue;
+				}
+
+				if ( req->size == 0 ) {
+					finish( state, std::move( req ), true );
+					continue;
+				}
+
+				state->ring.queue( req.get() );
+
+				{
+					std::lock_guard<std::mutex> lock( state->mutex );
+					state->active.push_back( req );
+				}
+
+				inFlight.emplace_back( std::move( req ) );
+			}
+
+			// Files that couldn't be opened or have an unknown size go to the pool
+			for ( auto& req : blocking ) {
+				Uint64 tag = req->tag;
+				state->pool->run(
+					[req = std::move( req ), guard = slotGuard( state )] {
+						performBlocking( *req );
+						runCallback( *req );
+					},
+					[]( const Uint64& ) {}, tag );
+			}
+			blocking.clear();
+
+			if ( inFlight.empty() )
+				continue;
+
+			// Shutting down waits here for the requests in flight, the kernel references their
+			// buffers
+			if ( !state->ring.enter( 1 ) ) {
+				Log::error( "AsyncFileIO: io_uring_enter failed: %s", strerror( errno ) );
+
+				// Serve the in flight requests with blocking calls
+				for ( auto& req : inFlight ) {
+					if ( req->fd >= 0 ) {
+						::close( req->fd );
+						req->fd = -1;
+					}
+					performBlocking( *req );
+					req->done = req->data.size();
+					dispatch( state, req );
+				}
+
+				std::lock_guard<std::mutex> lock( state->mutex );
+				state->active.clear();
+				inFlight.clear();
+				continue;
+			}
+
+			std::vector<AsyncFileIORequest*> completed;
+			std::vector<std::pair<AsyncFileIORequest*, bool>> finished;
+
+			state->ring.reap( [&]( AsyncFileIORequest* req, int res ) {
+				if ( res > 0 ) {
+					req->done += res;
+
+					if ( req->done < req->size ) {
+						// Short read or write, continue from where it stopped
+						completed.push_back( req );
+						return;
+					}
+				} else if ( res == -EINTR || res == -EAGAIN ) {
+					completed.push_back( req );
+					return;
+				}
+
+				// res == 0 means that the file shrank after being opened
+				finished.emplace_back( req, res >= 0 && ( !req->write || req->done == req->size ) );
+			} );
+
+			for ( auto req : completed )
+				state->ring.queue( req );
+
+			for ( auto& fin : finished ) {
+				auto it =
+					std::find_if( inFlight.begin(), inFlight.end(),
+								  [&fin]( const RequestPtr& r ) { return r.get() == fin.first; } );
+
+				if ( it == inFlight.end() )
+					continue;
+
+				RequestPtr req( std::move( *it ) );
+				inFlight.erase( it );
+
+				{
+					std::lock_guard<std::mutex> lock( state->mutex );
+					auto ait = std::find( state->active.begin(), state->active.end(), req );
+					if ( ait != state->active.end() )
+						state->active.erase( ait );
+				}
+
+				finish( state, std::move( req ), fin.second );
+			}
+		}
+	}
+#endif
+};
+
+std::shared_ptr<AsyncFileIO> AsyncFileIO::New( std::shared_ptr<ThreadPool> pool,
+											   Uint32 queueDepth ) {
+	return std::make_shared<AsyncFileIO>( std::move( pool ), queueDepth );
+}
+
+AsyncFileIO::AsyncFileIO( std::shared_ptr<ThreadPool> pool, Uint32 queueDepth ) :
+	mPool( std::move( pool ) ),
+	mState( std::make_shared<AsyncFileIOState>() ),
+	mQueueDepth( eemax<Uint32>( 1, queueDepth ) ) {
+	mState->pool = mPool.get();
+	mState->maxOutstanding = mQueueDepth * 2;
+
+#ifdef EE_ASYNC_FILE_IO_URING
+	if ( mState->ring.init( mQueueDepth ) ) {
+		mThread = std::make_unique<Thread>( &AsyncFileIOState::ioThread, mState );
+		mThread->launch();
+	} else {
+		Log::info( "AsyncFileIO: io_uring not available, using blocking reads in the thread pool" );
+	}
+#endif
+}
+
+AsyncFileIO::~AsyncFileIO() {
+	*mState->alive = false;
+
+	{
+		std::lock_guard<std::mutex> lock( mState->mutex );
+		mState->shuttingDown = true;
+		mState->pending.clear();
+		for ( auto& req : mState->active )
+			req->canceled = true;
+	}
+
+	mState->cond.notify_all();
+
+	if ( mThread )
+		mThread->wait();
+}
+
+Uint64 AsyncFileIO::request( bool write, const std::string& path, std::string&& data,
+							 Callback&& callback, const Uint64& tag ) {
+	RequestPtr req( std::make_shared<AsyncFileIORequest>() );
+	req->id = ++mState->lastId;
+	req->tag = tag;
+	req->write = write;
+	req->path = path;
+	req->data = std::move( data );
+	req->callback = std::move( callback );
+	req->alive = mState->alive;
+	Uint64 id = req->id;
+
+	if ( isUsingIoUring() ) {
+		{
+			std::lock_guard<std::mutex> lock( mState->mutex );
+			mState->pending.emplace_back( std::move( req ) );
+		}
+
+		mState->cond.notify_all();
+		return id;
+	}
+
+	mPool->run(
+		[req = std::move( req )] {
+			performBlocking( *req );
+			runCallback( *req );
+		},
+		[]( const Uint64& ) {}, tag );
+
+	return id;
+}
+
+Uint64 AsyncFileIO::readFile( const std::string& path, Callback callback, const Uint64& tag ) {
+	return request( false, path, {}, std::move( callback ), tag );
+}
+
+void AsyncFileIO::readFiles( const std::vector<std::string>& paths, const Callback& callback,
+							 const Uint64& tag ) {
+	for ( const auto& path : paths )
+		request( false, path, {}, Callback( callback ), tag );
+}
+
+std::future<AsyncFileIO::Result> AsyncFileIO::readFileFuture( const std::string& path ) {
+	auto promise = std::make_shared<std::promise<Result>>();
+	auto future = promise->get_future();
+	request( false, path, {}, [promise]( Result& res ) { promise->set_value( std::move( res ) ); },
+			 0 );
+	return future;
+}
+
+Uint64 AsyncFileIO::writeFile( const std::string& path, std::string data, Callback callback,
+							   const Uint64& tag ) {
+	return request( true, path, std::move( data ), std::move( callback ), tag );
+}
+
+std::future<AsyncFileIO::Result> AsyncFileIO::writeFileFuture( const std::string& path,
+															   std::string data ) {
+	auto promise = std::make_shared<std::promise<Result>>();
+	auto future = promise->get_future();
+	request( true, path, std::move( data ),
+			 [promise]( Result& res ) { promise->set_value( std::move( res ) ); }, 0 );
+	return future;
+}
+
+bool AsyncFileIO::cancel( const Uint64& tag ) {
+	if ( tag == 0 )
+		return false;
+
+	bool removed = false;
+
+	if ( isUsingIoUring() ) {
+		std::lock_guard<std::mutex> lock( mState->mutex );
+		size_t count = mState->pending.size();
+
+		mState->pending.erase( std::remove_if( mState->pending.begin(), mState->pending.end(),
+											   [tag]( const RequestPtr& req ) {
+												   return req->tag == tag;
+											   } ),
+							   mState->pending.end() );
+
+		removed = count != mState->pending.size();
+
+		for ( auto& req : mState->active ) {
+			if ( req->tag == tag ) {
+				req->canceled = true;
+				removed = true;
+			}
+		}
+	}
+
+	return mPool->removeWithTag( tag ) || removed;
+}
+
+bool AsyncFileIO::isUsingIoUring() const {
+	return mThread != nullptr;
+}
+
+Uint32 AsyncFileIO::getQueueDepth() const {
+	return mQueueDepth;
+}
+
+const std::shared_ptr<ThreadPool>& AsyncFileIO::getThreadPool() const {
+	return mPool;
+}
+
+}} // namespace EE::System
@@ -2,6 +2,7 @@
 #include <climits>
 #include <eepp/system/filesystem.hpp>
 #include <eepp/system/iostreamfile.hpp>
+#include <eepp/system/profiler.hpp>
 #include <eepp/system/sys.hpp>
 #include <filesystem>
 #include <sys/stat.h>
@@ -48,6 +49,7 @@ std::string FileSystem::getOSSlash() {
 }
 
 bool FileSystem::fileGet( const std::string& path, ScopedBuffer& data ) {
+	EE_PROFILE_ZONE_CATEGORY( "FileSystem::fileGet", "io" );
 	if ( fileExists( path ) ) {
 		IOStreamFile fs( path );
 
@@ -62,6 +64,7 @@ bool FileSystem::fileGet( const std::string& path, ScopedBuffer& data ) {
 }
 
 bool FileSystem::fileGet( const std::string& path, std::vector<Uint8>& data ) {
+	EE_PROFILE_ZONE_CATEGORY( "FileSystem::fileGet", "io" );
 	if ( fileExists( path ) ) {
 		IOStreamFile fs( path );
 		ios_size fsize = fs.getSize();
@@ -78,6 +81,7 @@ bool FileSystem::fileGet( const std::string& path, std::vector<Uint8>& data ) {
 }
 
 bool FileSystem::fileGet( const std::string& path, std::string& data ) {
+	EE_PROFILE_ZONE_CATEGORY( "FileSystem::fileGet", "io" );
 	if ( fileExists( path ) ) {
 		IOStreamFile fs( path );
 		ios_size fsize = fs.getSize();
@@ -169,6 +173,7 @@ void FileSystem::filePathRemoveCurrentWorkingDirectory( std::string& path ) {
 
 bool FileSystem::fileWrite( const std::string& filepath, const Uint8* data,
 							const Uint32& dataSize ) {
+	EE_PROFILE_ZONE_CATEGORY( "FileSystem::fileWrite", "io" );
 	IOStreamFile fs( filepath, "wb" );
 
 	if ( fs.isOpen() ) {
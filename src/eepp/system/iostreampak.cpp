@@ -1,5 +1,7 @@
+#include <cstring>
 #include <eepp/system/iostreamfile.hpp>
 #include <eepp/system/iostreampak.hpp>
+#include <eepp/system/lock.hpp>
 
 namespace EE { namespace System {
 
@@ -8,18 +10,46 @@ IOStreamPak* IOStreamPak::New( Pak* pack, const std::string& path, bool writeMod
 }
 
 IOStreamPak::IOStreamPak( Pak* pack, const std::string& path, bool writeMode ) :
-	mFile( NULL ), mPos( 0 ), mOpen( false ) {
-	int index = -1;
+	mFile( NULL ), mData( NULL ), mPosition( 0 ), mSize( 0 ), mPos( 0 ), mOpen( false ) {
+	Lock l( *pack );
 
-	if ( -1 != ( index = pack->exists( path ) ) ) {
-		mEntry = pack->getPackEntry( (Uint32)index );
+	const Pak::Entry* entry = pack->getEntry( path );
 
-		mFile = IOStreamFile::New( pack->getPackPath(), ( writeMode ? "wb" : "rb" ) );
+	if ( NULL == entry )
+		return;
 
-		if ( mFile->isOpen() ) {
-			mFile->seek( mEntry.file_position );
-			mOpen = true;
+	mPosition = entry->position;
+	mSize = entry->uncompressedSize;
+
+	if ( entry->compression != Pak::FileCompression::None ) {
+		if ( writeMode )
+			return;
+
+		ScopedBuffer stored;
+		const Uint8* mapped = pack->getMappedData( *entry );
+
+		if ( NULL != mapped ) {
+			mBuffer.reset( mSize );
+			mOpen = pack->decompressEntry( *entry, mapped, mBuffer.get() );
+		} else if ( pack->readStoredData( *entry, stored ) ) {
+			mBuffer.reset( mSize );
+			mOpen = pack->decompressEntry( *entry, stored.get(), mBuffer.get() );
 		}
+
+		mData = mBuffer.get();
+		return;
+	}
+
+	if ( !writeMode && NULL != ( mData = pack->getMappedData( *entry ) ) ) {
+		mOpen = true;
+		return;
+	}
+
+	mFile = IOStreamFile::New( pack->getPackPath(), ( writeMode ? "r+b" : "rb" ) );
+
+	if ( mFile->isOpen() ) {
+		mFile->seek( mPosition );
+		mOpen = true;
 	}
 }
 
@@ -28,30 +58,42 @@ IOStreamPak::~IOStreamPak() {
 }
 
 ios_size IOStreamPak::read( char* data, ios_size size ) {
-	if ( isOpen() ) {
-		mFile->read( data, size );
+	if ( !isOpen() || size <= 0 || mPos >= mSize )
+		return 0;
 
-		mPos += size;
+	ios_size count = (ios_size)eemin<Uint64>( size, mSize - mPos );
+
+	if ( NULL != mData ) {
+		std::memcpy( data, mData + mPos, count );
+	} else {
+		count = mFile->read( data, count );
 	}
 
-	return size;
+	mPos += count;
+
+	return count;
 }
 
 ios_size IOStreamPak::write( const char* data, ios_size size ) {
-	if ( isOpen() && static_cast<Uint32>( mPos ) + size < mEntry.file_length ) {
+	// Only the contents of uncompressed files can be overwritten, files can't grow
+	if ( isOpen() && NULL != mFile && mPos + size <= mSize ) {
 		mFile->write( data, size );
+		mPos += size;
+		return size;
 	}
 
-	return size;
+	return 0;
 }
 
 ios_size IOStreamPak::seek( ios_size position ) {
 	if ( isOpen() ) {
-		mFile->seek( mEntry.file_position + position );
-		mPos = position;
+		mPos = eemin<Uint64>( position, mSize );
+
+		if ( NULL != mFile )
+			mFile->seek( mPosition + mPos );
 	}
 
-	return position;
+	return mPos;
 }
 
 ios_size IOStreamPak::tell() {
@@ -59,7 +101,7 @@ ios_size IOStreamPak::tell() {
 }
 
 ios_size IOStreamPak::getSize() {
-	return isOpen() ? mEntry.file_length : 0;
+	return isOpen() ? mSize : 0;
 }
 
 bool IOStreamPak::isOpen() {
@@ -1,7 +1,15 @@
 #include <algorithm>
+#include <condition_variable>
 #include <cstdarg>
+#include <ctime>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/lock.hpp>
 #include <eepp/system/log.hpp>
+#include <eepp/system/thread.hpp>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #if EE_PLATFORM == EE_PLATFORM_ANDROID
 #include <android/log.h>
@@ -23,6 +31,71 @@ namespace EE { namespace System {
 
 SINGLETON_DECLARE_IMPLEMENTATION( Log )
 
+namespace {
+
+struct LogRecord {
+	Uint64 sequence{ 0 };
+	Int64 time{ 0 };
+	LogLevel level{ LogLevel::Info };
+	bool hasLevel{ false };
+	bool appendNewLine{ false };
+	std::string text;
+};
+
+/** Single producer ( the owner thread ) single consumer ( the writer thread ) ring buffer */
+struct LogThreadBuffer {
+	explicit LogThreadBuffer( size_t capacity ) : records( capacity ), mask( capacity - 1 ) {}
+
+	std::vector<LogRecord> records;
+	size_t mask;
+	std::atomic<size_t> head{ 0 };
+	std::atomic<size_t> tail{ 0 };
+};
+
+struct LogThreadLocal {
+	std::shared_ptr<LogThreadBuffer> buffer;
+	Uint64 generation{ 0 };
+};
+
+static thread_local LogThreadLocal sLogThreadLocal;
+
+static std::atomic<Uint64> sLogGeneration{ 0 };
+
+} // namespace
+
+struct LogAsyncState {
+	Uint64 generation{ ++sLogGeneration };
+	size_t bufferSize{ 1024 };
+	std::mutex buffersMutex;
+	std::vector<std::shared_ptr<LogThreadBuffer>> buffers;
+	std::mutex mutex;
+	std::condition_variable cond;
+	std::condition_variable passCond;
+	Uint64 passes{ 0 };
+	bool wakeUp{ false };
+	std::atomic<bool> running{ false };
+	std::atomic<UintPtr> writerId{ 0 };
+	std::atomic<Uint64> sequence{ 0 };
+	std::atomic<Uint64> dropped{ 0 };
+	std::unique_ptr<Thread> thread;
+	// Only used by the writer thread
+	Uint64 droppedReported{ 0 };
+	std::vector<std::shared_ptr<LogThreadBuffer>> draining;
+	std::vector<size_t> drainingHeads;
+	std::vector<const LogRecord*> records;
+	std::string batch;
+	Int64 lastTime{ -1 };
+	std::string lastTimeStr;
+
+	void wake() {
+		{
+			std::lock_guard<std::mutex> lock( mutex );
+			wakeUp = true;
+		}
+		cond.notify_one();
+	}
+};
+
 std::unordered_map<std::string, LogLevel> Log::getMapFlag() {
 	return { { "debug", LogLevel::Debug },	 { "info", LogLevel::Info },
 			 { "notice", LogLevel::Notice }, { "warning", LogLevel::Warning },
@@ -89,6 +162,8 @@ void Log::setFilePath( const std::string& filePath ) {
 Log::~Log() {
 	writel( LogLevel::Info, "eepp stopped\n" );
 
+	setAsync( false );
+
 	if ( mSave && !mLiveWrite && mKeepLog ) {
 		openFS();
 
@@ -96,6 +171,8 @@ Log::~Log() {
 	}
 
 	closeFS();
+
+	eeSAFE_DELETE( mAsyncState );
 }
 
 const LogLevel& Log::getLogLevelThreshold() const {
@@ -117,36 +194,78 @@ void Log::save( const std::string& filepath ) {
 }
 
 void Log::write( const std::string_view& text ) {
-	if ( mKeepLog ) {
-		lock();
-		mData += text;
-		unlock();
+	if ( mAsync ) {
+		enqueue( nullptr, text, false );
+		return;
 	}
 
+	keepLog( text, false );
+
 	writeToReaders( text );
 
-	if ( mStdOutEnabled ) {
+	if ( mStdOutEnabled )
+		writeToStdOut( text, false );
+
+	if ( mLiveWrite )
+		writeToFile( text, true );
+}
+
+void Log::writeToStdOut( const std::string_view& text, bool appendNewLine ) {
 #if EE_PLATFORM == EE_PLATFORM_ANDROID
-		__android_log_print( ANDROID_LOG_INFO, "eepp", "%s", text.data() );
+	__android_log_print( ANDROID_LOG_INFO, "eepp", appendNewLine ? "%.*s\n" : "%.*s",
+						 (int)text.size(), text.data() );
 #elif defined( EE_COMPILER_MSVC )
 #ifdef UNICODE
-		OutputDebugString( String::fromUtf8( text ).toWideString().c_str() );
+	OutputDebugString( String::fromUtf8( text ).toWideString().c_str() );
+	if ( appendNewLine )
+		OutputDebugString( String::fromUtf8( std::string_view{ "\n" } ).toWideString().c_str() );
 #else
-		OutputDebugString( text.c_str() );
+	OutputDebugString( std::string( text ).c_str() );
+	if ( appendNewLine )
+		OutputDebugString( "\n" );
 #endif
 #elif EE_PLATFORM == EE_PLATFORM_EMSCRIPTEN
-		emscripten_console_log( text.data() );
+	emscripten_console_log( std::string( text ).c_str() );
 #else
+	if ( appendNewLine ) {
+		std::cout << text << std::endl;
+	} else {
 		std::cout << text << std::flush;
-#endif
 	}
+#endif
+}
 
-	if ( mLiveWrite ) {
-		openFS();
+void Log::writeToFile( const std::string_view& text, bool flush ) {
+	Lock l( *this );
 
-		mFS->write( text.data(), text.size() );
+	openFS();
 
+	if ( mMaxFileSize > 0 && mFileSize > 0 && mFileSize + text.size() > mMaxFileSize )
+		rotateFS();
+
+	mFS->write( text.data(), text.size() );
+	mFileSize += text.size();
+
+	if ( flush )
 		mFS->flush();
+}
+
+void Log::keepLog( const std::string_view& text, bool appendNewLine ) {
+	if ( !mKeepLog )
+		return;
+
+	Lock l( *this );
+
+	mData += text;
+
+	if ( appendNewLine )
+		mData += '\n';
+
+	// Trims with some slack to avoid moving the whole buffer on every write
+	if ( mKeepLogMaxSize > 0 && mData.size() > mKeepLogMaxSize + mKeepLogMaxSize / 4 ) {
+		size_t cut = mData.size() - mKeepLogMaxSize;
+		size_t lineEnd = mData.find( '\n', cut );
+		mData.erase( 0, lineEnd != std::string::npos ? lineEnd + 1 : cut );
 	}
 }
 
@@ -178,60 +297,72 @@ std::string Log::logLevelWithTimestamp( const LogLevel& level, const std::string
 }
 
 void Log::write( const LogLevel& level, const std::string_view& text ) {
-	if ( level >= mLogLevelThreshold )
+	if ( level < mLogLevelThreshold )
+		return;
+	if ( mAsync ) {
+		enqueue( &level, text, false );
+	} else {
 		write( logLevelWithTimestamp( level, text, false ) );
+	}
 }
 
 void Log::writel( const std::string_view& text ) {
-	if ( mKeepLog ) {
-		lock();
-		mData += text;
-		mData += "\n";
-		unlock();
+	if ( mAsync ) {
+		enqueue( nullptr, text, true );
+		return;
 	}
 
+	keepLog( text, true );
+
 	writeToReaders( text );
 	writeToReaders( "\n" );
 
-	if ( mStdOutEnabled ) {
-#if EE_PLATFORM == EE_PLATFORM_ANDROID
-		__android_log_print( ANDROID_LOG_INFO, "eepp", "%s\n", text.data() );
-#elif defined( EE_COMPILER_MSVC )
-#ifdef UNICODE
-		OutputDebugString( String::fromUtf8( text ).toWideString().c_str() );
-		OutputDebugString( String::fromUtf8( std::string_view{ "\n" } ).toWideString().c_str() );
-#else
-		OutputDebugString( text.data() );
-		OutputDebugString( "\n" );
-#endif
-#elif EE_PLATFORM == EE_PLATFORM_EMSCRIPTEN
-		emscripten_console_log( text.data() );
-#else
-		std::cout << text << std::endl;
-#endif
-	}
+	if ( mStdOutEnabled )
+		writeToStdOut( text, true );
 
 	if ( mLiveWrite ) {
-		openFS();
-
-		mFS->write( text.data(), text.size() );
-		mFS->write( "\n", 1 );
-
-		mFS->flush();
+		writeToFile( text, false );
+		writeToFile( "\n", true );
 	}
 }
 
 void Log::writel( const LogLevel& level, const std::string_view& text ) {
-	if ( level >= mLogLevelThreshold )
+	if ( level < mLogLevelThreshold )
+		return;
+	if ( mAsync ) {
+		enqueue( &level, text, true );
+	} else {
 		write( logLevelWithTimestamp( level, text, true ) );
+	}
 }
 
 void Log::openFS() {
 	if ( mFilePath.empty() )
 		mFilePath = Sys::getProcessPath() + "log.log";
 
-	if ( NULL == mFS )
+	if ( NULL == mFS ) {
 		mFS = IOStreamFile::New( mFilePath, "a" );
+		mFileSize = FileSystem::fileSize( mFilePath );
+	}
+}
+
+void Log::rotateFS() {
+	eeSAFE_DELETE( mFS );
+
+	if ( mMaxRotatedFiles == 0 ) {
+		FileSystem::fileRemove( mFilePath );
+	} else {
+		FileSystem::fileRemove( String::format( "%s.%u", mFilePath, mMaxRotatedFiles ) );
+		for ( Uint32 i = mMaxRotatedFiles - 1; i >= 1; i-- ) {
+			std::string path( String::format( "%s.%u", mFilePath, i ) );
+			if ( FileSystem::fileExists( path ) )
+				FileSystem::fileMove( path, String::format( "%s.%u", mFilePath, i + 1 ) );
+		}
+		FileSystem::fileMove( mFilePath, mFilePath + ".1" );
+	}
+
+	mFS = IOStreamFile::New( mFilePath, "a" );
+	mFileSize = 0;
 }
 
 void Log::closeFS() {
@@ -273,18 +404,252 @@ void Log::setLiveWrite( const bool& lw ) {
 }
 
 void Log::addLogReader( LogReaderInterface* reader ) {
+	Lock l( mReadersMutex );
 	mReaders.push_back( reader );
 }
 
 void Log::removeLogReader( LogReaderInterface* reader ) {
+	Lock l( mReadersMutex );
 	auto found = std::find( mReaders.begin(), mReaders.end(), reader );
 	if ( found != mReaders.end() )
 		mReaders.erase( found );
 }
 
 void Log::writeToReaders( const std::string_view& text ) {
+	Lock l( mReadersMutex );
 	for ( const auto& reader : mReaders )
 		reader->writeLog( text );
 }
 
+const size_t& Log::getKeepLogMaxSize() const {
+	return mKeepLogMaxSize;
+}
+
+void Log::setKeepLogMaxSize( const size_t& maxSize ) {
+	mKeepLogMaxSize = maxSize;
+}
+
+void Log::setFileRotation( const Uint64& maxFileSize, const Uint32& maxRotatedFiles ) {
+	Lock l( *this );
+	mMaxFileSize = maxFileSize;
+	mMaxRotatedFiles = maxRotatedFiles;
+}
+
+const Uint64& Log::getMaxFileSize() const {
+	return mMaxFileSize;
+}
+
+const Uint32& Log::getMaxRotatedFiles() const {
+	return mMaxRotatedFiles;
+}
+
+bool Log::isAsync() const {
+	return mAsync;
+}
+
+Uint64 Log::getDroppedMessages() const {
+	return mAsyncState ? mAsyncState->dropped.load() : 0;
+}
+
+void Log::setAsync( bool async, size_t threadBufferSize ) {
+	if ( async == mAsync )
+		return;
+
+	if ( async ) {
+		if ( NULL == mAsyncState )
+			mAsyncState = eeNew( LogAsyncState, () );
+
+		size_t bufferSize = 2;
+		while ( bufferSize < threadBufferSize )
+			bufferSize <<= 1;
+
+		// A new generation makes every thread allocate a new buffer of the requested size
+		if ( bufferSize != mAsyncState->bufferSize ) {
+			std::lock_guard<std::mutex> lock( mAsyncState->buffersMutex );
+			mAsyncState->buffers.clear();
+			mAsyncState->bufferSize = bufferSize;
+			mAsyncState->generation = ++sLogGeneration;
+		}
+
+		mAsyncState->running = true;
+		mAsyncState->thread = std::make_unique<Thread>( [this] { asyncWriterLoop(); } );
+		mAsyncState->thread->launch();
+		mAsync = true;
+	} else {
+		mAsync = false;
+		{
+			std::lock_guard<std::mutex> lock( mAsyncState->mutex );
+			mAsyncState->running = false;
+		}
+		mAsyncState->cond.notify_one();
+		// The writer drains the pending messages before exiting
+		mAsyncState->thread->wait();
+		mAsyncState->thread.reset();
+	}
+}
+
+void Log::flush() {
+	LogAsyncState* state = mAsyncState;
+
+	if ( !mAsync || NULL == state || Thread::getCurrentThreadId() == state->writerId )
+		return;
+
+	std::unique_lock<std::mutex> lock( state->mutex );
+	// The pass running now could have started before the last messages were queued
+	Uint64 target = state->passes + 2;
+
+	while ( state->running && state->passes < target ) {
+		state->wakeUp = true;
+		state->cond.notify_one();
+		state->passCond.wait( lock );
+	}
+}
+
+void Log::enqueue( const LogLevel* level, const std::string_view& text, bool appendNewLine ) {
+	LogAsyncState* state = mAsyncState;
+	LogThreadLocal& local = sLogThreadLocal;
+
+	if ( !local.buffer || local.generation != state->generation ) {
+		std::lock_guard<std::mutex> lock( state->buffersMutex );
+		local.buffer = std::make_shared<LogThreadBuffer>( state->bufferSize );
+		local.generation = state->generation;
+		state->buffers.push_back( local.buffer );
+	}
+
+	LogThreadBuffer& buffer = *local.buffer;
+	size_t capacity = buffer.records.size();
+	size_t head = buffer.head.load( std::memory_order_relaxed );
+	bool important = level != nullptr && *level >= LogLevel::Error;
+
+	while ( head - buffer.tail.load( std::memory_order_acquire ) >= capacity ) {
+		if ( !important || !state->running || Thread::getCurrentThreadId() == state->writerId ) {
+			state->dropped.fetch_add( 1, std::memory_order_relaxed );
+			state->wake();
+			return;
+		}
+		state->wake();
+		std::this_thread::yield();
+	}
+
+	LogRecord& record = buffer.records[head & buffer.mask];
+	record.sequence = state->sequence.fetch_add( 1, std::memory_order_relaxed );
+	record.time = static_cast<Int64>( std::time( nullptr ) );
+	record.hasLevel = level != nullptr;
+	record.level = level != nullptr ? *level : LogLevel::Info;
+	record.appendNewLine = appendNewLine;
+	record.text.assign( text.data(), text.size() );
+	buffer.head.store( head + 1, std::memory_order_release );
+
+	// The writer wakes up periodically, only hurry it when the buffer is getting full
+	if ( important || head + 1 - buffer.tail.load( std::memory_order_relaxed ) >= capacity / 2 )
+		state->wake();
+
+	if ( level != nullptr && *level >= LogLevel::Critical )
+		flush();
+}
+
+void Log::asyncWriterLoop() {
+	LogAsyncState* state = mAsyncState;
+	state->writerId = Thread::getCurrentThreadId();
+	std::unique_lock<std::mutex> lock( state->mutex );
+
+	while ( true ) {
+		state->cond.wait_for( lock, std::chrono::milliseconds( 100 ),
+							  [state] { return state->wakeUp || !state->running; } );
+		bool stop = !state->running;
+		state->wakeUp = false;
+		lock.unlock();
+
+		asyncDrain();
+
+		lock.lock();
+		state->passes++;
+		state->passCond.notify_all();
+
+		if ( stop )
+			break;
+	}
+
+	state->writerId = 0;
+}
+
+void Log::asyncDrain() {
+	LogAsyncState* state = mAsyncState;
+
+	{
+		std::lock_guard<std::mutex> lock( state->buffersMutex );
+		state->draining = state->buffers;
+	}
+
+	state->records.clear();
+	state->drainingHeads.clear();
+
+	for ( const auto& buffer : state->draining ) {
+		size_t head = buffer->head.load( std::memory_order_acquire );
+		for ( size_t i = buffer->tail.load( std::memory_order_relaxed ); i < head; i++ )
+			state->records.push_back( &buffer->records[i & buffer->mask] );
+		state->drainingHeads.push_back( head );
+	}
+
+	std::sort( state->records.begin(), state->records.end(),
+			   []( const LogRecord* a, const LogRecord* b ) { return a->sequence < b->sequence; } );
+
+	std::string& batch = state->batch;
+	batch.clear();
+
+	for ( const LogRecord* record : state->records ) {
+		if ( record->hasLevel ) {
+			if ( record->time != state->lastTime ) {
+				state->lastTime = record->time;
+				state->lastTimeStr = Sys::epochToString( record->time, "%Y-%m-%d %X" );
+			}
+			batch += state->lastTimeStr;
+			batch += " - ";
+			batch += logLevelToString( record->level );
+			batch += ": ";
+		}
+		batch += record->text;
+		if ( record->appendNewLine )
+			batch += '\n';
+	}
+
+	// The records are copied, the producers can reuse the slots
+	for ( size_t i = 0; i < state->draining.size(); i++ )
+		state->draining[i]->tail.store( state->drainingHeads[i], std::memory_order_release );
+
+	Uint64 dropped = state->dropped.load();
+	if ( dropped != state->droppedReported ) {
+		batch += String::format( "%s - WARNING: %llu log messages were dropped\n",
+								 Sys::getDateTimeStr(),
+								 (unsigned long long)( dropped - state->droppedReported ) );
+		state->droppedReported = dropped;
+	}
+
+	// Releases the buffers of the threads that already finished
+	state->draining.clear();
+	{
+		std::lock_guard<std::mutex> lock( state->buffersMutex );
+		auto& buffers = state->buffers;
+		buffers.erase( std::remove_if( buffers.begin(), buffers.end(),
+									   []( const std::shared_ptr<LogThreadBuffer>& buffer ) {
+										   return buffer.use_count() == 1 &&
+												  buffer->head.load() == buffer->tail.load();
+									   } ),
+					   buffers.end() );
+	}
+
+	if ( batch.empty() )
+		return;
+
+	keepLog( batch, false );
+
+	writeToReaders( batch );
+
+	if ( mStdOutEnabled )
+		writeToStdOut( batch, false );
+
+	if ( mLiveWrite )
+		writeToFile( batch, true );
+}
+
 }} // namespace EE::System
@@ -1,10 +1,102 @@
+#include <algorithm>
+#include <cstring>
+#include <eepp/system/compression.hpp>
 #include <eepp/system/filesystem.hpp>
+#include <eepp/system/iostreammemory.hpp>
 #include <eepp/system/iostreampak.hpp>
+#include <eepp/system/iostreamstring.hpp>
 #include <eepp/system/log.hpp>
 #include <eepp/system/pak.hpp>
 
+#if EE_PLATFORM == EE_PLATFORM_WIN
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace EE { namespace System {
 
+struct PakMappedFile {
+	const Uint8* data{ nullptr };
+	Uint64 size{ 0 };
+#if EE_PLATFORM == EE_PLATFORM_WIN
+	HANDLE file{ INVALID_HANDLE_VALUE };
+	HANDLE mapping{ NULL };
+#endif
+
+	static PakMappedFile* map( const std::string& path ) {
+		PakMappedFile* mapped = eeNew( PakMappedFile, () );
+#if EE_PLATFORM == EE_PLATFORM_WIN
+		std::wstring wpath( String::fromUtf8( path ).toWideString() );
+		mapped->file = CreateFileW( wpath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+									NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+		LARGE_INTEGER fileSize;
+
+		if ( mapped->file != INVALID_HANDLE_VALUE && GetFileSizeEx( mapped->file, &fileSize ) &&
+			 fileSize.QuadPart > 0 ) {
+			mapped->mapping = CreateFileMappingW( mapped->file, NULL, PAGE_READONLY, 0, 0, NULL );
+
+			if ( mapped->mapping != NULL ) {
+				mapped->data =
+					(const Uint8*)MapViewOfFile( mapped->mapping, FILE_MAP_READ, 0, 0, 0 );
+				mapped->size = fileSize.QuadPart;
+			}
+		}
+#else
+		int fd = ::open( path.c_str(), O_RDONLY );
+
+		if ( fd != -1 ) {
+			struct stat st;
+
+			if ( fstat( fd, &st ) == 0 && st.st_size > 0 ) {
+				void* data = mmap( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+
+				if ( data != MAP_FAILED ) {
+					mapped->data = (const Uint8*)data;
+					mapped->size = st.st_size;
+				}
+			}
+
+			// The mapping keeps its own reference to the file
+			::close( fd );
+		}
+#endif
+
+		if ( NULL == mapped->data )
+			eeSAFE_DELETE( mapped );
+
+		return mapped;
+	}
+
+	~PakMappedFile() {
+#if EE_PLATFORM == EE_PLATFORM_WIN
+		if ( NULL != data )
+			UnmapViewOfFile( data );
+		if ( NULL != mapping )
+			CloseHandle( mapping );
+		if ( INVALID_HANDLE_VALUE != file )
+			CloseHandle( file );
+#else
+		if ( NULL != data )
+			munmap( (void*)data, size );
+#endif
+	}
+};
+
+static Compression::Mode pakCompressionMode( const Pak::FileCompression& compression ) {
+	return compression == Pak::FileCompression::Brotli ? Compression::MODE_BROTLI
+													   : Compression::MODE_DEFLATE;
+}
+
 Pak* Pak::New() {
 	return eeNew( Pak, () );
 }
@@ -15,31 +107,50 @@ Pak::Pak() : Pack() {
 
 Pak::~Pak() {
 	close();
+	eeSAFE_DELETE( mPak.fs );
 }
 
 bool Pak::create( const std::string& path ) {
+	return create( path, Version::V1 );
+}
+
+bool Pak::create( const std::string& path, const Version& version ) {
 	if ( !FileSystem::fileExists( path ) ) {
-		pakFile Pak;
+		eeSAFE_DELETE( mPak.fs );
 
-		Pak.header.head[0] = 'P';
-		Pak.header.head[1] = 'A';
-		Pak.header.head[2] = 'C';
-		Pak.header.head[3] = 'K';
+		mPak.fs = IOStreamFile::New( path, "wb" ); // Open the PAK file
 
-		Pak.header.dir_offset = sizeof( Pak.header.head ) + 1;
-		Pak.header.dir_length = 1;
+		if ( !mPak.fs->isOpen() ) {
+			eeSAFE_DELETE( mPak.fs );
+			return false;
+		}
 
-		eeSAFE_DELETE( mPak.fs );
+		if ( version == Version::V2 ) {
+			pakHeaderV2 header;
+			std::memcpy( header.head, "PAK2", 4 );
+			header.version = 2;
+			header.dir_offset = sizeof( pakHeaderV2 );
+			header.entries = 0;
+			header.names_length = 0;
 
-		mPak.fs = IOStreamFile::New( path, "wb" ); // Open the PAK file
+			mPak.fs->write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+		} else {
+			pakFile Pak;
 
-		mPak.fs->write( reinterpret_cast<const char*>( &Pak.header ), sizeof( Pak.header ) );
+			Pak.header.head[0] = 'P';
+			Pak.header.head[1] = 'A';
+			Pak.header.head[2] = 'C';
+			Pak.header.head[3] = 'K';
 
-		eeSAFE_DELETE( mPak.fs );
+			Pak.header.dir_offset = sizeof( Pak.header.head ) + 1;
+			Pak.header.dir_length = 1;
 
-		open( path );
+			mPak.fs->write( reinterpret_cast<const char*>( &Pak.header ), sizeof( Pak.header ) );
+		}
 
-		return true;
+		eeSAFE_DELETE( mPak.fs );
+
+		return open( path );
 	} else {
 		return open( path );
 	}
@@ -49,44 +160,146 @@ bool Pak::create( const std::string& path ) {
 
 bool Pak::open( const std::string& path ) {
 	if ( FileSystem::fileExists( path ) ) {
+		close();
+
 		mPak.pakPath = path;
 
 		eeSAFE_DELETE( mPak.fs );
 
-		mPak.fs = IOStreamFile::New( path, "rwb" ); // Open the PAK file
+		mPak.fs = IOStreamFile::New( path, "r+b" ); // Open the PAK file
+
+		if ( !mPak.fs->isOpen() ) {
+			eeSAFE_DELETE( mPak.fs );
+			mPak.fs = IOStreamFile::New( path, "rb" ); // Read only
+		}
+
+		char head[4] = { 0, 0, 0, 0 };
+		mPak.fs->read( head, sizeof( head ) );
+		mPak.fs->seek( 0 );
 
-		mPak.fs->read( reinterpret_cast<char*>( &mPak.header ),
-					   sizeof( pakHeader ) ); // Read the PAK header
+		if ( std::memcmp( head, "PAK2", 4 ) == 0 ) {
+			if ( !openV2() ) {
+				mEntries.clear();
+				mIndex.clear();
+				eeSAFE_DELETE( mPak.fs );
+				return false;
+			}
+		} else {
+			mVersion = Version::V1;
+
+			mPak.fs->read( reinterpret_cast<char*>( &mPak.header ),
+						   sizeof( pakHeader ) ); // Read the PAK header
+
+			if ( checkPack() != 0 ) {
+				eeSAFE_DELETE( mPak.fs );
+				return false;
+			}
 
-		if ( checkPack() == 0 ) {
 			mPak.pakFilesNum = mPak.header.dir_length / 64; // Number of files in the PAK
 
 			mPak.fs->seek( mPak.header.dir_offset ); // Seek to read the pakEntries
 
-			for ( Uint32 i = 0; i < mPak.pakFilesNum; i++ ) { // Read all the pakEntries
-				pakEntry Entry;
+			mPakFiles.resize( mPak.pakFilesNum );
+
+			if ( mPak.pakFilesNum > 0 )
+				mPak.fs->read( reinterpret_cast<char*>( &mPakFiles[0] ),
+							   sizeof( pakEntry ) * mPak.pakFilesNum ); // Read all the pakEntries
 
-				mPak.fs->read( reinterpret_cast<char*>( &Entry ), sizeof( pakEntry ) );
+			mEntries.reserve( mPak.pakFilesNum );
 
-				mPakFiles.push_back( Entry );
+			for ( const auto& pakEntry : mPakFiles ) {
+				Entry entry;
+				size_t len = strnlen( pakEntry.filename, sizeof( pakEntry.filename ) );
+				entry.path = std::string( pakEntry.filename, len );
+				entry.hash = String::hash( entry.path );
+				entry.position = pakEntry.file_position;
+				entry.length = pakEntry.file_length;
+				entry.uncompressedSize = pakEntry.file_length;
+				entry.compression = FileCompression::None;
+				mEntries.emplace_back( std::move( entry ) );
 			}
 
-			mIsOpen = true;
+			for ( Uint32 i = 0; i < mEntries.size(); i++ )
+				indexEntry( i );
+		}
 
-			onPackOpened();
+		mapFile();
 
-			return true;
-		}
+		mIsOpen = true;
+
+		onPackOpened();
+
+		return true;
 	}
 
 	return false;
 }
 
+bool Pak::openV2() {
+	pakHeaderV2 header;
+
+	if ( mPak.fs->read( reinterpret_cast<char*>( &header ), sizeof( header ) ) !=
+			 sizeof( header ) ||
+		 header.version != 2 || header.dir_offset < sizeof( pakHeaderV2 ) )
+		return false;
+
+	// Validate the directory size against the stream before allocating anything from the header
+	Uint64 size = mPak.fs->getSize();
+	Uint64 dirSize = (Uint64)header.entries * sizeof( pakEntryV2 ) + header.names_length;
+
+	if ( header.dir_offset > size || dirSize > size - header.dir_offset )
+		return false;
+
+	mVersion = Version::V2;
+	mDataEnd = header.dir_offset;
+
+	std::vector<pakEntryV2> entries( header.entries );
+	std::string names( header.names_length, '\0' );
+
+	mPak.fs->seek( header.dir_offset );
+
+	if ( header.entries > 0 &&
+		 mPak.fs->read( reinterpret_cast<char*>( &entries[0] ),
+						sizeof( pakEntryV2 ) * header.entries ) !=
+			 (ios_size)( sizeof( pakEntryV2 ) * header.entries ) )
+		return false;
+
+	if ( header.names_length > 0 &&
+		 mPak.fs->read( &names[0], header.names_length ) != (ios_size)header.names_length )
+		return false;
+
+	mEntries.reserve( header.entries );
+	mIndex.reserve( header.entries );
+
+	for ( const auto& pakEntry : entries ) {
+		if ( (Uint64)pakEntry.name_offset + pakEntry.name_length > names.size() )
+			return false;
+
+		Entry entry;
+		entry.path = names.substr( pakEntry.name_offset, pakEntry.name_length );
+		entry.hash = pakEntry.hash;
+		entry.position = pakEntry.file_position;
+		entry.length = pakEntry.file_length;
+		entry.uncompressedSize = pakEntry.uncompressed_size;
+		entry.compression = static_cast<FileCompression>( pakEntry.compression );
+
+		// The directory is stored sorted, so the index is already built
+		mIndex.push_back( mEntries.size() );
+		mEntries.emplace_back( std::move( entry ) );
+	}
+
+	return true;
+}
+
 bool Pak::close() {
 	if ( mIsOpen ) {
+		unmapFile();
+
 		eeSAFE_DELETE( mPak.fs );
 
 		mPakFiles.clear();
+		mEntries.clear();
+		mIndex.clear();
 
 		mIsOpen = false;
 
@@ -99,7 +312,7 @@ bool Pak::close() {
 }
 
 Int8 Pak::checkPack() {
-	if ( NULL != mPak.fs && mPak.fs->isOpen() ) {
+	if ( NULL != mPak.fs && mPak.fs->isOpen() && mVersion == Version::V1 ) {
 		if ( mPak.header.head[0] != 'P' || mPak.header.head[1] != 'A' ||
 			 mPak.header.head[2] != 'C' || mPak.header.head[3] != 'K' )
 			return -1; // Ident corrupt
@@ -112,66 +325,137 @@ Int8 Pak::checkPack() {
 	return 0;
 }
 
+void Pak::indexEntry( Uint32 index ) {
+	const Entry& entry = mEntries[index];
+
+	auto it = std::lower_bound( mIndex.begin(), mIndex.end(), index, [this]( Uint32 a, Uint32 b ) {
+		const Entry& ea = mEntries[a];
+		const Entry& eb = mEntries[b];
+		return ea.hash != eb.hash ? ea.hash < eb.hash : ea.path < eb.path;
+	} );
+
+	// Duplicated paths keep the first file, as the linear search did
+	if ( it != mIndex.end() && mEntries[*it].hash == entry.hash &&
+		 mEntries[*it].path == entry.path )
+		return;
+
+	mIndex.insert( it, index );
+}
+
 Int32 Pak::exists( const std::string& path ) {
-	if ( isOpen() ) {
-		for ( Uint32 i = 0; i < mPakFiles.size(); i++ )
-			if ( std::strncmp( path.c_str(), mPakFiles[i].filename, path.size() ) == 0 )
-				return i;
+	if ( isOpen() || !mEntries.empty() ) {
+		String::HashType hash = String::hash( path );
+
+		auto it =
+			std::lower_bound( mIndex.begin(), mIndex.end(), hash,
+							  [this]( Uint32 index, String::HashType hash ) {
+								  return mEntries[index].hash < hash;
+							  } );
+
+		for ( ; it != mIndex.end() && mEntries[*it].hash == hash; ++it ) {
+			if ( mEntries[*it].path == path )
+				return *it;
+		}
 	}
 
 	return -1;
 }
 
-bool Pak::extractFile( const std::string& path, const std::string& dest ) {
-	if ( NULL == mPak.fs || !mPak.fs->isOpen() ) {
+const Pak::Entry* Pak::getEntry( const std::string& path ) {
+	Int32 index = exists( path );
+	return index != -1 ? &mEntries[index] : NULL;
+}
+
+void Pak::mapFile() {
+	unmapFile();
+	mMapped = PakMappedFile::map( mPak.pakPath );
+}
+
+void Pak::unmapFile() {
+	eeSAFE_DELETE( mMapped );
+}
+
+bool Pak::isMapped() const {
+	return NULL != mMapped;
+}
+
+const Uint8* Pak::getMappedData( const Entry& entry ) const {
+	if ( NULL == mMapped || entry.position + entry.length > mMapped->size )
+		return NULL;
+
+	return mMapped->data + entry.position;
+}
+
+bool Pak::decompressEntry( const Entry& entry, const Uint8* src, Uint8* dst ) {
+	Compression::Status status =
+		Compression::decompress( dst, entry.uncompressedSize, src, entry.length,
+								 pakCompressionMode( entry.compression ) );
+
+	if ( status != Compression::OK ) {
+		Log::error( "Pak: failed to decompress \"%s\" from \"%s\"", entry.path.c_str(),
+					mPak.pakPath.c_str() );
 		return false;
 	}
 
-	lock();
-
-	bool Ret = false;
+	return true;
+}
 
-	Int32 Pos = exists( path );
+bool Pak::readStoredData( const Entry& entry, ScopedBuffer& data ) {
+	data.reset( entry.length );
 
-	if ( Pos != -1 ) {
-		ScopedBuffer data;
+	if ( entry.length == 0 )
+		return true;
 
-		if ( extractFileToMemory( path, data ) ) {
-			FileSystem::fileWrite( path, data.get(), data.length() );
-		}
+	const Uint8* mapped = getMappedData( entry );
 
-		Ret = true;
+	if ( NULL != mapped ) {
+		std::memcpy( data.get(), mapped, entry.length );
+		return true;
 	}
 
-	unlock();
+	mPak.fs->seek( entry.position );
+	return mPak.fs->read( reinterpret_cast<char*>( data.get() ), entry.length ) ==
+		   (ios_size)entry.length;
+}
+
+const Uint8* Pak::getFileData( const std::string& path, Uint64* size ) {
+	Lock l( *this );
+
+	const Entry* entry = getEntry( path );
+
+	if ( NULL == entry || entry->compression != FileCompression::None )
+		return NULL;
 
-	return Ret;
+	const Uint8* mapped = getMappedData( *entry );
+
+	if ( NULL != mapped && NULL != size )
+		*size = entry->length;
+
+	return mapped;
 }
 
-bool Pak::extractFileToMemory( const std::string& path, std::vector<Uint8>& data ) {
+bool Pak::extractFile( const std::string& path, const std::string& dest ) {
 	if ( NULL == mPak.fs || !mPak.fs->isOpen() ) {
 		return false;
 	}
 
-	lock();
-
-	bool Ret = false;
+	ScopedBuffer data;
 
-	Int32 Pos = exists( path );
+	if ( extractFileToMemory( path, data ) )
+		return FileSystem::fileWrite( dest, data.get(), data.length() );
 
-	if ( Pos != -1 ) {
-		data.clear();
-		data.resize( mPakFiles[Pos].file_length );
+	return false;
+}
 
-		mPak.fs->seek( mPakFiles[Pos].file_position );
-		mPak.fs->read( reinterpret_cast<char*>( &data[0] ), mPakFiles[Pos].file_length );
+bool Pak::extractFileToMemory( const std::string& path, std::vector<Uint8>& data ) {
+	ScopedBuffer buffer;
 
-		Ret = true;
-	}
+	if ( !extractFileToMemory( path, buffer ) )
+		return false;
 
-	unlock();
+	data.assign( buffer.get(), buffer.get() + buffer.length() );
 
-	return Ret;
+	return true;
 }
 
 bool Pak::extractFileToMemory( const std::string& path, ScopedBuffer& data ) {
@@ -179,33 +463,54 @@ bool Pak::extractFileToMemory( const std::string& path, ScopedBuffer& data ) {
 		return false;
 	}
 
-	lock();
+	Lock l( *this );
 
-	bool Ret = false;
+	const Entry* entry = getEntry( path );
 
-	Int32 Pos = exists( path );
+	if ( NULL == entry )
+		return false;
 
-	if ( Pos != -1 ) {
-		data.reset( mPakFiles[Pos].file_length );
+	if ( entry->compression == FileCompression::None )
+		return readStoredData( *entry, data );
 
-		mPak.fs->seek( mPakFiles[Pos].file_position );
-		mPak.fs->read( reinterpret_cast<char*>( data.get() ), data.length() );
+	// Decompress straight from the mapped pack when possible
+	const Uint8* mapped = getMappedData( *entry );
 
-		Ret = true;
+	if ( NULL != mapped ) {
+		data.reset( entry->uncompressedSize );
+		return decompressEntry( *entry, mapped, data.get() );
 	}
 
-	unlock();
+	ScopedBuffer stored;
+
+	if ( !readStoredData( *entry, stored ) )
+		return false;
 
-	return Ret;
+	data.reset( entry->uncompressedSize );
+	return decompressEntry( *entry, stored.get(), data.get() );
 }
 
 bool Pak::addFile( const Uint8* data, const Uint32& dataSize, const std::string& inpack ) {
 	if ( dataSize < 1 )
 		return false;
 
+	if ( mVersion == Version::V2 ) {
+		Lock l( *this );
+		return addFileV2( data, dataSize, inpack, true );
+	}
+
 	Uint32 fsize = dataSize;
 
 	if ( NULL != mPak.fs && mPak.fs->isOpen() ) {
+		if ( inpack.size() >= sizeof( pakEntry::filename ) || exists( inpack ) != -1 )
+			return false;
+
+		Lock l( *this );
+
+		unmapFile();
+
+		pakEntry newFile;
+
 		if ( mPak.header.dir_length == 1 ) {
 			mPak.header.dir_offset = sizeof( pakHeader ) + fsize;
 			mPak.header.dir_length = sizeof( pakEntry );
@@ -219,7 +524,7 @@ bool Pak::addFile( const Uint8* data, const Uint32& dataSize, const std::string&
 
 			mPak.fs->write( reinterpret_cast<const char*>( &data[0] ), fsize );
 
-			pakEntry newFile;
+			std::memset( &newFile, 0, sizeof( newFile ) );
 			String::strCopy( newFile.filename, inpack.c_str(), 56 );
 			newFile.file_position = sizeof( pakHeader );
 			newFile.file_length = fsize;
@@ -227,22 +532,11 @@ bool Pak::addFile( const Uint8* data, const Uint32& dataSize, const std::string&
 			mPak.fs->write( reinterpret_cast<const char*>( &newFile ), sizeof( pakEntry ) );
 
 			mPakFiles.push_back( newFile );
-
-			return true;
 		} else {
-			if ( exists( inpack ) != -1 ) // If the file already exists exit
-				return false;
-
-			if ( mPak.header.dir_length % 64 != 0 ) // Corrupted file?
+			if ( mPak.header.dir_length % 64 != 0 ) { // Corrupted file?
+				mapFile();
 				return false;
-
-			std::vector<pakEntry> pakE;
-			pakE.resize( mPak.pakFilesNum +
-						 1 ); // Alloc space for all the pakEntries and the new one
-
-			mPak.fs->seek( mPak.header.dir_offset ); // seek to the file pakEntries
-			mPak.fs->read( reinterpret_cast<char*>( &pakE[0] ),
-						   sizeof( pakEntry ) * mPak.pakFilesNum ); // get all the pakEntries
+			}
 
 			mPak.header.dir_offset = mPak.header.dir_offset + fsize; // Update the new dir_offset
 			mPak.header.dir_length =
@@ -258,33 +552,151 @@ bool Pak::addFile( const Uint8* data, const Uint32& dataSize, const std::string&
 			mPak.fs->write( reinterpret_cast<const char*>( &data[0] ), fsize ); // Alloc the file
 
 			// Fill the new file data on the pakEntry
-			String::strCopy( pakE[mPak.pakFilesNum].filename, inpack.c_str(), 56 );
+			std::memset( &newFile, 0, sizeof( newFile ) );
+			String::strCopy( newFile.filename, inpack.c_str(), 56 );
+			newFile.file_position = mPak.header.dir_offset - fsize;
+			newFile.file_length = fsize;
 
-			pakE[mPak.pakFilesNum].file_position = mPak.header.dir_offset - fsize;
-			pakE[mPak.pakFilesNum].file_length = fsize;
+			mPakFiles.push_back( newFile );
+			mPak.pakFilesNum += 1;
 
-			// Update the new pakEntries on pakFile
-			mPak.fs->write( reinterpret_cast<const char*>( &pakE[0] ),
-							(ios_size)( sizeof( pakEntry ) * pakE.size() ) );
+			// Update the new pakEntries on pakFile, the directory in memory is up to date
+			mPak.fs->write( reinterpret_cast<const char*>( &mPakFiles[0] ),
+							(ios_size)( sizeof( pakEntry ) * mPakFiles.size() ) );
+		}
 
-			mPakFiles.push_back( pakE[mPak.pakFilesNum] );
-			mPak.pakFilesNum += 1;
+		Entry entry;
+		entry.path = inpack;
+		entry.hash = String::hash( inpack );
+		entry.position = newFile.file_position;
+		entry.length = fsize;
+		entry.uncompressedSize = fsize;
+		entry.compression = FileCompression::None;
+		mEntries.emplace_back( std::move( entry ) );
+		indexEntry( mEntries.size() - 1 );
 
-			pakE.clear();
+		mPak.fs->flush();
+		mapFile();
 
-			return true;
-		}
+		return true;
 	}
 
 	return false;
 }
 
+bool Pak::addFileV2( const Uint8* data, const Uint64& dataSize, const std::string& inpack,
+					 bool writeDirectory ) {
+	if ( NULL == mPak.fs || !mPak.fs->isOpen() || inpack.empty() ||
+		 inpack.size() > std::numeric_limits<Uint16>::max() || exists( inpack ) != -1 )
+		return false;
+
+	Entry entry;
+	entry.path = inpack;
+	entry.hash = String::hash( inpack );
+	entry.position = mDataEnd;
+	entry.length = dataSize;
+	entry.uncompressedSize = dataSize;
+	entry.compression = FileCompression::None;
+
+	IOStreamString compressed;
+
+	if ( mCompression != FileCompression::None ) {
+		IOStreamMemory src( reinterpret_cast<const char*>( data ), dataSize );
+
+		// Keep the file uncompressed if it doesn't shrink ( or the encoder is not available )
+		if ( Compression::compress( compressed, src, pakCompressionMode( mCompression ) ) ==
+				 Compression::OK &&
+			 (Uint64)compressed.getSize() < dataSize ) {
+			data = reinterpret_cast<const Uint8*>( compressed.getStreamPointer() );
+			entry.length = compressed.getSize();
+			entry.compression = mCompression;
+		}
+	}
+
+	unmapFile();
+
+	mPak.fs->seek( mDataEnd );
+	mPak.fs->write( reinterpret_cast<const char*>( data ), entry.length );
+	mDataEnd += entry.length;
+
+	mEntries.emplace_back( std::move( entry ) );
+	indexEntry( mEntries.size() - 1 );
+
+	if ( writeDirectory )
+		return writeDirectoryV2();
+
+	return true;
+}
+
+bool Pak::writeDirectoryV2() {
+	if ( NULL == mPak.fs || !mPak.fs->isOpen() )
+		return false;
+
+	unmapFile();
+
+	std::vector<pakEntryV2> entries;
+	std::string names;
+
+	entries.reserve( mIndex.size() );
+
+	// The directory is written sorted by hash, so it can be binary searched as is
+	for ( Uint32 index : mIndex ) {
+		const Entry& entry = mEntries[index];
+		pakEntryV2 pakEntry;
+		std::memset( &pakEntry, 0, sizeof( pakEntry ) );
+		pakEntry.file_position = entry.position;
+		pakEntry.file_length = entry.length;
+		pakEntry.uncompressed_size = entry.uncompressedSize;
+		pakEntry.hash = entry.hash;
+		pakEntry.name_offset = names.size();
+		pakEntry.name_length = entry.path.size();
+		pakEntry.compression = static_cast<Uint8>( entry.compression );
+		names += entry.path;
+		entries.emplace_back( pakEntry );
+	}
+
+	pakHeaderV2 header;
+	std::memcpy( header.head, "PAK2", 4 );
+	header.version = 2;
+	header.dir_offset = mDataEnd;
+	header.entries = entries.size();
+	header.names_length = names.size();
+
+	mPak.fs->seek( mDataEnd );
+
+	if ( !entries.empty() )
+		mPak.fs->write( reinterpret_cast<const char*>( &entries[0] ),
+						(ios_size)( sizeof( pakEntryV2 ) * entries.size() ) );
+
+	mPak.fs->write( names.data(), names.size() );
+
+	mPak.fs->seek( 0 );
+	mPak.fs->write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+	mPak.fs->flush();
+
+	// The entries indexes changed to the sorted order
+	std::vector<Entry> sorted;
+	sorted.reserve( mEntries.size() );
+
+	for ( Uint32 index : mIndex )
+		sorted.emplace_back( std::move( mEntries[index] ) );
+
+	mEntries = std::move( sorted );
+
+	for ( Uint32 i = 0; i < mIndex.size(); i++ )
+		mIndex[i] = i;
+
+	mapFile();
+
+	return true;
+}
+
 bool Pak::addFile( std::vector<Uint8>& data, const std::string& inpack ) {
 	return addFile( reinterpret_cast<const Uint8*>( &data[0] ), (Uint32)data.size(), inpack );
 }
 
 bool Pak::addFile( const std::string& path, const std::string& inpack ) {
-	if ( path.size() > 56 )
+	if ( mVersion == Version::V1 && inpack.size() >= sizeof( pakEntry::filename ) )
 		return false;
 
 	ScopedBuffer file;
@@ -295,6 +707,24 @@ bool Pak::addFile( const std::string& path, const std::string& inpack ) {
 }
 
 bool Pak::addFiles( std::map<std::string, std::string> paths ) {
+	if ( mVersion == Version::V2 ) {
+		Lock l( *this );
+		bool ret = true;
+
+		for ( auto itr = paths.begin(); itr != paths.end(); ++itr ) {
+			ScopedBuffer file;
+
+			if ( !FileSystem::fileGet( itr->first, file ) ||
+				 !addFileV2( file.get(), file.length(), itr->second, false ) ) {
+				ret = false;
+				break;
+			}
+		}
+
+		// Keep the files already added
+		return writeDirectoryV2() && ret;
+	}
+
 	for ( std::map<std::string, std::string>::iterator itr = paths.begin(); itr != paths.end();
 		  ++itr )
 		if ( !addFile( itr->first, itr->second ) )
@@ -324,20 +754,20 @@ bool Pak::eraseFiles( const std::vector<std::string>& paths ) {
 			files.push_back( Ex );
 	}
 
+	if ( mVersion == Version::V2 )
+		return eraseFilesV2( files );
+
 	nPf.pakPath = std::string( mPak.pakPath + ".new" );
 
 	nPf.fs = IOStreamFile::New( nPf.pakPath.c_str(), "wb" );
 
-	for ( i = 0; i < mPakFiles.size(); i++ ) {
-		bool Remove = false;
-
-		for ( Uint32 u = 0; u < files.size(); u++ ) {
-			if ( files[u] == static_cast<Int32>( i ) )
-				Remove = true;
-		}
+	std::vector<Uint32> uIndex;
 
-		if ( !Remove ) {
+	// Version 1 entries are kept in the same order than the pak directory
+	for ( i = 0; i < mPakFiles.size(); i++ ) {
+		if ( std::find( files.begin(), files.end(), static_cast<Int32>( i ) ) == files.end() ) {
 			uEntry.push_back( mPakFiles[i] );
+			uIndex.push_back( i );
 			total_offset += mPakFiles[i].file_length;
 		}
 	}
@@ -348,29 +778,100 @@ bool Pak::eraseFiles( const std::vector<std::string>& paths ) {
 	nPf.header.head[2] = 'C';
 	nPf.header.head[3] = 'K';
 	nPf.header.dir_offset = total_offset + sizeof( pakHeader );
-	nPf.header.dir_length = (Uint32)uEntry.size() * sizeof( pakEntry );
+	nPf.header.dir_length = uEntry.empty() ? 1 : (Uint32)uEntry.size() * sizeof( pakEntry );
 
 	nPf.fs->write( reinterpret_cast<const char*>( &nPf.header ), sizeof( pakHeader ) );
 
-	std::vector<Uint8> data;
-	for ( i = 0; i < uEntry.size(); i++ )
-		if ( extractFileToMemory( std::string( uEntry[i].filename ), data ) ) {
+	ScopedBuffer data;
+	for ( i = 0; i < uEntry.size(); i++ ) {
+		if ( readStoredData( mEntries[uIndex[i]], data ) ) {
 			uEntry[i].file_position = nPf.fs->tell();
-			uEntry[i].file_length = (Uint32)data.size();
-			nPf.fs->write( reinterpret_cast<const char*>( &data[0] ), (ios_size)data.size() );
+			uEntry[i].file_length = (Uint32)data.length();
+			nPf.fs->write( reinterpret_cast<const char*>( data.get() ), (ios_size)data.length() );
 		}
+	}
 
-	nPf.fs->write( reinterpret_cast<const char*>( &uEntry[0] ),
-				   (ios_size)( sizeof( pakEntry ) * uEntry.size() ) );
+	if ( !uEntry.empty() )
+		nPf.fs->write( reinterpret_cast<const char*>( &uEntry[0] ),
+					   (ios_size)( sizeof( pakEntry ) * uEntry.size() ) );
 
 	eeSAFE_DELETE( nPf.fs );
 
-	remove( mPak.pakPath.c_str() );
-	rename( nPf.pakPath.c_str(), mPak.pakPath.c_str() );
+	std::string pakPath( mPak.pakPath );
+
+	close();
+
+	remove( pakPath.c_str() );
+	rename( nPf.pakPath.c_str(), pakPath.c_str() );
+
+	open( pakPath );
+
+	return true;
+}
+
+bool Pak::eraseFilesV2( const std::vector<Int32>& files ) {
+	std::string pakPath( mPak.pakPath );
+	std::string newPath( pakPath + ".new" );
+	std::vector<Entry> entries;
+
+	{
+		IOStreamFile fs( newPath, "wb" );
+
+		if ( !fs.isOpen() )
+			return false;
+
+		pakHeaderV2 header;
+		std::memset( &header, 0, sizeof( header ) );
+		fs.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+
+		ScopedBuffer data;
+
+		// The files are copied as stored, compressed files are not recompressed
+		for ( Uint32 i = 0; i < mEntries.size(); i++ ) {
+			if ( std::find( files.begin(), files.end(), static_cast<Int32>( i ) ) != files.end() )
+				continue;
+
+			if ( !readStoredData( mEntries[i], data ) )
+				continue;
+
+			Entry entry( mEntries[i] );
+			entry.position = fs.tell();
+			fs.write( reinterpret_cast<const char*>( data.get() ), (ios_size)data.length() );
+			entries.emplace_back( std::move( entry ) );
+		}
+	}
 
 	close();
 
-	open( mPak.pakPath );
+	remove( pakPath.c_str() );
+	rename( newPath.c_str(), pakPath.c_str() );
+
+	// Open the new pack with an empty directory and write the directory of the copied files
+	mPak.pakPath = pakPath;
+	mPak.fs = IOStreamFile::New( pakPath, "r+b" );
+
+	if ( !mPak.fs->isOpen() ) {
+		eeSAFE_DELETE( mPak.fs );
+		return false;
+	}
+
+	mVersion = Version::V2;
+	mDataEnd = sizeof( pakHeaderV2 );
+
+	for ( auto& entry : entries )
+		mDataEnd = eemax( mDataEnd, entry.position + entry.length );
+
+	mEntries = std::move( entries );
+
+	for ( Uint32 i = 0; i < mEntries.size(); i++ )
+		indexEntry( i );
+
+	if ( !writeDirectoryV2() )
+		return false;
+
+	mIsOpen = true;
+
+	onPackOpened();
 
 	return true;
 }
@@ -378,10 +879,10 @@ bool Pak::eraseFiles( const std::vector<std::string>& paths ) {
 std::vector<std::string> Pak::getFileList() {
 	std::vector<std::string> tmpv;
 
-	tmpv.resize( mPakFiles.size() );
+	tmpv.resize( mEntries.size() );
 
-	for ( Uint32 i = 0; i < mPakFiles.size(); i++ )
-		tmpv[i] = std::string( mPakFiles[i].filename );
+	for ( Uint32 i = 0; i < mEntries.size(); i++ )
+		tmpv[i] = mEntries[i].path;
 
 	return tmpv;
 }
@@ -398,6 +899,18 @@ IOStream* Pak::getFileStream( const std::string& path ) {
 	return eeNew( IOStreamPak, ( this, path ) );
 }
 
+const Pak::Version& Pak::getVersion() const {
+	return mVersion;
+}
+
+void Pak::setCompression( const FileCompression& compression ) {
+	mCompression = compression;
+}
+
+const Pak::FileCompression& Pak::getCompression() const {
+	return mCompression;
+}
+
 Pak::pakEntry Pak::getPackEntry( Uint32 index ) {
 	if ( isOpen() && index < mPakFiles.size() ) {
 		return mPakFiles[index];
@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <eepp/core/string.hpp>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/lock.hpp>
+#include <eepp/system/profiler.hpp>
+#include <eepp/system/thread.hpp>
+
+namespace EE { namespace System {
+
+SINGLETON_DECLARE_IMPLEMENTATION( Profiler )
+
+std::atomic<bool> Profiler::sEnabled{ false };
+
+static const std::chrono::steady_clock::time_point sProfilerEpoch =
+	std::chrono::steady_clock::now();
+
+static constexpr Uint64 ProfilerBufferMask = Profiler::ThreadBufferCapacity - 1;
+
+// Zones close to be overwritten by the owner thread are not read from other threads
+static constexpr Uint64 ProfilerReadMargin = 1024;
+
+static std::string jsonEscape( const char* str ) {
+	std::string res;
+	for ( const char* c = str; *c; ++c ) {
+		if ( *c == '"' || *c == '\\' ) {
+			res += '\\';
+			res += *c;
+		} else if ( (unsigned char)*c >= 0x20 ) {
+			res += *c;
+		}
+	}
+	return res;
+}
+
+Profiler::ScopedZone::ScopedZone( const char* name, const char* category ) :
+	mName( name ), mCategory( category ), mActive( Profiler::isEnabled() ) {
+	if ( mActive ) {
+		Profiler::getThreadBuffer()->depth++;
+		mStart = Profiler::now();
+	}
+}
+
+Profiler::ScopedZone::~ScopedZone() {
+	if ( !mActive )
+		return;
+
+	Uint64 end = Profiler::now();
+	ThreadBuffer* buffer = Profiler::getThreadBuffer();
+	buffer->depth--;
+
+	Uint64 head = buffer->head.load( std::memory_order_relaxed );
+	Zone& zone = buffer->zones[head & ProfilerBufferMask];
+	zone.name = mName;
+	zone.category = mCategory;
+	zone.start = mStart;
+	zone.duration = end - mStart;
+	zone.depth = buffer->depth;
+	buffer->head.store( head + 1, std::memory_order_release );
+}
+
+Profiler::Profiler() {}
+
+Profiler::~Profiler() {
+	sEnabled = false;
+}
+
+void Profiler::setEnabled( bool enabled ) {
+	if ( enabled )
+		Profiler::instance();
+	sEnabled = enabled;
+}
+
+Uint64 Profiler::now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() -
+																 sProfilerEpoch )
+		.count();
+}
+
+Profiler::ThreadBuffer* Profiler::getThreadBuffer() {
+	static thread_local std::shared_ptr<ThreadBuffer> buffer;
+
+	if ( !buffer ) {
+		buffer = std::make_shared<ThreadBuffer>();
+		buffer->zones.resize( ThreadBufferCapacity );
+		buffer->threadId = Thread::getCurrentThreadId();
+		Profiler::instance()->registerBuffer( buffer );
+	}
+
+	return buffer.get();
+}
+
+void Profiler::registerBuffer( const std::shared_ptr<ThreadBuffer>& buffer ) {
+	Lock l( mMutex );
+	mBuffers.push_back( buffer );
+}
+
+void Profiler::setThreadName( const std::string& name ) {
+	ThreadBuffer* buffer = getThreadBuffer();
+	Lock l( Profiler::instance()->mMutex );
+	buffer->name = name;
+}
+
+void Profiler::frameMark() {
+	Uint64 frameEnd = now();
+	ThreadBuffer* buffer = getThreadBuffer();
+	Uint64 head = buffer->head.load( std::memory_order_relaxed );
+	Uint64 tail = eemax( buffer->tail.load( std::memory_order_relaxed ),
+						 head > ThreadBufferCapacity ? head - ThreadBufferCapacity : 0 );
+	std::vector<const Zone*> zones;
+
+	// The zones are stored in the order they end, the ones of this frame are at the end
+	for ( Uint64 i = head; i > tail; --i ) {
+		const Zone& zone = buffer->zones[( i - 1 ) & ProfilerBufferMask];
+
+		if ( zone.start + zone.duration < mFrameStart )
+			break;
+
+		if ( zone.start >= mFrameStart )
+			zones.push_back( &zone );
+	}
+
+	std::sort( zones.begin(), zones.end(),
+			   []( const Zone* a, const Zone* b ) { return a->start < b->start; } );
+
+	std::vector<ZoneStats> stats;
+
+	for ( const Zone* zone : zones ) {
+		auto it = std::find_if( stats.begin(), stats.end(), [zone]( const ZoneStats& stat ) {
+			return stat.depth == zone->depth && strcmp( stat.name, zone->name ) == 0;
+		} );
+
+		if ( it == stats.end() ) {
+			ZoneStats stat;
+			stat.name = zone->name;
+			stat.depth = zone->depth;
+			stats.push_back( stat );
+			it = stats.end() - 1;
+		}
+
+		it->calls++;
+		it->time += Microseconds( zone->duration / 1000 );
+	}
+
+	Lock l( mMutex );
+	mLastFrameStats = std::move( stats );
+	mLastFrameTime = Microseconds( ( frameEnd - mFrameStart ) / 1000 );
+	mFrameStart = frameEnd;
+}
+
+std::vector<Profiler::ZoneStats> Profiler::getLastFrameStats() const {
+	Lock l( mMutex );
+	return mLastFrameStats;
+}
+
+Time Profiler::getLastFrameTime() const {
+	Lock l( mMutex );
+	return mLastFrameTime;
+}
+
+std::string Profiler::toChromeTraceJSON() const {
+	std::string json( "{\"traceEvents\":[" );
+	bool first = true;
+
+	Lock l( mMutex );
+
+	for ( const auto& buffer : mBuffers ) {
+		if ( !buffer->name.empty() ) {
+			json += String::format(
+				"%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%llu,"
+				"\"args\":{\"name\":\"%s\"}}",
+				first ? "" : ",", (unsigned long long)buffer->threadId,
+				jsonEscape( buffer->name.c_str() ).c_str() );
+			first = false;
+		}
+
+		Uint64 head = buffer->head.load( std::memory_order_acquire );
+		Uint64 tail = buffer->tail.load( std::memory_order_relaxed );
+
+		if ( head > ThreadBufferCapacity - ProfilerReadMargin )
+			tail = eemax( tail, head - ( ThreadBufferCapacity - ProfilerReadMargin ) );
+
+		for ( Uint64 i = tail; i < head; ++i ) {
+			const Zone& zone = buffer->zones[i & ProfilerBufferMask];
+			json += String::format(
+				"%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+				"\"pid\":1,\"tid\":%llu}",
+				first ? "" : ",", jsonEscape( zone.name ).c_str(),
+				jsonEscape( zone.category ).c_str(), zone.start / 1000.0, zone.duration / 1000.0,
+				(unsigned long long)buffer->threadId );
+			first = false;
+		}
+	}
+
+	json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return json;
+}
+
+bool Profiler::exportChromeTrace( const std::string& path ) const {
+	return FileSystem::fileWrite( path, toChromeTraceJSON() );
+}
+
+void Profiler::clear() {
+	Lock l( mMutex );
+
+	for ( auto& buffer : mBuffers )
+		buffer->tail = buffer->head.load( std::memory_order_acquire );
+
+	mLastFrameStats.clear();
+}
+
+}} // namespace EE::System
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <eepp/system/profiler.hpp>
 #include <eepp/system/threadpool.hpp>
 
 namespace EE { namespace System {
@@ -43,6 +44,8 @@ ThreadPool::~ThreadPool() {
 }
 
 void ThreadPool::threadFunc() {
+	EE_PROFILE_THREAD_NAME( "ThreadPool worker" );
+
 	while ( true ) {
 		std::unique_ptr<Work> work;
 		{
@@ -58,10 +61,13 @@ void ThreadPool::threadFunc() {
 			mWork.pop_front();
 		}
 
-		work->func();
+		{
+			EE_PROFILE_ZONE_CATEGORY( "ThreadPool::job", "threadpool" );
+			work->func();
 
-		if ( work->callback != nullptr ) {
-			work->callback( work->id );
+			if ( work->callback != nullptr ) {
+				work->callback( work->id );
+			}
 		}
 	}
 }
@@ -128,6 +134,39 @@ Uint64 ThreadPool::run( const std::function<void()>& func,
 	return id;
 }
 
+void ThreadPool::parallelFor( const size_t& count, const std::function<void( size_t )>& fn ) {
+	if ( count == 0 )
+		return;
+
+	struct State {
+		std::atomic<size_t> next{ 0 };
+		std::atomic<size_t> done{ 0 };
+		std::mutex mutex;
+		std::condition_variable finished;
+	};
+
+	auto state = std::make_shared<State>();
+	auto work = [state, count, &fn] {
+		size_t index;
+		while ( ( index = state->next++ ) < count ) {
+			fn( index );
+			if ( ++state->done == count ) {
+				std::unique_lock<std::mutex> lock( state->mutex );
+				state->finished.notify_all();
+			}
+		}
+	};
+
+	size_t helpers = eemin<size_t>( numThreads(), count - 1 );
+	for ( size_t i = 0; i < helpers; ++i )
+		run( work );
+
+	work();
+
+	std::unique_lock<std::mutex> lock( state->mutex );
+	state->finished.wait( lock, [&state, count] { return state->done == count; } );
+}
+
 Uint32 ThreadPool::numThreads() const {
 	std::unique_lock<std::mutex> lock( mMutex );
 	return mShuttingDown ? 0 : static_cast<Uint32>( mThreads.size() );
@@ -1,10 +1,13 @@
 #include <eepp/core/string.hpp>
 #include <eepp/system/time.hpp>
+#include <limits>
 
 namespace EE { namespace System {
 
 const Time Time::Zero;
 
+const Time Time::Infinity = Microseconds( std::numeric_limits<Int64>::max() );
+
 bool Time::isValid( const std::string& str ) {
 	if ( String::endsWith( str, "s" ) || String::endsWith( str, "ms" ) ) {
 		size_t to = str.find_last_of( "sm" );
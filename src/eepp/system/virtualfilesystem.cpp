@@ -13,6 +13,19 @@ static std::vector<std::string> vfsSplitPath( std::string& path ) {
 	return String::split( path, '/' );
 }
 
+static std::string vfsNormalizePath( const std::string& path ) {
+	bool normalized = !path.empty() && path.front() != '/' && path.back() != '/' &&
+					  path.find( "//" ) == std::string::npos;
+#if EE_PLATFORM == EE_PLATFORM_WIN
+	normalized = normalized && path.find_first_of( '\\' ) == std::string::npos;
+#endif
+	if ( normalized )
+		return path;
+
+	std::string tpath( path );
+	return String::join( vfsSplitPath( tpath ), '/' );
+}
+
 VirtualFileSystem::VirtualFileSystem() {}
 
 std::vector<std::string> VirtualFileSystem::filesGetInPath( std::string path ) {
@@ -45,30 +58,8 @@ std::vector<std::string> VirtualFileSystem::filesGetInPath( std::string path ) {
 }
 
 Pack* VirtualFileSystem::getPackFromFile( std::string path ) {
-	std::vector<std::string> paths = vfsSplitPath( path );
-	vfsDirectory* curDir = &mRoot;
-
-	if ( paths.size() >= 1 ) {
-		size_t pos = 0;
-
-		do {
-			if ( pos == paths.size() - 1 ) {
-				if ( curDir->files.find( paths[pos] ) != curDir->files.end() ) {
-					return curDir->files[paths[pos]].pack;
-				}
-			} else {
-				if ( curDir->directories.find( paths[pos] ) == curDir->directories.end() ) {
-					return NULL;
-				}
-
-				curDir = &curDir->directories[paths[pos]];
-			}
-
-			pos++;
-		} while ( pos < paths.size() );
-	}
-
-	return NULL;
+	auto it = mFiles.find( vfsNormalizePath( path ) );
+	return it != mFiles.end() ? it->second : NULL;
 }
 
 IOStream* VirtualFileSystem::getFileFromPath( const std::string& path ) {
@@ -93,10 +84,21 @@ void VirtualFileSystem::onResourceAdd( Pack* resource ) {
 void VirtualFileSystem::onResourceRemove( Pack* resource ) {
 	remove( resource );
 	removePackFromDirectory( resource, mRoot );
+
+	for ( auto it = mFiles.begin(); it != mFiles.end(); ) {
+		if ( it->second == resource )
+			it = mFiles.erase( it );
+		else
+			++it;
+	}
 }
 
 void VirtualFileSystem::addFile( std::string path, Pack* pack ) {
 	std::vector<std::string> paths = vfsSplitPath( path );
+
+	if ( !paths.empty() )
+		mFiles[String::join( paths, '/' )] = pack;
+
 	vfsDirectory* curDir = &mRoot;
 
 	if ( paths.size() >= 1 ) {
@@ -637,17 +637,46 @@ UIWidget* UIAbstractTableView::setupCell( UITableCell* widget, UIWidget* rowWidg
 	return widget;
 }
 
-UIWidget* UIAbstractTableView::updateCell( const Vector2<Int64>& posIndex, const ModelIndex& index,
-										   const size_t&, const Float& yOffset ) {
+Uint32 UIAbstractTableView::getCellType( const ModelIndex& index ) const {
+	return index.column();
+}
+
+UIWidget* UIAbstractTableView::acquireCell( const Vector2<Int64>& posIndex,
+											const ModelIndex& index, const Float& yOffset ) {
 	if ( posIndex.y >= (int)mWidgets.size() )
 		mWidgets.resize( posIndex.y + 1 );
+	if ( posIndex.y >= (int)mCellPool.size() )
+		mCellPool.resize( posIndex.y + 1 );
+
+	Uint32 type = getCellType( index );
 	auto* widget = mWidgets[posIndex.y][posIndex.x];
-	if ( !widget ) {
+
+	if ( widget ) {
+		auto typeIt = mCellTypes.find( widget );
+		if ( typeIt == mCellTypes.end() || typeIt->second == type )
+			return widget;
+		widget->setVisible( false, false );
+		mCellPool[posIndex.y][typeIt->second].push_back( widget );
+	}
+
+	auto& pool = mCellPool[posIndex.y][type];
+	if ( !pool.empty() ) {
+		widget = pool.back();
+		pool.pop_back();
+	} else {
 		UIWidget* rowWidget = updateRow( posIndex.y, index, yOffset );
 		widget = createCell( rowWidget, index );
-		mWidgets[posIndex.y][posIndex.x] = widget;
+		mCellTypes[widget] = type;
 		widget->reloadStyle( true, true, true );
 	}
+
+	mWidgets[posIndex.y][posIndex.x] = widget;
+	return widget;
+}
+
+UIWidget* UIAbstractTableView::updateCell( const Vector2<Int64>& posIndex, const ModelIndex& index,
+										   const size_t&, const Float& yOffset ) {
+	auto* widget = acquireCell( posIndex, index, yOffset );
 	const auto& colData = columnData( index.column() );
 	if ( !colData.visible ) {
 		widget->setVisible( false, false );
@@ -732,7 +761,8 @@ void UIAbstractTableView::updateTableCellData( UITableCell* cell, const ModelInd
 		}
 	}
 
-	Variant txt( getModel()->data( index, ModelRole::Display ) );
+	Variant storage;
+	const Variant& txt = getDisplayData( index, storage );
 	if ( txt.isValid() ) {
 		if ( txt.is( Variant::Type::String ) )
 			cell->setText( txt.asString() );
@@ -743,6 +773,30 @@ void UIAbstractTableView::updateTableCellData( UITableCell* cell, const ModelInd
 	}
 }
 
+void UIAbstractTableView::prefetchDisplayData( const ModelIndex& parent, Int64 firstRow,
+											   Int64 rowCount, Int64 firstColumn,
+											   Int64 columnCount ) {
+	if ( !getModel() || rowCount <= 0 || columnCount <= 0 ) {
+		mDisplayData.clear();
+		return;
+	}
+	mDisplayData.reset( parent, firstRow, rowCount, firstColumn, columnCount,
+						ModelRole::Display );
+	getModel()->dataRange( mDisplayData );
+}
+
+void UIAbstractTableView::releaseDisplayData() {
+	mDisplayData.clear();
+}
+
+const Variant& UIAbstractTableView::getDisplayData( const ModelIndex& index,
+													Variant& storage ) const {
+	if ( !mDisplayData.empty() && mDisplayData.contains( index ) )
+		return mDisplayData.get( index );
+	storage = getModel()->data( index, ModelRole::Display );
+	return storage;
+}
+
 void UIAbstractTableView::moveSelection( int steps ) {
 	if ( !getModel() )
 		return;
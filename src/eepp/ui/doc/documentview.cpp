@@ -70,18 +70,24 @@ void DocumentView::setLineWrapMode( LineWrapMode mode ) {
 }
 
 TextPosition DocumentView::getVisibleIndexPosition( VisibleIndex visibleIndex ) const {
-	eeASSERT( mConfig.mode == LineWrapMode::NoWrap || !mVisibleLines.empty() );
-	if ( isOneToOne() || mVisibleLines.empty() )
+	eeASSERT( mConfig.mode == LineWrapMode::NoWrap || !mLines.empty() );
+	if ( isOneToOne() || mLines.empty() )
 		return { static_cast<Int64>( visibleIndex ), 0 };
-	return mVisibleLines[eeclamp( static_cast<Int64>( visibleIndex ), 0ll,
-								  eemax( static_cast<Int64>( mVisibleLines.size() ) - 1, 0ll ) )];
+	Int64 idx = eeclamp( static_cast<Int64>( visibleIndex ), 0ll,
+						 eemax( mVisualLines.total() - 1, 0ll ) );
+	Int64 docIdx = eemin( static_cast<Int64>( mVisualLines.find( idx ) ),
+						  static_cast<Int64>( mLines.size() ) - 1 );
+	const auto& line = measureLine( docIdx );
+	// The line could have less visual lines than estimated
+	Int64 offset = eemin( idx - lineStartVisibleIndex( docIdx ), line.visualLines - 1 );
+	return { docIdx, offset > 0 ? line.wraps[offset - 1] : 0 };
 }
 
 Float DocumentView::getLinePadding( Int64 docIdx ) const {
-	if ( isOneToOne() || mVisibleLinesOffset.empty() )
+	if ( isOneToOne() || mLines.empty() )
 		return 0;
-	return mVisibleLinesOffset[eeclamp(
-		docIdx, 0ll, eemax( static_cast<Int64>( mVisibleLinesOffset.size() ) - 1, 0ll ) )];
+	return measureLine( eeclamp( docIdx, 0ll, static_cast<Int64>( mLines.size() ) - 1 ) )
+		.paddingStart;
 }
 
 void DocumentView::setConfig( Config config ) {
@@ -103,42 +109,39 @@ void DocumentView::invalidateCache() {
 	Clock clock;
 	BoolScopedOp op( mUnderConstruction, true );
 
-	mVisibleLines.clear();
-	mDocLineToVisibleIndex.clear();
-	mVisibleLinesOffset.clear();
-
-	bool wrap = mConfig.mode != LineWrapMode::NoWrap;
+	bool wrap = isWrapEnabled();
 	Int64 linesCount = mDoc->linesCount();
-	mVisibleLines.reserve( linesCount );
-	mVisibleLinesOffset.reserve( linesCount );
-	mDocLineToVisibleIndex.reserve( linesCount );
-
-	for ( auto i = 0; i < linesCount; i++ ) {
-		if ( isFolded( i, true ) ) {
-			mVisibleLinesOffset.emplace_back(
-				wrap ? LineWrap::computeOffsets(
-						   mDoc->line( i ).getText().view(), mFontStyle, mConfig.tabWidth,
-						   eemax( mMaxWidth - mWhiteSpaceWidth, mWhiteSpaceWidth ) )
-					 : 0 );
-			mDocLineToVisibleIndex.push_back( static_cast<Int64>( VisibleIndex::invalid ) );
-		} else {
-			auto lb = wrap ? computeLineBreaks( *mDoc, i, mFontStyle, mMaxWidth, mConfig.mode,
-												mConfig.keepIndentation, mConfig.tabWidth,
-												mWhiteSpaceWidth, mConfig.tabStops )
-						   : LineWrapInfo{ { 0 }, 0.f };
-			mVisibleLinesOffset.emplace_back( lb.paddingStart );
-			bool first = true;
-			for ( const auto& col : lb.wraps ) {
-				mVisibleLines.emplace_back( i, col );
-				if ( first ) {
-					mDocLineToVisibleIndex.emplace_back( mVisibleLines.size() - 1 );
-					first = false;
-				}
-			}
-		}
-	}
+	mLines.clear();
+	mLines.resize( linesCount );
 
-	eeASSERT( static_cast<Int64>( mDocLineToVisibleIndex.size() ) == linesCount );
+	for ( const auto& region : mFoldedRegions ) {
+		Int64 toLine = eemin( region.end().line(), linesCount - 1 );
+		for ( Int64 i = eemax( region.start().line() + 1, 0ll ); i <= toLine; i++ )
+			mLines[i].hidden = true;
+	}
+
+	mEstimatedCharWidth = mWhiteSpaceWidth;
+	if ( wrap && mEstimatedCharWidth == 0 && mFontStyle.Font ) {
+		mEstimatedCharWidth =
+			mFontStyle.Font
+				->getGlyph( L' ', mFontStyle.CharacterSize,
+							( mFontStyle.Style & Text::Style::Bold ) != 0,
+							( mFontStyle.Style & Text::Style::Italic ) != 0,
+							mFontStyle.OutlineThickness )
+				.advance;
+	}
+
+	// Line breaks are computed lazily, until then every line uses an estimation
+	std::vector<Int64> visualLines( linesCount );
+	for ( Int64 i = 0; i < linesCount; i++ ) {
+		auto& line = mLines[i];
+		line.measured = !wrap;
+		line.visualLines = line.hidden ? 0 : estimateVisualLines( i );
+		visualLines[i] = line.visualLines;
+	}
+	mVisualLines.assign( visualLines );
+	mPendingLines = wrap ? linesCount : 0;
+	mPendingLinesCursor = 0;
 
 	mPendingReconstruction = false;
 
@@ -148,30 +151,142 @@ void DocumentView::invalidateCache() {
 				clock.getElapsedTime().toString() );
 }
 
+bool DocumentView::measureVisibleRegion( VisibleIndex fromVisibleIndex, Int64 visibleCount ) {
+	if ( isOneToOne() || mLines.empty() || mPendingLines == 0 )
+		return false;
+
+	Int64 visibleLinesCount = mVisualLines.total();
+	Int64 idx = eeclamp( static_cast<Int64>( fromVisibleIndex ), 0ll,
+						 eemax( visibleLinesCount - 1, 0ll ) );
+	Int64 linesCount = mLines.size();
+	Int64 docIdx = mVisualLines.find( idx );
+	Int64 covered = lineStartVisibleIndex( docIdx ) - idx;
+
+	for ( ; docIdx < linesCount && covered < visibleCount; docIdx++ ) {
+		if ( !mLines[docIdx].hidden )
+			covered += measureLine( docIdx ).visualLines;
+	}
+
+	if ( visibleLinesCount != mVisualLines.total() ) {
+		onVisibleLinesCountChange();
+		return true;
+	}
+	return false;
+}
+
+bool DocumentView::measurePendingLines( const Time& budget ) {
+	if ( mLines.empty() || mPendingLines == 0 )
+		return false;
+
+	Clock clock;
+	Int64 visibleLinesCount = mVisualLines.total();
+	Int64 linesCount = mLines.size();
+
+	while ( mPendingLines > 0 && mPendingLinesCursor < linesCount ) {
+		measureLine( mPendingLinesCursor++ );
+		if ( ( mPendingLinesCursor % 64 ) == 0 && clock.getElapsedTime() >= budget )
+			break;
+	}
+
+	// Every pending line is always after the cursor
+	if ( mPendingLinesCursor >= linesCount )
+		mPendingLines = 0;
+
+	if ( visibleLinesCount != mVisualLines.total() ) {
+		onVisibleLinesCountChange();
+		return true;
+	}
+	return false;
+}
+
+Int64 DocumentView::estimateVisualLines( Int64 docIdx ) const {
+	if ( !isWrapEnabled() || mEstimatedCharWidth <= 0 || mMaxWidth <= 0 ||
+		 docIdx >= static_cast<Int64>( mDoc->linesCount() ) )
+		return 1;
+	Float width = ( mDoc->line( docIdx ).size() - 1 ) * mEstimatedCharWidth;
+	return eemax( 1ll, static_cast<Int64>( std::ceil( width / mMaxWidth ) ) );
+}
+
+void DocumentView::resetLine( Int64 docIdx, bool hidden ) {
+	auto& line = mLines[docIdx];
+	// Without wrapping there's nothing to measure
+	bool measured = !isWrapEnabled();
+	if ( line.measured != measured )
+		mPendingLines += measured ? -1 : 1;
+	if ( !measured )
+		mPendingLinesCursor = eemin( mPendingLinesCursor, docIdx );
+	line.wraps.clear();
+	line.paddingStart = 0;
+	line.measured = measured;
+	line.hidden = hidden;
+	setLineVisualLines( docIdx, hidden ? 0 : estimateVisualLines( docIdx ) );
+}
+
+const DocumentView::LineBreaks& DocumentView::measureLine( Int64 docIdx ) const {
+	auto& line = mLines[docIdx];
+	if ( line.measured )
+		return line;
+
+	line.measured = true;
+	mPendingLines--;
+
+	if ( line.hidden ) {
+		line.paddingStart =
+			LineWrap::computeOffsets( mDoc->line( docIdx ).getText().view(), mFontStyle,
+									  mConfig.tabWidth,
+									  eemax( mMaxWidth - mWhiteSpaceWidth, mWhiteSpaceWidth ) );
+		return line;
+	}
+
+	auto lb = computeLineBreaks( *mDoc, docIdx, mFontStyle, mMaxWidth, mConfig.mode,
+								 mConfig.keepIndentation, mConfig.tabWidth, mWhiteSpaceWidth,
+								 mConfig.tabStops );
+	line.paddingStart = lb.paddingStart;
+	line.wraps.clear();
+	if ( lb.wraps.size() > 1 )
+		line.wraps.assign( lb.wraps.begin() + 1, lb.wraps.end() );
+	setLineVisualLines( docIdx, line.wraps.size() + 1 );
+	return line;
+}
+
+void DocumentView::setLineVisualLines( Int64 docIdx, Int64 visualLines ) const {
+	auto& line = mLines[docIdx];
+	if ( line.visualLines != visualLines ) {
+		mVisualLines.add( docIdx, visualLines - line.visualLines );
+		line.visualLines = visualLines;
+	}
+}
+
+void DocumentView::measureAllLines() const {
+	if ( mPendingLines == 0 )
+		return;
+	Int64 linesCount = mLines.size();
+	for ( Int64 i = 0; i < linesCount; i++ )
+		measureLine( i );
+	mPendingLinesCursor = linesCount;
+}
+
+Int64 DocumentView::lineStartVisibleIndex( Int64 docIdx ) const {
+	return mVisualLines.prefixSum( docIdx );
+}
+
 VisibleIndex DocumentView::toVisibleIndex( Int64 docIdx, bool retLast ) const {
 	// eeASSERT( isLineVisible( docIdx ) );
-	if ( isOneToOne() || mDocLineToVisibleIndex.empty() )
+	if ( isOneToOne() || mLines.empty() )
 		return static_cast<VisibleIndex>( docIdx );
-	auto idx = mDocLineToVisibleIndex[eeclamp(
-		docIdx, 0ll, static_cast<Int64>( mDocLineToVisibleIndex.size() - 1 ) )];
-	if ( retLast && idx != static_cast<Int64>( VisibleIndex::invalid ) ) {
-		Int64 lastOfLine = mVisibleLines[idx].line();
-		Int64 visibleLinesCount = mVisibleLines.size();
-		for ( auto i = idx + 1; i < visibleLinesCount; i++ ) {
-			if ( mVisibleLines[i].line() == lastOfLine )
-				idx = i;
-			else
-				break;
-		}
-	}
+	docIdx = eeclamp( docIdx, 0ll, static_cast<Int64>( mLines.size() - 1 ) );
+	if ( mLines[docIdx].hidden )
+		return VisibleIndex::invalid;
+	Int64 idx = lineStartVisibleIndex( docIdx );
+	if ( retLast )
+		idx += measureLine( docIdx ).visualLines - 1;
 	return static_cast<VisibleIndex>( idx );
 }
 
 bool DocumentView::isWrappedLine( Int64 docIdx ) const {
-	if ( isWrapEnabled() ) {
-		Int64 visibleIndex = static_cast<Int64>( toVisibleIndex( docIdx ) );
-		return visibleIndex + 1 < static_cast<Int64>( mVisibleLines.size() ) &&
-			   mVisibleLines[visibleIndex].line() == mVisibleLines[visibleIndex + 1].line();
+	if ( isWrapEnabled() && docIdx >= 0 && docIdx < static_cast<Int64>( mLines.size() ) &&
+		 !mLines[docIdx].hidden ) {
+		return measureLine( docIdx ).visualLines > 1;
 	}
 	return false;
 }
@@ -179,72 +294,68 @@ bool DocumentView::isWrappedLine( Int64 docIdx ) const {
 DocumentView::VisibleLineInfo DocumentView::getVisibleLineInfo( Int64 docIdx ) const {
 	eeASSERT( isLineVisible( docIdx ) );
 	VisibleLineInfo line;
-	if ( isOneToOne() ) {
+	if ( isOneToOne() || mLines.empty() ) {
 		line.visualLines.push_back( { docIdx, 0 } );
 		line.visibleIndex = static_cast<VisibleIndex>( docIdx );
 		return line;
 	}
-	Int64 fromIdx = static_cast<Int64>( toVisibleIndex( docIdx ) );
-	Int64 toIdx = static_cast<Int64>( toVisibleIndex( docIdx, true ) );
-	line.visualLines.reserve( toIdx - fromIdx + 1 );
-	for ( Int64 i = fromIdx; i <= toIdx; i++ )
-		line.visualLines.emplace_back( mVisibleLines[i] );
-	line.visibleIndex = static_cast<VisibleIndex>( fromIdx );
-	line.paddingStart = mVisibleLinesOffset[docIdx];
+	if ( !isLineVisible( docIdx ) )
+		return line;
+	const auto& lb = measureLine( docIdx );
+	line.visualLines.reserve( lb.wraps.size() + 1 );
+	line.visualLines.push_back( { docIdx, 0 } );
+	for ( const auto& col : lb.wraps )
+		line.visualLines.push_back( { docIdx, col } );
+	line.visibleIndex = toVisibleIndex( docIdx );
+	line.paddingStart = lb.paddingStart;
 	return line;
 }
 
 DocumentView::VisibleLineRange DocumentView::getVisibleLineRange( const TextPosition& pos,
 																  bool allowVisualLineEnd ) const {
-	if ( isOneToOne() ) {
-		DocumentView::VisibleLineRange info;
+	DocumentView::VisibleLineRange info;
+
+	if ( isOneToOne() || mLines.empty() ) {
 		info.visibleIndex = static_cast<VisibleIndex>( pos.line() );
 		info.range = mDoc->getLineRange( pos.line() );
 		return info;
 	}
 
-	Int64 fromIdx = static_cast<Int64>( toVisibleIndex( pos.line() ) );
-	Int64 toIdx = static_cast<Int64>( toVisibleIndex( pos.line(), true ) );
+	if ( !isLineVisible( pos.line() ) )
+		return info;
 
-	DocumentView::VisibleLineRange info;
+	const auto& lb = measureLine( pos.line() );
+	Int64 fromIdx = lineStartVisibleIndex( pos.line() );
+	Int64 last = lb.visualLines - 1;
+	auto column = [&lb]( Int64 i ) { return i > 0 ? lb.wraps[i - 1] : 0; };
 
-	// If we have no visible lines in range, return early
-	if ( fromIdx >= toIdx ) {
-		info.visibleIndex = static_cast<VisibleIndex>( toIdx );
-		if ( info.visibleIndex != VisibleIndex::invalid ) {
-			info.range = { { pos.line(), mVisibleLines[toIdx].column() },
-						   mDoc->endOfLine( { pos.line(), 0ll } ) };
-		}
+	// A line without wraps has a single range
+	if ( last == 0 ) {
+		info.visibleIndex = static_cast<VisibleIndex>( fromIdx );
+		info.range = { { pos.line(), 0 }, mDoc->endOfLine( { pos.line(), 0ll } ) };
 		return info;
 	}
 
 	// Binary search implementation
-	Int64 left = fromIdx;
-	Int64 right = toIdx - 1; // Subtract 1 since we need to access [i+1] in the loop
+	Int64 left = 0;
+	Int64 right = last - 1; // Subtract 1 since we need to access [i+1] in the loop
 
 	while ( left <= right ) {
 		Int64 mid = left + ( right - left ) / 2;
 
-		Int64 fromCol = mVisibleLines[mid].column();
-		Int64 toCol = mid + 1 <= toIdx
-						  ? mVisibleLines[mid + 1].column() - ( allowVisualLineEnd ? 0 : 1 )
-						  : mDoc->getLineLength( pos.line() );
+		Int64 fromCol = column( mid );
+		Int64 toCol = column( mid + 1 ) - ( allowVisualLineEnd ? 0 : 1 );
 
 		if ( pos.column() >= fromCol && pos.column() <= toCol ) {
 			// If it's between the limits we must check if it fits into the previous one
 			if ( allowVisualLineEnd && pos.column() == fromCol && mid - 1 >= 0 ) {
-				Int64 fromCol = mVisibleLines[mid - 1].column();
-				Int64 toCol = mid <= toIdx
-								  ? mVisibleLines[mid].column() - ( allowVisualLineEnd ? 0 : 1 )
-								  : mDoc->getLineLength( pos.line() );
-
-				info.visibleIndex = static_cast<VisibleIndex>( mid - 1 );
-				info.range = { { pos.line(), fromCol }, { pos.line(), toCol } };
+				info.visibleIndex = static_cast<VisibleIndex>( fromIdx + mid - 1 );
+				info.range = { { pos.line(), column( mid - 1 ) }, { pos.line(), fromCol } };
 				return info;
 			}
 
 			// Found the correct range
-			info.visibleIndex = static_cast<VisibleIndex>( mid );
+			info.visibleIndex = static_cast<VisibleIndex>( fromIdx + mid );
 			info.range = { { pos.line(), fromCol }, { pos.line(), toCol } };
 			return info;
 		}
@@ -257,25 +368,21 @@ DocumentView::VisibleLineRange DocumentView::getVisibleLineRange( const TextPosi
 	}
 
 	// If we didn't find an exact match, return the last possible range
-	eeASSERT( toIdx >= 0 );
-	info.visibleIndex = static_cast<VisibleIndex>( toIdx );
-	if ( info.visibleIndex != VisibleIndex::invalid ) {
-		info.range = { { pos.line(), mVisibleLines[toIdx].column() },
-					   mDoc->endOfLine( { pos.line(), 0ll } ) };
-	}
+	info.visibleIndex = static_cast<VisibleIndex>( fromIdx + last );
+	info.range = { { pos.line(), column( last ) }, mDoc->endOfLine( { pos.line(), 0ll } ) };
 	return info;
 }
 
 TextRange DocumentView::getVisibleIndexRange( VisibleIndex visibleIndex ) const {
-	if ( isOneToOne() )
+	if ( isOneToOne() || mLines.empty() )
 		return mDoc->getLineRange( static_cast<Int64>( visibleIndex ) );
-	Int64 idx = static_cast<Int64>( visibleIndex );
 	auto start = getVisibleIndexPosition( visibleIndex );
 	auto end = start;
 	eeASSERT( visibleIndex >= static_cast<VisibleIndex>( 0 ) );
-	if ( idx >= 0 && idx + 1 < static_cast<Int64>( mVisibleLines.size() ) &&
-		 mVisibleLines[idx + 1].line() == start.line() ) {
-		end.setColumn( mVisibleLines[idx + 1].column() );
+	const auto& line = mLines[start.line()];
+	Int64 offset = static_cast<Int64>( visibleIndex ) - lineStartVisibleIndex( start.line() );
+	if ( offset >= 0 && offset + 1 < line.visualLines ) {
+		end.setColumn( line.wraps[offset] );
 	} else {
 		end.setColumn( mDoc->getLineLength( start.line() ) );
 	}
@@ -302,11 +409,12 @@ void DocumentView::setPendingReconstruction( bool pendingReconstruction ) {
 }
 
 void DocumentView::clearCache() {
-	auto visibleLines = mVisibleLines.size();
-	mVisibleLines.clear();
-	mDocLineToVisibleIndex.clear();
-	mVisibleLinesOffset.clear();
-	if ( mDoc && visibleLines != mDoc->linesCount() )
+	Int64 visibleLines = mVisualLines.total();
+	mLines.clear();
+	mVisualLines.clear();
+	mPendingLines = 0;
+	mPendingLinesCursor = 0;
+	if ( mDoc && visibleLines != static_cast<Int64>( mDoc->linesCount() ) )
 		onVisibleLinesCountChange();
 }
 
@@ -326,9 +434,9 @@ double DocumentView::getLineYOffset( Int64 docIdx, Float lineHeight ) const {
 }
 
 bool DocumentView::isLineVisible( Int64 docIdx ) const {
-	return mDocLineToVisibleIndex.empty() || isOneToOne() ||
-		   ( docIdx < static_cast<Int64>( mDocLineToVisibleIndex.size() ) &&
-			 mDocLineToVisibleIndex[docIdx] != static_cast<Int64>( VisibleIndex::invalid ) );
+	return mLines.empty() || isOneToOne() ||
+		   ( docIdx >= 0 && docIdx < static_cast<Int64>( mLines.size() ) &&
+			 !mLines[docIdx].hidden );
 }
 
 std::vector<TextRange> DocumentView::intersectsFoldedRegions( const TextRange& range ) const {
@@ -349,8 +457,9 @@ void DocumentView::updateCache( Int64 fromLine, Int64 toLine, Int64 numLines ) {
 		return;
 
 	// Safety check: ensure fromLine and toLine are within bounds of the old state
-	if ( fromLine < 0 || fromLine >= (Int64)mVisibleLinesOffset.size() ||
-		 toLine < 0 || toLine >= (Int64)mVisibleLinesOffset.size() || fromLine > toLine ) {
+	if ( fromLine < 0 || fromLine >= (Int64)mLines.size() || toLine < 0 ||
+		 toLine >= (Int64)mLines.size() || fromLine > toLine ||
+		 (Int64)mLines.size() + numLines != (Int64)mDoc->linesCount() ) {
 		invalidateCache();
 		return;
 	}
@@ -359,124 +468,91 @@ void DocumentView::updateCache( Int64 fromLine, Int64 toLine, Int64 numLines ) {
 	if ( numLines < 0 ) {
 		auto foldedRegions = intersectsFoldedRegions( { { fromLine, 0 }, { toLine, 0 } } );
 		for ( const auto& fold : foldedRegions )
-			unfoldRegion( fold.start().line(), false, false, false );
+			unfoldRegion( fold.start().line(), false );
 	} else if ( isFolded( fromLine ) ) {
-		// Offsets will be recomputed here instead in the unfold operation
-		unfoldRegion( fromLine, false, false, false );
+		unfoldRegion( fromLine, false );
 	}
 
-	// Get affected visible range
-	Int64 oldIdxFrom = static_cast<Int64>( toVisibleIndex( fromLine, false ) );
-	Int64 oldIdxTo = static_cast<Int64>( toVisibleIndex( toLine, true ) );
+	if ( isOneToOne() )
+		return;
 
-	if ( oldIdxFrom == static_cast<Int64>( VisibleIndex::invalid ) ||
-		 oldIdxTo == static_cast<Int64>( VisibleIndex::invalid ) ||
-		 oldIdxFrom > oldIdxTo ||
-		 oldIdxFrom >= (Int64)mVisibleLines.size() ||
-		 oldIdxTo >= (Int64)mVisibleLines.size() ) {
+	if ( mLines.empty() ) {
 		invalidateCache();
 		return;
 	}
 
-	auto visibleLinesCount = mVisibleLines.size();
-
-	// Remove old visible lines
-	mVisibleLines.erase( mVisibleLines.begin() + oldIdxFrom, mVisibleLines.begin() + oldIdxTo + 1 );
-
-	// Remove old offsets
-	mVisibleLinesOffset.erase( mVisibleLinesOffset.begin() + fromLine,
-							   mVisibleLinesOffset.begin() + toLine + 1 );
+	Int64 visibleLinesCount = mVisualLines.total();
+	auto netLines = toLine + numLines;
 
-	// Shift the line numbers
 	if ( numLines != 0 ) {
-		visibleLinesCount = mVisibleLines.size();
-		for ( Int64 i = oldIdxFrom; i < static_cast<Int64>( visibleLinesCount ); i++ )
-			mVisibleLines[i].setLine( mVisibleLines[i].line() + numLines );
+		for ( Int64 i = fromLine; i <= toLine; i++ ) {
+			if ( !mLines[i].measured )
+				mPendingLines--;
+		}
 
-		shiftFoldingRegions( fromLine, numLines );
-	}
+		// The new lines are added empty and then reset with their estimation
+		LineBreaks newLine;
+		newLine.measured = true;
+		newLine.visualLines = 0;
+		mLines.erase( mLines.begin() + fromLine, mLines.begin() + toLine + 1 );
+		mLines.insert( mLines.begin() + fromLine, netLines - fromLine + 1, newLine );
 
-	// Recompute line breaks
-	auto netLines = toLine + numLines;
-	auto idxOffset = oldIdxFrom;
+		shiftFoldingRegions( fromLine, numLines );
 
-	if ( netLines >= (Int64)mDocLineToVisibleIndex.size() )
-		mDocLineToVisibleIndex.resize( netLines + 1, static_cast<Int64>( VisibleIndex::invalid ) );
+		std::vector<Int64> visualLines( mLines.size() );
+		for ( size_t i = 0; i < mLines.size(); i++ )
+			visualLines[i] = mLines[i].visualLines;
+		mVisualLines.assign( visualLines );
+		mPendingLinesCursor = eemin( mPendingLinesCursor, fromLine );
+	}
 
+	// Lines modified by regular editing are measured right away, big insertions are measured
+	// lazily as any other line
+	bool measure = netLines - fromLine < 256;
 	for ( auto i = fromLine; i <= netLines; i++ ) {
-		if ( isFolded( i ) ) {
-			mVisibleLinesOffset.insert(
-				mVisibleLinesOffset.begin() + i,
-				LineWrap::computeOffsets(
-					mDoc->line( i ).getText().view(), mFontStyle, mConfig.tabWidth,
-					eemax( mMaxWidth - mWhiteSpaceWidth, mWhiteSpaceWidth ) ) );
-			mDocLineToVisibleIndex[i] = static_cast<Int64>( VisibleIndex::invalid );
-		} else {
-			auto lb = computeLineBreaks( *mDoc, i, mFontStyle, mMaxWidth, mConfig.mode,
-										 mConfig.keepIndentation, mConfig.tabWidth,
-										 mWhiteSpaceWidth, mConfig.tabStops );
-
-			mVisibleLinesOffset.insert( mVisibleLinesOffset.begin() + i, lb.paddingStart );
-
-			std::vector<TextPosition> newWraps;
-			newWraps.reserve( lb.wraps.size() );
-			for ( const auto& col : lb.wraps )
-				newWraps.push_back( { i, col } );
-
-			mVisibleLines.insert( mVisibleLines.begin() + idxOffset, newWraps.begin(),
-								  newWraps.end() );
-
-			idxOffset += lb.wraps.size();
-		}
+		resetLine( i, isFolded( i, true ) );
+		if ( measure )
+			measureLine( i );
 	}
 
-	recomputeDocLineToVisibleIndex( oldIdxFrom );
-
 	verifyStructuralConsistency();
 
-	if ( visibleLinesCount != mVisibleLines.size() )
+	if ( visibleLinesCount != mVisualLines.total() )
 		onVisibleLinesCountChange();
 }
 
-void DocumentView::recomputeDocLineToVisibleIndex( Int64 fromVisibleIndex, bool ensureDocSize ) {
-	// Recompute document line to visible index
-	Int64 visibleLinesCount = mVisibleLines.size();
-	if ( ensureDocSize )
-		mDocLineToVisibleIndex.resize( mDoc->linesCount() );
-
-	if ( fromVisibleIndex < 0 || fromVisibleIndex >= visibleLinesCount )
-		return;
+size_t DocumentView::getVisibleLinesCount() const {
+	// Until the line breaks are computed ( i.e. while loading ) every line is a visual line
+	return isOneToOne() || mLines.empty() ? mDoc->linesCount() : mVisualLines.total();
+}
 
-	Int64 previousLineIdx = mVisibleLines[fromVisibleIndex].line();
-	for ( Int64 visibleIdx = fromVisibleIndex; visibleIdx < visibleLinesCount; visibleIdx++ ) {
-		const auto& visibleLine = mVisibleLines[visibleIdx];
-		if ( visibleLine.column() == 0 ) {
-			// Non-contiguous lines means hidden lines
-			if ( visibleLine.line() - previousLineIdx > 1 ) {
-				for ( Int64 i = previousLineIdx + 1; i < visibleLine.line(); i++ ) {
-					if ( i < (Int64)mDocLineToVisibleIndex.size() )
-						mDocLineToVisibleIndex[i] = static_cast<Int64>( VisibleIndex::invalid );
-				}
-			}
-			if ( visibleLine.line() < (Int64)mDocLineToVisibleIndex.size() )
-				mDocLineToVisibleIndex[visibleLine.line()] =
-					isFolded( visibleLine.line(), true ) ? static_cast<Int64>( VisibleIndex::invalid )
-														 : visibleIdx;
-			previousLineIdx = visibleLine.line();
-		}
+const std::vector<Int64> DocumentView::getDocLineToVisibleIndex() const {
+	measureAllLines();
+	std::vector<Int64> docLineToVisibleIndex;
+	docLineToVisibleIndex.reserve( mLines.size() );
+	Int64 visibleIndex = 0;
+	for ( const auto& line : mLines ) {
+		docLineToVisibleIndex.push_back(
+			line.hidden ? static_cast<Int64>( VisibleIndex::invalid ) : visibleIndex );
+		visibleIndex += line.visualLines;
 	}
+	return docLineToVisibleIndex;
 }
 
-size_t DocumentView::getVisibleLinesCount() const {
-	return isOneToOne() ? mDoc->linesCount() : mVisibleLines.size();
+const std::vector<Float> DocumentView::getVisibleLinesOffset() const {
+	measureAllLines();
+	std::vector<Float> visibleLinesOffset;
+	visibleLinesOffset.reserve( mLines.size() );
+	for ( const auto& line : mLines )
+		visibleLinesOffset.push_back( line.paddingStart );
+	return visibleLinesOffset;
 }
 
 void DocumentView::foldRegion( Int64 foldDocIdx ) {
 	auto foldRegion = mDoc->getFoldRangeService().find( foldDocIdx );
 	if ( !foldRegion )
 		return;
-	if ( isOneToOne() || mDocLineToVisibleIndex.empty() || mVisibleLines.empty() ||
-		 mVisibleLinesOffset.empty() )
+	if ( isOneToOne() || mLines.empty() )
 		invalidateCache();
 	Int64 toDocIdx = foldRegion->end().line();
 	changeVisibility( foldDocIdx + 1, toDocIdx, false );
@@ -490,17 +566,15 @@ void DocumentView::unfoldRegion( Int64 foldDocIdx ) {
 	return unfoldRegion( foldDocIdx, true );
 }
 
-void DocumentView::unfoldRegion( Int64 foldDocIdx, bool verifyConsistency, bool recomputeOffset,
-								 bool recomputeLineToVisibleIndex ) {
+void DocumentView::unfoldRegion( Int64 foldDocIdx, bool verifyConsistency ) {
 	auto foldRegion = mDoc->getFoldRangeService().find( foldDocIdx );
 	if ( !foldRegion )
 		return;
-	if ( mDocLineToVisibleIndex.empty() || mVisibleLines.empty() || mVisibleLinesOffset.empty() )
+	if ( mLines.empty() )
 		invalidateCache();
 	Int64 toDocIdx = foldRegion->end().line();
 	removeFoldedRegion( *foldRegion );
-	changeVisibility( foldDocIdx + 1, toDocIdx, true, recomputeOffset,
-					  recomputeLineToVisibleIndex );
+	changeVisibility( foldDocIdx + 1, toDocIdx, true );
 	if ( verifyConsistency )
 		verifyStructuralConsistency();
 	if ( isOneToOne() )
@@ -580,68 +654,17 @@ bool DocumentView::isOneToOne() const {
 	return mConfig.mode == LineWrapMode::NoWrap && mFoldedRegions.empty();
 }
 
-void DocumentView::changeVisibility( Int64 fromDocIdx, Int64 toDocIdx, bool visible,
-									 bool recomputeOffset, bool recomputeLineToVisibleIndex ) {
-	if ( visible ) {
-		auto it = std::lower_bound( mVisibleLines.begin(), mVisibleLines.end(),
-									TextPosition{ fromDocIdx, 0 } );
-		Int64 oldIdxFrom = std::distance( mVisibleLines.begin(), it );
-		auto idxOffset = oldIdxFrom;
-		for ( auto i = fromDocIdx; i <= toDocIdx; i++ ) {
-			if ( isFolded( i, true ) ) {
-				if ( recomputeOffset && i < (Int64)mVisibleLinesOffset.size() ) {
-					mVisibleLinesOffset[i] = LineWrap::computeOffsets(
-						mDoc->line( i ).getText().view(), mFontStyle, mConfig.tabWidth,
-						eemax( mMaxWidth - mWhiteSpaceWidth, mWhiteSpaceWidth ) );
-				}
-				continue;
-			}
-			auto lb = isWrapEnabled()
-						  ? computeLineBreaks( *mDoc, i, mFontStyle, mMaxWidth, mConfig.mode,
-											   mConfig.keepIndentation, mConfig.tabWidth,
-											   mWhiteSpaceWidth, mConfig.tabStops )
-						  : LineWrapInfo{ { 0 }, 0 };
-			if ( recomputeOffset && i < (Int64)mVisibleLinesOffset.size() )
-				mVisibleLinesOffset[i] = lb.paddingStart;
-			for ( const auto& col : lb.wraps ) {
-				if ( idxOffset >= 0 && idxOffset <= (Int64)mVisibleLines.size() ) {
-					mVisibleLines.insert( mVisibleLines.begin() + idxOffset, { i, col } );
-					idxOffset++;
-				}
-			}
-		}
-
-		recomputeDocLineToVisibleIndex( oldIdxFrom, recomputeLineToVisibleIndex );
-	} else {
-		auto oldIdxFromVI = toVisibleIndex( fromDocIdx );
-		auto oldIdxToVI = toVisibleIndex( toDocIdx, true );
-		Int64 oldIdxFrom = static_cast<Int64>( oldIdxFromVI );
-		Int64 oldIdxTo = static_cast<Int64>( oldIdxToVI );
-		if ( VisibleIndex::invalid == oldIdxFromVI || VisibleIndex::invalid == oldIdxToVI ||
-			 oldIdxFrom < 0 || oldIdxTo < 0 ||
-			 oldIdxFrom > oldIdxTo || oldIdxFrom >= (Int64)mVisibleLines.size() ||
-			 oldIdxTo >= (Int64)mVisibleLines.size() )
-			return;
-		mVisibleLines.erase( mVisibleLines.begin() + oldIdxFrom,
-							 mVisibleLines.begin() + oldIdxTo + 1 );
-		for ( Int64 idx = fromDocIdx; idx <= toDocIdx; idx++ ) {
-			if ( idx < (Int64)mDocLineToVisibleIndex.size() )
-				mDocLineToVisibleIndex[idx] = static_cast<Int64>( VisibleIndex::invalid );
-		}
-		Int64 linesCount = mDoc->linesCount();
-		Int64 idxOffset = oldIdxTo - oldIdxFrom + 1;
-		for ( Int64 idx = toDocIdx + 1; idx < linesCount; idx++ ) {
-			if ( idx < (Int64)mDocLineToVisibleIndex.size() &&
-				 mDocLineToVisibleIndex[idx] != static_cast<Int64>( VisibleIndex::invalid ) )
-				mDocLineToVisibleIndex[idx] -= idxOffset;
+void DocumentView::changeVisibility( Int64 fromDocIdx, Int64 toDocIdx, bool visible ) {
+	Int64 lastDocIdx = eemin( toDocIdx, static_cast<Int64>( mLines.size() ) - 1 );
+	for ( Int64 i = eemax( fromDocIdx, 0ll ); i <= lastDocIdx; i++ ) {
+		if ( visible ) {
+			// Nested folded regions keep their lines hidden
+			resetLine( i, isFolded( i, true ) );
+		} else if ( !mLines[i].hidden ) {
+			resetLine( i, true );
 		}
 	}
 
-#ifdef EE_DEBUG
-	if ( recomputeLineToVisibleIndex )
-		eeASSERT( mDocLineToVisibleIndex.size() == mDoc->linesCount() );
-#endif
-
 	onVisibleLinesCountChange();
 }
 
@@ -693,49 +716,24 @@ void DocumentView::verifyStructuralConsistency() {
 	if ( isOneToOne() )
 		return;
 
-	auto visibleLines = mVisibleLines;
-	auto docLineToVisibleIndex = mDocLineToVisibleIndex;
-	auto visibleLinesOffset = mVisibleLinesOffset;
+	measureAllLines();
+	auto lines = mLines;
 
 	invalidateCache();
+	measureAllLines();
 
-	auto visibleLinesConsistency = visibleLines == mVisibleLines;
-	eeASSERT( visibleLinesConsistency );
+	bool linesConsistency = lines.size() == mLines.size();
+	eeASSERT( linesConsistency );
 
-	if ( !visibleLinesConsistency && mVisibleLines.size() == visibleLines.size() ) {
-		for ( size_t i = 0; i < mVisibleLines.size(); i++ ) {
-			if ( mVisibleLines[i] != visibleLines[i] ) {
-				eeASSERT( mVisibleLines[i] == visibleLines[i] );
-				break;
-			}
-		}
-	}
-
-	bool docConsistency = docLineToVisibleIndex == mDocLineToVisibleIndex;
-	eeASSERT( docConsistency );
-
-	if ( !docConsistency && docLineToVisibleIndex.size() == mDocLineToVisibleIndex.size() ) {
-		for ( size_t i = 0; i < mDocLineToVisibleIndex.size(); i++ ) {
-			if ( mDocLineToVisibleIndex[i] != docLineToVisibleIndex[i] ) {
-				eeASSERT( mDocLineToVisibleIndex[i] == docLineToVisibleIndex[i] );
-				break;
-			}
-		}
-	}
-
-	bool offsetConsistency = visibleLinesOffset == mVisibleLinesOffset;
-	eeASSERT( offsetConsistency );
-
-	if ( !offsetConsistency && visibleLinesOffset.size() == mVisibleLinesOffset.size() ) {
-		for ( size_t i = 0; i < mVisibleLinesOffset.size(); i++ ) {
-			if ( mVisibleLinesOffset[i] != visibleLinesOffset[i] ) {
-				eeASSERT( mVisibleLinesOffset[i] == visibleLinesOffset[i] );
-				break;
-			}
-		}
+	for ( size_t i = 0; linesConsistency && i < mLines.size(); i++ ) {
+		linesConsistency = lines[i].wraps == mLines[i].wraps &&
+						   lines[i].paddingStart == mLines[i].paddingStart &&
+						   lines[i].hidden == mLines[i].hidden &&
+						   lines[i].visualLines == mLines[i].visualLines;
+		eeASSERT( linesConsistency );
 	}
 
-	eeASSERT( mVisibleLinesOffset.size() == mDoc->linesCount() );
+	eeASSERT( mLines.size() == mDoc->linesCount() );
 #endif
 }
 
@@ -18,6 +18,16 @@
 
 #include <set>
 
+#if defined( EE_ARCH_X86_64 )
+#if defined( _MSC_VER )
+#include <intrin.h>
+#else
+#include <emmintrin.h>
+#endif
+#elif defined( EE_ARCH_ARM64 )
+#include <arm_neon.h>
+#endif
+
 using namespace std::literals;
 
 using namespace EE::Network;
@@ -31,6 +41,11 @@ static constexpr char DEFAULT_NON_WORD_CHARS[] = " \t\n/\\()\"':,.;<>~!@#$%^&*|+
 
 static UnorderedSet<String::HashType> TEXT_DOCUMENT_COMMANDS = {};
 
+// Documents with less lines than this are searched sequentially by findAllParallel
+static constexpr Int64 FIND_ALL_PARALLEL_MIN_LINES = 16384;
+
+static constexpr Int64 FIND_ALL_CHUNK_MIN_LINES = 4096;
+
 bool TextDocument::fileMightBeBinary( const std::string& file ) {
 	static constexpr size_t MAX_READ = 4096;
 	static constexpr std::array<char, 4> NULL_SEQUENCE = { 0, 0, 0, 0 };
@@ -330,7 +345,7 @@ TextDocument::~TextDocument() {
 		Sys::sleep( Milliseconds( 0.1 ) );
 
 	if ( mLoading ) {
-		mLoading = false;
+		mStopLoading = true;
 		Lock l( mLoadingMutex );
 	}
 
@@ -340,7 +355,7 @@ TextDocument::~TextDocument() {
 
 	// Loading has been stopped
 	while ( mLoadingAsync ) {
-		mLoading = false;
+		mStopLoading = true;
 		Sys::sleep( Milliseconds( 0.1 ) );
 	}
 
@@ -377,6 +392,7 @@ void TextDocument::reset() {
 		Lock l( mLinesMutex );
 		mLines.clear();
 		mLines.emplace_back( String( "\n" ), mDocumentMutex );
+		resetLineData();
 	}
 
 	{
@@ -444,6 +460,64 @@ static inline void searchSubstr( char* data, const size_t& size, size_t& positio
 	}
 }
 
+// Returns the position of the first '\n' or '\r', or size if there's none
+static size_t findLineEnd( const char* data, const size_t& size ) {
+	size_t i = 0;
+#if defined( EE_ARCH_X86_64 )
+	const __m128i lf = _mm_set1_epi8( '\n' );
+	const __m128i cr = _mm_set1_epi8( '\r' );
+	for ( ; i + 16 <= size; i += 16 ) {
+		__m128i chunk = _mm_loadu_si128( reinterpret_cast<const __m128i*>( data + i ) );
+		if ( _mm_movemask_epi8(
+				 _mm_or_si128( _mm_cmpeq_epi8( chunk, lf ), _mm_cmpeq_epi8( chunk, cr ) ) ) )
+			break;
+	}
+#elif defined( EE_ARCH_ARM64 )
+	const uint8x16_t lf = vdupq_n_u8( '\n' );
+	const uint8x16_t cr = vdupq_n_u8( '\r' );
+	for ( ; i + 16 <= size; i += 16 ) {
+		uint8x16_t chunk = vld1q_u8( reinterpret_cast<const uint8_t*>( data + i ) );
+		if ( vmaxvq_u8( vorrq_u8( vceqq_u8( chunk, lf ), vceqq_u8( chunk, cr ) ) ) )
+			break;
+	}
+#endif
+	while ( i < size && data[i] != '\n' && data[i] != '\r' )
+		i++;
+	return i;
+}
+
+static bool isAscii( const char* data, const size_t& size ) {
+	size_t i = 0;
+#if defined( EE_ARCH_X86_64 )
+	for ( ; i + 16 <= size; i += 16 ) {
+		if ( _mm_movemask_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( data + i ) ) ) )
+			return false;
+	}
+#elif defined( EE_ARCH_ARM64 )
+	for ( ; i + 16 <= size; i += 16 ) {
+		if ( vmaxvq_u8( vld1q_u8( reinterpret_cast<const uint8_t*>( data + i ) ) ) >= 0x80 )
+			return false;
+	}
+#endif
+	for ( ; i < size; i++ ) {
+		if ( static_cast<unsigned char>( data[i] ) >= 0x80 )
+			return false;
+	}
+	return true;
+}
+
+static String utf8ToString( const char* data, const size_t& size ) {
+	// Most source code lines are pure ASCII, which doesn't need any UTF-8 decoding
+	if ( !isAscii( data, size ) )
+		return String( data, size );
+	String str;
+	auto& buffer = str.getString();
+	buffer.resize( size );
+	for ( size_t i = 0; i < size; i++ )
+		buffer[i] = static_cast<unsigned char>( data[i] );
+	return str;
+}
+
 static String ptrGetLine( char* data, const size_t& size, size_t& position,
 						  TextFormat::Encoding enc ) {
 	static constexpr auto LE_END_LF = "\n\0"sv;
@@ -470,8 +544,7 @@ static String ptrGetLine( char* data, const size_t& size, size_t& position,
 			break;
 	}
 
-	while ( position < size && data[position] != '\n' && data[position] != '\r' )
-		position++;
+	position = findLineEnd( data, size );
 	if ( position < size ) {
 		if ( position + 1 < size && data[position] == '\r' && data[position + 1] == '\n' )
 			position++;
@@ -483,7 +556,7 @@ static String ptrGetLine( char* data, const size_t& size, size_t& position,
 	else if ( enc == TextFormat::Encoding::Latin1 )
 		return String::fromLatin1( data, position );
 
-	return String( data, position );
+	return utf8ToString( data, position );
 }
 
 TextDocument::LoadStatus TextDocument::loadFromStream( IOStream& file ) {
@@ -501,6 +574,7 @@ TextDocument::LoadStatus TextDocument::loadFromStream( IOStream& file, std::stri
 	{
 		Lock l( mLinesMutex );
 		mLines.clear();
+		resetLineData();
 	}
 
 	MD5::Context md5Ctx;
@@ -516,8 +590,22 @@ TextDocument::LoadStatus TextDocument::loadFromStream( IOStream& file, std::stri
 		char* bufferPtr;
 		TScopedBuffer<char> data( blockSize );
 		MD5::init( md5Ctx );
+		size_t loadedLines = 0;
+		std::vector<TextDocumentLine> batch;
+
+		// The lines are decoded into a batch that is published once per block, so the loaded
+		// lines can be displayed while loading ( see getLinesMutex ).
+		const auto publishLines = [this, &batch] {
+			if ( batch.empty() )
+				return;
+			Lock l( mLinesMutex );
+			insertLineData( mLines.size(), batch.size() );
+			mLines.insert( mLines.end(), std::make_move_iterator( batch.begin() ),
+						   std::make_move_iterator( batch.end() ) );
+			batch.clear();
+		};
 
-		while ( pending && mLoading ) {
+		while ( pending && !mStopLoading ) {
 			read = file.read( data.get(), blockSize );
 			bufferPtr = data.get();
 			consume = read;
@@ -555,7 +643,7 @@ TextDocument::LoadStatus TextDocument::loadFromStream( IOStream& file, std::stri
 				}
 			}
 
-			while ( consume && mLoading ) {
+			while ( consume && !mStopLoading ) {
 				lineBuffer += ptrGetLine( bufferPtr, consume, position, mEncoding );
 				bufferPtr += position;
 				consume -= position;
@@ -565,7 +653,7 @@ TextDocument::LoadStatus TextDocument::loadFromStream( IOStream& file, std::stri
 				char lastChar = lineBuffer[lineBufferSize - 1];
 
 				if ( lastChar == '\n' || lastChar == '\r' ) {
-					if ( linesCount() == 0 ) {
+					if ( loadedLines == 0 ) {
 						if ( lineBufferSize > 1 && lineBuffer[lineBufferSize - 2] == '\r' &&
 							 lastChar == '\n' ) {
 							mLineEnding = TextFormat::LineEnding::CRLF;
@@ -598,14 +686,12 @@ TextDocument::LoadStatus TextDocument::loadFromStream( IOStream& file, std::stri
 						}
 					}
 
-					{
-						Lock l( mLinesMutex );
-						mLines.emplace_back( lineBuffer, mDocumentMutex );
-					}
+					batch.emplace_back( lineBuffer, mDocumentMutex );
+					loadedLines++;
 					lineBuffer.resize( 0 );
 				} else if ( consume <= 0 && pending - read == 0 ) {
-					Lock l( mLinesMutex );
-					mLines.emplace_back( lineBuffer, mDocumentMutex );
+					batch.emplace_back( lineBuffer, mDocumentMutex );
+					loadedLines++;
 				}
 
 				if ( consume < 0 ) {
@@ -614,11 +700,15 @@ TextDocument::LoadStatus TextDocument::loadFromStream( IOStream& file, std::stri
 				}
 			}
 
+			publishLines();
+
 			if ( !read )
 				break;
 			pending -= read;
 			blockSize = eemin( pending, BLOCK_SIZE );
 		};
+
+		publishLines();
 	}
 
 	auto lineCount = linesCount();
@@ -635,6 +725,8 @@ TextDocument::LoadStatus TextDocument::loadFromStream( IOStream& file, std::stri
 		mLines.emplace_back( String( "\n" ), mDocumentMutex );
 	}
 
+	resetLineData();
+
 	if ( mAutoDetectIndentType )
 		guessIndentType();
 
@@ -642,11 +734,16 @@ TextDocument::LoadStatus TextDocument::loadFromStream( IOStream& file, std::stri
 		Log::info( "Document \"%s\" loaded in %.2fms.", path.c_str(),
 				   clock.getElapsedTime().asMilliseconds() );
 
-	bool wasInterrupted = !mLoading;
-	if ( wasInterrupted )
+	// The document is still flagged as loading while it's reset, so the loaded lines aren't
+	// accessed without holding the lines mutex
+	bool wasInterrupted = mStopLoading;
+	if ( wasInterrupted ) {
+		Lock l( mLinesMutex );
 		reset();
+	}
 
 	mHash = MD5::result( md5Ctx ).digest;
+	mStopLoading = false;
 	mLoading = false;
 
 	return wasInterrupted ? LoadStatus::Interrupted
@@ -829,6 +926,9 @@ URI TextDocument::getLoadingFileURI() const {
 }
 
 TextDocument::LoadStatus TextDocument::loadFromFile( const std::string& path ) {
+	// An asynchronous load could have already been stopped
+	if ( !mLoadingAsync )
+		mStopLoading = false;
 	mLoading = true;
 	bool fileExists = FileSystem::fileExists( path );
 
@@ -845,6 +945,11 @@ TextDocument::LoadStatus TextDocument::loadFromFile( const std::string& path ) {
 	if ( fileExists ) {
 		IOStreamFile file( path, "rb" );
 		ret = loadFromStream( file, path, true );
+		// The document was reset, it's not bound to the file
+		if ( ret == LoadStatus::Interrupted ) {
+			mLoading = false;
+			return ret;
+		}
 	} else {
 		setDirtyUntilSave();
 	}
@@ -859,6 +964,7 @@ TextDocument::LoadStatus TextDocument::loadFromFile( const std::string& path ) {
 
 bool TextDocument::loadAsyncFromFile( const std::string& path, std::shared_ptr<ThreadPool> pool,
 									  std::function<void( TextDocument*, bool )> onLoaded ) {
+	mStopLoading = false;
 	mLoading = true;
 	mLoadingAsync = true;
 	{
@@ -876,7 +982,8 @@ bool TextDocument::loadAsyncFromFile( const std::string& path, std::shared_ptr<T
 			mLoadingFilePath.clear();
 			mLoadingFileURI = URI();
 		}
-		notifyDocumentLoaded();
+		if ( loaded != LoadStatus::Interrupted )
+			notifyDocumentLoaded();
 		mLoadingAsync = false;
 	} );
 	return true;
@@ -929,6 +1036,7 @@ bool TextDocument::loadAsyncFromURL( const std::string& url,
 									 const Http::Request::FieldTable& headers,
 									 std::function<void( TextDocument*, bool success )> onLoaded,
 									 const Http::Request::ProgressCallback& progressCallback ) {
+	mStopLoading = false;
 	mLoading = true;
 	URI uri( url );
 
@@ -1160,6 +1268,15 @@ bool TextDocument::isLoading() const {
 	return mLoading;
 }
 
+void TextDocument::stopLoading() {
+	if ( mLoading )
+		mStopLoading = true;
+}
+
+Mutex& TextDocument::getLinesMutex() const {
+	return mLinesMutex;
+}
+
 bool TextDocument::isDeleteOnClose() const {
 	return mDeleteOnClose;
 }
@@ -1573,10 +1690,18 @@ TextPosition TextDocument::insert( const size_t& cursorIdx, TextPosition positio
 		mLines[position.line()] = TextDocumentLine( lines[0], mDocumentMutex );
 		notifyLineChanged( position.line() );
 
-		for ( Int64 i = 1; i < (Int64)lines.size(); i++ ) {
-			mLines.insert( mLines.begin() + position.line() + i,
-						   TextDocumentLine( lines[i], mDocumentMutex ) );
-			notifyLineChanged( position.line() + i );
+		if ( lines.size() > 1 ) {
+			// Insert all the new lines at once, inserting them one by one is quadratic
+			std::vector<TextDocumentLine> newLines;
+			newLines.reserve( lines.size() - 1 );
+			for ( size_t i = 1; i < lines.size(); i++ )
+				newLines.emplace_back( lines[i], mDocumentMutex );
+			mLines.insert( mLines.begin() + position.line() + 1,
+						   std::make_move_iterator( newLines.begin() ),
+						   std::make_move_iterator( newLines.end() ) );
+			insertLineData( position.line() + 1, newLines.size() );
+			for ( Int64 i = 1; i < (Int64)lines.size(); i++ )
+				notifyLineChanged( position.line() + i );
 		}
 	}
 
@@ -1678,6 +1803,7 @@ size_t TextDocument::remove( const size_t& cursorIdx, TextRange range,
 			mLines.erase( mLines.begin() + range.start().line() + 1,
 						  mLines.begin() + range.end().line() );
 			linesRemoved = range.end().line() - ( range.start().line() + 1 );
+			removeLineData( range.start().line() + 1, linesRemoved );
 			range.end().setLine( range.start().line() + 1 );
 		}
 	}
@@ -1724,14 +1850,17 @@ size_t TextDocument::remove( const size_t& cursorIdx, TextRange range,
 
 		Lock l( mLinesMutex );
 		mLines.erase( mLines.begin() + range.end().line() );
+		removeLineData( range.end().line(), 1 );
 		linesRemoved += 1;
 		deletedAcrossNewLine = true;
 	}
 
 	{
 		Lock l( mLinesMutex );
-		if ( mLines.empty() )
+		if ( mLines.empty() ) {
 			mLines.emplace_back( String( "\n" ), mDocumentMutex );
+			insertLineData( 0, 1 );
+		}
 	}
 
 	if ( mSelection.size() > 1 ) {
@@ -2388,6 +2517,38 @@ void TextDocument::unregisterClient( Client* client ) {
 		setActiveClient( nullptr );
 }
 
+void TextDocument::registerLineData( TextDocumentLineDataBase* lineData ) {
+	Lock l( mLinesMutex );
+	if ( std::find( mLineData.begin(), mLineData.end(), lineData ) == mLineData.end() )
+		mLineData.push_back( lineData );
+	lineData->reset( mLines.size() );
+}
+
+void TextDocument::unregisterLineData( TextDocumentLineDataBase* lineData ) {
+	Lock l( mLinesMutex );
+	auto it = std::find( mLineData.begin(), mLineData.end(), lineData );
+	if ( it != mLineData.end() )
+		mLineData.erase( it );
+}
+
+void TextDocument::insertLineData( Int64 line, Int64 count ) {
+	Lock l( mLinesMutex );
+	for ( auto lineData : mLineData )
+		lineData->insertLines( line, count );
+}
+
+void TextDocument::removeLineData( Int64 line, Int64 count ) {
+	Lock l( mLinesMutex );
+	for ( auto lineData : mLineData )
+		lineData->removeLines( line, count );
+}
+
+void TextDocument::resetLineData() {
+	Lock l( mLinesMutex );
+	for ( auto lineData : mLineData )
+		lineData->reset( mLines.size() );
+}
+
 std::size_t TextDocument::clientOfTypeCount( TextDocument::Client::Type type ) {
 	Lock l( mClientsMutex );
 	std::size_t count = 0;
@@ -3609,19 +3770,24 @@ bool TextDocument::isInsertingText() const {
 	return mInsertingText;
 }
 
-TextDocument::SearchResults TextDocument::findAll( const String& text, bool caseSensitive,
-												   bool wholeWord, FindReplaceType type,
-												   TextRange restrictRange, size_t maxResults ) {
-	SearchResults all;
-	TextDocument::SearchResult found;
-	TextPosition from = startOfDoc();
+bool* TextDocument::addStopFlag() {
 	auto stopFlagUP = std::make_unique<bool>( false );
 	bool* stopFlag = stopFlagUP.get();
-	{
-		Lock l( mStopFlagsMutex );
-		mStopFlags.insert( { stopFlag, std::move( stopFlagUP ) } );
-	}
+	Lock l( mStopFlagsMutex );
+	mStopFlags.insert( { stopFlag, std::move( stopFlagUP ) } );
+	return stopFlag;
+}
+
+void TextDocument::removeStopFlag( bool* stopFlag ) {
+	Lock l( mStopFlagsMutex );
+	mStopFlags.erase( stopFlag );
+}
 
+void TextDocument::findAllInRange( SearchResults& all, const String& text, bool caseSensitive,
+								   bool wholeWord, FindReplaceType type, TextRange restrictRange,
+								   size_t maxResults, bool* stopFlag ) {
+	TextDocument::SearchResult found;
+	TextPosition from = startOfDoc();
 	if ( restrictRange.isValid() )
 		from = restrictRange.normalized().start();
 	do {
@@ -3635,30 +3801,110 @@ TextDocument::SearchResults TextDocument::findAll( const String& text, bool case
 				break;
 		}
 	} while ( found.isValid() );
+}
+
+TextDocument::SearchResults TextDocument::findAll( const String& text, bool caseSensitive,
+												   bool wholeWord, FindReplaceType type,
+												   TextRange restrictRange, size_t maxResults ) {
+	SearchResults all;
+	bool* stopFlag = addStopFlag();
+	findAllInRange( all, text, caseSensitive, wholeWord, type, restrictRange, maxResults,
+					stopFlag );
 	if ( !all.empty() )
 		all.setSorted();
+	removeStopFlag( stopFlag );
+	return all;
+}
 
-	{
-		Lock l( mStopFlagsMutex );
-		mStopFlags.erase( stopFlag );
+TextDocument::SearchResults
+TextDocument::findAllParallel( const std::shared_ptr<ThreadPool>& pool, const String& text,
+							   bool caseSensitive, bool wholeWord, FindReplaceType type,
+							   TextRange restrictRange,
+							   const std::function<void( const SearchResults& )>& onResults ) {
+	Int64 fromLine = 0;
+	Int64 toLine = static_cast<Int64>( linesCount() ) - 1;
+	if ( restrictRange.isValid() ) {
+		restrictRange = sanitizeRange( restrictRange.normalized() );
+		fromLine = restrictRange.start().line();
+		toLine = restrictRange.end().line();
 	}
+
+	// Matches of searches spanning several lines can't be found by chunks of lines
+	bool multiLine = type == FindReplaceType::Normal && text.find( '\n' ) != String::InvalidPos;
+	Int64 numLines = toLine - fromLine + 1;
+
+	if ( !pool || multiLine || text.empty() || numLines < FIND_ALL_PARALLEL_MIN_LINES ) {
+		SearchResults all = findAll( text, caseSensitive, wholeWord, type, restrictRange );
+		if ( onResults && !all.empty() )
+			onResults( all );
+		return all;
+	}
+
+	Int64 chunkLines = eemax<Int64>( FIND_ALL_CHUNK_MIN_LINES,
+									 numLines / ( static_cast<Int64>( pool->numThreads() ) * 4 ) );
+	size_t numChunks = ( numLines + chunkLines - 1 ) / chunkLines;
+	std::vector<SearchResults> chunks( numChunks );
+	Mutex onResultsMutex;
+	bool* stopFlag = addStopFlag();
+
+	pool->parallelFor( numChunks, [&]( size_t chunk ) {
+		if ( *stopFlag )
+			return;
+
+		Int64 firstLine = fromLine + static_cast<Int64>( chunk ) * chunkLines;
+		Int64 lastLine = eemin<Int64>( firstLine + chunkLines - 1, toLine );
+		// The chunk ends at the start of the next line so the matches that include the line
+		// break are found exactly as in the sequential search
+		TextRange range( { firstLine, 0 }, lastLine + 1 < static_cast<Int64>( linesCount() )
+											   ? TextPosition( lastLine + 1, 0 )
+											   : endOfDoc() );
+		if ( restrictRange.isValid() ) {
+			if ( range.start() < restrictRange.start() )
+				range.setStart( restrictRange.start() );
+			if ( restrictRange.end() < range.end() )
+				range.setEnd( restrictRange.end() );
+		}
+
+		SearchResults& results = chunks[chunk];
+		findAllInRange( results, text, caseSensitive, wholeWord, type, range, 0, stopFlag );
+
+		// Matches starting at the next line belong to the next chunk
+		while ( !results.empty() && results.back().result.start().line() > lastLine )
+			results.pop_back();
+
+		if ( onResults && !results.empty() ) {
+			Lock l( onResultsMutex );
+			onResults( results );
+		}
+	} );
+
+	removeStopFlag( stopFlag );
+
+	size_t count = 0;
+	for ( const auto& results : chunks )
+		count += results.size();
+
+	SearchResults all;
+	all.reserve( count );
+	for ( auto& results : chunks )
+		all.insert( all.end(), std::make_move_iterator( results.begin() ),
+					std::make_move_iterator( results.end() ) );
+	if ( !all.empty() )
+		all.setSorted();
 	return all;
 }
 
 int TextDocument::replaceAll( const String& text, const String& replace, const bool& caseSensitive,
 							  const bool& wholeWord, FindReplaceType type,
-							  TextRange restrictRange ) {
+							  TextRange restrictRange, const std::shared_ptr<ThreadPool>& pool ) {
 	if ( text.empty() )
 		return 0;
-	bool wasRunningTransaction = isRunningTransaction();
-	if ( !wasRunningTransaction )
-		setRunningTransaction( true );
-	int count = 0;
-	TextDocument::SearchResult found;
-	TextPosition startedPosition = getSelection().start();
-	TextPosition from = startOfDoc();
-	if ( restrictRange.isValid() )
-		from = restrictRange.normalized().start();
+
+	SearchResults results =
+		findAllParallel( pool, text, caseSensitive, wholeWord, type, restrictRange );
+
+	if ( results.empty() )
+		return 0;
 
 	size_t numCaptures = 0;
 	PatternMatcher::Range matchList[MAX_CAPTURES];
@@ -3673,40 +3919,154 @@ int TextDocument::replaceAll( const String& text, const String& replace, const b
 		}
 	}
 
-	do {
-		found = find( text, from, caseSensitive, wholeWord, type, restrictRange );
-		if ( found.isValid() ) {
-			if ( numCaptures && numCaptures <= found.captures.size() ) {
-				String finalReplace( replace );
-				std::string l( getLineTextUtf8( found.captures[0].start().line() ) );
-				for ( size_t i = 0; i < numCaptures; i++ ) {
-					String matchSubStr( replace.substr(
-						matchList[i].start, matchList[i].end - matchList[i].start ) ); // $1 $2 ...
-					std::string matchNum( matchSubStr.substr( 1 ) );				   // 1 2 ...
-					int num;
-					if ( String::fromString( num, matchNum ) && num > 0 &&
-						 num - 1 < static_cast<int>( found.captures.size() ) ) {
-						auto start = found.captures[num - 1].start().column();
-						auto end = found.captures[num - 1].end().column();
-						finalReplace.replaceAll(
-							matchSubStr, String::fromUtf8( l.substr( start, end - start ) ) );
-					}
+	// All the matches are replaced in a single edit of the lines that contain them
+	Int64 fromLine = results.front().result.start().line();
+	Int64 toLine =
+		eemin<Int64>( results.back().result.end().line(), static_cast<Int64>( linesCount() ) - 1 );
+	String oldText;
+	std::vector<size_t> lineOffsets;
+	lineOffsets.reserve( toLine - fromLine + 1 );
+	for ( Int64 i = fromLine; i <= toLine; i++ ) {
+		lineOffsets.push_back( oldText.size() );
+		oldText += line( i ).getText();
+	}
+
+	// The last line break is never replaced
+	auto toOffset = [&]( const TextPosition& pos ) -> size_t {
+		if ( pos.line() > toLine )
+			return oldText.size() - 1;
+		return eemin<size_t>( lineOffsets[pos.line() - fromLine] + pos.column(),
+							  oldText.size() - 1 );
+	};
+
+	String newText;
+	newText.reserve( oldText.size() );
+	size_t lastOffset = 0;
+	int count = 0;
+
+	for ( const auto& found : results ) {
+		size_t start = toOffset( found.result.start() );
+		size_t end = toOffset( found.result.end() );
+		if ( start < lastOffset )
+			continue;
+
+		newText.append( oldText, lastOffset, start - lastOffset );
+
+		if ( numCaptures && numCaptures <= found.captures.size() ) {
+			String finalReplace( replace );
+			std::string l( getLineTextUtf8( found.captures[0].start().line() ) );
+			for ( size_t i = 0; i < numCaptures; i++ ) {
+				String matchSubStr( replace.substr(
+					matchList[i].start, matchList[i].end - matchList[i].start ) ); // $1 $2 ...
+				std::string matchNum( matchSubStr.substr( 1 ) );				   // 1 2 ...
+				int num;
+				if ( String::fromString( num, matchNum ) && num > 0 &&
+					 num - 1 < static_cast<int>( found.captures.size() ) ) {
+					auto capStart = found.captures[num - 1].start().column();
+					auto capEnd = found.captures[num - 1].end().column();
+					finalReplace.replaceAll(
+						matchSubStr, String::fromUtf8( l.substr( capStart, capEnd - capStart ) ) );
 				}
-				setSelection( found.result );
-				from = replaceSelection( finalReplace );
-			} else {
-				setSelection( found.result );
-				from = replaceSelection( replace );
 			}
-			count++;
+			newText += finalReplace;
+		} else {
+			newText += replace;
 		}
-	} while ( found.isValid() && endOfDoc() != found.result.end() );
+
+		lastOffset = end;
+		count++;
+	}
+
+	newText.append( oldText, lastOffset, oldText.size() - lastOffset );
+
+	bool wasRunningTransaction = isRunningTransaction();
+	if ( !wasRunningTransaction )
+		setRunningTransaction( true );
+	TextPosition startedPosition = getSelection().start();
+	replaceLines( fromLine, toLine, oldText, newText );
 	if ( !wasRunningTransaction )
 		setRunningTransaction( false );
 	setSelection( startedPosition );
 	return count;
 }
 
+void TextDocument::replaceLines( Int64 fromLine, Int64 toLine, const String& oldText,
+								 const String& newText ) {
+	eeASSERT( !oldText.empty() && !newText.empty() && newText[newText.size() - 1] == '\n' );
+
+	mModificationId++;
+	mUndoStack.clearRedoStack();
+
+	size_t lineCount = linesCount();
+	std::vector<String> lines = newText.split( '\n', true );
+	// The text ends with a line break, the split adds an empty line after it
+	lines.pop_back();
+	for ( auto& line : lines )
+		line += '\n';
+
+	Int64 oldLinesCount = toLine - fromLine + 1;
+	Int64 newLinesCount = static_cast<Int64>( lines.size() );
+
+	{
+		Lock l( mLinesMutex );
+		Int64 common = eemin( oldLinesCount, newLinesCount );
+		for ( Int64 i = 0; i < common; i++ ) {
+			if ( mLines[fromLine + i].getText() != lines[i] )
+				mLines[fromLine + i] = TextDocumentLine( lines[i], mDocumentMutex );
+		}
+
+		if ( newLinesCount < oldLinesCount ) {
+			mLines.erase( mLines.begin() + fromLine + common,
+						  mLines.begin() + fromLine + oldLinesCount );
+			removeLineData( fromLine + common, oldLinesCount - common );
+		} else if ( newLinesCount > oldLinesCount ) {
+			std::vector<TextDocumentLine> newLines;
+			newLines.reserve( newLinesCount - common );
+			for ( Int64 i = common; i < newLinesCount; i++ )
+				newLines.emplace_back( lines[i], mDocumentMutex );
+			mLines.insert( mLines.begin() + fromLine + common,
+						   std::make_move_iterator( newLines.begin() ),
+						   std::make_move_iterator( newLines.end() ) );
+			insertLineData( fromLine + common, newLinesCount - common );
+		}
+	}
+
+	for ( Int64 i = 0; i < newLinesCount; i++ )
+		notifyLineChanged( fromLine + i );
+
+	// Recorded as removing the old text and inserting the new one with the same timestamp, so it
+	// is undone and redone as a single step
+	String oldTextNoNL( oldText.substr( 0, oldText.size() - 1 ) );
+	String newTextNoNL( newText.substr( 0, newText.size() - 1 ) );
+	TextPosition start( fromLine, 0 );
+	TextPosition oldEnd( toLine, 0 );
+	auto oldLastNL = oldTextNoNL.find_last_of( '\n' );
+	oldEnd.setColumn( oldLastNL == String::InvalidPos ? oldTextNoNL.size()
+													  : oldTextNoNL.size() - oldLastNL - 1 );
+	TextPosition newEnd( fromLine + newLinesCount - 1, 0 );
+	auto newLastNL = newTextNoNL.find_last_of( '\n' );
+	newEnd.setColumn( newLastNL == String::InvalidPos ? newTextNoNL.size()
+													  : newTextNoNL.size() - newLastNL - 1 );
+
+	Time time( mTimer.getElapsedTime() );
+	UndoStackContainer& undoStack = mUndoStack.getUndoStackContainer();
+	mUndoStack.pushSelection( undoStack, 0, mSelection, time );
+	mUndoStack.pushInsert( undoStack, oldTextNoNL, 0, start, time );
+	mUndoStack.pushSelection( undoStack, 0, mSelection, time );
+	mUndoStack.pushRemove( undoStack, 0, { start, newEnd }, time );
+
+	// Lines are reported as always moved so the views update every line of the range even if the
+	// number of lines didn't change
+	if ( newLinesCount != oldLinesCount )
+		mHighlighter->moveHighlight( fromLine, toLine, newLinesCount - oldLinesCount );
+	notifyDocumentLineMove( fromLine, toLine, newLinesCount - oldLinesCount );
+
+	notifyTextChanged( { { start, oldEnd }, newTextNoNL } );
+
+	if ( lineCount != linesCount() )
+		notifyLineCountChanged( lineCount, linesCount() );
+}
+
 TextPosition TextDocument::replaceSelection( const String& replace ) {
 	return replaceSelection( 0, replace );
 }
@@ -3833,6 +4193,7 @@ std::vector<TextDocumentLine> TextDocument::getLines() const {
 
 void TextDocument::setLines( std::vector<TextDocumentLine>&& lines ) {
 	mLines = std::move( lines );
+	resetLineData();
 }
 
 std::string TextDocument::serializeUndoRedo( bool inverted ) {
@@ -3843,6 +4204,22 @@ void TextDocument::unserializeUndoRedo( const std::string& jsonString ) {
 	return mUndoStack.fromJSON( jsonString );
 }
 
+std::string TextDocument::serializeUndoRedoBinary( bool inverted ) {
+	return mUndoStack.toBinary( inverted );
+}
+
+bool TextDocument::unserializeUndoRedoBinary( const std::string& data ) {
+	return mUndoStack.fromBinary( data );
+}
+
+TextUndoStack& TextDocument::getUndoStack() {
+	return mUndoStack;
+}
+
+const TextUndoStack& TextDocument::getUndoStack() const {
+	return mUndoStack;
+}
+
 void TextDocument::changeFilePath( const std::string& filePath ) {
 	changeFilePath( filePath, true );
 }
@@ -4353,6 +4730,12 @@ void TextDocument::notifyLineCountChanged( const size_t& lastCount, const size_t
 }
 
 void TextDocument::notifyLineChanged( const Int64& lineIndex ) {
+	{
+		Lock l( mLinesMutex );
+		for ( auto lineData : mLineData )
+			lineData->resetLine( lineIndex );
+	}
+
 	Lock l( mClientsMutex );
 	for ( auto& client : mClients ) {
 		client->onDocumentLineChanged( lineIndex );
@@ -13,12 +13,20 @@ nlohmann::json TextUndoCommand::baseJSON() const {
 	nlohmann::json j;
 	j["type"] = mType;
 	j["timestamp"] = mTimestamp.toString();
+	j["firstTimestamp"] = mFirstTimestamp.toString();
 	return j;
 }
 
+static Time firstTimestampFromJSON( const nlohmann::json& j, const Time& timestamp ) {
+	// Stacks saved before merged runs were serialized don't have it
+	return j.contains( "firstTimestamp" )
+			   ? Time::fromString( j["firstTimestamp"].get<std::string>() )
+			   : timestamp;
+}
+
 nlohmann::json TextUndoCommandInsert::toJSON() const {
 	auto j = baseJSON();
-	j["text"] = mText.toUtf8();
+	j["text"] = mText;
 	j["position"] = mPosition.toString();
 	j["cursorIdx"] = mCursorIdx;
 	return j;
@@ -26,10 +34,12 @@ nlohmann::json TextUndoCommandInsert::toJSON() const {
 
 TextUndoCommandInsert TextUndoCommandInsert::fromJSON( nlohmann::json j, Uint64 id ) {
 	auto timestamp = Time::fromString( j["timestamp"].get<std::string>() );
-	auto text = String::fromUtf8( j["text"].get<std::string>() );
+	auto text = j["text"].get<std::string>();
 	auto position = TextPosition::fromString( j["position"].get<std::string>() );
 	auto cursorIdx = j["cursorIdx"].get<size_t>();
-	return TextUndoCommandInsert( id, cursorIdx, text, position, timestamp );
+	TextUndoCommandInsert cmd( id, cursorIdx, std::move( text ), position, timestamp );
+	cmd.mFirstTimestamp = firstTimestampFromJSON( j, timestamp );
+	return cmd;
 }
 
 nlohmann::json TextUndoCommandRemove::toJSON() const {
@@ -43,7 +53,9 @@ TextUndoCommandRemove TextUndoCommandRemove::fromJSON( nlohmann::json j, Uint64
 	auto timestamp = Time::fromString( j["timestamp"].get<std::string>() );
 	auto range = TextRange::fromString( j["range"].get<std::string>() );
 	auto cursorIdx = j["cursorIdx"].get<size_t>();
-	return TextUndoCommandRemove( id, cursorIdx, range, timestamp );
+	TextUndoCommandRemove cmd( id, cursorIdx, range, timestamp );
+	cmd.mFirstTimestamp = firstTimestampFromJSON( j, timestamp );
+	return cmd;
 }
 
 nlohmann::json TextUndoCommandSelection::toJSON() const {
@@ -57,12 +69,14 @@ TextUndoCommandSelection TextUndoCommandSelection::fromJSON( nlohmann::json j, U
 	auto timestamp = Time::fromString( j["timestamp"].get<std::string>() );
 	auto range = TextRange::fromString( j["range"].get<std::string>() );
 	auto cursorIdx = j["cursorIdx"].get<size_t>();
-	return TextUndoCommandSelection( id, cursorIdx, range, timestamp );
+	TextUndoCommandSelection cmd( id, cursorIdx, range, timestamp );
+	cmd.mFirstTimestamp = firstTimestampFromJSON( j, timestamp );
+	return cmd;
 }
 
 TextUndoCommand::TextUndoCommand( const Uint64& id, const TextUndoCommandType& type,
 								  const Time& timestamp ) :
-	mId( id ), mType( type ), mTimestamp( timestamp ) {}
+	mId( id ), mType( type ), mTimestamp( timestamp ), mFirstTimestamp( timestamp ) {}
 
 TextUndoCommand::~TextUndoCommand() {}
 
@@ -78,15 +92,32 @@ const Time& TextUndoCommand::getTimestamp() const {
 	return mTimestamp;
 }
 
+const Time& TextUndoCommand::getFirstTimestamp() const {
+	return mFirstTimestamp;
+}
+
 TextUndoCommandInsert::TextUndoCommandInsert( const Uint64& id, const size_t& cursorIdx,
 											  const String& text, const TextPosition& position,
 											  const Time& timestamp ) :
 	TextUndoCommand( id, TextUndoCommandType::Insert, timestamp ),
-	mText( text ),
+	mText( text.toUtf8() ),
 	mPosition( position ),
 	mCursorIdx( cursorIdx ) {}
 
-const String& TextUndoCommandInsert::getText() const {
+TextUndoCommandInsert::TextUndoCommandInsert( const Uint64& id, const size_t& cursorIdx,
+											  std::string&& textUtf8,
+											  const TextPosition& position,
+											  const Time& timestamp ) :
+	TextUndoCommand( id, TextUndoCommandType::Insert, timestamp ),
+	mText( std::move( textUtf8 ) ),
+	mPosition( position ),
+	mCursorIdx( cursorIdx ) {}
+
+String TextUndoCommandInsert::getText() const {
+	return String::fromUtf8( mText );
+}
+
+const std::string& TextUndoCommandInsert::getTextUtf8() const {
 	return mText;
 }
 
@@ -127,11 +158,13 @@ size_t TextUndoCommandSelection::getCursorIdx() const {
 	return mCursorIdx;
 }
 
-TextUndoStack::TextUndoStack( TextDocument* owner, const Uint32& maxStackSize ) :
+TextUndoStack::TextUndoStack( TextDocument* owner, const Uint32& maxStackSize,
+							  const size_t& maxMemory ) :
 	mDoc( owner ),
 	mMaxStackSize( maxStackSize ),
 	mChangeIdCounter( 0 ),
-	mMergeTimeout( Milliseconds( 300.f ) ) {}
+	mMergeTimeout( Milliseconds( 300.f ) ),
+	mMaxMemory( maxMemory ) {}
 
 TextUndoStack::~TextUndoStack() {
 	clear();
@@ -144,31 +177,155 @@ void TextUndoStack::clear() {
 
 void TextUndoStack::clearUndoStack() {
 	mUndoStack.clear();
+	mUndoMemory = 0;
 }
 
 void TextUndoStack::clearRedoStack() {
 	mRedoStack.clear();
+	mRedoMemory = 0;
+}
+
+static size_t commandMemoryUsage( const UndoCommandVariant& cmdVariant ) {
+	return sizeof( UndoCommandVariant ) +
+		   std::visit(
+			   []( const auto& cmd ) -> size_t {
+				   using T = std::decay_t<decltype( cmd )>;
+				   if constexpr ( std::is_same_v<T, TextUndoCommandInsert> ) {
+					   return cmd.getTextUtf8().capacity();
+				   } else if constexpr ( std::is_same_v<T, TextUndoCommandSelection> ) {
+					   return cmd.getSelection().capacity() * sizeof( TextRange );
+				   }
+				   return 0;
+			   },
+			   cmdVariant );
+}
+
+size_t& TextUndoStack::memoryUsage( const UndoStackContainer& stack ) {
+	return &stack == &mRedoStack ? mRedoMemory : mUndoMemory;
 }
 
 void TextUndoStack::limitStackSize( UndoStackContainer& stack ) {
-	while ( stack.size() > mMaxStackSize )
+	size_t& memory = memoryUsage( stack );
+	if ( stack.size() <= mMaxStackSize && memory <= mMaxMemory )
+		return;
+
+	auto firstTimestamp = []( const UndoCommandVariant& cmd ) {
+		return std::visit( []( const auto& c ) { return c.getFirstTimestamp(); }, cmd );
+	};
+	auto lastTimestamp = []( const UndoCommandVariant& cmd ) {
+		return std::visit( []( const auto& c ) { return c.getTimestamp(); }, cmd );
+	};
+
+	// The commands of the last edit share its first timestamp, they are never discarded. A merged
+	// run keeps the time of its first edit, so it must be compared against that one.
+	Time newestEdit = firstTimestamp( stack.back() );
+	Time discarded;
+	bool hasDiscarded = false;
+
+	while ( ( stack.size() > mMaxStackSize || memory > mMaxMemory ) &&
+			firstTimestamp( stack.front() ) != newestEdit ) {
+		discarded = lastTimestamp( stack.front() );
+		hasDiscarded = true;
+		memory -= commandMemoryUsage( stack.front() );
+		stack.pop_front();
+	}
+
+	// Discard the rest of the undo step of the last discarded command, a partial step can't be
+	// undone
+	while ( hasDiscarded && !stack.empty() && firstTimestamp( stack.front() ) != newestEdit &&
+			eeabs( ( firstTimestamp( stack.front() ) - discarded ).asMilliseconds() ) <
+				mMergeTimeout.asMilliseconds() ) {
+		discarded = lastTimestamp( stack.front() );
+		memory -= commandMemoryUsage( stack.front() );
 		stack.pop_front();
+	}
 }
 
 void TextUndoStack::pushUndo( UndoStackContainer& undoStack, UndoCommandVariant&& cmd ) {
+	memoryUsage( undoStack ) += commandMemoryUsage( cmd );
 	undoStack.emplace_back( std::move( cmd ) );
 	limitStackSize( undoStack );
 }
 
+bool TextUndoStack::mergeInsert( UndoStackContainer& undoStack, const String& string,
+								 const size_t& cursorIdx, const TextPosition& position,
+								 const Time& time ) {
+	// Consecutive deletions push [ remove, selection ], [ remove, selection ], ... the new one is
+	// merged with the previous remove when they are contiguous ( backspace and delete runs )
+	if ( undoStack.size() < 2 || string.empty() || string.find( '\n' ) != String::InvalidPos )
+		return false;
+
+	auto* sel = std::get_if<TextUndoCommandSelection>( &undoStack.back() );
+	auto* prev = std::get_if<TextUndoCommandInsert>( &undoStack[undoStack.size() - 2] );
+
+	if ( !sel || !prev || sel->getCursorIdx() != cursorIdx || prev->getCursorIdx() != cursorIdx ||
+		 sel->getTimestamp() != time ||
+		 eeabs( ( time - prev->getTimestamp() ).asMilliseconds() ) >=
+			 mMergeTimeout.asMilliseconds() )
+		return false;
+
+	bool backward = position.line() == prev->getPosition().line() &&
+					position.column() + (Int64)string.size() == prev->getPosition().column();
+	bool forward = position == prev->getPosition();
+
+	if ( !backward && !forward )
+		return false;
+
+	size_t& memory = memoryUsage( undoStack );
+	memory -= commandMemoryUsage( undoStack.back() ) + commandMemoryUsage( *prev );
+
+	if ( backward ) {
+		prev->mText.insert( 0, string.toUtf8() );
+		prev->mPosition = position;
+	} else {
+		prev->mText.append( string.toUtf8() );
+	}
+
+	prev->mId = ++mChangeIdCounter;
+	prev->mTimestamp = time;
+	undoStack.pop_back();
+	memory += commandMemoryUsage( undoStack.back() );
+	return true;
+}
+
+bool TextUndoStack::mergeRemove( UndoStackContainer& undoStack, const size_t& cursorIdx,
+								 const TextRange& range, const Time& time ) {
+	// Typing pushes [ selection, remove ], [ selection, remove ], ... the new one is merged with
+	// the previous remove when the inserted texts are contiguous
+	if ( undoStack.size() < 2 )
+		return false;
+
+	auto* sel = std::get_if<TextUndoCommandSelection>( &undoStack.back() );
+	auto* prev = std::get_if<TextUndoCommandRemove>( &undoStack[undoStack.size() - 2] );
+
+	if ( !sel || !prev || sel->getCursorIdx() != cursorIdx || prev->getCursorIdx() != cursorIdx ||
+		 sel->getTimestamp() != time || prev->getRange().end() != range.start() ||
+		 eeabs( ( time - prev->getTimestamp() ).asMilliseconds() ) >=
+			 mMergeTimeout.asMilliseconds() )
+		return false;
+
+	memoryUsage( undoStack ) -= commandMemoryUsage( undoStack.back() );
+	undoStack.pop_back();
+	prev = std::get_if<TextUndoCommandRemove>( &undoStack.back() );
+	prev->mRange.setEnd( range.end() );
+	prev->mId = ++mChangeIdCounter;
+	prev->mTimestamp = time;
+	return true;
+}
+
 void TextUndoStack::pushInsert( UndoStackContainer& undoStack, const String& string,
 								const size_t& cursorIdx, const TextPosition& position,
 								const Time& time ) {
+	if ( mergeInsert( undoStack, string, cursorIdx, position, time ) )
+		return;
 	pushUndo( undoStack,
 			  TextUndoCommandInsert( ++mChangeIdCounter, cursorIdx, string, position, time ) );
 }
 
 void TextUndoStack::pushRemove( UndoStackContainer& undoStack, const size_t& cursorIdx,
 								const TextRange& range, const Time& time ) {
+	if ( mergeRemove( undoStack, cursorIdx, range, time ) )
+		return;
 	pushUndo( undoStack, TextUndoCommandRemove( ++mChangeIdCounter, cursorIdx, range, time ) );
 }
 
@@ -182,6 +339,7 @@ void TextUndoStack::popUndo( UndoStackContainer& undoStack, UndoStackContainer&
 	if ( undoStack.empty() )
 		return;
 
+	memoryUsage( undoStack ) -= commandMemoryUsage( undoStack.back() );
 	UndoCommandVariant cmdVariant = std::move( undoStack.back() );
 	undoStack.pop_back();
 
@@ -189,7 +347,7 @@ void TextUndoStack::popUndo( UndoStackContainer& undoStack, UndoStackContainer&
 
 	std::visit(
 		[&]( auto& cmd ) {
-			lastTimestamp = cmd.getTimestamp();
+			lastTimestamp = cmd.getFirstTimestamp();
 
 			using T = std::decay_t<decltype( cmd )>;
 
@@ -246,6 +404,22 @@ void TextUndoStack::setMergeTimeout( const Time& mergeTimeout ) {
 	mMergeTimeout = mergeTimeout;
 }
 
+size_t TextUndoStack::getMemoryUsage() const {
+	return mUndoMemory + mRedoMemory;
+}
+
+const size_t& TextUndoStack::getMaxMemory() const {
+	return mMaxMemory;
+}
+
+void TextUndoStack::setMaxMemory( const size_t& maxMemory ) {
+	mMaxMemory = maxMemory;
+	if ( !mUndoStack.empty() )
+		limitStackSize( mUndoStack );
+	if ( !mRedoStack.empty() )
+		limitStackSize( mRedoStack );
+}
+
 Uint64 TextUndoStack::getCurrentChangeId() const {
 	if ( mUndoStack.empty() )
 		return 0;
@@ -303,6 +477,186 @@ void TextUndoStack::fromJSON( const std::string& jsonString ) {
 	}
 }
 
+static constexpr std::string_view UNDO_STACK_BINARY_MAGIC = "EEUS";
+static constexpr Uint8 UNDO_STACK_BINARY_VERSION = 1;
+
+static void writeVarUint( std::string& out, Uint64 value ) {
+	while ( value >= 0x80 ) {
+		out.push_back( static_cast<char>( ( value & 0x7F ) | 0x80 ) );
+		value >>= 7;
+	}
+	out.push_back( static_cast<char>( value ) );
+}
+
+static void writeVarInt( std::string& out, Int64 value ) {
+	writeVarUint( out, ( static_cast<Uint64>( value ) << 1 ) ^ static_cast<Uint64>( value >> 63 ) );
+}
+
+static void writePosition( std::string& out, const TextPosition& pos ) {
+	writeVarInt( out, pos.line() );
+	writeVarInt( out, pos.column() );
+}
+
+static bool readVarUint( std::string_view data, size_t& pos, Uint64& value ) {
+	value = 0;
+	for ( int shift = 0; shift < 64 && pos < data.size(); shift += 7 ) {
+		Uint8 byte = static_cast<Uint8>( data[pos++] );
+		value |= static_cast<Uint64>( byte & 0x7F ) << shift;
+		if ( !( byte & 0x80 ) )
+			return true;
+	}
+	return false;
+}
+
+static bool readVarInt( std::string_view data, size_t& pos, Int64& value ) {
+	Uint64 raw;
+	if ( !readVarUint( data, pos, raw ) )
+		return false;
+	value = static_cast<Int64>( raw >> 1 ) ^ -static_cast<Int64>( raw & 1 );
+	return true;
+}
+
+static bool readPosition( std::string_view data, size_t& pos, TextPosition& position ) {
+	Int64 line, column;
+	if ( !readVarInt( data, pos, line ) || !readVarInt( data, pos, column ) )
+		return false;
+	position = TextPosition( line, column );
+	return true;
+}
+
+static void writeCommand( std::string& out, const UndoCommandVariant& cmdVariant ) {
+	std::visit(
+		[&out]( const auto& cmd ) {
+			out.push_back( static_cast<char>( cmd.getType() ) );
+			writeVarInt( out, cmd.getTimestamp().asMicroseconds() );
+			writeVarInt( out, cmd.getFirstTimestamp().asMicroseconds() );
+			writeVarUint( out, cmd.getCursorIdx() );
+			using T = std::decay_t<decltype( cmd )>;
+			if constexpr ( std::is_same_v<T, TextUndoCommandInsert> ) {
+				writePosition( out, cmd.getPosition() );
+				writeVarUint( out, cmd.getTextUtf8().size() );
+				out.append( cmd.getTextUtf8() );
+			} else if constexpr ( std::is_same_v<T, TextUndoCommandRemove> ) {
+				writePosition( out, cmd.getRange().start() );
+				writePosition( out, cmd.getRange().end() );
+			} else if constexpr ( std::is_same_v<T, TextUndoCommandSelection> ) {
+				writeVarUint( out, cmd.getSelection().size() );
+				for ( const auto& range : cmd.getSelection() ) {
+					writePosition( out, range.start() );
+					writePosition( out, range.end() );
+				}
+			}
+		},
+		cmdVariant );
+}
+
+std::string TextUndoStack::toBinary( bool inverted ) {
+	std::string out( UNDO_STACK_BINARY_MAGIC );
+	out.push_back( static_cast<char>( UNDO_STACK_BINARY_VERSION ) );
+
+	// Same order than toJSON
+	auto serialize = [&out]( const UndoStackContainer& stack ) {
+		writeVarUint( out, stack.size() );
+		for ( auto it = stack.rbegin(); it != stack.rend(); it++ )
+			writeCommand( out, *it );
+	};
+
+	if ( inverted ) {
+		while ( hasUndo() )
+			undo();
+		serialize( mRedoStack );
+		while ( hasRedo() )
+			redo();
+	} else {
+		serialize( mUndoStack );
+	}
+
+	return out;
+}
+
+bool TextUndoStack::fromBinary( const std::string& data ) {
+	std::string_view view( data );
+	size_t pos = UNDO_STACK_BINARY_MAGIC.size() + 1;
+	Uint64 count;
+
+	if ( view.size() < pos || view.substr( 0, UNDO_STACK_BINARY_MAGIC.size() ) !=
+								  UNDO_STACK_BINARY_MAGIC ||
+		 static_cast<Uint8>( view[pos - 1] ) != UNDO_STACK_BINARY_VERSION ||
+		 !readVarUint( view, pos, count ) ) {
+		Log::error( "TextUndoStack::fromBinary - Invalid binary undo stack" );
+		return false;
+	}
+
+	// Everything is parsed before touching the stack, so invalid data doesn't leave it half
+	// loaded
+	std::vector<UndoCommandVariant> commands;
+	commands.reserve( eemin<Uint64>( count, view.size() ) );
+
+	for ( Uint64 i = 0; i < count; i++ ) {
+		if ( pos >= view.size() )
+			return false;
+
+		auto type = static_cast<TextUndoCommandType>( view[pos++] );
+		Int64 timestamp, firstTimestamp;
+		Uint64 cursorIdx;
+		if ( !readVarInt( view, pos, timestamp ) || !readVarInt( view, pos, firstTimestamp ) ||
+			 !readVarUint( view, pos, cursorIdx ) )
+			return false;
+
+		switch ( type ) {
+			case TextUndoCommandType::Insert: {
+				TextPosition position;
+				Uint64 length;
+				if ( !readPosition( view, pos, position ) || !readVarUint( view, pos, length ) ||
+					 length > view.size() - pos )
+					return false;
+				commands.emplace_back( TextUndoCommandInsert(
+					0, cursorIdx, std::string( view.substr( pos, length ) ), position,
+					Microseconds( timestamp ) ) );
+				pos += length;
+				break;
+			}
+			case TextUndoCommandType::Remove: {
+				TextPosition start, end;
+				if ( !readPosition( view, pos, start ) || !readPosition( view, pos, end ) )
+					return false;
+				commands.emplace_back( TextUndoCommandRemove( 0, cursorIdx, { start, end },
+															  Microseconds( timestamp ) ) );
+				break;
+			}
+			case TextUndoCommandType::Selection: {
+				Uint64 rangesCount;
+				if ( !readVarUint( view, pos, rangesCount ) || rangesCount > view.size() - pos )
+					return false;
+				TextRanges ranges;
+				ranges.reserve( rangesCount );
+				for ( Uint64 r = 0; r < rangesCount; r++ ) {
+					TextPosition start, end;
+					if ( !readPosition( view, pos, start ) || !readPosition( view, pos, end ) )
+						return false;
+					ranges.emplace_back( start, end );
+				}
+				commands.emplace_back( TextUndoCommandSelection( 0, cursorIdx, ranges,
+																 Microseconds( timestamp ) ) );
+				break;
+			}
+			default:
+				return false;
+		}
+
+		std::visit(
+			[firstTimestamp]( auto& cmd ) { cmd.mFirstTimestamp = Microseconds( firstTimestamp ); },
+			commands.back() );
+	}
+
+	for ( auto it = commands.rbegin(); it != commands.rend(); it++ ) {
+		std::visit( [this]( auto& cmd ) { cmd.mId = ++mChangeIdCounter; }, *it );
+		pushUndo( mRedoStack, std::move( *it ) );
+	}
+
+	return true;
+}
+
 UndoStackContainer& TextUndoStack::getUndoStackContainer() {
 	return mUndoStack;
 }
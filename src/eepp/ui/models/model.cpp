@@ -33,6 +33,18 @@ void Model::refreshView() const {
 	forEachView( []( UIAbstractView* view ) { view->invalidateDraw(); } );
 }
 
+void Model::dataRange( ModelDataRange& range ) const {
+	Int64 lastRow = range.firstRow() + range.rowCount();
+	Int64 lastColumn = range.firstColumn() + range.columnCount();
+	for ( Int64 row = range.firstRow(); row < lastRow; row++ ) {
+		for ( Int64 col = range.firstColumn(); col < lastColumn; col++ ) {
+			ModelIndex cellIndex( index( row, col, range.parent() ) );
+			if ( cellIndex.isValid() )
+				range.set( row, col, data( cellIndex, range.role() ) );
+		}
+	}
+}
+
 void Model::registerView( UIAbstractView* view ) {
 	mViews.insert( view );
 }
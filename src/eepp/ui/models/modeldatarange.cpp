@@ -0,0 +1,52 @@
+#include <eepp/core/utf.hpp>
+#include <eepp/ui/models/modeldatarange.hpp>
+#include <iterator>
+
+namespace EE { namespace UI { namespace Models {
+
+void ModelDataRange::reset( const ModelIndex& parent, Int64 firstRow, Int64 rowCount,
+							Int64 firstColumn, Int64 columnCount, ModelRole role ) {
+	clear();
+	mParent = parent;
+	mFirstRow = firstRow;
+	mRowCount = eemax<Int64>( 0, rowCount );
+	mFirstColumn = firstColumn;
+	mColumnCount = eemax<Int64>( 0, columnCount );
+	mRole = role;
+	size_t count = mRowCount * mColumnCount;
+	mData.resize( count );
+	if ( mStrings.size() < count )
+		mStrings.resize( count );
+}
+
+void ModelDataRange::clear() {
+	mData.clear();
+	mRowCount = mColumnCount = 0;
+}
+
+bool ModelDataRange::contains( const ModelIndex& index ) const {
+	return index.row() >= mFirstRow && index.row() < mFirstRow + mRowCount &&
+		   index.column() >= mFirstColumn && index.column() < mFirstColumn + mColumnCount &&
+		   index.parent() == mParent;
+}
+
+void ModelDataRange::set( Int64 row, Int64 column, Variant&& value ) {
+	mData[offset( row, column )] = std::move( value );
+}
+
+void ModelDataRange::set( Int64 row, Int64 column, std::string_view value ) {
+	size_t pos = offset( row, column );
+	String& str = mStrings[pos];
+	str.clear();
+	Utf8::toUtf32( value.begin(), value.end(), std::back_inserter( str.getString() ) );
+	mData[pos] = Variant( &str );
+}
+
+void ModelDataRange::set( Int64 row, Int64 column, const String& value ) {
+	size_t pos = offset( row, column );
+	String& str = mStrings[pos];
+	str.assign( value );
+	mData[pos] = Variant( &str );
+}
+
+}}} // namespace EE::UI::Models
@@ -1,6 +1,7 @@
 #include <SOIL2/src/SOIL2/stb_image.h>
 #include <eepp/scene/scenemanager.hpp>
 #include <eepp/system/filesystem.hpp>
+#include <eepp/system/sys.hpp>
 #include <eepp/ui/tools/textureatlasnew.hpp>
 #include <eepp/ui/uifiledialog.hpp>
 #include <eepp/ui/uimessagebox.hpp>
@@ -70,6 +71,9 @@ TextureAtlasNew::TextureAtlasNew( TGCreateCb NewTGCb ) : mUIWindow( NULL ), mNew
 		<CheckBox id="allowChildren" layout_width='match_parent' layout_height='wrap_content' text="Allow create multiple texture atlases on save."
 			tooltip="When enabled in the case of an atlas not having enough space in the&#10;image to fit all the source input images it will create new child&#10;atlas images to save them."
 		/>
+		<CheckBox id="parallelPipeline" layout_width='match_parent' layout_height='wrap_content' text="Decode and compose the images in parallel." checked="true"
+			tooltip="Probes, decodes and copies the source images into the texture atlas using&#10;all the CPU cores, keeping in memory only the images being decoded."
+		/>
 		<LinearLayout layout_gravity='center_vertical|right' layout_width='wrap_content' layout_height='wrap_content' orientation='horizontal' margin-top="8dp" margin-bottom='16dp'>
 			<PushButton id='cancelButton' layout_width='wrap_content' layout_height='wrap_content' layout_weight='0.2' icon='cancel' text='Cancel' margin-right='4dp' />
 			<PushButton id='okButton' layout_width='wrap_content' layout_height='wrap_content' layout_weight='0.2' icon='ok' text='OK' />
@@ -91,6 +95,7 @@ TextureAtlasNew::TextureAtlasNew( TGCreateCb NewTGCb ) : mUIWindow( NULL ), mNew
 	mUIWindow->bind( "scalableSVG", mScalableSVG );
 	mUIWindow->bind( "saveExtensions", mSaveExtensions );
 	mUIWindow->bind( "allowChildren", mAllowChildren );
+	mUIWindow->bind( "parallelPipeline", mParallelPipeline );
 
 	std::vector<String> Sizes;
 
@@ -174,6 +179,13 @@ void TextureAtlasNew::textureAtlasSave( const Event* Event ) {
 				mForcePow2->isChecked(), mScalableSVG->isChecked(), b, textureFilter,
 				mAllowChildren->isChecked(), false );
 
+			if ( mParallelPipeline->isChecked() ) {
+				UISceneNode* sceneNode = mUIWindow->getUISceneNode();
+				texturePacker->setThreadPool( sceneNode->hasThreadPool()
+												  ? sceneNode->getThreadPool()
+												  : ThreadPool::createShared( Sys::getCPUCount() ) );
+			}
+
 			texturePacker->addTexturesPath( mTGPath->getText() );
 
 			texturePacker->packTextures();
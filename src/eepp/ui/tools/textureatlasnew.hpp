@@ -34,6 +34,7 @@ class EE_API TextureAtlasNew {
 	UICheckBox* mScalableSVG;
 	UICheckBox* mSaveExtensions;
 	UICheckBox* mAllowChildren;
+	UICheckBox* mParallelPipeline;
 
 	void windowClose( const Event* Event );
 
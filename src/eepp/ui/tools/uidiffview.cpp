@@ -3,6 +3,7 @@
 #include <eepp/graphics/text.hpp>
 #include <eepp/system/filesystem.hpp>
 #include <eepp/system/log.hpp>
+#include <eepp/system/threadpool.hpp>
 #include <eepp/ui/doc/syntaxdefinitionmanager.hpp>
 #include <eepp/ui/doc/textdocument.hpp>
 #include <eepp/ui/tools/uidiffview.hpp>
@@ -559,7 +560,232 @@ void UIDiffView::updateEditorsText() {
 	}
 }
 
+// Lines longer than this are not diffed character by character, dtl's edit graph grows too much
+static constexpr size_t SUB_LINE_DIFF_MAX_LENGTH = 4096;
+
+// Maximum edit distance explored by Myers in a single gap, it bounds the trace memory
+static constexpr Int64 MYERS_MAX_COST = 1024;
+
+enum class LineEdit : Uint8 { Common, Added, Removed };
+
+struct LineDiffEngine {
+	const std::vector<Uint32>& a;
+	const std::vector<Uint32>& b;
+	std::vector<LineEdit> edits;
+
+	void push( LineEdit edit, Int64 count ) { edits.insert( edits.end(), count, edit ); }
+
+	void diff( Int64 aStart, Int64 aEnd, Int64 bStart, Int64 bEnd ) {
+		Int64 prefix = 0;
+		while ( aStart + prefix < aEnd && bStart + prefix < bEnd &&
+				a[aStart + prefix] == b[bStart + prefix] )
+			prefix++;
+		push( LineEdit::Common, prefix );
+		aStart += prefix;
+		bStart += prefix;
+
+		Int64 suffix = 0;
+		while ( aEnd - suffix > aStart && bEnd - suffix > bStart &&
+				a[aEnd - suffix - 1] == b[bEnd - suffix - 1] )
+			suffix++;
+		aEnd -= suffix;
+		bEnd -= suffix;
+
+		if ( aStart == aEnd ) {
+			push( LineEdit::Added, bEnd - bStart );
+		} else if ( bStart == bEnd ) {
+			push( LineEdit::Removed, aEnd - aStart );
+		} else if ( !anchor( aStart, aEnd, bStart, bEnd ) &&
+					!myers( aStart, aEnd, bStart, bEnd ) ) {
+			// Pathological gap, report it as replaced
+			push( LineEdit::Removed, aEnd - aStart );
+			push( LineEdit::Added, bEnd - bStart );
+		}
+
+		push( LineEdit::Common, suffix );
+	}
+
+	bool anchor( Int64 aStart, Int64 aEnd, Int64 bStart, Int64 bEnd ) {
+		struct Occurrences {
+			Int64 countA{ 0 };
+			Int64 countB{ 0 };
+			Int64 posB{ 0 };
+		};
+		UnorderedMap<Uint32, Occurrences> occurrences;
+		for ( Int64 i = aStart; i < aEnd; i++ )
+			occurrences[a[i]].countA++;
+		for ( Int64 i = bStart; i < bEnd; i++ ) {
+			auto it = occurrences.find( b[i] );
+			if ( it != occurrences.end() ) {
+				it->second.countB++;
+				it->second.posB = i;
+			}
+		}
+
+		// Lines unique in both sides, in the order of the old side
+		std::vector<std::pair<Int64, Int64>> unique;
+		for ( Int64 i = aStart; i < aEnd; i++ ) {
+			const auto& occ = occurrences[a[i]];
+			if ( occ.countA == 1 && occ.countB == 1 )
+				unique.emplace_back( i, occ.posB );
+		}
+
+		if ( unique.empty() )
+			return false;
+
+		// Longest increasing subsequence of the new side positions ( patience sorting )
+		std::vector<size_t> tails;
+		std::vector<Int64> prev( unique.size(), -1 );
+		for ( size_t i = 0; i < unique.size(); i++ ) {
+			auto it = std::lower_bound(
+				tails.begin(), tails.end(), unique[i].second,
+				[&unique]( size_t idx, Int64 pos ) { return unique[idx].second < pos; } );
+			if ( it != tails.begin() )
+				prev[i] = *( it - 1 );
+			if ( it == tails.end() )
+				tails.push_back( i );
+			else
+				*it = i;
+		}
+
+		std::vector<std::pair<Int64, Int64>> anchors( tails.size() );
+		for ( Int64 i = tails.back(), n = tails.size() - 1; i != -1; i = prev[i], n-- )
+			anchors[n] = unique[i];
+
+		for ( const auto& anchor : anchors ) {
+			diff( aStart, anchor.first, bStart, anchor.second );
+			push( LineEdit::Common, 1 );
+			aStart = anchor.first + 1;
+			bStart = anchor.second + 1;
+		}
+		diff( aStart, aEnd, bStart, bEnd );
+		return true;
+	}
+
+	bool myers( Int64 aStart, Int64 aEnd, Int64 bStart, Int64 bEnd ) {
+		Int64 n = aEnd - aStart;
+		Int64 m = bEnd - bStart;
+		Int64 maxCost = eemin( n + m, MYERS_MAX_COST );
+		Int64 offset = maxCost + 1;
+		std::vector<Int64> v( 2 * offset + 1, 0 );
+		std::vector<std::vector<Int64>> trace;
+		Int64 cost = -1;
+
+		for ( Int64 d = 0; d <= maxCost && cost == -1; d++ ) {
+			for ( Int64 k = -d; k <= d; k += 2 ) {
+				Int64 x = ( k == -d || ( k != d && v[offset + k - 1] < v[offset + k + 1] ) )
+							  ? v[offset + k + 1]
+							  : v[offset + k - 1] + 1;
+				Int64 y = x - k;
+				while ( x < n && y < m && a[aStart + x] == b[bStart + y] ) {
+					x++;
+					y++;
+				}
+				v[offset + k] = x;
+				if ( x >= n && y >= m ) {
+					cost = d;
+					break;
+				}
+			}
+			trace.emplace_back( v.begin() + offset - d, v.begin() + offset + d + 1 );
+		}
+
+		if ( cost == -1 )
+			return false;
+
+		std::vector<LineEdit> script;
+		Int64 x = n;
+		Int64 y = m;
+		for ( Int64 d = cost; d > 0; d-- ) {
+			const auto& prevV = trace[d - 1];
+			const auto at = [&prevV, d]( Int64 k ) { return prevV[k + d - 1]; };
+			Int64 k = x - y;
+			Int64 prevK = ( k == -d || ( k != d && at( k - 1 ) < at( k + 1 ) ) ) ? k + 1 : k - 1;
+			Int64 prevX = at( prevK );
+			Int64 prevY = prevX - prevK;
+			while ( x > prevX && y > prevY ) {
+				script.push_back( LineEdit::Common );
+				x--;
+				y--;
+			}
+			script.push_back( x == prevX ? LineEdit::Added : LineEdit::Removed );
+			x = prevX;
+			y = prevY;
+		}
+		script.insert( script.end(), x, LineEdit::Common );
+
+		edits.insert( edits.end(), script.rbegin(), script.rend() );
+		return true;
+	}
+};
+
+std::vector<UIDiffView::DiffLine>
+UIDiffView::diffLines( const std::vector<std::string>& oldLines,
+					   const std::vector<std::string>& newLines ) {
+	// Identical lines share the same id, so the diff compares integers instead of strings
+	UnorderedMap<std::string_view, Uint32> ids;
+	const auto toIds = [&ids]( const std::vector<std::string>& lines ) {
+		std::vector<Uint32> res;
+		res.reserve( lines.size() );
+		for ( const auto& line : lines )
+			res.push_back( ids.emplace( line, static_cast<Uint32>( ids.size() ) ).first->second );
+		return res;
+	};
+	std::vector<Uint32> a( toIds( oldLines ) );
+	std::vector<Uint32> b( toIds( newLines ) );
+
+	LineDiffEngine engine{ a, b, {} };
+	engine.diff( 0, a.size(), 0, b.size() );
+
+	std::vector<DiffLine> lines;
+	lines.reserve( eemax( oldLines.size(), newLines.size() ) );
+	const auto& edits = engine.edits;
+	size_t oldIdx = 0;
+	size_t newIdx = 0;
+	size_t i = 0;
+
+	while ( i < edits.size() ) {
+		if ( edits[i] == LineEdit::Common ) {
+			DiffLine dline;
+			dline.type = DiffLineType::Common;
+			dline.text = oldLines[oldIdx];
+			dline.oldLineNum = ++oldIdx;
+			dline.newLineNum = ++newIdx;
+			lines.emplace_back( std::move( dline ) );
+			i++;
+			continue;
+		}
+
+		// A block of changes lists the removed lines before the added ones, as unified diffs do
+		size_t added = 0;
+		size_t removed = 0;
+		for ( ; i < edits.size() && edits[i] != LineEdit::Common; i++ )
+			( edits[i] == LineEdit::Added ? added : removed )++;
+
+		for ( size_t n = 0; n < removed; n++ ) {
+			DiffLine dline;
+			dline.type = DiffLineType::Removed;
+			dline.text = oldLines[oldIdx];
+			dline.oldLineNum = ++oldIdx;
+			lines.emplace_back( std::move( dline ) );
+		}
+
+		for ( size_t n = 0; n < added; n++ ) {
+			DiffLine dline;
+			dline.type = DiffLineType::Added;
+			dline.text = newLines[newIdx];
+			dline.newLineNum = ++newIdx;
+			lines.emplace_back( std::move( dline ) );
+		}
+	}
+
+	return lines;
+}
+
 void UIDiffView::computeSubLineDiff( DiffLine& oldLine, DiffLine& newLine ) {
+	if ( oldLine.text.size() + newLine.text.size() > SUB_LINE_DIFF_MAX_LENGTH )
+		return;
+
 	dtl::Diff<String::StringBaseType, String::View> diff( oldLine.text.view(),
 														  newLine.text.view() );
 	diff.compose();
@@ -634,30 +860,53 @@ void UIDiffView::computeSubLineDiff( DiffLine& oldLine, DiffLine& newLine ) {
 	}
 }
 
-static void applySubLineDiff(
-	std::vector<UIDiffView::DiffLine>& lines,
-	std::function<void( UIDiffView::DiffLine&, UIDiffView::DiffLine& )> computeSubLineDiff ) {
+// Pairs the removed and added lines of each block of changes, as ( removed, added ) indexes
+static std::vector<std::pair<size_t, size_t>>
+findChangedLinePairs( const std::vector<UIDiffView::DiffLine>& lines ) {
+	std::vector<std::pair<size_t, size_t>> pairs;
 	size_t i = 0;
 	while ( i < lines.size() ) {
-		if ( lines[i].type == UIDiffView::DiffLineType::Removed ) {
+		auto type = lines[i].type;
+		if ( type == UIDiffView::DiffLineType::Removed ||
+			 type == UIDiffView::DiffLineType::Added ) {
+			auto otherType = type == UIDiffView::DiffLineType::Removed
+								 ? UIDiffView::DiffLineType::Added
+								 : UIDiffView::DiffLineType::Removed;
 			size_t j = i;
-			while ( j < lines.size() && lines[j].type == UIDiffView::DiffLineType::Removed )
+			while ( j < lines.size() && lines[j].type == type )
 				j++;
 			size_t k = j;
-			while ( k < lines.size() && lines[k].type == UIDiffView::DiffLineType::Added )
+			while ( k < lines.size() && lines[k].type == otherType )
 				k++;
 
-			size_t numRemoved = j - i;
-			size_t numAdded = k - j;
-			size_t numToCompare = std::min( numRemoved, numAdded );
+			size_t numToCompare = std::min( j - i, k - j );
 			for ( size_t m = 0; m < numToCompare; m++ ) {
-				computeSubLineDiff( lines[i + m], lines[j + m] );
+				if ( type == UIDiffView::DiffLineType::Removed )
+					pairs.emplace_back( i + m, j + m );
+				else
+					pairs.emplace_back( j + m, i + m );
 			}
 			i = k;
 		} else {
 			i++;
 		}
 	}
+	return pairs;
+}
+
+void UIDiffView::computeSubLineDiffs() {
+	auto pairs = findChangedLinePairs( mLines );
+	const auto compute = [this, &pairs]( size_t i ) {
+		computeSubLineDiff( mLines[pairs[i].first], mLines[pairs[i].second] );
+	};
+
+	// Every pair touches different lines, so they can be diffed in parallel
+	if ( pairs.size() > 1 && getUISceneNode() && getUISceneNode()->hasThreadPool() ) {
+		getUISceneNode()->getThreadPool()->parallelFor( pairs.size(), compute );
+	} else {
+		for ( size_t i = 0; i < pairs.size(); i++ )
+			compute( i );
+	}
 }
 
 void UIDiffView::loadFromPatch( const std::string& patchText,
@@ -775,9 +1024,7 @@ void UIDiffView::loadFromPatch( const std::string& patchText,
 		}
 	}
 
-	applySubLineDiff( mLines, [this]( DiffLine& oldLine, DiffLine& newLine ) {
-		computeSubLineDiff( oldLine, newLine );
-	} );
+	computeSubLineDiffs();
 
 	setCompleteViewToggleVisible( hasCompleteFile );
 
@@ -800,37 +1047,9 @@ void UIDiffView::loadFromStrings( const std::string& oldText, const std::string&
 	std::vector<std::string> leftLines = String::split( oldText, '\n', true );
 	std::vector<std::string> rightLines = String::split( newText, '\n', true );
 
-	dtl::Diff<std::string> diff( leftLines, rightLines );
-	diff.compose();
-	auto ranges = diff.getSes().getSequence();
-
-	size_t leftIndex = 0;
-	size_t rightIndex = 0;
+	mLines = diffLines( leftLines, rightLines );
 
-	for ( auto& pair : ranges ) {
-		DiffLine dline;
-		dline.text = pair.first;
-		switch ( pair.second.type ) {
-			case dtl::SES_COMMON:
-				dline.type = DiffLineType::Common;
-				dline.oldLineNum = ++leftIndex;
-				dline.newLineNum = ++rightIndex;
-				break;
-			case dtl::SES_ADD:
-				dline.type = DiffLineType::Added;
-				dline.newLineNum = ++rightIndex;
-				break;
-			case dtl::SES_DELETE:
-				dline.type = DiffLineType::Removed;
-				dline.oldLineNum = ++leftIndex;
-				break;
-		}
-		mLines.push_back( dline );
-	}
-
-	applySubLineDiff( mLines, [this]( DiffLine& oldLine, DiffLine& newLine ) {
-		computeSubLineDiff( oldLine, newLine );
-	} );
+	computeSubLineDiffs();
 
 	if ( !originalFilePath.empty() ) {
 		auto def = SyntaxDefinitionManager::instance()->getByExtension( originalFilePath );
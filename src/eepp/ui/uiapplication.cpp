@@ -119,7 +119,11 @@ int UIApplication::run() {
 			mWindow->display();
 		} else {
 #if EE_PLATFORM != EE_PLATFORM_EMSCRIPTEN
-			mWindow->getInput()->waitEvent( Milliseconds( mWindow->hasFocus() ? 16 : 100 ) );
+			Time pollTimeout( Milliseconds( mWindow->hasFocus() ? 16 : 100 ) );
+			if ( mIdleUntilDeadline )
+				SceneManager::instance()->waitForNextUpdate( mWindow, pollTimeout );
+			else
+				mWindow->getInput()->waitEvent( pollTimeout );
 #endif
 		}
 	} );
@@ -147,4 +151,12 @@ bool UIApplication::showMemoryManagerResult() const {
 	return mShowMemoryManagerResult;
 }
 
+void UIApplication::setIdleUntilDeadline( bool idleUntilDeadline ) {
+	mIdleUntilDeadline = idleUntilDeadline;
+}
+
+bool UIApplication::isIdleUntilDeadline() const {
+	return mIdleUntilDeadline;
+}
+
 }} // namespace EE::UI
@@ -184,6 +184,8 @@ UICodeEditor::UICodeEditor( const std::string& elementTag, const bool& autoRegis
 
 	setClipType( ClipType::ContentBox );
 	mDoc->registerClient( this );
+	mDoc->registerLineData( &mLinesWidthCache );
+	mDoc->registerLineData( &mColorBoxesCache );
 	subscribeScheduledUpdate();
 
 	if ( autoRegisterBaseCommands )
@@ -219,6 +221,8 @@ UICodeEditor::~UICodeEditor() {
 		Sys::sleep( Milliseconds( 0.1 ) );
 
 	mDocView.setDocument( nullptr );
+	mDoc->unregisterLineData( &mLinesWidthCache );
+	mDoc->unregisterLineData( &mColorBoxesCache );
 	std::size_t clientsOfTypeCount = mDoc->clientOfTypeCount( TextDocument::Client::Type::Core );
 	long useCount = mDoc.use_count();
 
@@ -258,17 +262,25 @@ void UICodeEditor::draw() {
 	if ( mFont == NULL )
 		return;
 
-	if ( mDisplayLoaderIfDocumentLoading && mDoc->isLoading() ) {
+	bool displayLoading = isDisplayingLoadingDocument();
+
+	if ( mDisplayLoaderIfDocumentLoading && mDoc->isLoading() && !displayLoading ) {
 		UILoader* loader = getLoader();
 		loader->setParent( this );
 		loader->setVisible( true );
 		loader->setEnabled( false );
 		loader->setPixelsSize( getPixelsSize() );
-	} else if ( mLoader != nullptr && !mDoc->isLoading() && mLoader->isVisible() ) {
+	} else if ( mLoader != nullptr && ( !mDoc->isLoading() || displayLoading ) &&
+				mLoader->isVisible() ) {
 		mLoader->setVisible( false );
 	}
 
-	if ( mDoc->isLoading() || mSize.getWidth() == 0 )
+	if ( ( mDoc->isLoading() && !displayLoading ) || mSize.getWidth() == 0 )
+		return;
+
+	// The loading thread can't publish new lines while the loaded ones are being drawn
+	ConditionalLock linesLock( displayLoading, &mDoc->getLinesMutex() );
+	if ( displayLoading && mDoc->linesCount() == 0 )
 		return;
 
 	bool needsClipping = mPaddingPx != Rectf::Zero;
@@ -283,6 +295,9 @@ void UICodeEditor::draw() {
 	if ( mDocView.isPendingReconstruction() )
 		mDocView.invalidateCache();
 
+	if ( mDocView.hasPendingLines() )
+		mDocView.measureVisibleRegion( getVisibleLineRange().first, getVisibleLinesCount() );
+
 	Color col;
 	auto lineRange = getDocumentLineRange();
 	auto visibleLineRange = getVisibleLineRange();
@@ -484,6 +499,29 @@ void UICodeEditor::scheduledUpdate( const Time& ) {
 	if ( !mVisible )
 		return;
 
+	if ( mDoc && mDoc->isLoading() && mDisplayDocumentWhileLoading ) {
+		size_t linesCount = mDoc->linesCount();
+		if ( linesCount != mLoadingLinesCount ) {
+			mLoadingLinesCount = linesCount;
+			updateScrollBar();
+			invalidateDraw();
+		}
+	} else if ( mLoadingLinesCount != 0 ) {
+		mLoadingLinesCount = 0;
+	}
+
+	if ( mDoc && !mDoc->isLoading() && mDocView.hasPendingLines() ) {
+		// Keep the first visible document line in place while the lines above it are measured
+		Int64 firstLine = mDocView.getVisibleIndexPosition( getVisibleLineRange().first ).line();
+		Int64 firstIndex = static_cast<Int64>( mDocView.toVisibleIndex( firstLine ) );
+		if ( mDocView.measurePendingLines( Milliseconds( 4 ) ) )
+			updateScrollBar();
+		Int64 offset = static_cast<Int64>( mDocView.toVisibleIndex( firstLine ) ) - firstIndex;
+		if ( offset != 0 )
+			setScrollY( mScroll.y + offset * getLineHeight() );
+		invalidateDraw();
+	}
+
 	if ( mDoc && !mDoc->isLoading() && !mDoc->isEmpty() &&
 		 !mDoc->getSyntaxDefinition().getPatterns().empty() &&
 		 mDoc->getHighlighter()->updateDirty( getVisibleLinesCount() ) ) {
@@ -500,6 +538,47 @@ void UICodeEditor::scheduledUpdate( const Time& ) {
 		plugin->update( this );
 }
 
+Time UICodeEditor::getScheduledUpdateTimeout( const Time& pollTimeout ) {
+	if ( mMouseDown || mMouseDownMinimap )
+		return pollTimeout;
+
+	Time timeout = Time::Infinity;
+
+	if ( mDisableCursorBlinkingAfterAMinuteOfInactivity &&
+		 mLastActivity.getElapsedTime() > Seconds( 60 ) ) {
+		if ( !mCursorVisible )
+			return Time::Zero;
+	} else if ( hasFocus() && getUISceneNode()->getWindow()->hasFocus() &&
+				mBlinkTime != Time::Zero ) {
+		Time elapsed = mBlinkTimer.getElapsedTime();
+		timeout = elapsed < mBlinkTime ? mBlinkTime - elapsed : Time::Zero;
+
+		if ( mDisableCursorBlinkingAfterAMinuteOfInactivity )
+			timeout = eemin( timeout, Seconds( 60 ) - mLastActivity.getElapsedTime() );
+	}
+
+	// The lines published while loading are polled
+	if ( mVisible && mDoc && mDoc->isLoading() && mDisplayDocumentWhileLoading )
+		timeout = eemin( timeout, pollTimeout );
+
+	// Pending highlighting and longest line updates are polled
+	if ( mVisible && mDoc && !mDoc->isLoading() &&
+		 ( ( mLongestLineWidthDirty && needsHorizontalLength() ) ||
+		   ( !mDoc->isEmpty() && !mDoc->getSyntaxDefinition().getPatterns().empty() &&
+			 mDoc->getHighlighter()->getFirstInvalidLine() <=
+				 mDoc->getHighlighter()->getMaxWantedLine() ) ) )
+		timeout = eemin( timeout, pollTimeout );
+
+	// Lines wrapped with an estimated number of visual lines are measured in the background
+	if ( mVisible && mDoc && !mDoc->isLoading() && mDocView.hasPendingLines() )
+		timeout = eemin( timeout, pollTimeout );
+
+	for ( auto& plugin : mPlugins )
+		timeout = eemin( timeout, plugin->getUpdateTimeout( this, pollTimeout ) );
+
+	return timeout;
+}
+
 void UICodeEditor::updateLongestLineWidth() {
 	if ( needsHorizontalLength() && mDoc && !mDoc->isLoading() && !mDoc->isRunningTransaction() ) {
 		Float maxWidth = mLongestLineWidth;
@@ -1021,11 +1100,15 @@ void UICodeEditor::setDocument( std::shared_ptr<TextDocument> doc ) {
 			mDoc->clientOfTypeCount( TextDocument::Client::Type::Core );
 		long useCount = mDoc.use_count();
 		mDoc->unregisterClient( this );
+		mDoc->unregisterLineData( &mLinesWidthCache );
+		mDoc->unregisterLineData( &mColorBoxesCache );
 		mDocView.setDocument( nullptr );
 		if ( clientsOfTypeCount == 1 || useCount == 1 )
 			onDocumentClosed( mDoc.get() );
 		mDoc = doc;
 		mDoc->registerClient( this );
+		mDoc->registerLineData( &mLinesWidthCache );
+		mDoc->registerLineData( &mColorBoxesCache );
 		mDocView.setDocument( doc );
 		onDocumentChanged( oldDocURI );
 		if ( mDoc->isLoading() ) {
@@ -1115,7 +1198,7 @@ Uint32 UICodeEditor::onFocusLoss() {
 Uint32 UICodeEditor::onTextInput( const TextInputEvent& event ) {
 	mLastActivity.restart();
 
-	if ( mLocked || NULL == mFont )
+	if ( mLocked || NULL == mFont || mDoc->isLoading() )
 		return 0;
 	Input* input = getInput();
 
@@ -1213,6 +1296,8 @@ void UICodeEditor::setCodeEditorFlags( std::string flags, bool enable ) {
 				mInteractiveLinks = enable;
 			} else if ( "displayloader" == flag ) {
 				mDisplayLoaderIfDocumentLoading = enable;
+			} else if ( "displaywhileloading" == flag ) {
+				mDisplayDocumentWhileLoading = enable;
 			} else if ( "defaultcontextmenu" == flag ) {
 				mCreateDefaultContextMenuOptions = enable;
 			} else if ( "minimap" == flag ) {
@@ -1268,6 +1353,8 @@ std::string UICodeEditor::getCodeEditorFlags( bool enabled ) const {
 		flags += "interactivelinks|";
 	if ( mDisplayLoaderIfDocumentLoading == enabled )
 		flags += "displayloader|";
+	if ( mDisplayDocumentWhileLoading == enabled )
+		flags += "displaywhileloading|";
 	if ( mCreateDefaultContextMenuOptions == enabled )
 		flags += "defaultcontextmenu|";
 	if ( mMinimapEnabled == enabled )
@@ -1303,14 +1390,22 @@ Uint32 UICodeEditor::onKeyDown( const KeyEvent& event ) {
 	if ( NULL == mFont || mUISceneNode->getUIEventDispatcher()->justGainedFocus() )
 		return 0;
 
-	for ( auto& plugin : mPlugins )
-		if ( plugin->onKeyDown( this, event ) )
-			return 1;
+	// The document lines are being published from the loader thread
+	bool loading = mDoc->isLoading();
+
+	if ( !loading ) {
+		for ( auto& plugin : mPlugins )
+			if ( plugin->onKeyDown( this, event ) )
+				return 1;
+	}
 
 	std::string cmd = mKeyBindings.getCommandFromKeyBind( { event.getKeyCode(), event.getMod() } );
 	if ( !cmd.empty() ) {
-		// Allow copy selection on locked mode
-		if ( !mLocked || mUnlockedCmd.find( cmd ) != mUnlockedCmd.end() ) {
+		// Allow copy selection on locked mode. While loading, only the unlocked commands that aren't
+		// document commands are allowed ( closing or switching tabs, splits, etc )
+		bool unlocked = mUnlockedCmd.find( cmd ) != mUnlockedCmd.end();
+		if ( loading ? unlocked && !TextDocument::isTextDocumentCommand( cmd )
+					 : !mLocked || unlocked ) {
 			mDoc->execute( cmd, this );
 			mLastCmdHash = String::hash( cmd );
 			mLastExecuteEventId = getInput()->getEventsSentId();
@@ -1549,6 +1644,8 @@ bool UICodeEditor::tryExecuteMouseBinding( const MouseBindings::Shortcut& shortc
 
 Uint32 UICodeEditor::onMouseDown( const Vector2i& position, const Uint32& flags ) {
 	mLastActivity.restart();
+	if ( mDoc->isLoading() )
+		return UIWidget::onMouseDown( position, flags );
 	for ( auto& plugin : mPlugins )
 		if ( plugin->onMouseDown( this, position, flags ) )
 			return UIWidget::onMouseDown( position, flags );
@@ -1755,6 +1852,8 @@ void UICodeEditor::updateMipmapHover( const Vector2f& position ) {
 
 Uint32 UICodeEditor::onMouseMove( const Vector2i& position, const Uint32& flags ) {
 	mLastActivity.restart();
+	if ( mDoc->isLoading() )
+		return UIWidget::onMouseMove( position, flags );
 	for ( auto& plugin : mPlugins )
 		if ( plugin->onMouseMove( this, position, flags ) )
 			return UIWidget::onMouseMove( position, flags );
@@ -1865,6 +1964,8 @@ Uint32 UICodeEditor::onMouseUp( const Vector2i& position, const Uint32& flags )
 
 Uint32 UICodeEditor::onMouseClick( const Vector2i& position, const Uint32& flags ) {
 	mLastActivity.restart();
+	if ( mDoc->isLoading() )
+		return UIWidget::onMouseClick( position, flags );
 	for ( auto& plugin : mPlugins )
 		if ( plugin->onMouseClick( this, position, flags ) )
 			return UIWidget::onMouseClick( position, flags );
@@ -1904,6 +2005,8 @@ Uint32 UICodeEditor::onMouseClick( const Vector2i& position, const Uint32& flags
 
 Uint32 UICodeEditor::onMouseDoubleClick( const Vector2i& position, const Uint32& flags ) {
 	mLastActivity.restart();
+	if ( mDoc->isLoading() )
+		return UIWidget::onMouseDoubleClick( position, flags );
 	for ( auto& plugin : mPlugins )
 		if ( plugin->onMouseDoubleClick( this, position, flags ) )
 			return UIWidget::onMouseDoubleClick( position, flags );
@@ -2095,10 +2198,8 @@ Float UICodeEditor::getLineWidth( const Int64& docLine ) {
 		Float width = 0;
 
 		if ( !isMonospaceLine ) {
-			auto found = mLinesWidthCache.find( docLine );
-			if ( found != mLinesWidthCache.end() &&
-				 mDoc->getLineHash( docLine ) == found->second.first )
-				return found->second.second;
+			if ( const Float* cachedWidth = mLinesWidthCache.get( docLine ) )
+				return *cachedWidth;
 		}
 
 		for ( size_t i = 0; i < vline.visualLines.size(); i++ ) {
@@ -2113,20 +2214,19 @@ Float UICodeEditor::getLineWidth( const Int64& docLine ) {
 		}
 
 		if ( !isMonospaceLine ) {
-			mLinesWidthCache[docLine] = { line.getHash(), width };
+			mLinesWidthCache.set( docLine, width );
 		}
 
 		return width;
 	}
 
 	if ( !isMonospaceLine ) {
+		if ( const Float* cachedWidth = mLinesWidthCache.get( docLine ) )
+			return *cachedWidth;
 		auto& line = mDoc->line( docLine );
-		auto found = mLinesWidthCache.find( docLine );
-		if ( found != mLinesWidthCache.end() && line.getHash() == found->second.first )
-			return found->second.second;
 		Float width = getTextWidth( line.getText(), {}, mTabStops ? 0 : std::optional<Float>{},
 									line.getTextHints() | getWidgetTextDrawHints() );
-		mLinesWidthCache[docLine] = { line.getHash(), width };
+		mLinesWidthCache.set( docLine, width );
 		return width;
 	}
 
@@ -2216,6 +2316,21 @@ void UICodeEditor::setDisplayLoaderIfDocumentLoading( bool newDisplayLoaderIfDoc
 	}
 }
 
+bool UICodeEditor::getDisplayDocumentWhileLoading() const {
+	return mDisplayDocumentWhileLoading;
+}
+
+void UICodeEditor::setDisplayDocumentWhileLoading( bool displayDocumentWhileLoading ) {
+	if ( mDisplayDocumentWhileLoading != displayDocumentWhileLoading ) {
+		mDisplayDocumentWhileLoading = displayDocumentWhileLoading;
+		invalidateDraw();
+	}
+}
+
+bool UICodeEditor::isDisplayingLoadingDocument() const {
+	return mDisplayDocumentWhileLoading && mDoc->isLoading() && mLoadingLinesCount > 0;
+}
+
 size_t UICodeEditor::getMenuIconSize() const {
 	return mMenuIconSize;
 }
@@ -2344,61 +2459,6 @@ void UICodeEditor::onDocumentClosed( TextDocument* doc ) {
 void UICodeEditor::onDocumentLineMove( const Int64& fromLine, const Int64& toLine,
 									   const Int64& numLines ) {
 	mDocView.updateCache( fromLine, toLine, numLines );
-
-	if ( !mColorBoxesCache.empty() ) {
-		Int64 linesCount = mDoc->linesCount();
-		if ( numLines > 0 ) {
-			for ( Int64 i = linesCount - 1; i >= fromLine; --i ) {
-				auto lineIt = mColorBoxesCache.find( i - numLines );
-				if ( lineIt != mColorBoxesCache.end() ) {
-					const auto& line = lineIt->second;
-					if ( line.first == mDoc->getLineHash( i ) ) {
-						auto nl = mColorBoxesCache.extract( lineIt );
-						nl.key() = i;
-						mColorBoxesCache.insert( std::move( nl ) );
-					}
-				}
-			}
-		} else if ( numLines < 0 ) {
-			for ( Int64 i = fromLine; i < linesCount; i++ ) {
-				auto lineIt = mColorBoxesCache.find( i - numLines );
-				if ( lineIt != mColorBoxesCache.end() &&
-					 lineIt->second.first == mDoc->getLineHash( i ) ) {
-					auto nl = mColorBoxesCache.extract( lineIt );
-					nl.key() = i;
-					mColorBoxesCache[i] = std::move( nl.mapped() );
-				}
-			}
-		}
-	}
-
-	if ( !mFont || mFont->isMonospace() || mLinesWidthCache.empty() )
-		return;
-
-	Int64 linesCount = mDoc->linesCount();
-	if ( numLines > 0 ) {
-		for ( Int64 i = linesCount - 1; i >= fromLine; --i ) {
-			auto lineIt = mLinesWidthCache.find( i - numLines );
-			if ( lineIt != mLinesWidthCache.end() ) {
-				const auto& line = lineIt->second;
-				if ( line.first == mDoc->getLineHash( i ) ) {
-					auto nl = mLinesWidthCache.extract( lineIt );
-					nl.key() = i;
-					mLinesWidthCache.insert( std::move( nl ) );
-				}
-			}
-		}
-	} else if ( numLines < 0 ) {
-		for ( Int64 i = fromLine; i < linesCount; i++ ) {
-			auto lineIt = mLinesWidthCache.find( i - numLines );
-			if ( lineIt != mLinesWidthCache.end() &&
-				 lineIt->second.first == mDoc->getLineHash( i ) ) {
-				auto nl = mLinesWidthCache.extract( lineIt );
-				nl.key() = i;
-				mLinesWidthCache[i] = std::move( nl.mapped() );
-			}
-		}
-	}
 }
 
 void UICodeEditor::onDocumentDirtyOnFileSystem( TextDocument* doc ) {
@@ -3735,6 +3795,8 @@ void UICodeEditor::unindent() {
 }
 
 void UICodeEditor::copy() {
+	if ( mDoc->isLoading() )
+		return;
 	getUISceneNode()->getWindow()->getClipboard()->setText( mDoc->getAllSelectedText().toUtf8() );
 }
 
@@ -3813,7 +3875,8 @@ void UICodeEditor::updateHighlightWordCache() {
 						mHighlightWordProcessing++;
 						mDoc->stopActiveFindAll();
 
-						auto wordCache = mDoc->findAll(
+						auto wordCache = mDoc->findAllParallel(
+							getUISceneNode()->getThreadPool(),
 							mHighlightWord.escapeSequences ? String::unescape( mHighlightWord.text )
 														   : mHighlightWord.text,
 							mHighlightWord.caseSensitive, mHighlightWord.wholeWord,
@@ -4071,8 +4134,8 @@ void UICodeEditor::drawLineText( const Int64& line, Vector2f position, const Flo
 	const std::vector<ColorBoxData>* colorBoxesPtr = nullptr;
 	size_t colorBoxIdx = 0;
 	if ( mEnableInlineColorBoxes ) {
-		auto it = mColorBoxesCache.find( line );
-		if ( it == mColorBoxesCache.end() || it->second.first != mDoc->getLineHash( line ) ) {
+		const std::vector<ColorBoxData>* lineColorBoxes = mColorBoxesCache.get( line );
+		if ( lineColorBoxes == nullptr ) {
 			std::vector<ColorBoxData> colorBoxes;
 			size_t cachePos = 0;
 			for ( const auto& token : tokens ) {
@@ -4096,11 +4159,10 @@ void UICodeEditor::drawLineText( const Int64& line, Vector2f position, const Flo
 				}
 				cachePos += token.len;
 			}
-			mColorBoxesCache[line] = { mDoc->getLineHash( line ), std::move( colorBoxes ) };
-			it = mColorBoxesCache.find( line );
+			lineColorBoxes = mColorBoxesCache.set( line, std::move( colorBoxes ) );
 		}
-		if ( !it->second.second.empty() )
-			colorBoxesPtr = &it->second.second;
+		if ( lineColorBoxes != nullptr && !lineColorBoxes->empty() )
+			colorBoxesPtr = lineColorBoxes;
 	}
 
 	WhitespaceDisplayConfig whitespaceDisplayConfig =
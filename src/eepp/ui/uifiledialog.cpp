@@ -1001,6 +1001,12 @@ bool UIFileDialog::usingNativeFileDialog() const {
 	return ( mDialogFlags & Flags::UseNativeFileDialog ) && pfd::settings::available();
 }
 
+Time UIFileDialog::getScheduledUpdateTimeout( const Time& pollTimeout ) {
+	// The native file dialog result is polled
+	return usingNativeFileDialog() ? pollTimeout
+								   : UIWindow::getScheduledUpdateTimeout( pollTimeout );
+}
+
 void UIFileDialog::scheduledUpdate( const Time& time ) {
 	if ( !usingNativeFileDialog() )
 		return UIWindow::scheduledUpdate( time );
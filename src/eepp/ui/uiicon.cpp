@@ -1,6 +1,7 @@
 #include <eepp/graphics/fonttruetype.hpp>
 #include <eepp/graphics/texturefactory.hpp>
 #include <eepp/ui/uiicon.hpp>
+#include <eepp/ui/uisvgiconatlas.hpp>
 
 namespace EE { namespace UI {
 
@@ -72,9 +73,15 @@ UIIcon* UISVGIcon::New( const std::string& name, const std::string& svgXML ) {
 	return eeNew( UISVGIcon, ( name, svgXML ) );
 }
 
-UISVGIcon::~UISVGIcon() {}
+UISVGIcon::~UISVGIcon() {
+	if ( mAtlas )
+		mAtlas->remove( this );
+}
 
 Drawable* UISVGIcon::getSize( const int& size ) const {
+	if ( mAtlas )
+		return mAtlas->getRegion( const_cast<UISVGIcon*>( this ), size );
+
 	auto it = mSVGs.find( size );
 	if ( it != mSVGs.end() )
 		return it->second;
@@ -102,4 +109,16 @@ Drawable* UISVGIcon::getSize( const int& size ) const {
 UISVGIcon::UISVGIcon( const std::string& name, const std::string& svgXML ) :
 	UIIcon( name ), mSVGXml( svgXML ) {}
 
+const std::string& UISVGIcon::getSVGXml() const {
+	return mSVGXml;
+}
+
+UISVGIconAtlas* UISVGIcon::getAtlas() const {
+	return mAtlas;
+}
+
+void UISVGIcon::setAtlas( UISVGIconAtlas* atlas ) {
+	mAtlas = atlas;
+}
+
 }} // namespace EE::UI
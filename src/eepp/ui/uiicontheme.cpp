@@ -10,6 +10,7 @@ UIIconTheme* UIIconTheme::New( const std::string& name ) {
 UIIconTheme::~UIIconTheme() {
 	for ( auto icon : mIcons )
 		eeDelete( icon.second );
+	eeSAFE_DELETE( mSVGIconAtlas );
 }
 
 UIIconTheme::UIIconTheme( const std::string& name ) : mName( name ) {}
@@ -19,14 +20,40 @@ UIIconTheme* UIIconTheme::add( UIIcon* icon ) {
 	if ( iconExists != mIcons.end() )
 		eeDelete( iconExists->second );
 	mIcons[icon->getName()] = icon;
+	if ( mSVGIconAtlas && icon->getType() == UIIcon::Type::SVG )
+		mSVGIconAtlas->add( static_cast<UISVGIcon*>( icon ) );
 	return this;
 }
 
 UIIconTheme* UIIconTheme::add( const std::unordered_map<std::string, UIIcon*>& icons ) {
 	mIcons.insert( icons.begin(), icons.end() );
+	if ( mSVGIconAtlas ) {
+		for ( const auto& icon : icons ) {
+			if ( icon.second->getType() == UIIcon::Type::SVG )
+				mSVGIconAtlas->add( static_cast<UISVGIcon*>( icon.second ) );
+		}
+	}
 	return this;
 }
 
+UIIconTheme* UIIconTheme::setSVGIconAtlas( UISVGIconAtlas* atlas ) {
+	if ( mSVGIconAtlas == atlas )
+		return this;
+	eeSAFE_DELETE( mSVGIconAtlas );
+	mSVGIconAtlas = atlas;
+	if ( mSVGIconAtlas ) {
+		for ( const auto& icon : mIcons ) {
+			if ( icon.second->getType() == UIIcon::Type::SVG )
+				mSVGIconAtlas->add( static_cast<UISVGIcon*>( icon.second ) );
+		}
+	}
+	return this;
+}
+
+UISVGIconAtlas* UIIconTheme::getSVGIconAtlas() const {
+	return mSVGIconAtlas;
+}
+
 const std::string& UIIconTheme::getName() const {
 	return mName;
 }
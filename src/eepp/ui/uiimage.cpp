@@ -378,7 +378,7 @@ bool UIImage::applyProperty( const StyleSheetProperty& attribute ) {
 			} else {
 				Drawable* res = NULL;
 				if ( NULL != ( res = DrawableSearcher::searchByName(
-								   path, false, getUISceneNode()->getReferer() ) ) )
+								   path, false, getUISceneNode()->getReferer(), true ) ) )
 					setDrawable( res, res->getDrawableType() == Drawable::SPRITE );
 			}
 			break;
@@ -0,0 +1,72 @@
+#include <eepp/ui/css/shorthanddefinition.hpp>
+#include <eepp/ui/css/stylesheetpropertiesparser.hpp>
+#include <eepp/ui/css/stylesheetselectorrule.hpp>
+#include <eepp/ui/uilayouttemplate.hpp>
+
+#define PUGIXML_HEADER_ONLY
+#include <pugixml/pugixml.hpp>
+
+using namespace EE::UI::CSS;
+
+namespace EE { namespace UI {
+
+UILayoutTemplate::UILayoutTemplate( std::unique_ptr<pugi::xml_document> document ) :
+	mDocument( std::move( document ) ) {
+	if ( mDocument )
+		compile( mDocument->first_child() );
+}
+
+UILayoutTemplate::~UILayoutTemplate() {}
+
+pugi::xml_node UILayoutTemplate::getFirstNode() const {
+	return mDocument ? mDocument->first_child() : pugi::xml_node();
+}
+
+const std::vector<StyleSheetProperty>*
+UILayoutTemplate::getAttributes( const pugi::xml_node& node ) const {
+	auto it = mAttributes.find( node.internal_object() );
+	return it != mAttributes.end() ? &it->second : nullptr;
+}
+
+void UILayoutTemplate::compile( const pugi::xml_node& firstNode ) {
+	for ( pugi::xml_node node = firstNode; node; node = node.next_sibling() ) {
+		if ( node.type() != pugi::node_element )
+			continue;
+
+		// The style sheets are parsed when instantiated, since the parsed rules are shared with
+		// the scene style sheet they are combined into.
+		if ( String::iequals( node.name(), "style" ) )
+			continue;
+
+		// Same conversion than UIWidget::loadFromXmlNode
+		std::vector<StyleSheetProperty>& attributes = mAttributes[node.internal_object()];
+
+		for ( pugi::xml_attribute_iterator ait = node.attributes_begin();
+			  ait != node.attributes_end(); ++ait ) {
+			if ( String::iequals( ait->name(), "style" ) ) {
+				StyleSheetPropertiesParser propertiesParser;
+				propertiesParser.parse( std::string_view{ ait->value() } );
+				for ( auto& [_, prop] : propertiesParser.getProperties() ) {
+					attributes.emplace_back( prop );
+					attributes.back().setSpecificity( StyleSheetSelectorRule::SpecificityInline );
+				}
+				continue;
+			}
+
+			StyleSheetProperty prop( ait->name(), ait->value(), false,
+									 StyleSheetSelectorRule::SpecificityInline );
+
+			if ( prop.getShorthandDefinition() != NULL ) {
+				auto properties = prop.getShorthandDefinition()->parse( ait->value() );
+				for ( auto& property : properties )
+					attributes.emplace_back( std::move( property ) );
+			} else {
+				attributes.emplace_back( std::move( prop ) );
+			}
+		}
+
+		compile( node.first_child() );
+	}
+}
+
+}} // namespace EE::UI
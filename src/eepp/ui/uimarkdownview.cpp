@@ -9,6 +9,94 @@ using namespace EE::UI::Doc;
 
 namespace EE { namespace UI {
 
+static size_t lineIndentation( std::string_view line ) {
+	size_t indent = 0;
+	for ( char ch : line ) {
+		if ( ch == ' ' )
+			indent++;
+		else if ( ch == '\t' )
+			indent += 4;
+		else
+			break;
+	}
+	return indent;
+}
+
+static bool isBlankLine( std::string_view line ) {
+	return line.find_first_not_of( " \t\r" ) == std::string_view::npos;
+}
+
+static size_t fenceLength( std::string_view line, char& fenceChar ) {
+	size_t start = line.find_first_not_of( " \t" );
+	if ( start == std::string_view::npos || ( line[start] != '`' && line[start] != '~' ) )
+		return 0;
+	line = line.substr( start );
+	size_t len = line.find_first_not_of( line[0] );
+	len = len == std::string_view::npos ? line.size() : len;
+	if ( len < 3 )
+		return 0;
+	fenceChar = line[0];
+	return len;
+}
+
+static bool isAtxHeading( std::string_view line ) {
+	size_t level = line.find_first_not_of( '#' );
+	level = level == std::string_view::npos ? line.size() : level;
+	return level >= 1 && level <= 6 &&
+		   ( level == line.size() || line[level] == ' ' || line[level] == '\t' ||
+			 line[level] == '\r' );
+}
+
+// Finds where the last block that can still change starts. Everything before it is made of
+// finished top level blocks: blocks followed by a blank line and a non indented line, closed
+// code fences and ATX headings. The scan starts from a previous block start, which is never
+// inside a code fence. Only complete lines are considered.
+static size_t findOpenBlockStart( std::string_view markdown, size_t from ) {
+	size_t openBlockStart = from;
+	bool inFence = false;
+	bool topLevelFence = false;
+	char fenceChar = 0;
+	size_t fenceLen = 0;
+	bool afterBlank = false;
+	size_t lineStart = from;
+	size_t lineEnd;
+
+	while ( ( lineEnd = markdown.find( '\n', lineStart ) ) != std::string_view::npos ) {
+		std::string_view line = markdown.substr( lineStart, lineEnd - lineStart );
+		size_t indent = lineIndentation( line );
+		char curFenceChar = 0;
+
+		if ( inFence ) {
+			size_t len = indent < 4 ? fenceLength( line, curFenceChar ) : 0;
+			if ( len >= fenceLen && curFenceChar == fenceChar &&
+				 isBlankLine( line.substr( line.find( fenceChar ) + len ) ) ) {
+				inFence = false;
+				if ( topLevelFence && indent == 0 )
+					openBlockStart = lineEnd + 1;
+			}
+		} else if ( isBlankLine( line ) ) {
+			afterBlank = true;
+		} else {
+			if ( afterBlank && indent == 0 )
+				openBlockStart = lineStart;
+			afterBlank = false;
+
+			if ( indent < 4 && ( fenceLen = fenceLength( line, fenceChar ) ) > 0 ) {
+				inFence = true;
+				topLevelFence = indent == 0;
+				if ( topLevelFence )
+					openBlockStart = lineStart;
+			} else if ( indent == 0 && isAtxHeading( line ) ) {
+				openBlockStart = lineEnd + 1;
+			}
+		}
+
+		lineStart = lineEnd + 1;
+	}
+
+	return openBlockStart;
+}
+
 UIMarkdownView* UIMarkdownView::New() {
 	return eeNew( UIMarkdownView, () );
 }
@@ -28,9 +116,52 @@ bool UIMarkdownView::isType( const Uint32& type ) const {
 
 void UIMarkdownView::loadFromString( std::string_view markdown ) {
 	closeAllChildren();
+	mMarkdown = markdown;
+	mOpenBlockStart = 0;
+	// The whole document is kept as an open block, so it's parsed as a single document and an
+	// append will split it in blocks
+	mOpenBlockNodes = loadBlocks( markdown );
+}
+
+void UIMarkdownView::appendMarkdown( std::string_view markdown ) {
+	if ( markdown.empty() )
+		return;
+
+	mMarkdown.append( markdown );
+	closeOpenBlockNodes();
+
+	std::string_view document( mMarkdown );
+	size_t openBlockStart = findOpenBlockStart( document, mOpenBlockStart );
+	if ( openBlockStart > mOpenBlockStart ) {
+		loadBlocks( document.substr( mOpenBlockStart, openBlockStart - mOpenBlockStart ) );
+		mOpenBlockStart = openBlockStart;
+	}
+
+	mOpenBlockNodes = loadBlocks( document.substr( mOpenBlockStart ) );
+}
+
+std::vector<Node*> UIMarkdownView::loadBlocks( std::string_view markdown ) {
+	std::vector<Node*> nodes;
 	auto xhtml = Markdown::toXHTML( markdown );
 	// printf( "%s", xhtml.c_str() );
+	if ( xhtml.empty() )
+		return nodes;
+	Node* lastChild = getLastChild();
 	getUISceneNode()->loadLayoutFromString( xhtml, this );
+	for ( Node* child = lastChild ? lastChild->getNextNode() : getFirstChild(); child != nullptr;
+		  child = child->getNextNode() )
+		nodes.push_back( child );
+	return nodes;
+}
+
+void UIMarkdownView::closeOpenBlockNodes() {
+	// Only compare the pointers, the nodes could have been removed by someone else
+	for ( Node* child = getFirstChild(); child != nullptr; child = child->getNextNode() ) {
+		if ( std::find( mOpenBlockNodes.begin(), mOpenBlockNodes.end(), child ) !=
+			 mOpenBlockNodes.end() )
+			child->close();
+	}
+	mOpenBlockNodes.clear();
 }
 
 void UIMarkdownView::loadFromXmlNode( const pugi::xml_node& node ) {
@@ -2,13 +2,16 @@
 #include <eepp/core/string.hpp>
 #include <eepp/graphics/fontmanager.hpp>
 #include <eepp/graphics/fonttruetype.hpp>
+#include <eepp/graphics/primitives.hpp>
 #include <eepp/graphics/text.hpp>
+#include <eepp/graphics/textureasyncloader.hpp>
 #include <eepp/network/http.hpp>
 #include <eepp/network/uri.hpp>
 #include <eepp/scene/scenemanager.hpp>
 #include <eepp/system/filesystem.hpp>
 #include <eepp/system/functionstring.hpp>
 #include <eepp/system/packmanager.hpp>
+#include <eepp/system/profiler.hpp>
 #include <eepp/system/regex.hpp>
 #include <eepp/system/virtualfilesystem.hpp>
 #include <eepp/ui/css/mediaquery.hpp>
@@ -16,6 +19,7 @@
 #include <eepp/ui/uieventdispatcher.hpp>
 #include <eepp/ui/uiiconthememanager.hpp>
 #include <eepp/ui/uilayout.hpp>
+#include <eepp/ui/uilayouttemplate.hpp>
 #include <eepp/ui/uiroot.hpp>
 #include <eepp/ui/uiscenenode.hpp>
 #include <eepp/ui/uistyle.hpp>
@@ -68,6 +72,7 @@ UISceneNode::UISceneNode( EE::Window::Window* window ) :
 }
 
 UISceneNode::~UISceneNode() {
+	eeSAFE_DELETE( mProfilerOverlayText );
 	eeSAFE_DELETE( mUIThemeManager );
 	eeSAFE_DELETE( mUIIconThemeManager );
 
@@ -488,6 +493,9 @@ std::shared_ptr<ThreadPool> UISceneNode::getThreadPool() {
 
 void UISceneNode::setThreadPool( const std::shared_ptr<ThreadPool>& threadPool ) {
 	mThreadPool = threadPool;
+	// Decode the asynchronously loaded textures in the shared thread pool
+	if ( mThreadPool && !TextureAsyncLoader::instance()->hasThreadPool() )
+		TextureAsyncLoader::instance()->setThreadPool( mThreadPool );
 }
 
 static std::string getErrorContext( size_t offset, std::string_view content ) {
@@ -558,6 +566,62 @@ UIWidget* UISceneNode::loadLayoutFromString( const char* layoutString, Node* par
 	return NULL;
 }
 
+std::shared_ptr<UILayoutTemplate>
+UISceneNode::compileLayoutFromString( const std::string& layoutString ) {
+	RegEx voidTagsRegex( VOIDTAG_REGEX );
+
+	auto doc = std::make_unique<pugi::xml_document>();
+	pugi::xml_parse_result result;
+	std::string fixedLayout;
+	bool needsReplacements = voidTagsRegex.matches( layoutString );
+
+	if ( needsReplacements ) {
+		fixedLayout = voidTagsRegex.gsub( layoutString, "%1 />" );
+		result =
+			doc->load_string( fixedLayout.c_str(), pugi::parse_default | pugi::parse_ws_pcdata );
+	} else {
+		result =
+			doc->load_string( layoutString.c_str(), pugi::parse_default | pugi::parse_ws_pcdata );
+	}
+
+	if ( !result ) {
+		Log::error( "Couldn't compile UI Layout from string: %s",
+					needsReplacements ? fixedLayout.c_str() : layoutString.c_str() );
+		Log::error( "Error description: %s", result.description() );
+		Log::error( "Error offset: %d", result.offset );
+		Log::error( "Error context: %s", getErrorContext( result.offset, layoutString ) );
+		return nullptr;
+	}
+
+	return std::make_shared<UILayoutTemplate>( std::move( doc ) );
+}
+
+std::shared_ptr<UILayoutTemplate>
+UISceneNode::compileLayoutFromFile( const std::string& layoutPath ) {
+	std::string data;
+
+	if ( !FileSystem::fileGet( layoutPath, data ) ) {
+		Log::error( "Couldn't compile UI Layout: %s", layoutPath.c_str() );
+		return nullptr;
+	}
+
+	return compileLayoutFromString( data );
+}
+
+UIWidget* UISceneNode::loadLayoutFromTemplate( const UILayoutTemplate& layoutTemplate,
+											   Node* parent, const Uint32& marker ) {
+	pugi::xml_node node = layoutTemplate.getFirstNode();
+
+	if ( !node )
+		return NULL;
+
+	const UILayoutTemplate* prevLayoutTemplate = mLayoutTemplate;
+	mLayoutTemplate = &layoutTemplate;
+	UIWidget* widget = loadLayoutNodes( node, NULL != parent ? parent : this, marker );
+	mLayoutTemplate = prevLayoutTemplate;
+	return widget;
+}
+
 UIWidget* UISceneNode::loadLayoutFromString( const std::string& layoutString, Node* parent,
 											 const Uint32& marker ) {
 	return loadLayoutFromString( layoutString.c_str(), parent, marker );
@@ -704,6 +768,7 @@ UISceneNode* UISceneNode::setPixelsSize( const Float& x, const Float& y ) {
 }
 
 void UISceneNode::update( const Time& elapsed ) {
+	EE_PROFILE_ZONE( "UISceneNode::update" );
 	UISceneNode* uiSceneNode = SceneManager::instance()->getUISceneNode();
 
 	if ( mFirstUpdate && mVerbose ) {
@@ -756,6 +821,90 @@ void UISceneNode::update( const Time& elapsed ) {
 		Log::debug( "UISceneNode::update first update took: %.2f ms",
 					mClock.getElapsedTime().asMilliseconds() );
 	}
+
+	if ( NULL != mProfilerOverlayText &&
+		 mProfilerOverlayClock.getElapsedTime() >= Milliseconds( 250 ) ) {
+		mProfilerOverlayClock.restart();
+		updateProfilerOverlay();
+	}
+}
+
+Time UISceneNode::getNextUpdateTimeout( const Time& pollTimeout ) {
+	Time timeout = SceneNode::getNextUpdateTimeout( pollTimeout );
+
+	if ( !mDirtyStyle.empty() || !mDirtyStyleState.empty() || !mDirtyLayouts.empty() )
+		timeout = eemin( timeout, pollTimeout );
+
+	if ( NULL != mProfilerOverlayText ) {
+		Time elapsed = mProfilerOverlayClock.getElapsedTime();
+		timeout = eemin( timeout, elapsed < Milliseconds( 250 ) ? Milliseconds( 250 ) - elapsed
+																: Time::Zero );
+	}
+
+	return timeout;
+}
+
+void UISceneNode::setProfilerOverlayVisible( bool visible ) {
+	if ( visible == isProfilerOverlayVisible() )
+		return;
+
+	if ( visible ) {
+		Font* font = FontManager::instance()->getByName( "monospace" );
+
+		if ( NULL == font )
+			font = getUIThemeManager()->getDefaultFont();
+
+		if ( NULL == font )
+			return;
+
+		Profiler::setEnabled( true );
+		mProfilerOverlayText = Text::New( font, PixelDensity::dpToPx( 11 ) );
+		mProfilerOverlayText->setFillColor( Color::White );
+		mProfilerOverlayClock.restart();
+		updateProfilerOverlay();
+	} else {
+		eeSAFE_DELETE( mProfilerOverlayText );
+		invalidateDraw();
+	}
+}
+
+bool UISceneNode::isProfilerOverlayVisible() const {
+	return NULL != mProfilerOverlayText;
+}
+
+void UISceneNode::updateProfilerOverlay() {
+	Profiler* profiler = Profiler::instance();
+	Time frameTime( profiler->getLastFrameTime() );
+	String text( String::format( "Frame: %.2f ms (%u FPS)", frameTime.asMilliseconds(),
+								 mWindow->getFPS() ) );
+
+	for ( const auto& stat : profiler->getLastFrameStats() ) {
+		text += String::format( "\n%s%s: %.2f ms", std::string( stat.depth * 2, ' ' ).c_str(),
+								stat.name, stat.time.asMilliseconds() );
+		if ( stat.calls > 1 )
+			text += String::format( " (x%u)", stat.calls );
+	}
+
+	mProfilerOverlayText->setString( text );
+
+	// Keep drawing frames while the overlay is visible to have fresh statistics
+	invalidateDraw();
+}
+
+void UISceneNode::postDraw() {
+	if ( NULL == mProfilerOverlayText )
+		return;
+
+	Float padding = PixelDensity::dpToPx( 4 );
+	Sizef size( mProfilerOverlayText->getTextWidth() + padding * 2,
+				mProfilerOverlayText->getTextHeight() + padding * 2 );
+	Vector2f pos( mScreenPos.x + mSize.getWidth() - size.getWidth(), mScreenPos.y );
+
+	Primitives P;
+	P.setColor( Color( 0, 0, 0, 200 ) );
+	P.drawRectangle( Rectf( pos, size ) );
+
+	mProfilerOverlayText->draw( pos.x + padding, pos.y + padding );
 }
 
 void UISceneNode::onWidgetDelete( Node* node ) {
@@ -940,6 +1089,7 @@ void UISceneNode::setIsLoading( bool isLoading ) {
 
 void UISceneNode::updateDirtyLayouts() {
 	if ( !mDirtyLayouts.empty() ) {
+		EE_PROFILE_ZONE( "UISceneNode::updateDirtyLayouts" );
 		Clock clock;
 		mUpdatingLayouts = true;
 
@@ -957,6 +1107,7 @@ void UISceneNode::updateDirtyLayouts() {
 
 void UISceneNode::updateDirtyStyles() {
 	if ( !mDirtyStyle.empty() ) {
+		EE_PROFILE_ZONE( "UISceneNode::updateDirtyStyles" );
 		Clock clock;
 		for ( auto& node : mDirtyStyle ) {
 			node->reloadStyle( true, false, false );
@@ -970,6 +1121,7 @@ void UISceneNode::updateDirtyStyles() {
 
 void UISceneNode::updateDirtyStyleStates() {
 	if ( !mDirtyStyleState.empty() ) {
+		EE_PROFILE_ZONE( "UISceneNode::updateDirtyStyleStates" );
 		Clock clock;
 		for ( auto& node : mDirtyStyleState ) {
 			node->reportStyleStateChangeRecursive( mDirtyStyleStateCSSAnimations[node] );
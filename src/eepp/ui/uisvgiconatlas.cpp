@@ -0,0 +1,367 @@
+#include <eepp/graphics/image.hpp>
+#include <eepp/graphics/texturefactory.hpp>
+#include <eepp/graphics/texturepacker.hpp>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/log.hpp>
+#include <eepp/ui/uiicon.hpp>
+#include <eepp/ui/uisvgiconatlas.hpp>
+#include <thirdparty/nanosvg/nanosvg.h>
+#include <thirdparty/nanosvg/nanosvgrast.h>
+
+namespace EE { namespace UI {
+
+static std::string regionName( const std::string& iconName, const int& size ) {
+	return iconName + "@" + String::toString( size );
+}
+
+UISVGIconAtlas* UISVGIconAtlas::New( const std::string& name,
+									 std::shared_ptr<ThreadPool> threadPool,
+									 const std::string& cacheDirectory ) {
+	return eeNew( UISVGIconAtlas, ( name, threadPool, cacheDirectory ) );
+}
+
+UISVGIconAtlas::UISVGIconAtlas( const std::string& name, std::shared_ptr<ThreadPool> threadPool,
+								const std::string& cacheDirectory ) :
+	mName( name ), mThreadPool( threadPool ) {
+	setCacheDirectory( cacheDirectory );
+}
+
+UISVGIconAtlas::~UISVGIconAtlas() {
+	for ( auto& entry : mEntries ) {
+		entry.first->setAtlas( nullptr );
+		if ( entry.second.image )
+			nsvgDelete( entry.second.image );
+	}
+
+	for ( auto region : mRegions )
+		eeDelete( region );
+
+	if ( TextureFactory::existsSingleton() ) {
+		for ( auto page : mPages )
+			TextureFactory::instance()->remove( page );
+	}
+}
+
+const std::string& UISVGIconAtlas::getName() const {
+	return mName;
+}
+
+void UISVGIconAtlas::add( UISVGIcon* icon ) {
+	if ( mEntries.find( icon ) != mEntries.end() )
+		return;
+	mEntries[icon] = Entry();
+	mThemeHash = 0;
+	icon->setAtlas( this );
+}
+
+void UISVGIconAtlas::remove( UISVGIcon* icon ) {
+	auto it = mEntries.find( icon );
+	if ( it == mEntries.end() )
+		return;
+	if ( it->second.image )
+		nsvgDelete( it->second.image );
+	mEntries.erase( it );
+	mThemeHash = 0;
+	icon->setAtlas( nullptr );
+}
+
+TextureRegion* UISVGIconAtlas::getRegion( UISVGIcon* icon, const int& size ) {
+	auto it = mEntries.find( icon );
+	if ( it == mEntries.end() || size <= 0 )
+		return nullptr;
+
+	auto rit = it->second.regions.find( size );
+	if ( rit != it->second.regions.end() )
+		return rit->second;
+
+	build( { size } );
+
+	rit = it->second.regions.find( size );
+	return rit != it->second.regions.end() ? rit->second : nullptr;
+}
+
+void UISVGIconAtlas::build( const std::vector<int>& sizes ) {
+	std::vector<std::pair<UISVGIcon*, Entry*>> unparsed;
+	for ( auto& entry : mEntries ) {
+		if ( !entry.second.parsed )
+			unparsed.emplace_back( entry.first, &entry.second );
+	}
+
+	// Each SVG is parsed only once, the parsed image is kept for the next sizes requested.
+	auto parse = [&unparsed]( size_t index ) {
+		std::string svgXml( unparsed[index].first->getSVGXml() );
+		unparsed[index].second->image = nsvgParse( &svgXml[0], "px", 96.0f, 0xFFFFFFFF );
+		unparsed[index].second->parsed = true;
+	};
+
+	if ( mThreadPool ) {
+		mThreadPool->parallelFor( unparsed.size(), parse );
+	} else {
+		for ( size_t i = 0; i < unparsed.size(); ++i )
+			parse( i );
+	}
+
+	for ( const auto& size : sizes ) {
+		std::vector<UISVGIcon*> icons;
+		for ( auto& entry : mEntries ) {
+			if ( entry.second.image && entry.second.image->width > 0 &&
+				 entry.second.image->height > 0 &&
+				 entry.second.regions.find( size ) == entry.second.regions.end() )
+				icons.push_back( entry.first );
+		}
+		if ( !icons.empty() )
+			buildSize( size, std::move( icons ) );
+	}
+}
+
+void UISVGIconAtlas::buildSize( const int& size, std::vector<UISVGIcon*>&& icons ) {
+	// Only a full build can be persisted, partial builds ( icons added after the size was
+	// rasterized ) are always rasterized.
+	bool isFullBuild = icons.size() == mEntries.size();
+
+	if ( isFullBuild && loadFromCache( size, icons ) )
+		return;
+
+	std::vector<NSVGimage*> svgs;
+	svgs.reserve( icons.size() );
+	for ( auto icon : icons )
+		svgs.push_back( mEntries[icon].image );
+
+	std::vector<Image*> images( icons.size(), nullptr );
+
+	auto rasterize = [&svgs, &images, size]( size_t index ) {
+		NSVGimage* svg = svgs[index];
+		Float scale = size / (Float)eemax( svg->width, svg->height );
+		int w = eemax( 1, (int)( svg->width * scale ) );
+		int h = eemax( 1, (int)( svg->height * scale ) );
+		NSVGrasterizer* rast = nsvgCreateRasterizer();
+		if ( rast == nullptr )
+			return;
+		Image* image = Image::New( w, h, 4 );
+		nsvgRasterize( rast, svg, 0, 0, scale, image->getPixels(), w, h, w * 4 );
+		nsvgDeleteRasterizer( rast );
+		images[index] = image;
+	};
+
+	if ( mThreadPool ) {
+		mThreadPool->parallelFor( icons.size(), rasterize );
+	} else {
+		for ( size_t i = 0; i < icons.size(); ++i )
+			rasterize( i );
+	}
+
+	UnorderedMap<std::string, UISVGIcon*> iconsByRegionName;
+	TexturePacker packer( mMaxPageSize, mMaxPageSize, 1, true, false, 1, Texture::Filter::Linear,
+						  true );
+
+	for ( size_t i = 0; i < icons.size(); ++i ) {
+		if ( images[i] == nullptr )
+			continue;
+		std::string name( regionName( icons[i]->getName(), size ) );
+		iconsByRegionName[name] = icons[i];
+		packer.addImage( images[i], name );
+	}
+
+	std::string index;
+	size_t pageNum = 0;
+
+	if ( packer.packTextures() > 0 ) {
+		for ( TexturePacker* page = &packer; page != nullptr; page = page->getChild() ) {
+			Image* pageImage = page->generateImage();
+			if ( pageImage == nullptr )
+				break;
+
+			Texture* texture = TextureFactory::instance()->loadFromPixels(
+				pageImage->getPixelsPtr(), pageImage->getWidth(), pageImage->getHeight(),
+				pageImage->getChannels(), false, Texture::ClampMode::ClampToEdge, false, false,
+				regionName( mName, size ) + "-" + String::toString( (Uint64)pageNum ) );
+
+			if ( texture != nullptr ) {
+				mPages.push_back( texture );
+
+				page->forEachPlaced(
+					[&]( const std::string& name, const Rect& rect, bool ) {
+						auto it = iconsByRegionName.find( name );
+						if ( it == iconsByRegionName.end() )
+							return;
+						addRegion( texture, rect, it->second, size );
+						index += String::format( "%zu %d %d %d %d %s\n", pageNum, rect.Left,
+												 rect.Top, rect.getWidth(), rect.getHeight(),
+												 it->second->getName().c_str() );
+					} );
+
+				if ( isFullBuild && !mCacheDirectory.empty() )
+					pageImage->saveToFile( getCachePath( size, pageNum, "png" ),
+										   Image::SaveType::PNG );
+			}
+
+			eeDelete( pageImage );
+			pageNum++;
+		}
+	} else {
+		Log::warning( "UISVGIconAtlas: %s failed to pack icons of size %d", mName.c_str(), size );
+	}
+
+	if ( isFullBuild && !mCacheDirectory.empty() && pageNum > 0 )
+		FileSystem::fileWrite( getCachePath( size, 0, "idx" ), index );
+
+	for ( auto image : images )
+		eeSAFE_DELETE( image );
+}
+
+std::string UISVGIconAtlas::getCachePath( const int& size, const size_t& page,
+										  const std::string& extension ) const {
+	std::string path( mCacheDirectory + mName + "-" + String::toString( getThemeHash() ) + "-" +
+					  String::toString( size ) );
+	if ( extension != "idx" )
+		path += "-" + String::toString( (Uint64)page );
+	return path + "." + extension;
+}
+
+bool UISVGIconAtlas::loadFromCache( const int& size, const std::vector<UISVGIcon*>& icons ) {
+	if ( mCacheDirectory.empty() )
+		return false;
+
+	std::string index;
+	if ( !FileSystem::fileGet( getCachePath( size, 0, "idx" ), index ) )
+		return false;
+
+	UnorderedMap<std::string, UISVGIcon*> iconsByName;
+	for ( auto icon : icons )
+		iconsByName[icon->getName()] = icon;
+
+	struct CachedRegion {
+		size_t page;
+		Rect rect;
+		UISVGIcon* icon;
+	};
+	std::vector<CachedRegion> cachedRegions;
+	size_t pageCount = 0;
+
+	auto lines = String::split( index, '\n' );
+	for ( const auto& line : lines ) {
+		size_t page;
+		int x, y, w, h, nameStart = 0;
+		if ( sscanf( line.c_str(), "%zu %d %d %d %d %n", &page, &x, &y, &w, &h, &nameStart ) <
+				 5 ||
+			 nameStart <= 0 )
+			return false;
+		auto it = iconsByName.find( line.substr( nameStart ) );
+		if ( it == iconsByName.end() )
+			return false;
+		cachedRegions.push_back( { page, Rect( x, y, x + w, y + h ), it->second } );
+		pageCount = eemax( pageCount, page + 1 );
+	}
+
+	if ( cachedRegions.size() != icons.size() )
+		return false;
+
+	std::vector<Image*> pageImages( pageCount, nullptr );
+	auto load = [this, &pageImages, size]( size_t page ) {
+		Image* image = Image::New( getCachePath( size, page, "png" ), 4 );
+		if ( image->getPixelsPtr() == nullptr ) {
+			eeDelete( image );
+			return;
+		}
+		pageImages[page] = image;
+	};
+
+	if ( mThreadPool ) {
+		mThreadPool->parallelFor( pageCount, load );
+	} else {
+		for ( size_t i = 0; i < pageCount; ++i )
+			load( i );
+	}
+
+	bool valid = std::all_of( pageImages.begin(), pageImages.end(),
+							  []( Image* image ) { return image != nullptr; } );
+
+	if ( valid ) {
+		std::vector<Texture*> textures;
+		for ( size_t page = 0; page < pageCount; ++page ) {
+			Image* image = pageImages[page];
+			Texture* texture = TextureFactory::instance()->loadFromPixels(
+				image->getPixelsPtr(), image->getWidth(), image->getHeight(),
+				image->getChannels(), false, Texture::ClampMode::ClampToEdge, false, false,
+				regionName( mName, size ) + "-" + String::toString( (Uint64)page ) );
+			mPages.push_back( texture );
+			textures.push_back( texture );
+		}
+
+		for ( const auto& cached : cachedRegions ) {
+			if ( textures[cached.page] )
+				addRegion( textures[cached.page], cached.rect, cached.icon, size );
+		}
+	}
+
+	for ( auto image : pageImages )
+		eeSAFE_DELETE( image );
+
+	return valid;
+}
+
+TextureRegion* UISVGIconAtlas::addRegion( Texture* texture, const Rect& rect, UISVGIcon* icon,
+										  const int& size ) {
+	TextureRegion* region =
+		TextureRegion::New( texture, rect, regionName( icon->getName(), size ) );
+	mRegions.push_back( region );
+	mEntries[icon].regions[size] = region;
+	return region;
+}
+
+const std::shared_ptr<ThreadPool>& UISVGIconAtlas::getThreadPool() const {
+	return mThreadPool;
+}
+
+void UISVGIconAtlas::setThreadPool( const std::shared_ptr<ThreadPool>& threadPool ) {
+	mThreadPool = threadPool;
+}
+
+const std::string& UISVGIconAtlas::getCacheDirectory() const {
+	return mCacheDirectory;
+}
+
+void UISVGIconAtlas::setCacheDirectory( const std::string& cacheDirectory ) {
+	mCacheDirectory = cacheDirectory;
+
+	if ( mCacheDirectory.empty() )
+		return;
+
+	FileSystem::dirAddSlashAtEnd( mCacheDirectory );
+
+	if ( !FileSystem::fileExists( mCacheDirectory ) &&
+		 !FileSystem::makeDir( mCacheDirectory, true ) ) {
+		Log::warning( "UISVGIconAtlas: couldn't create the cache directory %s",
+					  mCacheDirectory.c_str() );
+		mCacheDirectory.clear();
+	}
+}
+
+void UISVGIconAtlas::setMaxPageSize( const Uint32& maxPageSize ) {
+	mMaxPageSize = maxPageSize;
+}
+
+const Uint32& UISVGIconAtlas::getMaxPageSize() const {
+	return mMaxPageSize;
+}
+
+Uint64 UISVGIconAtlas::getThemeHash() const {
+	if ( mThemeHash != 0 )
+		return mThemeHash;
+
+	// The hash must not depend on the container iteration order
+	std::vector<std::pair<std::string, String::HashType>> icons;
+	icons.reserve( mEntries.size() );
+	for ( const auto& entry : mEntries )
+		icons.emplace_back( entry.first->getName(), String::hash( entry.first->getSVGXml() ) );
+	std::sort( icons.begin(), icons.end() );
+
+	size_t hash = String::hash( mName );
+	for ( const auto& icon : icons )
+		hash = hashCombine( hash, String::hash( icon.first ), icon.second );
+
+	mThemeHash = hash == 0 ? 1 : hash;
+	return mThemeHash;
+}
+
+}} // namespace EE::UI
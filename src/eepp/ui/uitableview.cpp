@@ -4,6 +4,7 @@
 #include <eepp/ui/uiscenenode.hpp>
 #include <eepp/ui/uiscrollbar.hpp>
 #include <eepp/ui/uitableview.hpp>
+#include <eepp/window/input.hpp>
 
 #include <cmath>
 
@@ -41,6 +42,7 @@ void UITableView::drawChildren() {
 		Float xOffset;
 		auto colCount = getModel()->columnCount();
 		auto headerHeight = getHeaderHeight();
+		prefetchVisibleDisplayData( start, end );
 		for ( size_t i = start; i < end; i++ ) {
 			xOffset = 0;
 			yOffset = headerHeight + i * rowHeight;
@@ -52,6 +54,7 @@ void UITableView::drawChildren() {
 			UITableRow* rowNode = updateRow( realRowIndex, rowIndex, yOffset );
 			rowNode->setChildrenVisibility( false, false );
 			realColIndex = 0;
+			mTextColumnsToDraw.clear();
 			for ( size_t colIndex = 0; colIndex < colCount; colIndex++ ) {
 				auto& colData = columnData( colIndex );
 				if ( !colData.visible || ( xOffset + colData.width ) - mScrollOffset.x < 0 ) {
@@ -62,18 +65,33 @@ void UITableView::drawChildren() {
 				if ( xOffset - mScrollOffset.x > mSize.getWidth() )
 					break;
 				xOffset += colData.width;
+				if ( isColumnTextOnly( colIndex ) ) {
+					mTextColumnsToDraw.push_back( colIndex );
+					continue;
+				}
 				updateCell( { realColIndex, realRowIndex },
 							getModel()->index( rowIndex.row(), colIndex, rowIndex.parent() ), 0,
 							yOffset );
 				realColIndex++;
 			}
 			rowNode->nodeDraw();
+			if ( !mTextColumnsToDraw.empty() && rowNode->isVisible() ) {
+				bool rowSelected = isRowSelection() && getSelection().contains( rowIndex );
+				for ( const auto& colIndex : mTextColumnsToDraw ) {
+					ModelIndex index(
+						getModel()->index( rowIndex.row(), colIndex, rowIndex.parent() ) );
+					drawTextCell( rowNode, realRowIndex, index,
+								  rowSelected ||
+									  ( isCellSelection() && getSelection().contains( index ) ) );
+				}
+			}
 			if ( mRowHeaderWidth ) {
 				updateRowHeader( realRowIndex, rowIndex,
 								 realRowIndex == 0 ? fmodf( -mScrollOffset.y, rowHeight ) : 0.f );
 			}
 			realRowIndex++;
 		}
+		releaseDisplayData();
 	}
 	if ( mHeader && mHeader->isVisible() )
 		mHeader->nodeDraw();
@@ -85,6 +103,159 @@ void UITableView::drawChildren() {
 		mVScroll->nodeDraw();
 }
 
+void UITableView::prefetchVisibleDisplayData( size_t startRow, size_t endRow ) {
+	if ( endRow <= startRow )
+		return;
+	size_t colCount = getModel()->columnCount();
+	Int64 firstColumn = -1;
+	Int64 lastColumn = -1;
+	Float xOffset = 0;
+	for ( size_t colIndex = 0; colIndex < colCount; colIndex++ ) {
+		const auto& colData = columnData( colIndex );
+		if ( !colData.visible )
+			continue;
+		if ( xOffset - mScrollOffset.x > mSize.getWidth() )
+			break;
+		if ( ( xOffset + colData.width ) - mScrollOffset.x >= 0 ) {
+			if ( firstColumn == -1 )
+				firstColumn = colIndex;
+			lastColumn = colIndex;
+		}
+		xOffset += colData.width;
+	}
+	if ( firstColumn != -1 ) {
+		prefetchDisplayData( {}, startRow, endRow - startRow, firstColumn,
+							 lastColumn - firstColumn + 1 );
+	}
+}
+
+void UITableView::setColumnTextOnly( const size_t& column, bool textOnly ) {
+	if ( column >= mColumnTextOnly.size() ) {
+		if ( !textOnly )
+			return;
+		mColumnTextOnly.resize( column + 1, false );
+	}
+	if ( mColumnTextOnly[column] != textOnly ) {
+		mColumnTextOnly[column] = textOnly;
+		invalidateDraw();
+	}
+}
+
+bool UITableView::isColumnTextOnly( const size_t& column ) const {
+	return column < mColumnTextOnly.size() && mColumnTextOnly[column];
+}
+
+UITableCell* UITableView::getTextCellStyle( bool selected ) {
+	UITableCell*& cell = selected ? mTextCellSelectedStyle : mTextCellStyle;
+	if ( nullptr == cell ) {
+		// Never drawn, they only exist to get the cell style matched by the style sheet
+		UITableRow* row = UITableRow::New( mTag + "::row" );
+		row->setParent( this );
+		row->setVisible( false );
+		row->setEnabled( false );
+		cell = UITableCell::New( mTag + "::cell" );
+		cell->setParent( row );
+		if ( selected ) {
+			row->pushState( UIState::StateSelected );
+			cell->pushState( UIState::StateSelected );
+		}
+		row->reloadStyle( true, true, true );
+	}
+	return cell;
+}
+
+void UITableView::drawTextCell( UITableRow* rowNode, const int& realRowIndex,
+								const ModelIndex& index, bool selected ) {
+	Variant storage;
+	const Variant& data = getDisplayData( index, storage );
+	if ( !data.isValid() )
+		return;
+
+	if ( realRowIndex >= (int)mTextCells.size() )
+		mTextCells.resize( realRowIndex + 1 );
+	auto& text = mTextCells[realRowIndex][index.column()];
+	if ( !text )
+		text = std::make_unique<Text>();
+
+	if ( data.is( Variant::Type::String ) )
+		text->setString( data.asString() );
+	else if ( data.is( Variant::Type::StringPtr ) )
+		text->setString( data.asStringPtr() );
+	else
+		text->setString( String( data.toString() ) );
+
+	if ( text->getString().empty() )
+		return;
+
+	UITableCell* style = getTextCellStyle( selected );
+	text->setStyleConfig( style->getTextView()->getFontStyleConfig() );
+
+	const Rectf& padding = style->getPixelsPadding();
+	Float rowHeight = getRowHeight();
+	Float width = columnData( index.column() ).width - padding.Left - padding.Right;
+	if ( width <= 0 )
+		return;
+
+	Vector2f pos( rowNode->getScreenPos() );
+	pos.x += getColumnPosition( index.column() ).x + padding.Left;
+
+	clipSmartEnable( pos.x, pos.y, width, rowHeight );
+	text->draw( eefloor( pos.x ), eefloor( pos.y + ( rowHeight - text->getTextHeight() ) * 0.5f ),
+				Vector2f::One, 0.f, getBlendMode() );
+	clipSmartDisable();
+}
+
+ModelIndex UITableView::getTextCellIndexAt( UITableRow* row, const Vector2f& position ) {
+	if ( !getModel() )
+		return {};
+	size_t colCount = getModel()->columnCount();
+	for ( size_t colIndex = 0; colIndex < colCount; colIndex++ ) {
+		const auto& colData = columnData( colIndex );
+		Float x = getColumnPosition( colIndex ).x;
+		if ( colData.visible && isColumnTextOnly( colIndex ) && position.x >= x &&
+			 position.x < x + colData.width ) {
+			const ModelIndex& rowIndex = row->getCurIndex();
+			return getModel()->index( rowIndex.row(), colIndex, rowIndex.parent() );
+		}
+	}
+	return {};
+}
+
+void UITableView::onRowCreated( UITableRow* row ) {
+	UIAbstractTableView::onRowCreated( row );
+	row->on( Event::MouseClick, [this]( const Event* event ) { onTextCellMouseEvent( event ); } );
+	row->on( Event::MouseDoubleClick,
+			 [this]( const Event* event ) { onTextCellMouseEvent( event ); } );
+}
+
+void UITableView::onTextCellMouseEvent( const Event* event ) {
+	UITableRow* row = event->getNode()->asType<UITableRow>();
+	// Clicks over cell widgets are handled by the cells, only the clicks over the row itself can
+	// belong to a text only cell
+	if ( mColumnTextOnly.empty() || getEventDispatcher()->getMouseDownNode() != row )
+		return;
+	auto mouseEvent = event->asMouseEvent();
+	ModelIndex index(
+		getTextCellIndexAt( row, row->convertToNodeSpace( mouseEvent->getPosition().asFloat() ) ) );
+	if ( !index.isValid() )
+		return;
+	ModelIndex rowIndex( row->getCurIndex() );
+	if ( event->getType() == Event::MouseDoubleClick ) {
+		if ( ( mouseEvent->getFlags() & EE_BUTTON_LMASK ) && !mSingleClickNavigation )
+			onOpenModelIndex( rowIndex, event );
+	} else if ( mouseEvent->getFlags() & EE_BUTTON_RMASK ) {
+		onOpenMenuModelIndex( rowIndex, event );
+	} else if ( ( mouseEvent->getFlags() & EE_BUTTON_LMASK ) && mSingleClickNavigation ) {
+		onOpenModelIndex( rowIndex, event );
+	} else if ( isCellSelection() && ( mouseEvent->getFlags() & EE_BUTTON_LMASK ) ) {
+		if ( getInput()->isControlPressed() ) {
+			getSelection().remove( index );
+		} else {
+			getSelection().set( index );
+		}
+	}
+}
+
 Node* UITableView::overFind( const Vector2f& point ) {
 	ScopedOp op( [this] { mUISceneNode->setIsLoading( true ); },
 				 [this] { mUISceneNode->setIsLoading( false ); } );
@@ -103,6 +103,17 @@ void UITextInput::scheduledUpdate( const Time& time ) {
 	}
 }
 
+Time UITextInput::getScheduledUpdateTimeout( const Time& pollTimeout ) {
+	if ( mMouseDown )
+		return pollTimeout;
+
+	// The waiting cursor blink accumulates the elapsed frame times, so it's polled
+	if ( mVisible && hasFocus() )
+		return eemin( pollTimeout, Milliseconds( eemax( 0.f, 500.f - mWaitCursorTime ) ) );
+
+	return Time::Infinity;
+}
+
 void UITextInput::onCursorPosChange() {
 	sendCommonEvent( Event::OnCursorPosChange );
 	updateIMELocation();
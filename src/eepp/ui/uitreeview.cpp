@@ -254,15 +254,7 @@ UIWidget* UITreeView::createCell( UIWidget* rowWidget, const ModelIndex& index )
 
 UIWidget* UITreeView::updateCell( const Vector2<Int64>& posIndex, const ModelIndex& index,
 								  const size_t& indentLevel, const Float& yOffset ) {
-	if ( posIndex.y >= (int)mWidgets.size() )
-		mWidgets.resize( posIndex.y + 1 );
-	auto* widget = mWidgets[posIndex.y][index.column()];
-	if ( !widget ) {
-		UIWidget* rowWidget = updateRow( posIndex.y, index, yOffset );
-		widget = createCell( rowWidget, index );
-		mWidgets[posIndex.y][index.column()] = widget;
-		widget->reloadStyle( true, true, true );
-	}
+	auto* widget = acquireCell( { index.column(), posIndex.y }, index, yOffset );
 	if ( !index.isValid() )
 		return widget;
 	const auto& colData = columnData( index.column() );
@@ -9,6 +9,7 @@
 #include <eepp/ui/css/transitiondefinition.hpp>
 #include <eepp/ui/uiborderdrawable.hpp>
 #include <eepp/ui/uieventdispatcher.hpp>
+#include <eepp/ui/uilayouttemplate.hpp>
 #include <eepp/ui/uinodedrawable.hpp>
 #include <eepp/ui/uiscenenode.hpp>
 #include <eepp/ui/uistyle.hpp>
@@ -2381,6 +2382,22 @@ bool UIWidget::applyProperty( const StyleSheetProperty& attribute ) {
 void UIWidget::loadFromXmlNode( const pugi::xml_node& node ) {
 	beginAttributesTransaction();
 
+	const UILayoutTemplate* layoutTemplate =
+		getUISceneNode() ? getUISceneNode()->getLoadingLayoutTemplate() : nullptr;
+	const std::vector<StyleSheetProperty>* compiledAttributes =
+		layoutTemplate ? layoutTemplate->getAttributes( node ) : nullptr;
+
+	if ( compiledAttributes ) {
+		for ( const auto& property : *compiledAttributes ) {
+			if ( NULL != mStyle )
+				mStyle->setStyleSheetProperty( property );
+			applyProperty( property );
+		}
+
+		endAttributesTransaction();
+		return;
+	}
+
 	for ( pugi::xml_attribute_iterator ait = node.attributes_begin(); ait != node.attributes_end();
 		  ++ait ) {
 		if ( String::iequals( ait->name(), "style" ) ) {
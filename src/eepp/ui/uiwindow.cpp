@@ -1019,6 +1019,11 @@ void UIWindow::scheduledUpdate( const Time& ) {
 	updateResize();
 }
 
+Time UIWindow::getScheduledUpdateTimeout( const Time& pollTimeout ) {
+	// The resize cursor only changes with the mouse events
+	return RESIZE_NONE != mResizeType ? pollTimeout : Time::Infinity;
+}
+
 UIWidget* UIWindow::getContainer() const {
 	return mContainer;
 }
@@ -2,6 +2,7 @@
 
 #ifdef EE_BACKEND_SDL2
 
+#include <eepp/system/profiler.hpp>
 #include <eepp/window/backend/SDL2/cursormanagersdl2.hpp>
 #include <eepp/window/backend/SDL2/inputsdl2.hpp>
 #include <eepp/window/backend/SDL2/joystickmanagersdl2.hpp>
@@ -21,6 +22,7 @@ InputSDL::InputSDL( EE::Window::Window* window ) :
 InputSDL::~InputSDL() {}
 
 void InputSDL::update() {
+	EE_PROFILE_ZONE( "Input::update" );
 	SDL_Event SDLEvent;
 	cleanStates();
 
@@ -51,6 +53,18 @@ void InputSDL::waitEvent( const Time& timeout ) {
 	}
 }
 
+void InputSDL::wakeUp() {
+	// Only one wake-up event is queued at a time
+	if ( mWakeUpEventType == (Uint32)-1 || mWakeUpPending.exchange( true ) )
+		return;
+
+	SDL_Event SDLEvent;
+	SDL_zero( SDLEvent );
+	SDLEvent.type = mWakeUpEventType;
+	if ( SDL_PushEvent( &SDLEvent ) <= 0 )
+		mWakeUpPending = false;
+}
+
 bool InputSDL::grabInput() {
 	return ( SDL_GetWindowGrab( static_cast<WindowSDL*>( mWindow )->getSDLWindow() ) == SDL_TRUE )
 			   ? true
@@ -119,9 +133,15 @@ Scancode InputSDL::getScancodeFromKey( const Keycode& scancode ) const {
 void InputSDL::init() {
 	mDPIScale = mWindow->getScale();
 	mMousePos = queryMousePos();
+	mWakeUpEventType = SDL_RegisterEvents( 1 );
 }
 
 void InputSDL::sendEvent( const SDL_Event& SDLEvent ) {
+	if ( SDLEvent.type == mWakeUpEventType ) {
+		mWakeUpPending = false;
+		return;
+	}
+
 	InputEvent event;
 	switch ( SDLEvent.type ) {
 		case SDL_WINDOWEVENT: {
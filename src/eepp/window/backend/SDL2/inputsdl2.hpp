@@ -6,6 +6,7 @@
 
 #ifdef EE_BACKEND_SDL2
 
+#include <atomic>
 #include <eepp/window/input.hpp>
 
 namespace EE { namespace Window { namespace Backend { namespace SDL2 {
@@ -18,6 +19,8 @@ class EE_API InputSDL : public Input {
 
 	void waitEvent( const Time& timeout = Time::Zero );
 
+	void wakeUp();
+
 	bool grabInput();
 
 	void grabInput( const bool& Grab );
@@ -46,6 +49,8 @@ class EE_API InputSDL : public Input {
 	friend class WindowSDL;
 	Float mDPIScale;
 	std::vector<SDL_Event> mQueuedEvents;
+	Uint32 mWakeUpEventType{ (Uint32)-1 };
+	std::atomic<bool> mWakeUpPending{ false };
 
 	InputSDL( EE::Window::Window* window );
 
@@ -1,3 +1,4 @@
+#include <eepp/system/profiler.hpp>
 #include <eepp/window/backend/SDL3/inputsdl3.hpp>
 #include <eepp/window/backend/SDL3/joystickmanagersdl3.hpp>
 #include <eepp/window/backend/SDL3/windowsdl3.hpp>
@@ -17,6 +18,7 @@ InputSDL::InputSDL( Window* window ) :
 InputSDL::~InputSDL() {}
 
 void InputSDL::update() {
+	EE_PROFILE_ZONE( "Input::update" );
 	SDL_Event SDLEvent;
 	cleanStates();
 
@@ -47,6 +49,18 @@ void InputSDL::waitEvent( const Time& timeout ) {
 	}
 }
 
+void InputSDL::wakeUp() {
+	// Only one wake-up event is queued at a time
+	if ( mWakeUpEventType == (Uint32)-1 || mWakeUpPending.exchange( true ) )
+		return;
+
+	SDL_Event SDLEvent;
+	SDL_zero( SDLEvent );
+	SDLEvent.type = mWakeUpEventType;
+	if ( !SDL_PushEvent( &SDLEvent ) )
+		mWakeUpPending = false;
+}
+
 bool InputSDL::grabInput() {
 	SDL_Window* win = static_cast<WindowSDL*>( mWindow )->getSDLWindow();
 	return SDL_GetWindowMouseGrab( win );
@@ -112,9 +126,17 @@ Scancode InputSDL::getScancodeFromKey( const Keycode& keycode ) const {
 void InputSDL::init() {
 	mDPIScale = mWindow->getScale();
 	mMousePos = queryMousePos();
+	Uint32 wakeUpEventType = SDL_RegisterEvents( 1 );
+	if ( wakeUpEventType != 0 )
+		mWakeUpEventType = wakeUpEventType;
 }
 
 void InputSDL::sendEvent( const SDL_Event& SDLEvent ) {
+	if ( SDLEvent.type == mWakeUpEventType ) {
+		mWakeUpPending = false;
+		return;
+	}
+
 	InputEvent event;
 	event.Type = InputEvent::NoEvent;
 	event.WinID = 0;
@@ -5,6 +5,7 @@
 #include <eepp/graphics/renderer/renderer.hpp>
 #include <eepp/graphics/shaderprogrammanager.hpp>
 #include <eepp/graphics/textlayout.hpp>
+#include <eepp/graphics/textureasyncloader.hpp>
 #include <eepp/graphics/textureatlasmanager.hpp>
 #include <eepp/graphics/texturefactory.hpp>
 #include <eepp/graphics/vertexbuffermanager.hpp>
@@ -88,6 +89,8 @@ Engine::~Engine() {
 
 	TextureAtlasManager::destroySingleton();
 
+	TextureAsyncLoader::destroySingleton();
+
 	TextureFactory::destroySingleton();
 
 	Graphics::Renderer::destroySingleton();
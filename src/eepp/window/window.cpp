@@ -4,6 +4,7 @@
 #include <eepp/graphics/renderer/renderer.hpp>
 #include <eepp/graphics/texturefactory.hpp>
 #include <eepp/system/filesystem.hpp>
+#include <eepp/system/profiler.hpp>
 #include <eepp/version.hpp>
 #include <eepp/window/clipboard.hpp>
 #include <eepp/window/cursormanager.hpp>
@@ -460,9 +461,13 @@ void Window::clear() {
 }
 
 void Window::display( bool clear ) {
-	GlobalBatchRenderer::instance()->draw();
+	{
+		EE_PROFILE_ZONE( "Window::display" );
+
+		GlobalBatchRenderer::instance()->draw();
 
-	swapBuffers();
+		swapBuffers();
+	}
 
 	if ( mCurrentView->isDirty() )
 		setView( *mCurrentView );
@@ -481,6 +486,8 @@ void Window::display( bool clear ) {
 
 	calculateFps();
 
+	EE_PROFILE_FRAME_MARK();
+
 	mFrameData.FPS.RenderClock.restart();
 }
 
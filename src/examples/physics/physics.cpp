@@ -552,6 +552,105 @@ void demo4Destroy() {
 	destroyDemo();
 }
 
+std::shared_ptr<ThreadPool> mPhysicsThreadPool;
+Clock mStepsClock;
+Time mStepsTime;
+int mStepsCount = 0;
+
+void demo5Create() {
+	defaultDrawOptions();
+
+	PhysicsManager::instance()->getDrawOptions()->DrawShapesBorders = false;
+
+	createJointAndBody();
+
+	mWindow->setTitle( "eepp - Physics - Islands Stress Test" );
+
+	Shape::resetShapeIdCounter();
+
+	// Every pile of bodies is an independent island, the islands are solved in parallel.
+	// The space is stepped with a fixed timestep. The debug draw renders the stepped state, only
+	// the sprite shapes are drawn at the interpolated state ( see Body::getRenderPos ).
+	if ( !mPhysicsThreadPool )
+		mPhysicsThreadPool = ThreadPool::createShared( eemax( 1, Sys::getCPUCount() - 1 ) );
+
+	mSpace = Physics::Space::New();
+	mSpace->setGravity( cVectNew( 0, 200 ) );
+	mSpace->setIterations( 10 );
+	mSpace->setThreadPool( mPhysicsThreadPool );
+	mSpace->setFixedTimestep( 1.0 / 120.0 );
+
+	Body* body;
+	Body* staticBody = mSpace->getStaticBody();
+	Shape* shape;
+	Float w = mWindow->getWidth();
+	Float h = mWindow->getHeight();
+
+	shape = mSpace->addShape(
+		ShapeSegment::New( staticBody, cVectNew( 0, h - 4 ), cVectNew( w, h - 4 ), 4.0f ) );
+	shape->setE( 0.0f );
+	shape->setU( 1.0f );
+	shape->setLayers( NOT_GRABABLE_MASK );
+
+	const int piles = 8;
+	const int columns = 8;
+	const int rows = 40;
+	const cpFloat size = 8;
+	Float pileWidth = w / piles;
+
+	for ( int p = 0; p < piles; p++ ) {
+		Float x0 = p * pileWidth + ( pileWidth - columns * ( size + 1 ) ) / 2;
+
+		for ( int y = 0; y < rows; y++ ) {
+			for ( int x = 0; x < columns; x++ ) {
+				cVect pos( cVectNew( x0 + x * ( size + 1 ) + size / 2,
+									 h - 8 - size / 2 - y * ( size + 1 ) ) );
+
+				if ( ( x + y ) % 2 ) {
+					body = mSpace->addBody(
+						Body::New( 1.0f, Moment::forBox( 1.0f, size, size ) ) );
+					body->setPos( pos );
+					shape = mSpace->addShape( ShapePoly::New( body, size, size ) );
+				} else {
+					body = mSpace->addBody( Body::New(
+						1.0f, Moment::forCircle( 1.0f, 0.0f, size / 2, cVectZero ) ) );
+					body->setPos( pos );
+					shape = mSpace->addShape( ShapeCircle::New( body, size / 2, cVectZero ) );
+				}
+
+				shape->setE( 0.0f );
+				shape->setU( 0.7f );
+			}
+		}
+	}
+
+	bodyCount = piles * columns * rows;
+	mStepsClock.restart();
+	mStepsTime = Time::Zero;
+	mStepsCount = 0;
+}
+
+void demo5Update() {
+	if ( mStepsClock.getElapsedTime() < Seconds( 1 ) )
+		return;
+
+	Time elapsed = mStepsClock.getElapsedTime();
+	mStepsClock.restart();
+
+	mWindow->setTitle( String::format(
+		"eepp - Physics - Islands Stress Test - %d bodies - %u threads - %.1f steps/s - "
+		"%.2f ms/step",
+		bodyCount, mPhysicsThreadPool->numThreads(), mStepsCount / elapsed.asSeconds(),
+		mStepsCount ? mStepsTime.asMilliseconds() / mStepsCount : 0.0 ) );
+
+	mStepsTime = Time::Zero;
+	mStepsCount = 0;
+}
+
+void demo5Destroy() {
+	destroyDemo();
+}
+
 void ChangeDemo( int num ) {
 	if ( num >= 0 && num < (int)mDemo.size() && num != mCurDemo ) {
 		if ( (int)eeINDEX_NOT_FOUND != mCurDemo )
@@ -592,6 +691,11 @@ void physicsCreate() {
 	demo.destroy = &demo4Destroy;
 	mDemo.push_back( demo );
 
+	demo.init = &demo5Create;
+	demo.update = &demo5Update;
+	demo.destroy = &demo5Destroy;
+	mDemo.push_back( demo );
+
 	ChangeDemo( 0 );
 }
 
@@ -624,12 +728,17 @@ void physicsUpdate() {
 	}
 
 	mDemo[mCurDemo].update();
-	mSpace->update();
+
+	Clock stepClock;
+	mStepsCount += mSpace->update( mWindow->getElapsed().asSeconds() );
+	mStepsTime += stepClock.getElapsedTime();
+
 	mSpace->draw();
 }
 
 void physicsDestroy() {
 	mDemo[mCurDemo].destroy();
+	mPhysicsThreadPool.reset();
 }
 
 void mainLoop() {
@@ -70,6 +70,8 @@ class EE_MAPS_API GameObject {
 	MapLayer* getLayer() const;
 
   protected:
+	friend class TileMapLayer;
+
 	Uint32 mFlags;
 	MapLayer* mLayer;
 
@@ -81,6 +83,9 @@ class EE_MAPS_API GameObject {
 
 	void assignTilePos();
 
+	/** Notifies the tiled layer that the object must be redrawn */
+	void invalidateTile();
+
 	Float getRotation();
 };
 
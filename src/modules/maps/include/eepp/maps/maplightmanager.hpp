@@ -3,6 +3,9 @@
 
 #include <eepp/maps/base.hpp>
 #include <eepp/maps/maplight.hpp>
+#include <eepp/system/threadpool.hpp>
+#include <memory>
+#include <unordered_map>
 
 namespace EE { namespace Maps {
 
@@ -38,12 +41,66 @@ class EE_MAPS_API MapLightManager {
 
 	MapLight* getLightOver( const Vector2f& OverPos, MapLight* LightCurrent = NULL );
 
+	/** Enables the light accumulation mode.
+	 * In this mode the light colors are kept for the whole map in a contiguous buffer ( one color
+	 * per tile vertex or per tile ), and only the tiles inside the area of the lights that have
+	 * been added, removed or changed ( moved, resized, recolored, etc ) since the last update are
+	 * recomputed. The lights are culled with a spatial grid and the dirty rows are evaluated in
+	 * parallel in a thread pool with SIMD falloff math.
+	 * The falloff used is the one implemented by MapLight, custom lights that override
+	 * MapLight::processVertex must use the default mode. Disabled by default. */
+	void setAccumulationEnabled( const bool& enabled );
+
+	const bool& isAccumulationEnabled() const;
+
+	/** @return The thread pool used by the accumulation mode. If no thread pool was set it will
+	 * create one. */
+	const std::shared_ptr<ThreadPool>& getThreadPool();
+
+	/** Sets the thread pool used by the accumulation mode */
+	void setThreadPool( const std::shared_ptr<ThreadPool>& threadPool );
+
+	/** Forces to recompute the whole map in the next update of the accumulation mode */
+	void invalidate();
+
   protected:
+	/** Light state snapshot used to detect the lights changes and to evaluate them */
+	struct LightData {
+		Float x{ 0 };
+		Float y{ 0 };
+		Float radius{ 0 };
+		Float invRadius{ 0 };
+		/** Vertical distance scale ( isometric lights are half as tall ) */
+		Float yScale{ 1 };
+		Float r{ 0 };
+		Float g{ 0 };
+		Float b{ 0 };
+		bool active{ false };
+		/** Samples affected by the light */
+		Rect samples;
+
+		bool operator==( const LightData& other ) const;
+	};
+
 	TileMap* mMap;
 	Int32 mNumVertex;
 	Color**** mTileColors;
 	LightsList mLights;
 	bool mIsByVertex;
+	bool mAccumulation{ false };
+	bool mFullDirty{ true };
+	/** Number of samples per row and per column ( tile vertices or tiles ) */
+	Sizei mSamplesSize;
+	/** Light colors of every sample, stored row by row */
+	std::vector<Color> mSamples;
+	Color mLastBaseColor;
+	std::unordered_map<MapLight*, LightData> mLightStates;
+	std::vector<LightData> mLightsData;
+	/** Indexes of the lights that affect every cell of the spatial grid */
+	std::vector<std::vector<Uint32>> mGrid;
+	Sizei mGridSize;
+	std::vector<Rect> mDirty;
+	std::shared_ptr<ThreadPool> mThreadPool;
 
 	void allocateColors();
 
@@ -54,6 +111,17 @@ class EE_MAPS_API MapLightManager {
 	virtual void updateByVertex();
 
 	virtual void updateByTile();
+
+	void allocateSamples();
+
+	LightData getLightData( MapLight* Light ) const;
+
+	void addDirty( const Rect& samples );
+
+	void updateAccumulation();
+
+	void accumulateRow( const Int32& y, const Int32& x0, const Int32& x1, std::vector<Float>& r,
+						std::vector<Float>& g, std::vector<Float>& b );
 };
 
 }} // namespace EE::Maps
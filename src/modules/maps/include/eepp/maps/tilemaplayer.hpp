@@ -4,10 +4,20 @@
 #include <eepp/maps/gameobject.hpp>
 #include <eepp/maps/maplayer.hpp>
 
+namespace EE { namespace Graphics {
+class Texture;
+class VertexBuffer;
+}} // namespace EE::Graphics
+
 namespace EE { namespace Maps {
 
+class GameObjectTextureRegion;
+
 class EE_MAPS_API TileMapLayer : public MapLayer {
   public:
+	/** Size in tiles of the chunks in which the static geometry of the layer is cached */
+	static constexpr Int32 ChunkSize = 16;
+
 	virtual ~TileMapLayer();
 
 	virtual void draw( const Vector2f& Offset = Vector2f( 0, 0 ) );
@@ -28,12 +38,43 @@ class EE_MAPS_API TileMapLayer : public MapLayer {
 
 	Vector2f getPosFromTilePos( const Vector2i& TilePos );
 
+	/** Marks the chunk that contains the tile as dirty, its geometry will be rebuilt the next time
+	 * it's drawn. The game objects already call it when they are modified. */
+	void invalidateTile( const Vector2i& TilePos );
+
+	/** Marks all the chunks as dirty */
+	void invalidateChunks();
+
+	/** Enables or disables the chunked static geometry cache ( enabled by default ).
+	 * When enabled the static tiles ( GameObjectTextureRegion ) are built into a vertex buffer per
+	 * chunk, so drawing the layer only costs the number of visible chunks. Animated and custom
+	 * game objects are still drawn every frame. Layers lit by the MapLightManager are always drawn
+	 * tile by tile since its colors change every frame. */
+	void setChunksEnabled( const bool& enabled );
+
+	const bool& getChunksEnabled() const;
+
   protected:
 	friend class TileMap;
 
+	struct ChunkBatch {
+		Texture* texture;
+		BlendMode blend;
+		VertexBuffer* vbo;
+	};
+
+	struct Chunk {
+		std::vector<ChunkBatch> batches;
+		std::vector<Vector2i> dynamicTiles;
+		bool dirty{ true };
+	};
+
 	GameObject*** mTiles;
 	Sizei mSize;
 	Vector2i mCurTile;
+	std::vector<Chunk> mChunks;
+	Sizei mChunksCount;
+	bool mChunksEnabled{ true };
 
 	TileMapLayer( TileMap* map, Sizei size, Uint32 flags, std::string name = "",
 				  Vector2f offset = Vector2f( 0, 0 ) );
@@ -41,6 +82,18 @@ class EE_MAPS_API TileMapLayer : public MapLayer {
 	void allocateLayer();
 
 	void deallocateLayer();
+
+	void drawTiles( const Vector2i& start, const Vector2i& end );
+
+	void drawChunks( const Vector2i& start, const Vector2i& end );
+
+	void buildChunk( Chunk& chunk, const Vector2i& chunkPos );
+
+	void clearChunk( Chunk& chunk );
+
+	bool isStaticTile( GameObject* obj ) const;
+
+	void addTileQuad( VertexBuffer* vbo, GameObjectTextureRegion* obj );
 };
 
 }} // namespace EE::Maps
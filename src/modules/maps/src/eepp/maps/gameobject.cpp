@@ -26,12 +26,14 @@ Uint32 GameObject::getFlag( const Uint32& Flag ) {
 void GameObject::setFlag( const Uint32& Flag ) {
 	if ( !( mFlags & Flag ) ) {
 		mFlags |= Flag;
+		invalidateTile();
 	}
 }
 
 void GameObject::clearFlag( const Uint32& Flag ) {
 	if ( mFlags & Flag ) {
 		mFlags &= ~Flag;
+		invalidateTile();
 	}
 }
 
@@ -88,6 +90,7 @@ Vector2f GameObject::getPosition() const {
 
 void GameObject::setPosition( Vector2f pos ) {
 	autoFixTilePos();
+	invalidateTile();
 }
 
 Vector2i GameObject::getTilePosition() const {
@@ -155,6 +158,11 @@ void GameObject::assignTilePos() {
 	setTilePosition( TLayer->getTilePosFromPos( getPosition() ) );
 }
 
+void GameObject::invalidateTile() {
+	if ( NULL != mLayer && mLayer->getType() == MAP_LAYER_TILED )
+		static_cast<TileMapLayer*>( mLayer )->invalidateTile( getTilePosition() );
+}
+
 Float GameObject::getRotation() {
 	return isRotated() ? 90 : 0;
 }
@@ -104,6 +104,7 @@ Graphics::TextureRegion* GameObjectTextureRegion::getTextureRegion() const {
 
 void GameObjectTextureRegion::setTextureRegion( Graphics::TextureRegion* TextureRegion ) {
 	mTextureRegion = TextureRegion;
+	invalidateTile();
 }
 
 Uint32 GameObjectTextureRegion::getDataId() {
@@ -105,6 +105,10 @@ void UIMap::onUpdateScreenPos() {
 	}
 }
 
+Time UIMap::getScheduledUpdateTimeout( const Time& pollTimeout ) {
+	return pollTimeout;
+}
+
 void UIMap::scheduledUpdate( const Time& time ) {
 	UIWindow::scheduledUpdate( time );
 
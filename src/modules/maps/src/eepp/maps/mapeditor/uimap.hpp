@@ -45,6 +45,8 @@ class EE_MAPS_API UIMap : public UIWindow {
 
 	virtual void scheduledUpdate( const Time& time );
 
+	virtual Time getScheduledUpdateTimeout( const Time& pollTimeout );
+
 	TileMap* Map() const;
 
 	void setEditingLights( const bool& editing );
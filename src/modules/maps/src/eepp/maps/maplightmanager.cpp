@@ -1,9 +1,107 @@
 #include <algorithm>
+#include <cmath>
 #include <eepp/maps/maplightmanager.hpp>
 #include <eepp/maps/tilemap.hpp>
+#include <eepp/system/sys.hpp>
+
+#if defined( EE_ARCH_X86_64 )
+#if defined( _MSC_VER )
+#include <intrin.h>
+#else
+#include <emmintrin.h>
+#endif
+#elif defined( EE_ARCH_ARM64 )
+#include <arm_neon.h>
+#endif
 
 namespace EE { namespace Maps {
 
+// Samples per side of every spatial grid cell
+static constexpr Int32 LightGridCellSize = 8;
+
+// Rows evaluated per thread pool task
+static constexpr Int32 LightRowsPerTask = 8;
+
+// Below this number of dirty samples the rows are evaluated in the calling thread
+static constexpr Int64 LightParallelThreshold = 4096;
+
+// Dirty rectangles kept before collapsing them into its union
+static constexpr size_t LightMaxDirtyRects = 32;
+
+#if defined( EE_ARCH_X86_64 )
+static inline __m128 brighten( const __m128& c, const __m128& light, const __m128& t ) {
+	return _mm_max_ps( c, _mm_add_ps( c, _mm_mul_ps( _mm_sub_ps( light, c ), t ) ) );
+}
+#elif defined( EE_ARCH_ARM64 )
+static inline float32x4_t brighten( const float32x4_t& c, const float32x4_t& light,
+									const float32x4_t& t ) {
+	return vmaxq_f32( c, vmlaq_f32( c, vsubq_f32( light, c ), t ) );
+}
+#endif
+
+// Accumulates a light over the samples [x0, x1) of a row. Every channel is brightened towards the
+// light color proportionally to the distance to the light, the same as MapLight::processVertex:
+// c = max( c, c + ( light - c ) * max( 0, 1 - distance / radius ) )
+static void accumulateLightSpan( Float* r, Float* g, Float* b, Int32 x0, const Int32& x1,
+								 const Float& originX, const Float& stepX, const Float& dy2,
+								 const Float& lx, const Float& invRadius, const Float& lr,
+								 const Float& lg, const Float& lb ) {
+#if defined( EE_ARCH_X86_64 )
+	const __m128 vStep = _mm_set1_ps( stepX * 4.f );
+	const __m128 vDy2 = _mm_set1_ps( dy2 );
+	const __m128 vInvRadius = _mm_set1_ps( invRadius );
+	const __m128 vOne = _mm_set1_ps( 1.f );
+	const __m128 vZero = _mm_setzero_ps();
+	const __m128 vR = _mm_set1_ps( lr );
+	const __m128 vG = _mm_set1_ps( lg );
+	const __m128 vB = _mm_set1_ps( lb );
+	const Float dx0 = originX + x0 * stepX - lx;
+	__m128 vDx = _mm_set_ps( dx0 + stepX * 3.f, dx0 + stepX * 2.f, dx0 + stepX, dx0 );
+
+	for ( ; x0 + 4 <= x1; x0 += 4 ) {
+		__m128 dist = _mm_sqrt_ps( _mm_add_ps( _mm_mul_ps( vDx, vDx ), vDy2 ) );
+		__m128 t = _mm_max_ps( vZero, _mm_sub_ps( vOne, _mm_mul_ps( dist, vInvRadius ) ) );
+		_mm_storeu_ps( r + x0, brighten( _mm_loadu_ps( r + x0 ), vR, t ) );
+		_mm_storeu_ps( g + x0, brighten( _mm_loadu_ps( g + x0 ), vG, t ) );
+		_mm_storeu_ps( b + x0, brighten( _mm_loadu_ps( b + x0 ), vB, t ) );
+		vDx = _mm_add_ps( vDx, vStep );
+	}
+#elif defined( EE_ARCH_ARM64 )
+	const float32x4_t vStep = vdupq_n_f32( stepX * 4.f );
+	const float32x4_t vDy2 = vdupq_n_f32( dy2 );
+	const float32x4_t vOne = vdupq_n_f32( 1.f );
+	const float32x4_t vZero = vdupq_n_f32( 0.f );
+	const float32x4_t vR = vdupq_n_f32( lr );
+	const float32x4_t vG = vdupq_n_f32( lg );
+	const float32x4_t vB = vdupq_n_f32( lb );
+	const Float dx0 = originX + x0 * stepX - lx;
+	const float offsets[4] = { dx0, dx0 + stepX, dx0 + stepX * 2.f, dx0 + stepX * 3.f };
+	float32x4_t vDx = vld1q_f32( offsets );
+
+	for ( ; x0 + 4 <= x1; x0 += 4 ) {
+		float32x4_t dist = vsqrtq_f32( vfmaq_f32( vDy2, vDx, vDx ) );
+		float32x4_t t = vmaxq_f32( vZero, vmlsq_n_f32( vOne, dist, invRadius ) );
+		vst1q_f32( r + x0, brighten( vld1q_f32( r + x0 ), vR, t ) );
+		vst1q_f32( g + x0, brighten( vld1q_f32( g + x0 ), vG, t ) );
+		vst1q_f32( b + x0, brighten( vld1q_f32( b + x0 ), vB, t ) );
+		vDx = vaddq_f32( vDx, vStep );
+	}
+#endif
+
+	for ( ; x0 < x1; x0++ ) {
+		Float dx = originX + x0 * stepX - lx;
+		Float t = eemax( 0.f, 1.f - std::sqrt( dx * dx + dy2 ) * invRadius );
+		r[x0] = eemax( r[x0], r[x0] + ( lr - r[x0] ) * t );
+		g[x0] = eemax( g[x0], g[x0] + ( lg - g[x0] ) * t );
+		b[x0] = eemax( b[x0], b[x0] + ( lb - b[x0] ) * t );
+	}
+}
+
+bool MapLightManager::LightData::operator==( const LightData& other ) const {
+	return x == other.x && y == other.y && radius == other.radius && yScale == other.yScale &&
+		   r == other.r && g == other.g && b == other.b && active == other.active;
+}
+
 MapLightManager::MapLightManager( TileMap* Map, bool ByVertex ) : mMap( Map ), mTileColors( NULL ) {
 	mIsByVertex = ByVertex;
 
@@ -21,7 +119,9 @@ MapLightManager::~MapLightManager() {
 }
 
 void MapLightManager::update() {
-	if ( mIsByVertex ) {
+	if ( mAccumulation ) {
+		updateAccumulation();
+	} else if ( mIsByVertex ) {
 		updateByVertex();
 	} else {
 		updateByTile();
@@ -193,6 +293,9 @@ const Color* MapLightManager::getTileColor( const Vector2i& TilePos ) {
 	if ( !mLights.size() )
 		return &mMap->getBaseColor();
 
+	if ( mAccumulation )
+		return &mSamples[TilePos.y * mSamplesSize.x + TilePos.x];
+
 	return mTileColors[TilePos.x][TilePos.y][0];
 }
 
@@ -202,6 +305,13 @@ const Color* MapLightManager::getTileColor( const Vector2i& TilePos, const Uint3
 	if ( !mLights.size() )
 		return &mMap->getBaseColor();
 
+	if ( mAccumulation ) {
+		// Vertex order: top-left, bottom-left, bottom-right, top-right
+		Int32 x = TilePos.x + ( ( Vertex == 2 || Vertex == 3 ) ? 1 : 0 );
+		Int32 y = TilePos.y + ( ( Vertex == 1 || Vertex == 2 ) ? 1 : 0 );
+		return &mSamples[y * mSamplesSize.x + x];
+	}
+
 	return mTileColors[TilePos.x][TilePos.y][Vertex];
 }
 
@@ -223,6 +333,9 @@ void MapLightManager::allocateColors() {
 }
 
 void MapLightManager::deallocateColors() {
+	if ( NULL == mTileColors )
+		return;
+
 	Sizei Size = mMap->getSize();
 
 	for ( Int32 x = 0; x < Size.x; x++ ) {
@@ -296,4 +409,261 @@ MapLight* MapLightManager::getLightOver( const Vector2f& OverPos, MapLight* Ligh
 	return PivotLight;
 }
 
+void MapLightManager::setAccumulationEnabled( const bool& enabled ) {
+	if ( enabled == mAccumulation )
+		return;
+
+	mAccumulation = enabled;
+
+	if ( mAccumulation ) {
+		deallocateColors();
+		allocateSamples();
+	} else {
+		mSamples.clear();
+		mSamples.shrink_to_fit();
+		mLightStates.clear();
+		mLightsData.clear();
+		mGrid.clear();
+		mDirty.clear();
+		allocateColors();
+		update();
+	}
+}
+
+const bool& MapLightManager::isAccumulationEnabled() const {
+	return mAccumulation;
+}
+
+const std::shared_ptr<ThreadPool>& MapLightManager::getThreadPool() {
+	if ( !mThreadPool )
+		mThreadPool = ThreadPool::createShared( eemax( 1, Sys::getCPUCount() - 1 ) );
+	return mThreadPool;
+}
+
+void MapLightManager::setThreadPool( const std::shared_ptr<ThreadPool>& threadPool ) {
+	mThreadPool = threadPool;
+}
+
+void MapLightManager::invalidate() {
+	mFullDirty = true;
+}
+
+void MapLightManager::allocateSamples() {
+	Sizei Size = mMap->getSize();
+	mSamplesSize = mIsByVertex ? Sizei( Size.x + 1, Size.y + 1 ) : Size;
+	mSamples.assign( mSamplesSize.getWidth() * mSamplesSize.getHeight(),
+					 Color( 255, 255, 255, 255 ) );
+	mGridSize = Sizei( ( mSamplesSize.x + LightGridCellSize - 1 ) / LightGridCellSize,
+					   ( mSamplesSize.y + LightGridCellSize - 1 ) / LightGridCellSize );
+	mGrid.assign( mGridSize.getWidth() * mGridSize.getHeight(), std::vector<Uint32>() );
+	mLightStates.clear();
+	mFullDirty = true;
+}
+
+MapLightManager::LightData MapLightManager::getLightData( MapLight* Light ) const {
+	LightData data;
+	Sizei TileSize = mMap->getTileSize();
+	// The vertices are sampled at the tile corners and the tiles at the tile centers
+	Float offsetX = mIsByVertex ? 0.f : TileSize.x * 0.5f;
+	Float offsetY = mIsByVertex ? 0.f : TileSize.y * 0.5f;
+	Rectf AABB = Light->getAABB();
+
+	data.x = Light->getPosition().x;
+	data.y = Light->getPosition().y;
+	data.radius = Light->getRadius();
+	data.invRadius = data.radius > 0 ? 1.f / data.radius : 0.f;
+	data.yScale = Light->getType() == MapLightType::Isometric ? 2.f : 1.f;
+	data.r = Light->getColor().r;
+	data.g = Light->getColor().g;
+	data.b = Light->getColor().b;
+	data.active = Light->isActive() && data.radius > 0;
+
+	if ( data.active ) {
+		data.samples.Left =
+			eemax( 0, (Int32)std::ceil( ( AABB.Left - offsetX ) / TileSize.x ) );
+		data.samples.Top = eemax( 0, (Int32)std::ceil( ( AABB.Top - offsetY ) / TileSize.y ) );
+		data.samples.Right = eemin(
+			mSamplesSize.x, (Int32)std::floor( ( AABB.Right - offsetX ) / TileSize.x ) + 1 );
+		data.samples.Bottom = eemin(
+			mSamplesSize.y, (Int32)std::floor( ( AABB.Bottom - offsetY ) / TileSize.y ) + 1 );
+	}
+
+	return data;
+}
+
+void MapLightManager::addDirty( const Rect& samples ) {
+	if ( mFullDirty || samples.Left >= samples.Right || samples.Top >= samples.Bottom )
+		return;
+
+	Rect rect( samples );
+
+	// Merge with the overlapping rectangles so no sample is evaluated twice
+	for ( size_t i = 0; i < mDirty.size(); ) {
+		if ( mDirty[i].overlap( rect ) ) {
+			rect.expand( mDirty[i] );
+			mDirty.erase( mDirty.begin() + i );
+			i = 0;
+		} else {
+			i++;
+		}
+	}
+
+	mDirty.push_back( rect );
+
+	if ( mDirty.size() > LightMaxDirtyRects ) {
+		for ( const auto& dirty : mDirty )
+			rect.expand( dirty );
+		mDirty.clear();
+		mDirty.push_back( rect );
+	}
+}
+
+void MapLightManager::updateAccumulation() {
+	if ( mMap->getBaseColor() != mLastBaseColor ) {
+		mLastBaseColor = mMap->getBaseColor();
+		mFullDirty = true;
+	}
+
+	// Detect the lights added, changed and removed since the last update
+	std::unordered_map<MapLight*, LightData> states;
+	states.reserve( mLights.size() );
+	mLightsData.clear();
+
+	for ( MapLight* Light : mLights ) {
+		LightData data = getLightData( Light );
+		auto state = mLightStates.find( Light );
+
+		if ( state == mLightStates.end() ) {
+			addDirty( data.samples );
+		} else {
+			if ( !( state->second == data ) ) {
+				addDirty( state->second.samples );
+				addDirty( data.samples );
+			}
+
+			mLightStates.erase( state );
+		}
+
+		states[Light] = data;
+		mLightsData.push_back( data );
+	}
+
+	for ( const auto& removed : mLightStates )
+		addDirty( removed.second.samples );
+
+	mLightStates = std::move( states );
+
+	if ( mFullDirty ) {
+		mDirty.clear();
+		mDirty.push_back( Rect( 0, 0, mSamplesSize.x, mSamplesSize.y ) );
+		mFullDirty = false;
+	}
+
+	if ( mDirty.empty() )
+		return;
+
+	// Rebuild the spatial grid, the lights are stored in order so the accumulation order is the
+	// same of the default mode
+	for ( auto& cell : mGrid )
+		cell.clear();
+
+	for ( Uint32 i = 0; i < mLightsData.size(); i++ ) {
+		const Rect& samples = mLightsData[i].samples;
+
+		if ( !mLightsData[i].active || samples.Left >= samples.Right ||
+			 samples.Top >= samples.Bottom )
+			continue;
+
+		for ( Int32 cy = samples.Top / LightGridCellSize;
+			  cy <= ( samples.Bottom - 1 ) / LightGridCellSize; cy++ )
+			for ( Int32 cx = samples.Left / LightGridCellSize;
+				  cx <= ( samples.Right - 1 ) / LightGridCellSize; cx++ )
+				mGrid[cy * mGridSize.x + cx].push_back( i );
+	}
+
+	struct RowSpan {
+		Int32 y;
+		Int32 x0;
+		Int32 x1;
+	};
+
+	std::vector<RowSpan> rows;
+	Int64 samplesCount = 0;
+
+	for ( const auto& dirty : mDirty ) {
+		for ( Int32 y = dirty.Top; y < dirty.Bottom; y++ )
+			rows.push_back( { y, dirty.Left, dirty.Right } );
+		samplesCount += (Int64)( dirty.Right - dirty.Left ) * ( dirty.Bottom - dirty.Top );
+	}
+
+	mDirty.clear();
+
+	size_t tasks = ( rows.size() + LightRowsPerTask - 1 ) / LightRowsPerTask;
+	auto evaluate = [this, &rows]( size_t task ) {
+		std::vector<Float> r, g, b;
+		size_t end = eemin( rows.size(), ( task + 1 ) * LightRowsPerTask );
+
+		for ( size_t i = task * LightRowsPerTask; i < end; i++ )
+			accumulateRow( rows[i].y, rows[i].x0, rows[i].x1, r, g, b );
+	};
+
+	if ( samplesCount < LightParallelThreshold || tasks < 2 ) {
+		for ( size_t task = 0; task < tasks; task++ )
+			evaluate( task );
+	} else {
+		getThreadPool()->parallelFor( tasks, evaluate );
+	}
+}
+
+void MapLightManager::accumulateRow( const Int32& y, const Int32& x0, const Int32& x1,
+									 std::vector<Float>& r, std::vector<Float>& g,
+									 std::vector<Float>& b ) {
+	Sizei TileSize = mMap->getTileSize();
+	Float offsetX = mIsByVertex ? 0.f : TileSize.x * 0.5f;
+	Float offsetY = mIsByVertex ? 0.f : TileSize.y * 0.5f;
+	Float posY = offsetY + y * TileSize.y;
+	// The row is stored relative to x0
+	Float originX = offsetX + x0 * TileSize.x;
+	Int32 width = x1 - x0;
+
+	r.assign( width, mLastBaseColor.r );
+	g.assign( width, mLastBaseColor.g );
+	b.assign( width, mLastBaseColor.b );
+
+	Int32 cy = y / LightGridCellSize;
+
+	for ( Int32 cx = x0 / LightGridCellSize; cx <= ( x1 - 1 ) / LightGridCellSize; cx++ ) {
+		Int32 cellStart = eemax( x0, cx * LightGridCellSize );
+		Int32 cellEnd = eemin( x1, ( cx + 1 ) * LightGridCellSize );
+
+		for ( const Uint32& index : mGrid[cy * mGridSize.x + cx] ) {
+			const LightData& light = mLightsData[index];
+
+			if ( y < light.samples.Top || y >= light.samples.Bottom )
+				continue;
+
+			Int32 start = eemax( cellStart, light.samples.Left );
+			Int32 end = eemin( cellEnd, light.samples.Right );
+
+			if ( start >= end )
+				continue;
+
+			Float dy = ( posY - light.y ) * light.yScale;
+
+			accumulateLightSpan( r.data(), g.data(), b.data(), start - x0, end - x0, originX,
+								 (Float)TileSize.x, dy * dy, light.x, light.invRadius, light.r,
+								 light.g, light.b );
+		}
+	}
+
+	Color* samples = &mSamples[y * mSamplesSize.x + x0];
+
+	for ( Int32 x = 0; x < width; x++ ) {
+		samples[x].r = (Uint8)eemin( 255.f, r[x] );
+		samples[x].g = (Uint8)eemin( 255.f, g[x] );
+		samples[x].b = (Uint8)eemin( 255.f, b[x] );
+		samples[x].a = 255;
+	}
+}
+
 }} // namespace EE::Maps
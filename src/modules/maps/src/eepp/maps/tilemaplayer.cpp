@@ -1,9 +1,12 @@
+#include <eepp/maps/gameobjecttextureregion.hpp>
 #include <eepp/maps/tilemap.hpp>
 #include <eepp/maps/tilemaplayer.hpp>
 
 #include <eepp/graphics/globalbatchrenderer.hpp>
 #include <eepp/graphics/renderer/renderer.hpp>
 #include <eepp/graphics/texture.hpp>
+#include <eepp/graphics/textureregion.hpp>
+#include <eepp/graphics/vertexbuffer.hpp>
 using namespace EE::Graphics;
 
 namespace EE { namespace Maps {
@@ -27,15 +30,10 @@ void TileMapLayer::draw( const Vector2f& Offset ) {
 	Vector2i start = mMap->getStartTile();
 	Vector2i end = mMap->getEndTile();
 
-	for ( Int32 x = start.x; x < end.x; x++ ) {
-		for ( Int32 y = start.y; y < end.y; y++ ) {
-			mCurTile.x = x;
-			mCurTile.y = y;
-
-			if ( NULL != mTiles[x][y] ) {
-				mTiles[x][y]->draw();
-			}
-		}
+	if ( mChunksEnabled && !( mMap->getLightsEnabled() && getLightsEnabled() ) ) {
+		drawChunks( start, end );
+	} else {
+		drawTiles( start, end );
 	}
 
 	Texture* Tex = mMap->getBlankTileTexture();
@@ -58,6 +56,192 @@ void TileMapLayer::draw( const Vector2f& Offset ) {
 	GLi->popMatrix();
 }
 
+void TileMapLayer::drawTiles( const Vector2i& start, const Vector2i& end ) {
+	for ( Int32 x = start.x; x < end.x; x++ ) {
+		for ( Int32 y = start.y; y < end.y; y++ ) {
+			mCurTile.x = x;
+			mCurTile.y = y;
+
+			if ( NULL != mTiles[x][y] ) {
+				mTiles[x][y]->draw();
+			}
+		}
+	}
+}
+
+void TileMapLayer::drawChunks( const Vector2i& start, const Vector2i& end ) {
+	Vector2i chunkStart( start.x / ChunkSize, start.y / ChunkSize );
+	Vector2i chunkEnd( eemin( ( end.x + ChunkSize - 1 ) / ChunkSize, mChunksCount.x ),
+					   eemin( ( end.y + ChunkSize - 1 ) / ChunkSize, mChunksCount.y ) );
+
+	for ( Int32 cx = chunkStart.x; cx < chunkEnd.x; cx++ ) {
+		for ( Int32 cy = chunkStart.y; cy < chunkEnd.y; cy++ ) {
+			Chunk& chunk = mChunks[cx * mChunksCount.y + cy];
+
+			if ( chunk.dirty )
+				buildChunk( chunk, Vector2i( cx, cy ) );
+
+			for ( auto& batch : chunk.batches ) {
+				batch.texture->bind( Texture::CoordinateType::Normalized );
+				BlendMode::setMode( batch.blend );
+				batch.vbo->bind();
+				batch.vbo->draw();
+				batch.vbo->unbind();
+			}
+
+			for ( const auto& tile : chunk.dynamicTiles ) {
+				if ( tile.x >= start.x && tile.x < end.x && tile.y >= start.y && tile.y < end.y &&
+					 NULL != mTiles[tile.x][tile.y] ) {
+					mCurTile = tile;
+					mTiles[tile.x][tile.y]->draw();
+				}
+			}
+		}
+	}
+}
+
+bool TileMapLayer::isStaticTile( GameObject* obj ) const {
+	if ( obj->getType() != GAMEOBJECT_TYPE_TEXTUREREGION )
+		return false;
+
+	TextureRegion* textureRegion = static_cast<GameObjectTextureRegion*>( obj )->getTextureRegion();
+
+	return NULL != textureRegion && NULL != textureRegion->getTexture() &&
+		   textureRegion->getTexture()->getClampMode() != Texture::ClampMode::ClampRepeat;
+}
+
+void TileMapLayer::addTileQuad( VertexBuffer* vbo, GameObjectTextureRegion* obj ) {
+	TextureRegion* textureRegion = obj->getTextureRegion();
+	Texture* texture = textureRegion->getTexture();
+	Vector2f pos( obj->getPosition() + textureRegion->getOffset().asFloat() );
+	Rectf rect( pos, textureRegion->getRealSize().asFloat() );
+	Quad2f quad( Vector2f( rect.Left, rect.Top ), Vector2f( rect.Left, rect.Bottom ),
+				 Vector2f( rect.Right, rect.Bottom ), Vector2f( rect.Right, rect.Top ) );
+
+	Float angle = obj->getRotation();
+
+	if ( 0 != angle )
+		quad.rotate( angle, rect.getCenter() );
+
+	Rect src( textureRegion->getSrcRect() );
+	Float w = (Float)texture->getImageWidth();
+	Float h = (Float)texture->getImageHeight();
+	Rectf uv( 0, 0, 1, 1 );
+
+	if ( src.Right != 0 || src.Bottom != 0 )
+		uv = Rectf( src.Left / w, src.Top / h, src.Right / w, src.Bottom / h );
+
+	// Same texture coordinates than Texture::drawEx for each render mode
+	Vector2f coords[4];
+
+	switch ( obj->getRenderModeFromFlags() ) {
+		case RENDER_MIRROR:
+			std::swap( uv.Left, uv.Right );
+			break;
+		case RENDER_FLIPPED:
+			std::swap( uv.Top, uv.Bottom );
+			break;
+		case RENDER_FLIPPED_MIRRORED:
+			std::swap( uv.Left, uv.Right );
+			std::swap( uv.Top, uv.Bottom );
+			break;
+		default:
+			break;
+	}
+
+	coords[0] = Vector2f( uv.Left, uv.Top );
+	coords[1] = Vector2f( uv.Left, uv.Bottom );
+	coords[2] = Vector2f( uv.Right, uv.Bottom );
+	coords[3] = Vector2f( uv.Right, uv.Top );
+
+	static const int quadIndices[] = { 0, 1, 2, 3 };
+	static const int trianglesIndices[] = { 1, 0, 3, 1, 2, 3 };
+	const int* indices = GLi->quadVertex() == 6 ? trianglesIndices : quadIndices;
+
+	for ( int i = 0; i < GLi->quadVertex(); i++ ) {
+		vbo->addVertex( quad.V[indices[i]] );
+		vbo->addTextureCoord( coords[indices[i]] );
+		vbo->addColor( Color::White );
+	}
+}
+
+void TileMapLayer::clearChunk( Chunk& chunk ) {
+	for ( auto& batch : chunk.batches )
+		eeSAFE_DELETE( batch.vbo );
+
+	chunk.batches.clear();
+	chunk.dynamicTiles.clear();
+}
+
+void TileMapLayer::buildChunk( Chunk& chunk, const Vector2i& chunkPos ) {
+	clearChunk( chunk );
+
+	Int32 fromX = chunkPos.x * ChunkSize;
+	Int32 fromY = chunkPos.y * ChunkSize;
+	Int32 toX = eemin( fromX + ChunkSize, mSize.x );
+	Int32 toY = eemin( fromY + ChunkSize, mSize.y );
+
+	// Tiles are grouped in consecutive runs sharing texture and blend mode, so the draw order of
+	// the tiles is kept
+	for ( Int32 x = fromX; x < toX; x++ ) {
+		for ( Int32 y = fromY; y < toY; y++ ) {
+			GameObject* obj = mTiles[x][y];
+
+			if ( NULL == obj )
+				continue;
+
+			if ( !isStaticTile( obj ) ) {
+				chunk.dynamicTiles.emplace_back( x, y );
+				continue;
+			}
+
+			GameObjectTextureRegion* tileObj = static_cast<GameObjectTextureRegion*>( obj );
+			Texture* texture = tileObj->getTextureRegion()->getTexture();
+			BlendMode blend( tileObj->getBlendModeFromFlags() );
+
+			if ( chunk.batches.empty() || chunk.batches.back().texture != texture ||
+				 chunk.batches.back().blend != blend ) {
+				chunk.batches.push_back(
+					{ texture, blend,
+					  VertexBuffer::New( VERTEX_FLAGS_DEFAULT,
+										 GLi->quadVertex() == 6 ? PRIMITIVE_TRIANGLES
+																: PRIMITIVE_QUADS ) } );
+			}
+
+			addTileQuad( chunk.batches.back().vbo, tileObj );
+		}
+	}
+
+	chunk.dirty = false;
+}
+
+void TileMapLayer::invalidateTile( const Vector2i& TilePos ) {
+	if ( TilePos.x >= 0 && TilePos.y >= 0 && TilePos.x < mSize.x && TilePos.y < mSize.y &&
+		 !mChunks.empty() ) {
+		mChunks[( TilePos.x / ChunkSize ) * mChunksCount.y + TilePos.y / ChunkSize].dirty = true;
+	}
+}
+
+void TileMapLayer::invalidateChunks() {
+	for ( auto& chunk : mChunks )
+		chunk.dirty = true;
+}
+
+void TileMapLayer::setChunksEnabled( const bool& enabled ) {
+	if ( enabled != mChunksEnabled ) {
+		mChunksEnabled = enabled;
+
+		for ( auto& chunk : mChunks ) {
+			clearChunk( chunk );
+			chunk.dirty = true;
+		}
+	}
+}
+
+const bool& TileMapLayer::getChunksEnabled() const {
+	return mChunksEnabled;
+}
+
 void TileMapLayer::update( const Time& dt ) {
 	Vector2i start = mMap->getStartTile();
 	Vector2i end = mMap->getEndTile();
@@ -84,9 +268,18 @@ void TileMapLayer::allocateLayer() {
 			mTiles[x][y] = NULL;
 		}
 	}
+
+	mChunksCount = Sizei( ( mSize.x + ChunkSize - 1 ) / ChunkSize,
+						  ( mSize.y + ChunkSize - 1 ) / ChunkSize );
+	mChunks.resize( mChunksCount.x * mChunksCount.y );
 }
 
 void TileMapLayer::deallocateLayer() {
+	for ( auto& chunk : mChunks )
+		clearChunk( chunk );
+
+	mChunks.clear();
+
 	for ( Int32 x = 0; x < mSize.x; x++ ) {
 		for ( Int32 y = 0; y < mSize.y; y++ ) {
 			eeSAFE_DELETE( mTiles[x][y] );
@@ -106,6 +299,8 @@ void TileMapLayer::addGameObject( GameObject* obj, const Vector2i& TilePos ) {
 
 		mTiles[TilePos.x][TilePos.y] = obj;
 
+		invalidateTile( TilePos );
+
 		obj->setPosition(
 			Vector2f( TilePos.x * mMap->getTileSize().x, TilePos.y * mMap->getTileSize().y ) );
 	}
@@ -117,6 +312,7 @@ void TileMapLayer::removeGameObject( const Vector2i& TilePos ) {
 	if ( TilePos.x < mSize.x && TilePos.y < mSize.y ) {
 		if ( NULL != mTiles[TilePos.x][TilePos.y] ) {
 			eeSAFE_DELETE( mTiles[TilePos.x][TilePos.y] );
+			invalidateTile( TilePos );
 		}
 	}
 }
@@ -129,6 +325,9 @@ void TileMapLayer::moveTileObject( const Vector2i& FromPos, const Vector2i& ToPo
 	mTiles[FromPos.x][FromPos.y] = NULL;
 
 	mTiles[ToPos.x][ToPos.y] = tObj;
+
+	invalidateTile( FromPos );
+	invalidateTile( ToPos );
 }
 
 GameObject* TileMapLayer::getGameObject( const Vector2i& TilePos ) {
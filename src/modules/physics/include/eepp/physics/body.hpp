@@ -117,6 +117,21 @@ class EE_PHYSICS_API Body {
 
 	cVect getRot() const;
 
+	/** @return The position interpolated between the previous and the current fixed step of its
+	 * space ( see Space::setFixedTimestep ). Returns the current position if the body doesn't
+	 * belong to a space stepped with a fixed timestep. */
+	cVect getRenderPos() const;
+
+	/** @return The angle in radians interpolated between the previous and the current fixed step
+	 * of its space. */
+	cpFloat getRenderAngle() const;
+
+	cpFloat getRenderAngleDeg() const;
+
+	/** Stores the current position and angle as the previous state used for the interpolation.
+	 * Called by the space before every fixed step. */
+	void storePrevState();
+
 	cpFloat getVelLimit() const;
 
 	void setVelLimit( const cpFloat& speed );
@@ -171,6 +186,8 @@ class EE_PHYSICS_API Body {
 
 	cpBody* mBody;
 	void* mData;
+	cVect mPrevPos;
+	cpFloat mPrevAngle;
 
 	BodyVelocityFunc mVelocityFunc;
 
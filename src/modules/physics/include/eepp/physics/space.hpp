@@ -6,6 +6,10 @@
 #include <eepp/physics/body.hpp>
 #include <eepp/physics/constraints/constraint.hpp>
 #include <eepp/physics/shape.hpp>
+#include <eepp/system/threadpool.hpp>
+#include <memory>
+
+using namespace EE::System;
 
 namespace EE { namespace Physics {
 
@@ -108,10 +112,45 @@ class EE_PHYSICS_API Space {
 
 	virtual ~Space();
 
+	/** Steps the space forward in time by dt. If a thread pool is set the step is distributed
+	 * between the pool threads ( see setThreadPool ). */
 	void step( const cpFloat& dt );
 
+	/** Steps the space with the elapsed time of the current window. If a fixed timestep is set the
+	 * elapsed time is accumulated and consumed in fixed steps ( see setFixedTimestep ). */
 	void update();
 
+	/** Steps the space with a variable elapsed time. If a fixed timestep is set the elapsed time is
+	 * accumulated and consumed in fixed steps, the remainder is used as the interpolation alpha.
+	 * @return The number of steps executed */
+	int update( const cpFloat& elapsed );
+
+	/** Sets the thread pool used to step the space. The bodies integration, the narrow-phase
+	 * collision detection and the solver of every independent island of bodies run in parallel,
+	 * while the collision and constraint callbacks are still called from the thread calling step.
+	 * Custom body velocity and position functions must only modify their own body.
+	 * By default there is no thread pool and the space is stepped serially. */
+	void setThreadPool( const std::shared_ptr<ThreadPool>& threadPool );
+
+	const std::shared_ptr<ThreadPool>& getThreadPool() const;
+
+	/** Sets a fixed timestep used by update ( 0 disables it, the default ). Stepping with a fixed
+	 * timestep makes the simulation deterministic and independent of the frame rate, the bodies
+	 * should be rendered at its interpolated state ( see Body::getRenderPos ). */
+	void setFixedTimestep( const cpFloat& dt );
+
+	const cpFloat& getFixedTimestep() const;
+
+	/** Maximum number of fixed steps executed per update ( 8 by default ). Avoids the spiral of
+	 * death when the simulation can't keep up, the remaining time is dropped. */
+	void setMaxSubSteps( const int& maxSubSteps );
+
+	const int& getMaxSubSteps() const;
+
+	/** @return The fraction of a fixed timestep accumulated and not stepped yet, in the range
+	 * [0,1). Always 1 when no fixed timestep is set. */
+	const cpFloat& getInterpolationAlpha() const;
+
 	Body* getStaticBody() const;
 
 	const int& getIterations() const;
@@ -248,6 +287,11 @@ class EE_PHYSICS_API Space {
 	UnorderedMap<cpHashValue, CollisionHandler> mCollisions;
 	CollisionHandler mCollisionsDefault;
 	std::vector<PostStepCallbackCont*> mPostStepCallbacks;
+	std::shared_ptr<ThreadPool> mThreadPool;
+	cpFloat mFixedTimestep;
+	cpFloat mAccumulator;
+	cpFloat mInterpolationAlpha;
+	int mMaxSubSteps;
 };
 
 }} // namespace EE::Physics
@@ -282,4 +282,17 @@ void cpSpaceUseSpatialHash(cpSpace *space, cpFloat dim, int count);
 /// Step the space forward in time by @c dt.
 void cpSpaceStep(cpSpace *space, cpFloat dt);
 
+/// Function called by cpSpaceStepParallel() for every index of a parallel loop.
+typedef void (*cpParallelForBody)(int index, void *context);
+/// Parallel loop function provided to cpSpaceStepParallel().
+/// Must call @c body(i, context) for every i in [0, count) and return once every call has finished.
+typedef void (*cpParallelForFunc)(int count, cpParallelForBody body, void *context, void *data);
+
+/// Step the space forward in time by @c dt distributing the work with @c parallelFor.
+/// The position and velocity integration, the narrow-phase collision detection and the solver of
+/// every independent island of bodies run in parallel, while the broad-phase and every callback
+/// (collision handlers, constraint pre and post solve functions and post-step callbacks) run in
+/// the calling thread. Custom body velocity and position functions must only modify their body.
+void cpSpaceStepParallel(cpSpace *space, cpFloat dt, cpParallelForFunc parallelFor, void *data);
+
 /// @}
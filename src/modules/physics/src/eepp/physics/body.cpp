@@ -3,6 +3,7 @@
 #include <eepp/physics/constraints/constraint.hpp>
 #include <eepp/physics/physicsmanager.hpp>
 #include <eepp/physics/shape.hpp>
+#include <eepp/physics/space.hpp>
 
 namespace EE { namespace Physics {
 
@@ -22,15 +23,15 @@ void Body::Free( Body* body ) {
 	eeSAFE_DELETE( body );
 }
 
-Body::Body( cpBody* body ) : mBody( body ), mData( NULL ) {
+Body::Body( cpBody* body ) : mBody( body ), mData( NULL ), mPrevAngle( 0 ) {
 	setData();
 }
 
-Body::Body( cpFloat m, cpFloat i ) : mBody( cpBodyNew( m, i ) ), mData( NULL ) {
+Body::Body( cpFloat m, cpFloat i ) : mBody( cpBodyNew( m, i ) ), mData( NULL ), mPrevAngle( 0 ) {
 	setData();
 }
 
-Body::Body() : mBody( cpBodyNewStatic() ), mData( NULL ) {
+Body::Body() : mBody( cpBodyNewStatic() ), mData( NULL ), mPrevAngle( 0 ) {
 	setData();
 }
 
@@ -44,6 +45,8 @@ Body::~Body() {
 void Body::setData() {
 	mBody->data = (void*)this;
 
+	storePrevState();
+
 	PhysicsManager::instance()->addBodyFree( this );
 }
 
@@ -101,6 +104,9 @@ cVect Body::getPos() const {
 
 void Body::setPos( const cVect& pos ) {
 	cpBodySetPos( mBody, tocpv( pos ) );
+
+	// Teleports the body, it must not be interpolated from its old position
+	mPrevPos = pos;
 }
 
 cVect Body::getVel() const {
@@ -125,6 +131,8 @@ cpFloat Body::getAngle() const {
 
 void Body::setAngle( const cpFloat& rads ) {
 	cpBodySetAngle( mBody, rads );
+
+	mPrevAngle = rads;
 }
 
 cpFloat Body::getAngleDeg() {
@@ -135,6 +143,45 @@ void Body::setAngleDeg( const cpFloat& angle ) {
 	this->setAngle( cpRadians( angle ) );
 }
 
+void Body::storePrevState() {
+	mPrevPos = tovect( mBody->p );
+	mPrevAngle = mBody->a;
+}
+
+static const Space* bodyInterpolatedSpace( const cpBody* body ) {
+	if ( NULL == body->space || NULL == body->space->data )
+		return NULL;
+
+	const Space* space = reinterpret_cast<const Space*>( body->space->data );
+
+	return space->getFixedTimestep() > 0 ? space : NULL;
+}
+
+cVect Body::getRenderPos() const {
+	const Space* space = bodyInterpolatedSpace( mBody );
+
+	if ( NULL == space || cpBodyIsSleeping( mBody ) )
+		return getPos();
+
+	cpFloat alpha = space->getInterpolationAlpha();
+
+	return cVectNew( mPrevPos.x + ( mBody->p.x - mPrevPos.x ) * alpha,
+					 mPrevPos.y + ( mBody->p.y - mPrevPos.y ) * alpha );
+}
+
+cpFloat Body::getRenderAngle() const {
+	const Space* space = bodyInterpolatedSpace( mBody );
+
+	if ( NULL == space || cpBodyIsSleeping( mBody ) )
+		return getAngle();
+
+	return mPrevAngle + ( mBody->a - mPrevAngle ) * space->getInterpolationAlpha();
+}
+
+cpFloat Body::getRenderAngleDeg() const {
+	return cpDegrees( getRenderAngle() );
+}
+
 cpFloat Body::getAngVel() const {
 	return cpBodyGetAngVel( mBody );
 }
@@ -23,10 +23,10 @@ ShapeCircleSprite::~ShapeCircleSprite() {
 }
 
 void ShapeCircleSprite::draw( Space* space ) {
-	cVect Pos = getBody()->getPos();
+	cVect Pos = getBody()->getRenderPos();
 
 	mSprite->setPosition( Vector2f( Pos.x, Pos.y ) );
-	mSprite->setRotation( getBody()->getAngleDeg() );
+	mSprite->setRotation( getBody()->getRenderAngleDeg() );
 	mSprite->draw();
 }
 
@@ -37,11 +37,11 @@ ShapePolySprite::~ShapePolySprite() {
 }
 
 void ShapePolySprite::draw( Space* space ) {
-	cVect Pos = getBody()->getPos();
+	cVect Pos = getBody()->getRenderPos();
 
 	mSprite->setOffset( mOffset );
 	mSprite->setPosition( Vector2f( Pos.x, Pos.y ) );
-	mSprite->setRotation( getBody()->getAngleDeg() );
+	mSprite->setRotation( getBody()->getRenderAngleDeg() );
 	mSprite->draw();
 }
 
@@ -1,3 +1,4 @@
+#include <cmath>
 #include <eepp/physics/physicsmanager.hpp>
 #include <eepp/physics/space.hpp>
 
@@ -17,7 +18,23 @@ void Space::Free( Space* space ) {
 	eeSAFE_DELETE( space );
 }
 
-Space::Space() : mData( NULL ) {
+static void spaceParallelFor( int count, cpParallelForBody body, void* context, void* data ) {
+	if ( count < 2 ) {
+		for ( int i = 0; i < count; i++ )
+			body( i, context );
+		return;
+	}
+
+	reinterpret_cast<ThreadPool*>( data )->parallelFor(
+		count, [body, context]( size_t index ) { body( (int)index, context ); } );
+}
+
+Space::Space() :
+	mData( NULL ),
+	mFixedTimestep( 0 ),
+	mAccumulator( 0 ),
+	mInterpolationAlpha( 1 ),
+	mMaxSubSteps( 8 ) {
 	mSpace = cpSpaceNew();
 	mSpace->data = (void*)this;
 	mStatiBody = eeNew( Body, ( mSpace->staticBody ) );
@@ -57,17 +74,82 @@ void* Space::getData() const {
 }
 
 void Space::step( const cpFloat& dt ) {
-	cpSpaceStep( mSpace, dt );
+	if ( mThreadPool && mThreadPool->numThreads() > 1 ) {
+		cpSpaceStepParallel( mSpace, dt, &spaceParallelFor, mThreadPool.get() );
+	} else {
+		cpSpaceStep( mSpace, dt );
+	}
 }
 
 void Space::update() {
 #ifdef PHYSICS_RENDERER_ENABLED
-	step( Window::Engine::instance()->getCurrentWindow()->getElapsed().asSeconds() );
+	update( Window::Engine::instance()->getCurrentWindow()->getElapsed().asSeconds() );
 #else
-	Step( 1 / 60 );
+	update( 1.0 / 60.0 );
 #endif
 }
 
+int Space::update( const cpFloat& elapsed ) {
+	if ( mFixedTimestep <= 0 ) {
+		step( elapsed );
+		return 1;
+	}
+
+	mAccumulator += elapsed;
+
+	int steps = 0;
+
+	while ( mAccumulator >= mFixedTimestep && steps < mMaxSubSteps ) {
+		for ( auto& body : mBodys )
+			body->storePrevState();
+
+		step( mFixedTimestep );
+		mAccumulator -= mFixedTimestep;
+		steps++;
+	}
+
+	// Drop the time that could not be simulated
+	if ( mAccumulator >= mFixedTimestep )
+		mAccumulator = std::fmod( mAccumulator, mFixedTimestep );
+
+	mInterpolationAlpha = mAccumulator / mFixedTimestep;
+
+	return steps;
+}
+
+void Space::setThreadPool( const std::shared_ptr<ThreadPool>& threadPool ) {
+	mThreadPool = threadPool;
+}
+
+const std::shared_ptr<ThreadPool>& Space::getThreadPool() const {
+	return mThreadPool;
+}
+
+void Space::setFixedTimestep( const cpFloat& dt ) {
+	mFixedTimestep = eemax( (cpFloat)0, dt );
+	mAccumulator = 0;
+	mInterpolationAlpha = 1;
+
+	for ( auto& body : mBodys )
+		body->storePrevState();
+}
+
+const cpFloat& Space::getFixedTimestep() const {
+	return mFixedTimestep;
+}
+
+void Space::setMaxSubSteps( const int& maxSubSteps ) {
+	mMaxSubSteps = eemax( 1, maxSubSteps );
+}
+
+const int& Space::getMaxSubSteps() const {
+	return mMaxSubSteps;
+}
+
+const cpFloat& Space::getInterpolationAlpha() const {
+	return mInterpolationAlpha;
+}
+
 const int& Space::getIterations() const {
 	return mSpace->iterations;
 }
@@ -179,6 +261,8 @@ Shape* Space::addStaticShape( Shape* shape ) {
 Body* Space::addBody( Body* body ) {
 	cpSpaceAddBody( mSpace, body->getBody() );
 
+	body->storePrevState();
+
 	mBodys.push_back( body );
 
 	PhysicsManager::instance()->removeBodyFree( body );
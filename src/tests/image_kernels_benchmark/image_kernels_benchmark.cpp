@@ -0,0 +1,93 @@
+#include <eepp/ee.hpp>
+#include <iostream>
+
+// Microbenchmark of the pixel kernels used by the Image bulk operations.
+// Runs every kernel with the scalar backend and with every vectorized backend supported by the
+// CPU, and reports the time per run and the speedup against the scalar backend.
+
+using KernelBackend = PixelKernels::Backend;
+
+static const Uint32 WIDTH = 2048;
+static const Uint32 HEIGHT = 2048;
+static const int RUNS = 20;
+
+static std::vector<Uint8> randomPixels( size_t size ) {
+	std::vector<Uint8> pixels( size );
+	Uint32 seed = 0x12345678;
+	for ( auto& p : pixels ) {
+		seed = seed * 1664525 + 1013904223;
+		p = (Uint8)( seed >> 24 );
+	}
+	return pixels;
+}
+
+static double run( const KernelBackend& backend, const std::function<void()>& reset,
+				   const std::function<void()>& kernel ) {
+	PixelKernels::setBackend( backend );
+	double total = 0;
+	for ( int i = 0; i < RUNS; i++ ) {
+		reset();
+		Clock clock;
+		kernel();
+		total += clock.getElapsedTime().asMilliseconds();
+	}
+	return total / RUNS;
+}
+
+static void benchmark( const std::string& name, const std::function<void()>& reset,
+					   const std::function<void()>& kernel ) {
+	double scalar = run( KernelBackend::Scalar, reset, kernel );
+	std::cout << String::format( "%-20s %-6s %8.3f ms", name.c_str(), "Scalar", scalar )
+			  << std::endl;
+
+	for ( auto backend : { KernelBackend::SSE2, KernelBackend::AVX2, KernelBackend::NEON } ) {
+		if ( !PixelKernels::isBackendSupported( backend ) )
+			continue;
+		double time = run( backend, reset, kernel );
+		std::cout << String::format( "%-20s %-6s %8.3f ms (x%.2f)", name.c_str(),
+									 PixelKernels::backendToString( backend ), time,
+									 time > 0 ? scalar / time : 0. )
+				  << std::endl;
+	}
+}
+
+EE_MAIN_FUNC int main( int, char*[] ) {
+	const size_t count = (size_t)WIDTH * HEIGHT;
+	const std::vector<Uint8> src = randomPixels( count * 4 );
+	const std::vector<Uint8> dst = randomPixels( count * 4 );
+	const std::vector<Uint8> rgb = randomPixels( count * 3 );
+	std::vector<Uint8> work( count * 4 );
+	std::vector<Uint8> out( count * 4 );
+	auto resetWork = [&] { memcpy( work.data(), dst.data(), work.size() ); };
+	auto noReset = [] {};
+
+	std::cout << "Pixel kernels benchmark: " << WIDTH << "x" << HEIGHT << " pixels, " << RUNS
+			  << " runs, best backend: "
+			  << PixelKernels::backendToString( PixelKernels::getBestBackend() ) << std::endl;
+
+	benchmark( "replaceColor RGBA", resetWork, [&] {
+		PixelKernels::replaceColor( work.data(), count, 4, Color( 0, 0, 0, 255 ), Color::Red );
+	} );
+	benchmark( "fill RGBA", noReset,
+			   [&] { PixelKernels::fill( work.data(), count, 4, Color::Red ); } );
+	benchmark( "blendOver", resetWork,
+			   [&] { PixelKernels::blendOver( work.data(), src.data(), count ); } );
+	benchmark( "premultiplyAlpha", resetWork,
+			   [&] { PixelKernels::premultiplyAlpha( work.data(), count ); } );
+	benchmark( "unpremultiplyAlpha", resetWork,
+			   [&] { PixelKernels::unpremultiplyAlpha( work.data(), count ); } );
+	benchmark( "swizzleRedBlue", resetWork,
+			   [&] { PixelKernels::swizzleRedBlue( work.data(), count ); } );
+	benchmark( "rgbToRgba", noReset,
+			   [&] { PixelKernels::rgbToRgba( out.data(), rgb.data(), count ); } );
+	benchmark( "rgbaToRgb", noReset,
+			   [&] { PixelKernels::rgbaToRgb( out.data(), src.data(), count ); } );
+	benchmark( "grayToRgba", noReset,
+			   [&] { PixelKernels::grayToRgba( out.data(), rgb.data(), count ); } );
+	benchmark( "rgbaToGray", noReset,
+			   [&] { PixelKernels::rgbaToGray( out.data(), src.data(), count ); } );
+
+	PixelKernels::setBackend( PixelKernels::getBestBackend() );
+
+	return EXIT_SUCCESS;
+}
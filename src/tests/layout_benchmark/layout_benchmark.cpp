@@ -0,0 +1,87 @@
+#include <eepp/ee.hpp>
+#include <iostream>
+
+// Benchmark of the layout instantiation.
+// Instantiates a complex layout many times loading it from its source with
+// UISceneNode::loadLayoutFromString and from its compiled template with
+// UISceneNode::loadLayoutFromTemplate, and reports the time per instance and the speedup.
+
+static const int INSTANCES = 1000;
+
+static const char* LAYOUT = R"xml(
+<vbox lw="mp" lh="wc" padding="8dp" class="card" background-color="#2a2a2a" border-radius="4dp">
+	<hbox lw="mp" lh="wc" layout-gravity="center_vertical">
+		<Image lw="24dp" lh="24dp" margin-right="8dp" background-color="#4a90d9" />
+		<vbox lw="0" lw8="1" lh="wc">
+			<TextView id="title" lw="mp" lh="wc" text="Card title" font-style="bold" font-size="14dp" />
+			<TextView id="subtitle" lw="mp" lh="wc" text="Card subtitle" color="#aaaaaa" font-size="11dp" />
+		</vbox>
+		<PushButton id="close" lw="wc" lh="wc" text="Close" padding="2dp 6dp" />
+	</hbox>
+	<TextView lw="mp" lh="wc" word-wrap="true" margin="8dp 0dp" style="color: #dddddd; font-size: 12dp; padding: 4dp;"
+		text="Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua." />
+	<hbox lw="mp" lh="wc" margin-top="4dp">
+		<CheckBox id="check" lw="wc" lh="wc" text="Remember" margin-right="8dp" />
+		<RadioButton lw="wc" lh="wc" text="Option A" margin-right="8dp" />
+		<RadioButton lw="wc" lh="wc" text="Option B" />
+	</hbox>
+	<hbox lw="mp" lh="wc" margin-top="4dp" layout-gravity="right">
+		<TextInput id="input" lw="0" lw8="1" lh="wc" hint="Write something" padding="4dp" />
+		<PushButton lw="wc" lh="wc" text="Accept" margin-left="4dp" border="1dp solid #4a90d9" />
+		<PushButton lw="wc" lh="wc" text="Cancel" margin-left="4dp" style="border: 1dp solid #666666;" />
+	</hbox>
+</vbox>
+)xml";
+
+static double run( UISceneNode* sceneNode, const std::function<void( Node* )>& load ) {
+	UILinearLayout* container = UILinearLayout::NewVertical();
+	container->setParent( sceneNode );
+	container->setVisible( false );
+
+	Clock clock;
+	for ( int i = 0; i < INSTANCES; i++ )
+		load( container );
+	double time = clock.getElapsedTime().asMilliseconds();
+
+	container->close();
+	SceneManager::instance()->update();
+	return time;
+}
+
+EE_MAIN_FUNC int main( int, char*[] ) {
+	UIApplication app(
+		WindowSettings( 1024, 650, "eepp - Layout Benchmark", WindowStyle::Default,
+						WindowBackend::Default, 32, {}, 1, false, true ),
+		UIApplication::Settings( Sys::getProcessPath() + ".." + FileSystem::getOSSlash(), 1 ) );
+	UISceneNode* sceneNode = app.getUI();
+
+	std::cout << "Layout benchmark: " << INSTANCES << " instances" << std::endl;
+
+	Clock clock;
+	auto layoutTemplate = UISceneNode::compileLayoutFromString( LAYOUT );
+	double compileTime = clock.getElapsedTime().asMilliseconds();
+
+	if ( !layoutTemplate ) {
+		std::cout << "Couldn't compile the layout" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	double fromString = run( sceneNode, [sceneNode]( Node* parent ) {
+		sceneNode->loadLayoutFromString( LAYOUT, parent );
+	} );
+
+	double fromTemplate = run( sceneNode, [sceneNode, &layoutTemplate]( Node* parent ) {
+		sceneNode->loadLayoutFromTemplate( *layoutTemplate, parent );
+	} );
+
+	std::cout << String::format( "%-24s %8.3f ms", "compile", compileTime ) << std::endl;
+	std::cout << String::format( "%-24s %8.3f ms (%.4f ms per instance)", "loadLayoutFromString",
+								 fromString, fromString / INSTANCES )
+			  << std::endl;
+	std::cout << String::format( "%-24s %8.3f ms (%.4f ms per instance, x%.2f)",
+								 "loadLayoutFromTemplate", fromTemplate, fromTemplate / INSTANCES,
+								 fromTemplate > 0 ? fromString / fromTemplate : 0. )
+			  << std::endl;
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,46 @@
+#include <eepp/ee.hpp>
+#include <iostream>
+
+// Microbenchmark of the ParticleSystem simulation backends.
+// Updates looping fire effects of different sizes with the AoS backend, the SoA backend and the SoA
+// backend updated in parallel, and reports the time per update and the speedup against the AoS
+// backend. Only the simulation is measured, the particles are not drawn.
+
+using ParticlesBackend = ParticleSystem::Backend;
+
+static const int UPDATES = 120;
+
+static double run( const Uint32& count, const ParticlesBackend& backend,
+				   const std::shared_ptr<ThreadPool>& threadPool ) {
+	ParticleSystem ps;
+	ps.setBackend( backend );
+	ps.setThreadPool( threadPool );
+	ps.create( ParticleEffect::Fire, count, 0, Vector2f( 0, 0 ), 16, true, 1,
+			   ColorAf( 1, 1, 1, 1 ), Vector2f( 800, 600 ) );
+
+	Clock clock;
+	for ( int i = 0; i < UPDATES; i++ )
+		ps.update( Milliseconds( 16 ) );
+	return clock.getElapsedTime().asMilliseconds() / UPDATES;
+}
+
+EE_MAIN_FUNC int main( int, char*[] ) {
+	auto threadPool = ThreadPool::createShared( eemax( 1, Sys::getCPUCount() - 1 ) );
+
+	std::cout << "Particles benchmark: " << UPDATES << " updates, " << threadPool->numThreads()
+			  << " threads" << std::endl;
+
+	for ( Uint32 count : { 10000u, 100000u, 1000000u } ) {
+		double aos = run( count, ParticlesBackend::AoS, nullptr );
+		double soa = run( count, ParticlesBackend::SoA, nullptr );
+		double parallel = run( count, ParticlesBackend::SoA, threadPool );
+
+		std::cout << String::format( "%8u particles  AoS %8.3f ms  SoA %8.3f ms (x%.2f)  "
+									 "SoA parallel %8.3f ms (x%.2f)",
+									 count, aos, soa, soa > 0 ? aos / soa : 0., parallel,
+									 parallel > 0 ? aos / parallel : 0. )
+				  << std::endl;
+	}
+
+	return EXIT_SUCCESS;
+}
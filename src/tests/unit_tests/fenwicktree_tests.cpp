@@ -0,0 +1,86 @@
+#include "utest.h"
+#include <eepp/config.hpp>
+#include <eepp/core/fenwicktree.hpp>
+#include <random>
+
+using namespace EE;
+
+static std::size_t referenceFind( const std::vector<Int64>& values, Int64 offset ) {
+	Int64 sum = 0;
+	for ( std::size_t i = 0; i < values.size(); i++ ) {
+		sum += values[i];
+		if ( sum > offset )
+			return i;
+	}
+	return values.size();
+}
+
+UTEST( FenwickTree, basic ) {
+	FenwickTree<Int64> tree;
+	EXPECT_TRUE( tree.empty() );
+	EXPECT_EQ( static_cast<std::size_t>( 0 ), tree.size() );
+	EXPECT_EQ( 0ll, tree.total() );
+	EXPECT_EQ( static_cast<std::size_t>( 0 ), tree.find( 0 ) );
+
+	tree.assign( { 1, 3, 0, 2 } );
+	EXPECT_FALSE( tree.empty() );
+	EXPECT_EQ( static_cast<std::size_t>( 4 ), tree.size() );
+	EXPECT_EQ( 6ll, tree.total() );
+	EXPECT_EQ( 0ll, tree.prefixSum( 0 ) );
+	EXPECT_EQ( 1ll, tree.prefixSum( 1 ) );
+	EXPECT_EQ( 4ll, tree.prefixSum( 2 ) );
+	EXPECT_EQ( 4ll, tree.prefixSum( 3 ) );
+	EXPECT_EQ( 6ll, tree.prefixSum( 4 ) );
+	EXPECT_EQ( 6ll, tree.prefixSum( 100 ) );
+
+	EXPECT_EQ( static_cast<std::size_t>( 0 ), tree.find( 0 ) );
+	EXPECT_EQ( static_cast<std::size_t>( 1 ), tree.find( 1 ) );
+	EXPECT_EQ( static_cast<std::size_t>( 1 ), tree.find( 3 ) );
+	// The element with a zero value is skipped
+	EXPECT_EQ( static_cast<std::size_t>( 3 ), tree.find( 4 ) );
+	EXPECT_EQ( static_cast<std::size_t>( 3 ), tree.find( 5 ) );
+	EXPECT_EQ( static_cast<std::size_t>( 4 ), tree.find( 6 ) );
+
+	tree.add( 2, 5 );
+	EXPECT_EQ( 11ll, tree.total() );
+	EXPECT_EQ( static_cast<std::size_t>( 2 ), tree.find( 4 ) );
+	EXPECT_EQ( static_cast<std::size_t>( 3 ), tree.find( 9 ) );
+
+	tree.clear();
+	EXPECT_TRUE( tree.empty() );
+	EXPECT_EQ( 0ll, tree.total() );
+}
+
+UTEST( FenwickTree, matchesReference ) {
+	std::mt19937 rng( 1234 );
+	for ( std::size_t size : { 1, 2, 3, 7, 8, 9, 100, 1000, 1025 } ) {
+		std::vector<Int64> values( size );
+		for ( auto& value : values )
+			value = rng() % 4;
+
+		FenwickTree<Int64> tree;
+		tree.assign( values );
+		EXPECT_EQ( size, tree.size() );
+
+		for ( int op = 0; op < 200; op++ ) {
+			std::size_t index = rng() % size;
+			Int64 value = rng() % 4;
+			tree.add( index, value - values[index] );
+			values[index] = value;
+
+			Int64 sum = 0;
+			for ( std::size_t i = 0; i <= size; i++ ) {
+				EXPECT_EQ( sum, tree.prefixSum( i ) );
+				if ( i < size )
+					sum += values[i];
+			}
+			EXPECT_EQ( sum, tree.total() );
+
+			for ( int i = 0; i < 32; i++ ) {
+				Int64 offset = rng() % ( sum + 1 );
+				EXPECT_EQ( referenceFind( values, offset ), tree.find( offset ) );
+			}
+			EXPECT_EQ( size, tree.find( sum ) );
+		}
+	}
+}
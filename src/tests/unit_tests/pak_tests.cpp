@@ -0,0 +1,82 @@
+#include "utest.h"
+#include <cstring>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/pak.hpp>
+#include <eepp/system/sys.hpp>
+
+using namespace EE;
+using namespace EE::System;
+
+template <typename T> static void appendValue( std::string& data, T value ) {
+	char bytes[sizeof( T )];
+	std::memcpy( bytes, &value, sizeof( T ) );
+	data.append( bytes, sizeof( T ) );
+}
+
+UTEST( Pak, roundTripV2 ) {
+	std::string path = Sys::getTempPath() + "eepp_test_pak_v2.pak";
+	FileSystem::fileRemove( path );
+
+	std::string text = "Hello World!";
+	std::vector<Uint8> binary( 4096 );
+	for ( size_t i = 0; i < binary.size(); i++ )
+		binary[i] = static_cast<Uint8>( i % 7 );
+
+	{
+		Pak pak;
+		ASSERT_TRUE( pak.create( path, Pak::Version::V2 ) );
+		EXPECT_TRUE( pak.addFile( (const Uint8*)text.data(), (Uint32)text.size(), "hello.txt" ) );
+		EXPECT_TRUE( pak.addFile( binary, "data/binary.bin" ) );
+		pak.close();
+	}
+
+	Pak pak;
+	ASSERT_TRUE( pak.open( path ) );
+	EXPECT_TRUE( pak.getVersion() == Pak::Version::V2 );
+	EXPECT_EQ( static_cast<size_t>( 2 ), pak.getFileList().size() );
+	EXPECT_NE( -1, pak.exists( "hello.txt" ) );
+	EXPECT_NE( -1, pak.exists( "data/binary.bin" ) );
+	EXPECT_EQ( -1, pak.exists( "missing.txt" ) );
+
+	std::vector<Uint8> data;
+	EXPECT_TRUE( pak.extractFileToMemory( "hello.txt", data ) );
+	EXPECT_TRUE( std::string( data.begin(), data.end() ) == text );
+
+	data.clear();
+	EXPECT_TRUE( pak.extractFileToMemory( "data/binary.bin", data ) );
+	EXPECT_TRUE( data == binary );
+
+	pak.close();
+	FileSystem::fileRemove( path );
+}
+
+UTEST( Pak, corruptHeaderV2 ) {
+	std::string path = Sys::getTempPath() + "eepp_test_pak_v2_corrupt.pak";
+
+	// The directory claims far more entries and names than the file contains
+	std::string data( "PAK2" );
+	appendValue<Uint32>( data, 2 );
+	appendValue<Uint64>( data, 24 );
+	appendValue<Uint32>( data, 0xFFFFFFFF );
+	appendValue<Uint32>( data, 0xFFFFFFFF );
+	FileSystem::fileWrite( path, data );
+
+	Pak pak;
+	EXPECT_FALSE( pak.open( path ) );
+	EXPECT_FALSE( pak.isOpen() );
+	EXPECT_EQ( static_cast<size_t>( 0 ), pak.getFileList().size() );
+
+	// A directory offset past the end of the file
+	data.resize( 8 );
+	appendValue<Uint64>( data, 0xFFFFFFFFFFull );
+	appendValue<Uint32>( data, 1 );
+	appendValue<Uint32>( data, 0 );
+	FileSystem::fileWrite( path, data );
+	EXPECT_FALSE( pak.open( path ) );
+
+	// A truncated header
+	FileSystem::fileWrite( path, std::string_view( "PAK2\2" ) );
+	EXPECT_FALSE( pak.open( path ) );
+
+	FileSystem::fileRemove( path );
+}
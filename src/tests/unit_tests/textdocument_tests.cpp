@@ -1,7 +1,10 @@
 #include "utest.hpp"
 #include <eepp/system/filesystem.hpp>
 #include <eepp/system/sys.hpp>
+#include <eepp/system/threadpool.hpp>
 #include <eepp/ui/doc/textdocument.hpp>
+#include <optional>
+#include <random>
 
 using namespace EE::UI::Doc;
 using namespace EE::System;
@@ -190,3 +193,281 @@ UTEST( TextDocument, autoCloseBrackets ) {
 	doc.textInput( "\"" );		  // Balanced quotes (0), should auto close
 	EXPECT_STRINGEQ( "(\"\")\n", doc.line( 0 ).getText() );
 }
+
+UTEST( TextDocument, replaceAll ) {
+	std::string text;
+	for ( int i = 0; i < 20000; i++ )
+		text += "foo bar foo\nbaz\n";
+	TextDocument doc;
+	doc.loadFromMemory( reinterpret_cast<const Uint8*>( text.data() ), text.size() );
+	String original( doc.getText() );
+
+	auto pool = ThreadPool::createShared( 4 );
+	auto sequential = doc.findAll( "foo" );
+	auto parallel = doc.findAllParallel( pool, "foo" );
+	EXPECT_EQ( (size_t)40000, sequential.size() );
+	EXPECT_TRUE( sequential.ranges() == parallel.ranges() );
+
+	EXPECT_EQ( 40000, doc.replaceAll( "foo", "a\nb", true, false,
+									  TextDocument::FindReplaceType::Normal, TextRange(), pool ) );
+	EXPECT_EQ( (size_t)80001, doc.linesCount() );
+	EXPECT_STRINGEQ( "a\n", doc.line( 0 ).getText() );
+	EXPECT_STRINGEQ( "b bar a\n", doc.line( 1 ).getText() );
+	EXPECT_STRINGEQ( "b\n", doc.line( 2 ).getText() );
+
+	// A single undo step restores the whole document
+	doc.undo();
+	EXPECT_TRUE( original == doc.getText() );
+	doc.redo();
+	EXPECT_STRINGEQ( "b bar a\n", doc.line( 1 ).getText() );
+
+	EXPECT_EQ( 20000, doc.replaceAll( " bar ", "", true, false ) );
+	EXPECT_STRINGEQ( "ba\n", doc.line( 1 ).getText() );
+}
+
+UTEST( TextDocument, undoStack ) {
+	std::string text( "hello\n" );
+	TextDocument doc;
+	doc.loadFromMemory( reinterpret_cast<const Uint8*>( text.data() ), text.size() );
+	doc.getUndoStack().setMergeTimeout( Seconds( 60 ) );
+
+	// A typing run is stored as a single removal
+	doc.textInput( "a" );
+	size_t memoryUsage = doc.getUndoStack().getMemoryUsage();
+	EXPECT_TRUE( memoryUsage > 0 );
+	doc.textInput( "b" );
+	doc.textInput( "c" );
+	EXPECT_STRINGEQ( "abchello\n", doc.line( 0 ).getText() );
+	EXPECT_EQ( memoryUsage, doc.getUndoStack().getMemoryUsage() );
+
+	std::string binary( doc.serializeUndoRedoBinary( true ) );
+	EXPECT_STRINGEQ( "abchello\n", doc.line( 0 ).getText() );
+
+	doc.undo();
+	EXPECT_STRINGEQ( "hello\n", doc.line( 0 ).getText() );
+	doc.redo();
+	EXPECT_STRINGEQ( "abchello\n", doc.line( 0 ).getText() );
+
+	TextDocument restored;
+	restored.loadFromMemory( reinterpret_cast<const Uint8*>( text.data() ), text.size() );
+	EXPECT_TRUE( restored.unserializeUndoRedoBinary( binary ) );
+	EXPECT_FALSE( restored.unserializeUndoRedoBinary( "garbage" ) );
+	restored.redo();
+	EXPECT_STRINGEQ( "abchello\n", restored.line( 0 ).getText() );
+
+	// The memory cap drops the oldest steps but keeps the latest one
+	doc.getUndoStack().setMergeTimeout( Time::Zero );
+	doc.getUndoStack().setMaxMemory( 1 );
+	doc.textInput( "d" );
+	doc.undo();
+	EXPECT_STRINGEQ( "abchello\n", doc.line( 0 ).getText() );
+	EXPECT_FALSE( doc.hasUndo() );
+}
+
+static std::vector<std::string> jsonStringValues( const std::string& json,
+												  const std::string& key ) {
+	std::vector<std::string> values;
+	std::string token( "\"" + key + "\":\"" );
+	for ( size_t pos = json.find( token ); pos != std::string::npos;
+		  pos = json.find( token, pos ) ) {
+		pos += token.size();
+		values.push_back( json.substr( pos, json.find( '"', pos ) - pos ) );
+	}
+	return values;
+}
+
+static bool hasMergedRun( const std::string& json ) {
+	auto first( jsonStringValues( json, "firstTimestamp" ) );
+	auto last( jsonStringValues( json, "timestamp" ) );
+	if ( first.size() != last.size() )
+		return false;
+	for ( size_t i = 0; i < first.size(); i++ )
+		if ( first[i] != last[i] )
+			return true;
+	return false;
+}
+
+UTEST( TextDocument, undoStackMergedRun ) {
+	std::string text( "hello\n" );
+	TextDocument doc;
+	doc.loadFromMemory( reinterpret_cast<const Uint8*>( text.data() ), text.size() );
+	doc.getUndoStack().setMergeTimeout( Seconds( 60 ) );
+
+	for ( const char* chr : { "a", "b", "c" } ) {
+		doc.textInput( chr );
+		Sys::sleep( Milliseconds( 5 ) );
+	}
+	EXPECT_STRINGEQ( "abchello\n", doc.line( 0 ).getText() );
+
+	// The merged run keeps the time of its first edit through a JSON round trip
+	std::string json( doc.getUndoStack().toJSON( false ) );
+	EXPECT_TRUE( hasMergedRun( json ) );
+
+	TextDocument restored;
+	restored.loadFromMemory( reinterpret_cast<const Uint8*>( text.data() ), text.size() );
+	restored.getUndoStack().fromJSON( json );
+	EXPECT_TRUE( hasMergedRun( restored.getUndoStack().toJSON( true ) ) );
+
+	// The memory cap never discards the last edit, even when it's a merged run
+	doc.getUndoStack().setMaxMemory( 1 );
+	EXPECT_TRUE( doc.hasUndo() );
+	doc.undo();
+	EXPECT_STRINGEQ( "hello\n", doc.line( 0 ).getText() );
+}
+
+UTEST( TextDocument, loadFromMemory ) {
+	std::string text( "a plain ascii line longer than a vector\r\n"
+					  "ñandú, pingüino y cigüeña en una línea larga\r\n"
+					  "\r\n"
+					  "last" );
+	TextDocument doc;
+	EXPECT_TRUE( doc.loadFromMemory( reinterpret_cast<const Uint8*>( text.data() ),
+									 text.size() ) == TextDocument::LoadStatus::Loaded );
+	EXPECT_TRUE( doc.getLineEnding() == TextFormat::LineEnding::CRLF );
+	EXPECT_EQ( (size_t)4, doc.linesCount() );
+	EXPECT_STRINGEQ( "a plain ascii line longer than a vector\n", doc.line( 0 ).getText() );
+	EXPECT_STRINGEQ( "ñandú, pingüino y cigüeña en una línea larga\n",
+					 doc.line( 1 ).getText() );
+	EXPECT_STRINGEQ( "\n", doc.line( 2 ).getText() );
+	EXPECT_STRINGEQ( "last\n", doc.line( 3 ).getText() );
+}
+
+UTEST( TextDocument, stopLoading ) {
+	std::string path = Sys::getTempPath() + "eepp_test_stop_loading.txt";
+	FileSystem::fileWrite( path, "one\ntwo\nthree\n" );
+
+	// The worker is kept busy so the load is stopped before it starts
+	auto pool = ThreadPool::createShared( 1 );
+	std::atomic<bool> release{ false };
+	pool->run( [&release] {
+		while ( !release )
+			Sys::sleep( Milliseconds( 1 ) );
+	} );
+
+	TextDocument doc;
+	bool onLoadedCalled = false;
+	doc.loadAsyncFromFile( path, pool,
+						   [&onLoadedCalled]( TextDocument*, bool ) { onLoadedCalled = true; } );
+	EXPECT_TRUE( doc.isLoading() );
+	doc.stopLoading();
+	EXPECT_TRUE( doc.isLoading() );
+	release = true;
+	pool.reset();
+
+	EXPECT_FALSE( doc.isLoading() );
+	EXPECT_FALSE( onLoadedCalled );
+	EXPECT_EQ( (size_t)1, doc.linesCount() );
+	EXPECT_STRINGEQ( "\n", doc.line( 0 ).getText() );
+	EXPECT_TRUE( doc.getFilePath() != path );
+
+	// A stopped load doesn't affect the next one
+	EXPECT_TRUE( doc.loadFromFile( path ) == TextDocument::LoadStatus::Loaded );
+	EXPECT_EQ( (size_t)4, doc.linesCount() );
+	EXPECT_STDSTREQ( path, doc.getFilePath() );
+
+	FileSystem::fileRemove( path );
+}
+
+UTEST( TextDocument, lineData ) {
+	std::string text( "zero\none\ntwo\nthree\n" );
+	TextDocument doc;
+	doc.loadFromMemory( reinterpret_cast<const Uint8*>( text.data() ), text.size() );
+	TextDocumentLineData<int> lineData;
+	doc.registerLineData( &lineData );
+	EXPECT_EQ( (Int64)doc.linesCount(), lineData.size() );
+	for ( Int64 i = 0; i < lineData.size(); i++ )
+		lineData.set( i, static_cast<int>( i ) );
+
+	// Inserting lines moves the entries and modifying a line resets its entry
+	doc.insert( 0, { 1, 3 }, "\nnew\n" );
+	EXPECT_EQ( (Int64)doc.linesCount(), lineData.size() );
+	EXPECT_EQ( 0, *lineData.get( 0 ) );
+	EXPECT_TRUE( lineData.get( 1 ) == nullptr );
+	EXPECT_TRUE( lineData.get( 2 ) == nullptr );
+	EXPECT_TRUE( lineData.get( 3 ) == nullptr );
+	EXPECT_EQ( 2, *lineData.get( 4 ) );
+	EXPECT_EQ( 3, *lineData.get( 5 ) );
+
+	doc.remove( 0, { { 1, 0 }, { 4, 0 } } );
+	EXPECT_EQ( (Int64)doc.linesCount(), lineData.size() );
+	EXPECT_EQ( 0, *lineData.get( 0 ) );
+	EXPECT_TRUE( lineData.get( 1 ) == nullptr );
+	EXPECT_EQ( 3, *lineData.get( 2 ) );
+
+	doc.unregisterLineData( &lineData );
+}
+
+static void verifyLineData( int* utest_result, const TextDocumentLineData<int>& lineData,
+							const std::vector<std::optional<int>>& reference ) {
+	ASSERT_EQ( static_cast<Int64>( reference.size() ), lineData.size() );
+	for ( size_t i = 0; i < reference.size(); i++ ) {
+		const int* value = lineData.get( i );
+		ASSERT_EQ( reference[i].has_value(), value != nullptr );
+		if ( value )
+			ASSERT_EQ( *reference[i], *value );
+	}
+	EXPECT_TRUE( lineData.get( -1 ) == nullptr );
+	EXPECT_TRUE( lineData.get( reference.size() ) == nullptr );
+}
+
+UTEST( TextDocument, lineDataChunks ) {
+	constexpr Int64 CHUNK_SIZE = TextDocumentLineData<int>::CHUNK_SIZE;
+	std::mt19937 rng( 1234 );
+	TextDocumentLineData<int> lineData;
+	std::vector<std::optional<int>> reference( CHUNK_SIZE * 3 + 7 );
+	lineData.reset( reference.size() );
+
+	for ( size_t i = 0; i < reference.size(); i += 3 ) {
+		reference[i] = static_cast<int>( i );
+		lineData.set( i, static_cast<int>( i ) );
+	}
+	verifyLineData( utest_result, lineData, reference );
+
+	// A big insertion splits the chunk, removals span several chunks
+	lineData.insertLines( CHUNK_SIZE + 10, CHUNK_SIZE * 5 );
+	reference.insert( reference.begin() + CHUNK_SIZE + 10, CHUNK_SIZE * 5, std::nullopt );
+	verifyLineData( utest_result, lineData, reference );
+
+	lineData.removeLines( CHUNK_SIZE / 2, CHUNK_SIZE * 3 );
+	reference.erase( reference.begin() + CHUNK_SIZE / 2,
+					 reference.begin() + CHUNK_SIZE / 2 + CHUNK_SIZE * 3 );
+	verifyLineData( utest_result, lineData, reference );
+
+	for ( int op = 0; op < 500; op++ ) {
+		Int64 size = reference.size();
+		Int64 line = size > 0 ? rng() % ( size + 1 ) : 0;
+		Int64 count = rng() % 8 == 0 ? rng() % ( CHUNK_SIZE * 3 ) : rng() % 16 + 1;
+		switch ( rng() % 4 ) {
+			case 0:
+				lineData.insertLines( line, count );
+				reference.insert( reference.begin() + line, count, std::nullopt );
+				break;
+			case 1:
+				lineData.removeLines( line, count );
+				if ( line < size ) {
+					count = std::min( count, size - line );
+					reference.erase( reference.begin() + line, reference.begin() + line + count );
+				}
+				break;
+			case 2:
+				if ( line < size ) {
+					lineData.set( line, op );
+					reference[line] = op;
+				}
+				break;
+			case 3:
+				lineData.resetLine( line );
+				if ( line < size )
+					reference[line].reset();
+				break;
+		}
+		verifyLineData( utest_result, lineData, reference );
+	}
+
+	lineData.removeLines( 0, lineData.size() );
+	reference.clear();
+	verifyLineData( utest_result, lineData, reference );
+	lineData.insertLines( 0, CHUNK_SIZE * 2 + 1 );
+	lineData.set( CHUNK_SIZE * 2, 1 );
+	EXPECT_EQ( 1, *lineData.get( CHUNK_SIZE * 2 ) );
+}
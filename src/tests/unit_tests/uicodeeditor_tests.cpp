@@ -2,6 +2,8 @@
 #include <eepp/scene/node.hpp>
 #include <eepp/scene/scenemanager.hpp>
 #include <eepp/system/filesystem.hpp>
+#include <eepp/system/lock.hpp>
+#include <eepp/system/threadpool.hpp>
 #include <eepp/ui/doc/syntaxdefinitionmanager.hpp>
 #include <eepp/ui/uiapplication.hpp>
 #include <eepp/ui/uicodeeditor.hpp>
@@ -309,3 +311,94 @@ UTEST( UICodeEditor, ReproduceFoldingCrash ) {
 		editor->getDocument().undo();
 	}
 }
+
+static void verifyVisualLinesMapping( int* utest_result, const DocumentView& view,
+									  const TextDocument& doc ) {
+	Int64 visibleCount = 0;
+	for ( Int64 i = 0; i < (Int64)doc.linesCount(); i++ ) {
+		Int64 startIdx = (Int64)view.toVisibleIndex( i );
+		Int64 endIdx = (Int64)view.toVisibleIndex( i, true );
+		EXPECT_EQ( visibleCount, startIdx );
+		for ( Int64 idx = startIdx; idx <= endIdx; idx++ )
+			EXPECT_EQ( i, view.getVisibleIndexPosition( (VisibleIndex)idx ).line() );
+		visibleCount += endIdx - startIdx + 1;
+	}
+	EXPECT_EQ( (size_t)visibleCount, view.getVisibleLinesCount() );
+}
+
+UTEST( UICodeEditor, DocumentViewEstimatedVisualLines ) {
+	UIApplication app(
+		WindowSettings( 800, 600, "eepp - Visual Lines", WindowStyle::Default,
+						WindowBackend::Default, 32 ),
+		UIApplication::Settings( Sys::getProcessPath() + ".." + FileSystem::getOSSlash() ) );
+
+	auto* editor = UICodeEditor::New();
+	editor->setParent( (Node*)app.getUI() );
+	editor->setPixelsSize( 800, 600 );
+	editor->getDocument().textInput( userCode );
+	const TextDocument& doc = editor->getDocument();
+
+	// Lines are measured on demand when they are accessed
+	DocumentView lazyView( editor->getDocumentRef(), editor->getFontStyleConfig(),
+						   { LineWrapMode::Letter } );
+	lazyView.setMaxWidth( 100 );
+	EXPECT_TRUE( lazyView.hasPendingLines() );
+	verifyVisualLinesMapping( utest_result, lazyView, doc );
+	size_t visibleCount = lazyView.getVisibleLinesCount();
+	EXPECT_GT( visibleCount, (size_t)doc.linesCount() );
+	EXPECT_FALSE( lazyView.hasPendingLines() );
+
+	// Lines are measured in the background, the result must match the measurement on demand
+	DocumentView view( editor->getDocumentRef(), editor->getFontStyleConfig(),
+					   { LineWrapMode::Letter } );
+	view.setMaxWidth( 100 );
+	EXPECT_TRUE( view.hasPendingLines() );
+	while ( view.hasPendingLines() )
+		view.measurePendingLines( Milliseconds( 1 ) );
+	EXPECT_EQ( visibleCount, view.getVisibleLinesCount() );
+	verifyVisualLinesMapping( utest_result, view, doc );
+}
+
+UTEST( UICodeEditor, DocumentViewWhileLoading ) {
+	UIApplication app(
+		WindowSettings( 800, 600, "eepp - Loading", WindowStyle::Default, WindowBackend::Default,
+						32 ),
+		UIApplication::Settings( Sys::getProcessPath() + ".." + FileSystem::getOSSlash() ) );
+
+	auto* editor = UICodeEditor::New();
+	editor->setParent( (Node*)app.getUI() );
+
+	std::string path = Sys::getTempPath() + "eepp_test_document_view_loading.cpp";
+	std::string text;
+	for ( int i = 0; i < 2000; i++ )
+		text += userCode;
+	FileSystem::fileWrite( path, text );
+
+	auto doc = std::make_shared<TextDocument>();
+	auto pool = ThreadPool::createShared( 1 );
+	doc->loadAsyncFromFile( path, pool );
+
+	// The line breaks aren't computed while loading, the loaded lines are displayed one to one
+	DocumentView view( doc, editor->getFontStyleConfig(), { LineWrapMode::Letter } );
+	view.setMaxWidth( 100 );
+	while ( doc->isLoading() ) {
+		{
+			Lock l( doc->getLinesMutex() );
+			Int64 linesCount = doc->linesCount();
+			EXPECT_EQ( (size_t)linesCount, view.getVisibleLinesCount() );
+			if ( linesCount > 0 ) {
+				auto lastIdx = (VisibleIndex)( linesCount - 1 );
+				EXPECT_EQ( linesCount - 1, view.getVisibleIndexPosition( lastIdx ).line() );
+			}
+		}
+		Sys::sleep( Milliseconds( 1 ) );
+	}
+
+	view.setMaxWidth( 100, true );
+	EXPECT_FALSE( view.isPendingReconstruction() );
+	EXPECT_GT( view.getVisibleLinesCount(), (size_t)doc->linesCount() );
+	verifyVisualLinesMapping( utest_result, view, *doc );
+
+	pool.reset();
+	FileSystem::fileRemove( path );
+}
@@ -25,28 +25,28 @@ UTEST( UIDiffView, LoadFromStringsAndVerifyDiffLines ) {
 	EXPECT_EQ( UIDiffView::DiffLineType::Common, lines[0].type );
 	EXPECT_TRUE( lines[0].text.toUtf8() == "line 1" );
 
-	EXPECT_EQ( UIDiffView::DiffLineType::Added, lines[1].type );
-	EXPECT_TRUE( lines[1].text.toUtf8() == "line 2 changed" );
+	EXPECT_EQ( UIDiffView::DiffLineType::Removed, lines[1].type );
+	EXPECT_TRUE( lines[1].text.toUtf8() == "line 2" );
 
-	EXPECT_EQ( UIDiffView::DiffLineType::Removed, lines[2].type );
-	EXPECT_TRUE( lines[2].text.toUtf8() == "line 2" );
+	EXPECT_EQ( UIDiffView::DiffLineType::Added, lines[2].type );
+	EXPECT_TRUE( lines[2].text.toUtf8() == "line 2 changed" );
 
 	EXPECT_EQ( UIDiffView::DiffLineType::Common, lines[3].type );
 	EXPECT_TRUE( lines[3].text.toUtf8() == "line 3" );
 
-	EXPECT_EQ( UIDiffView::DiffLineType::Added, lines[4].type );
-	EXPECT_TRUE( lines[4].text.toUtf8() == "line 4 added" );
+	EXPECT_EQ( UIDiffView::DiffLineType::Removed, lines[4].type );
+	EXPECT_TRUE( lines[4].text.toUtf8() == "line 4" );
 
 	EXPECT_EQ( UIDiffView::DiffLineType::Added, lines[5].type );
-	EXPECT_TRUE( lines[5].text.toUtf8() == "line 5" );
+	EXPECT_TRUE( lines[5].text.toUtf8() == "line 4 added" );
 
-	EXPECT_EQ( UIDiffView::DiffLineType::Removed, lines[6].type );
-	EXPECT_TRUE( lines[6].text.toUtf8() == "line 4" );
+	EXPECT_EQ( UIDiffView::DiffLineType::Added, lines[6].type );
+	EXPECT_TRUE( lines[6].text.toUtf8() == "line 5" );
 
 	const auto& text = diffView->getEditor()->getDocument().getText();
 
 	std::string expectedCleanText =
-		"line 1\nline 2 changed\nline 2\nline 3\nline 4 added\nline 5\nline 4\n";
+		"line 1\nline 2\nline 2 changed\nline 3\nline 4\nline 4 added\nline 5\n";
 
 	std::string textUtf8 = text.toUtf8();
 	EXPECT_TRUE( expectedCleanText == textUtf8 );
@@ -100,3 +100,53 @@ UTEST( UIDiffView, LoadFromPatchAndVerifyCleanText ) {
 
 	eeDelete( diffView );
 }
+
+UTEST( UIDiffView, DiffLinesReconstructsBothSides ) {
+	std::vector<std::string> oldLines;
+	for ( int i = 0; i < 5000; i++ )
+		oldLines.push_back( i % 10 == 0 ? "}" : "line " + std::to_string( i ) );
+	std::vector<std::string> newLines( oldLines );
+	newLines[100] = "changed 100";
+	newLines.erase( newLines.begin() + 2000, newLines.begin() + 2010 );
+	newLines.insert( newLines.begin() + 4000, { "inserted a", "}", "inserted b" } );
+
+	auto lines = UIDiffView::diffLines( oldLines, newLines );
+
+	std::vector<std::string> oldResult;
+	std::vector<std::string> newResult;
+	size_t added = 0;
+	size_t removed = 0;
+	for ( size_t i = 0; i < lines.size(); i++ ) {
+		const auto& line = lines[i];
+		// Every block of changes lists the removed lines before the added ones
+		if ( i > 0 && line.type == UIDiffView::DiffLineType::Removed )
+			EXPECT_NE( UIDiffView::DiffLineType::Added, lines[i - 1].type );
+		if ( line.type != UIDiffView::DiffLineType::Added ) {
+			oldResult.push_back( line.text.toUtf8() );
+			EXPECT_EQ( (Int64)oldResult.size(), line.oldLineNum );
+		}
+		if ( line.type != UIDiffView::DiffLineType::Removed ) {
+			newResult.push_back( line.text.toUtf8() );
+			EXPECT_EQ( (Int64)newResult.size(), line.newLineNum );
+		}
+		if ( line.type == UIDiffView::DiffLineType::Added )
+			added++;
+		else if ( line.type == UIDiffView::DiffLineType::Removed )
+			removed++;
+	}
+
+	EXPECT_TRUE( oldResult == oldLines );
+	EXPECT_TRUE( newResult == newLines );
+	EXPECT_EQ( (size_t)4, added );
+	EXPECT_EQ( (size_t)11, removed );
+
+	// The replaced line is listed as removed and then added
+	auto replaced = std::find_if( lines.begin(), lines.end(), []( const auto& line ) {
+		return line.type != UIDiffView::DiffLineType::Common;
+	} );
+	ASSERT_TRUE( replaced != lines.end() && replaced + 1 != lines.end() );
+	EXPECT_EQ( UIDiffView::DiffLineType::Removed, replaced->type );
+	EXPECT_TRUE( replaced->text.toUtf8() == "}" );
+	EXPECT_EQ( UIDiffView::DiffLineType::Added, ( replaced + 1 )->type );
+	EXPECT_TRUE( ( replaced + 1 )->text.toUtf8() == "changed 100" );
+}
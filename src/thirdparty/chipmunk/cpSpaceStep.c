@@ -19,6 +19,8 @@
  * SOFTWARE.
  */
  
+#include <string.h>
+
 #include "chipmunk_private.h"
 
 //MARK: Post Step Callback Functions
@@ -218,31 +220,11 @@ queryReject(cpShape *a, cpShape *b)
 	);
 }
 
-// Callback from the spatial hash.
-void
-cpSpaceCollideShapes(cpShape *a, cpShape *b, cpSpace *space)
+// Updates the arbiter of two colliding shapes with the contacts found by the narrow-phase.
+// The contacts must be already pushed into the space's contact buffer.
+static void
+cpSpaceProcessCollision(cpSpace *space, cpShape *a, cpShape *b, cpCollisionHandler *handler, cpBool sensor, cpContact *contacts, int numContacts)
 {
-	// Reject any of the simple cases
-	if(queryReject(a,b)) return;
-	
-	cpCollisionHandler *handler = cpSpaceLookupHandler(space, a->collision_type, b->collision_type);
-	
-	cpBool sensor = a->sensor || b->sensor;
-	if(sensor && handler == &cpDefaultCollisionHandler) return;
-	
-	// Shape 'a' should have the lower shape type. (required by cpCollideShapes() )
-	if(a->klass->type > b->klass->type){
-		cpShape *temp = a;
-		a = b;
-		b = temp;
-	}
-	
-	// Narrow-phase collision detection.
-	cpContact *contacts = cpContactBufferGetArray(space);
-	int numContacts = cpCollideShapes(a, b, contacts);
-	if(!numContacts) return; // Shapes are not colliding.
-	cpSpacePushContacts(space, numContacts);
-	
 	// Get an arbiter from space->arbiterSet for the two shapes.
 	// This is where the persistant contact magic comes from.
 	cpShape *shape_pair[] = {a, b};
@@ -279,6 +261,34 @@ cpSpaceCollideShapes(cpShape *a, cpShape *b, cpSpace *space)
 	arb->stamp = space->stamp;
 }
 
+// Callback from the spatial hash.
+void
+cpSpaceCollideShapes(cpShape *a, cpShape *b, cpSpace *space)
+{
+	// Reject any of the simple cases
+	if(queryReject(a,b)) return;
+	
+	cpCollisionHandler *handler = cpSpaceLookupHandler(space, a->collision_type, b->collision_type);
+	
+	cpBool sensor = a->sensor || b->sensor;
+	if(sensor && handler == &cpDefaultCollisionHandler) return;
+	
+	// Shape 'a' should have the lower shape type. (required by cpCollideShapes() )
+	if(a->klass->type > b->klass->type){
+		cpShape *temp = a;
+		a = b;
+		b = temp;
+	}
+	
+	// Narrow-phase collision detection.
+	cpContact *contacts = cpContactBufferGetArray(space);
+	int numContacts = cpCollideShapes(a, b, contacts);
+	if(!numContacts) return; // Shapes are not colliding.
+	cpSpacePushContacts(space, numContacts);
+	
+	cpSpaceProcessCollision(space, a, b, handler, sensor, contacts, numContacts);
+}
+
 // Hashset filter func to throw away old arbiters.
 cpBool
 cpSpaceArbiterSetFilter(cpArbiter *arb, cpSpace *space)
@@ -434,3 +444,409 @@ cpSpaceStep(cpSpace *space, cpFloat dt)
 		}
 	} cpSpaceUnlock(space, cpTrue);
 }
+
+//MARK: Parallel cpSpaceStepParallel() Function
+
+// Number of bodies integrated per parallel task.
+#define CP_PARALLEL_BODIES_BATCH 256
+// Number of shape pairs tested by the narrow-phase per parallel task.
+#define CP_PARALLEL_PAIRS_BATCH 64
+// Minimum number of arbiters and constraints solved per parallel task.
+// Islands are never split between tasks.
+#define CP_PARALLEL_ISLANDS_BATCH 32
+
+typedef struct cpCollisionPair {
+	cpShape *a, *b;
+	cpCollisionHandler *handler;
+	cpBool sensor;
+	int numContacts;
+	cpContact contacts[CP_MAX_CONTACTS_PER_ARBITER];
+} cpCollisionPair;
+
+// An arbiter or a constraint of an island.
+// Arbiters use the order [0, arbiters->num), constraints use the order [arbiters->num, ...).
+typedef struct cpIslandEntry {
+	cpBody *root;
+	int order;
+} cpIslandEntry;
+
+typedef struct cpIslandBatch {
+	int start, end;
+} cpIslandBatch;
+
+typedef struct cpParallelStep {
+	cpSpace *space;
+	cpFloat dt, dt_coef, slop, biasCoef, damping;
+	cpVect gravity;
+	
+	cpCollisionPair *pairs;
+	int numPairs, maxPairs;
+	
+	cpIslandEntry *entries;
+	cpIslandBatch *batches;
+	int numBatches;
+} cpParallelStep;
+
+static inline int
+cpParallelBatchEnd(int index, int batchSize, int count)
+{
+	int end = (index + 1)*batchSize;
+	return (end < count ? end : count);
+}
+
+static void
+cpParallelStepCollectPair(cpShape *a, cpShape *b, cpParallelStep *step)
+{
+	if(queryReject(a,b)) return;
+	
+	cpCollisionHandler *handler = cpSpaceLookupHandler(step->space, a->collision_type, b->collision_type);
+	
+	cpBool sensor = a->sensor || b->sensor;
+	if(sensor && handler == &cpDefaultCollisionHandler) return;
+	
+	if(a->klass->type > b->klass->type){
+		cpShape *temp = a;
+		a = b;
+		b = temp;
+	}
+	
+	if(step->numPairs == step->maxPairs){
+		step->maxPairs = (step->maxPairs ? step->maxPairs*2 : 256);
+		step->pairs = (cpCollisionPair *)cprealloc(step->pairs, step->maxPairs*sizeof(cpCollisionPair));
+	}
+	
+	cpCollisionPair *pair = step->pairs + step->numPairs++;
+	pair->a = a;
+	pair->b = b;
+	pair->handler = handler;
+	pair->sensor = sensor;
+	pair->numContacts = 0;
+}
+
+static void
+cpParallelStepIntegratePositions(int index, cpParallelStep *step)
+{
+	cpArray *bodies = step->space->bodies;
+	int end = cpParallelBatchEnd(index, CP_PARALLEL_BODIES_BATCH, bodies->num);
+	
+	for(int i=index*CP_PARALLEL_BODIES_BATCH; i<end; i++){
+		cpBody *body = (cpBody *)bodies->arr[i];
+		body->position_func(body, step->dt);
+	}
+}
+
+static void
+cpParallelStepIntegrateVelocities(int index, cpParallelStep *step)
+{
+	cpArray *bodies = step->space->bodies;
+	int end = cpParallelBatchEnd(index, CP_PARALLEL_BODIES_BATCH, bodies->num);
+	
+	for(int i=index*CP_PARALLEL_BODIES_BATCH; i<end; i++){
+		cpBody *body = (cpBody *)bodies->arr[i];
+		body->velocity_func(body, step->gravity, step->damping, step->dt);
+	}
+}
+
+static void
+cpParallelStepCollidePairs(int index, cpParallelStep *step)
+{
+	int end = cpParallelBatchEnd(index, CP_PARALLEL_PAIRS_BATCH, step->numPairs);
+	
+	for(int i=index*CP_PARALLEL_PAIRS_BATCH; i<end; i++){
+		cpCollisionPair *pair = step->pairs + i;
+		pair->numContacts = cpCollideShapes(pair->a, pair->b, pair->contacts);
+	}
+}
+
+static void
+cpParallelStepPreStepIslands(int index, cpParallelStep *step)
+{
+	cpSpace *space = step->space;
+	cpIslandBatch batch = step->batches[index];
+	int numArbiters = space->arbiters->num;
+	
+	for(int i=batch.start; i<batch.end; i++){
+		int order = step->entries[i].order;
+		
+		if(order < numArbiters){
+			cpArbiterPreStep((cpArbiter *)space->arbiters->arr[order], step->dt, step->slop, step->biasCoef);
+		} else {
+			cpConstraint *constraint = (cpConstraint *)space->constraints->arr[order - numArbiters];
+			constraint->klass->preStep(constraint, step->dt);
+		}
+	}
+}
+
+static void
+cpParallelStepSolveIslands(int index, cpParallelStep *step)
+{
+	cpSpace *space = step->space;
+	cpIslandBatch batch = step->batches[index];
+	int numArbiters = space->arbiters->num;
+	
+	// Apply cached impulses
+	for(int i=batch.start; i<batch.end; i++){
+		int order = step->entries[i].order;
+		
+		if(order < numArbiters){
+			cpArbiterApplyCachedImpulse((cpArbiter *)space->arbiters->arr[order], step->dt_coef);
+		} else {
+			cpConstraint *constraint = (cpConstraint *)space->constraints->arr[order - numArbiters];
+			constraint->klass->applyCachedImpulse(constraint, step->dt_coef);
+		}
+	}
+	
+	// Run the impulse solver. The entries of every island are sorted with the arbiters first,
+	// so the islands are solved in the same order as cpSpaceStep() does.
+	for(int iteration=0; iteration<space->iterations; iteration++){
+		for(int i=batch.start; i<batch.end; i++){
+			int order = step->entries[i].order;
+			
+			if(order < numArbiters){
+				cpArbiterApplyImpulse((cpArbiter *)space->arbiters->arr[order]);
+			} else {
+				cpConstraint *constraint = (cpConstraint *)space->constraints->arr[order - numArbiters];
+				constraint->klass->applyImpulse(constraint, step->dt);
+			}
+		}
+	}
+}
+
+// Only the bodies with infinite mass and moment don't join islands, the impulses applied to them
+// don't change their velocities so they can be shared between islands. Any other body, rogue
+// bodies included, joins the island of every body it touches.
+static inline cpBool
+IslandMember(cpBody *body)
+{
+	return (body->m_inv != 0.0f || body->i_inv != 0.0f);
+}
+
+static inline void
+IslandReset(cpBody *body)
+{
+	if(IslandMember(body)) body->node.root = NULL;
+}
+
+static cpBody *
+IslandFind(cpBody *body)
+{
+	cpBody *root = body;
+	while(root->node.root) root = root->node.root;
+	
+	// Path compression
+	while(body != root){
+		cpBody *next = body->node.root;
+		body->node.root = root;
+		body = next;
+	}
+	
+	return root;
+}
+
+static void
+IslandUnion(cpBody *a, cpBody *b)
+{
+	if(IslandMember(a) && IslandMember(b)){
+		cpBody *rootA = IslandFind(a);
+		cpBody *rootB = IslandFind(b);
+		if(rootA != rootB) rootA->node.root = rootB;
+	}
+}
+
+static int
+cpIslandEntryCompare(const void *a, const void *b)
+{
+	const cpIslandEntry *ea = (const cpIslandEntry *)a;
+	const cpIslandEntry *eb = (const cpIslandEntry *)b;
+	
+	if(ea->root != eb->root) return ((cpHashValue)ea->root < (cpHashValue)eb->root ? -1 : 1);
+	return ea->order - eb->order;
+}
+
+static inline cpBody *
+IslandRoot(cpBody *a, cpBody *b)
+{
+	if(IslandMember(a)) return IslandFind(a);
+	if(IslandMember(b)) return IslandFind(b);
+	return NULL;
+}
+
+// Groups the arbiters and constraints by island and splits them into batches.
+static void
+cpParallelStepBuildIslands(cpParallelStep *step)
+{
+	cpSpace *space = step->space;
+	cpArray *arbiters = space->arbiters;
+	cpArray *constraints = space->constraints;
+	int count = arbiters->num + constraints->num;
+	
+	step->entries = (cpIslandEntry *)cpcalloc(count ? count : 1, sizeof(cpIslandEntry));
+	step->batches = (cpIslandBatch *)cpcalloc(count ? count : 1, sizeof(cpIslandBatch));
+	step->numBatches = 0;
+	
+	// The awake and rogue bodies have no component pointers at this point, the component root
+	// pointer is borrowed as the union-find parent and reset afterwards.
+	for(int i=0; i<arbiters->num; i++){
+		cpArbiter *arb = (cpArbiter *)arbiters->arr[i];
+		IslandUnion(arb->body_a, arb->body_b);
+	}
+	
+	for(int i=0; i<constraints->num; i++){
+		cpConstraint *constraint = (cpConstraint *)constraints->arr[i];
+		IslandUnion(constraint->a, constraint->b);
+	}
+	
+	for(int i=0; i<arbiters->num; i++){
+		cpArbiter *arb = (cpArbiter *)arbiters->arr[i];
+		step->entries[i].root = IslandRoot(arb->body_a, arb->body_b);
+		step->entries[i].order = i;
+	}
+	
+	for(int i=0; i<constraints->num; i++){
+		cpConstraint *constraint = (cpConstraint *)constraints->arr[i];
+		step->entries[arbiters->num + i].root = IslandRoot(constraint->a, constraint->b);
+		step->entries[arbiters->num + i].order = arbiters->num + i;
+	}
+	
+	// Rogue bodies aren't in the space bodies, reset every body reached from the arbiters and
+	// constraints instead
+	for(int i=0; i<arbiters->num; i++){
+		cpArbiter *arb = (cpArbiter *)arbiters->arr[i];
+		IslandReset(arb->body_a);
+		IslandReset(arb->body_b);
+	}
+	
+	for(int i=0; i<constraints->num; i++){
+		cpConstraint *constraint = (cpConstraint *)constraints->arr[i];
+		IslandReset(constraint->a);
+		IslandReset(constraint->b);
+	}
+	
+	qsort(step->entries, count, sizeof(cpIslandEntry), cpIslandEntryCompare);
+	
+	// Cut the batches at island boundaries once they are big enough
+	int start = 0;
+	for(int i=1; i<=count; i++){
+		if(i == count || (step->entries[i].root != step->entries[i - 1].root && i - start >= CP_PARALLEL_ISLANDS_BATCH)){
+			step->batches[step->numBatches].start = start;
+			step->batches[step->numBatches].end = i;
+			step->numBatches++;
+			start = i;
+		}
+	}
+}
+
+void
+cpSpaceStepParallel(cpSpace *space, cpFloat dt, cpParallelForFunc parallelFor, void *data)
+{
+	// don't step if the timestep is 0!
+	if(dt == 0.0f) return;
+	
+	space->stamp++;
+	
+	cpFloat prev_dt = space->curr_dt;
+	space->curr_dt = dt;
+	
+	cpArray *bodies = space->bodies;
+	cpArray *constraints = space->constraints;
+	cpArray *arbiters = space->arbiters;
+	
+	cpParallelStep step;
+	memset(&step, 0, sizeof(cpParallelStep));
+	step.space = space;
+	step.dt = dt;
+	
+	// Reset and empty the arbiter lists.
+	for(int i=0; i<arbiters->num; i++){
+		cpArbiter *arb = (cpArbiter *)arbiters->arr[i];
+		arb->state = cpArbiterStateNormal;
+		
+		// If both bodies are awake, unthread the arbiter from the contact graph.
+		if(!cpBodyIsSleeping(arb->body_a) && !cpBodyIsSleeping(arb->body_b)){
+			cpArbiterUnthread(arb);
+		}
+	}
+	arbiters->num = 0;
+	
+	int bodyBatches = (bodies->num + CP_PARALLEL_BODIES_BATCH - 1)/CP_PARALLEL_BODIES_BATCH;
+	
+	cpSpaceLock(space); {
+		// Integrate positions
+		parallelFor(bodyBatches, (cpParallelForBody)cpParallelStepIntegratePositions, &step, data);
+		
+		// Find the candidate pairs with the broad-phase
+		cpSpacePushFreshContactBuffer(space);
+		cpSpatialIndexEach(space->activeShapes, (cpSpatialIndexIteratorFunc)cpShapeUpdateFunc, NULL);
+		cpSpatialIndexReindexQuery(space->activeShapes, (cpSpatialIndexQueryFunc)cpParallelStepCollectPair, &step);
+		
+		// Run the narrow-phase in parallel
+		parallelFor((step.numPairs + CP_PARALLEL_PAIRS_BATCH - 1)/CP_PARALLEL_PAIRS_BATCH, (cpParallelForBody)cpParallelStepCollidePairs, &step, data);
+		
+		// Update the arbiters in the same order the broad-phase found the pairs
+		for(int i=0; i<step.numPairs; i++){
+			cpCollisionPair *pair = step.pairs + i;
+			if(!pair->numContacts) continue;
+			
+			cpContact *contacts = cpContactBufferGetArray(space);
+			memcpy(contacts, pair->contacts, pair->numContacts*sizeof(cpContact));
+			cpSpacePushContacts(space, pair->numContacts);
+			
+			cpSpaceProcessCollision(space, pair->a, pair->b, pair->handler, pair->sensor, contacts, pair->numContacts);
+		}
+		
+		cpfree(step.pairs);
+		step.pairs = NULL;
+	} cpSpaceUnlock(space, cpFalse);
+	
+	// Rebuild the contact graph (and detect sleeping components if sleeping is enabled)
+	cpSpaceProcessComponents(space, dt);
+	
+	cpSpaceLock(space); {
+		// Clear out old cached arbiters and call separate callbacks
+		cpHashSetFilter(space->cachedArbiters, (cpHashSetFilterFunc)cpSpaceArbiterSetFilter, space);
+		
+		cpParallelStepBuildIslands(&step);
+		
+		// Run the constraint pre-solve callbacks
+		for(int i=0; i<constraints->num; i++){
+			cpConstraint *constraint = (cpConstraint *)constraints->arr[i];
+			
+			cpConstraintPreSolveFunc preSolve = constraint->preSolve;
+			if(preSolve) preSolve(constraint, space);
+		}
+		
+		// Prestep the arbiters and constraints.
+		step.slop = space->collisionSlop;
+		step.biasCoef = 1.0f - cpfpow(space->collisionBias, dt);
+		parallelFor(step.numBatches, (cpParallelForBody)cpParallelStepPreStepIslands, &step, data);
+		
+		// Integrate velocities.
+		step.damping = cpfpow(space->damping, dt);
+		step.gravity = space->gravity;
+		bodyBatches = (bodies->num + CP_PARALLEL_BODIES_BATCH - 1)/CP_PARALLEL_BODIES_BATCH;
+		parallelFor(bodyBatches, (cpParallelForBody)cpParallelStepIntegrateVelocities, &step, data);
+		
+		// Apply cached impulses and run the impulse solver for every island.
+		step.dt_coef = (prev_dt == 0.0f ? 0.0f : dt/prev_dt);
+		parallelFor(step.numBatches, (cpParallelForBody)cpParallelStepSolveIslands, &step, data);
+		
+		cpfree(step.entries);
+		cpfree(step.batches);
+		
+		// Run the constraint post-solve callbacks
+		for(int i=0; i<constraints->num; i++){
+			cpConstraint *constraint = (cpConstraint *)constraints->arr[i];
+			
+			cpConstraintPostSolveFunc postSolve = constraint->postSolve;
+			if(postSolve) postSolve(constraint, space);
+		}
+		
+		// run the post-solve callbacks
+		for(int i=0; i<arbiters->num; i++){
+			cpArbiter *arb = (cpArbiter *) arbiters->arr[i];
+			
+			cpCollisionHandler *handler = arb->handler;
+			handler->postSolve(arb, space, handler->data);
+		}
+	} cpSpaceUnlock(space, cpTrue);
+}
@@ -15,6 +15,7 @@
 #include <args/args.hxx>
 #include <eepp/graphics/fontfamily.hpp>
 #include <eepp/system/iostreammemory.hpp>
+#include <eepp/system/profiler.hpp>
 #include <eepp/ui/doc/languagessyntaxhighlighting.hpp>
 #include <eepp/ui/iconmanager.hpp>
 #include <eepp/ui/tools/uiaudioplayer.hpp>
@@ -912,6 +913,9 @@ bool App::loadConfig( const LogLevel& logLevel, const Sizeu& displaySize, bool s
 	Log::create( mLogsPath, logLevel, stdOutLogs, !disableFileLogs );
 
 	Log::instance()->setKeepLog( true );
+	Log::instance()->setKeepLogMaxSize( 16 * 1024 * 1024 );
+	Log::instance()->setFileRotation( 16 * 1024 * 1024, 2 );
+	Log::instance()->setAsync( true );
 
 	if ( !mArgs.empty() ) {
 		std::string strargs( String::join( mArgs ) );
@@ -955,6 +959,10 @@ std::shared_ptr<ThreadPool> App::getThreadPool() const {
 	return mThreadPool;
 }
 
+std::shared_ptr<AsyncFileIO> App::getAsyncFileIO() const {
+	return mAsyncFileIO;
+}
+
 bool App::trySendUnlockedCmd( const KeyEvent& keyEvent ) {
 	if ( mSplitter->curEditorExistsAndFocused() ) {
 		std::string cmd = mSplitter->getCurEditor()->getKeyBindings().getCommandFromKeyBind(
@@ -1021,7 +1029,9 @@ void App::mainLoop() {
 		}
 	} else {
 #if EE_PLATFORM != EE_PLATFORM_EMSCRIPTEN
-		mWindow->getInput()->waitEvent( Milliseconds( mWindow->hasFocus() ? 16 : 100 ) );
+		// Sleep until the next timer, animation or caret blink is due, or an event arrives
+		SceneManager::instance()->waitForNextUpdate(
+			mWindow, Milliseconds( mWindow->hasFocus() ? 16 : 100 ) );
 #endif
 	}
 
@@ -1107,6 +1117,7 @@ App::App( const size_t& jobs, const std::vector<std::string>& args ) :
 	mArgs( args ),
 	mThreadPool(
 		ThreadPool::createShared( jobs > 0 ? jobs : eemax<int>( 4, Sys::getCPUCount() ) ) ),
+	mAsyncFileIO( AsyncFileIO::New( mThreadPool, mThreadPool->numThreads() * 16 ) ),
 	mSettingsActions( std::make_unique<SettingsActions>( this ) ) {}
 
 static void fsRemoveAll( const std::string& fpath ) {
@@ -1125,6 +1136,9 @@ App::~App() {
 		mProjectBuildManager.reset();
 
 	Http::setThreadPool( nullptr );
+	if ( TextureAsyncLoader::existsSingleton() )
+		TextureAsyncLoader::instance()->setThreadPool( nullptr );
+	mAsyncFileIO.reset();
 	mThreadPool.reset();
 
 	if ( mFileWatcher ) {
@@ -1507,6 +1521,27 @@ void App::debugDrawData() {
 	mUISceneNode->setDrawDebugData( !mUISceneNode->getDrawDebugData() );
 }
 
+void App::debugProfilerOverlayToggle() {
+	mUISceneNode->setProfilerOverlayVisible( !mUISceneNode->isProfilerOverlayVisible() );
+}
+
+void App::debugProfilerExportTrace() {
+	if ( !Profiler::isEnabled() ) {
+		Profiler::setEnabled( true );
+		mNotificationCenter->addNotification(
+			i18n( "profiler_enabled", "Profiler enabled, run the command again to export the "
+									  "trace." ) );
+		return;
+	}
+
+	std::string path( mConfigPath + "trace.json" );
+
+	if ( Profiler::instance()->exportChromeTrace( path ) ) {
+		mNotificationCenter->addNotification( String::format(
+			i18n( "profiler_trace_exported", "Profiler trace exported to: %s" ).toUtf8(), path ) );
+	}
+}
+
 void App::loadKeybindings() {
 	if ( !mKeybindings.empty() )
 		return;
@@ -2254,6 +2289,8 @@ std::vector<std::string> App::getUnlockedCommands() {
 		"debug-draw-highlight-toggle",
 		"debug-draw-boxes-toggle",
 		"debug-draw-debug-data",
+		"debug-profiler-overlay-toggle",
+		"debug-profiler-export-trace",
 		"editor-set-line-breaking-column",
 		"editor-set-line-spacing",
 		"editor-set-cursor-blinking-time",
@@ -4847,8 +4884,12 @@ void App::init( InitParameters& params ) {
 		);
 
 		mMenuIconSize = mConfig.ui.fontSize.asPixels( 0, Sizef(), mDisplayDPI );
-		mUISceneNode->getUIIconThemeManager()->setCurrentTheme(
-			IconManager::init( "ecode", mRemixIconFont, mNoniconsFont, mCodIconFont ) );
+		UIIconTheme* iconTheme =
+			IconManager::init( "ecode", mRemixIconFont, mNoniconsFont, mCodIconFont );
+		iconTheme->setSVGIconAtlas( UISVGIconAtlas::New(
+			"ecode", mThreadPool,
+			mConfigPath + "cache" + FileSystem::getOSSlash() + "icons" ) );
+		mUISceneNode->getUIIconThemeManager()->setCurrentTheme( iconTheme );
 
 		UIWidgetCreator::registerWidget( "searchbar", UISearchBar::New );
 		UIWidgetCreator::registerWidget( "locatebar", UILocateBar::New );
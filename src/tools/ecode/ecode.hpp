@@ -109,6 +109,8 @@ class App : public UICodeEditorSplitter::Client, public PluginContextProvider {
 
 	std::shared_ptr<ThreadPool> getThreadPool() const;
 
+	std::shared_ptr<AsyncFileIO> getAsyncFileIO() const;
+
 	void openFileFromPath( const std::string& path );
 
 	bool loadFileFromPath( std::string path, bool inNewTab = true,
@@ -197,6 +199,10 @@ class App : public UICodeEditorSplitter::Client, public PluginContextProvider {
 
 	void debugDrawData();
 
+	void debugProfilerOverlayToggle();
+
+	void debugProfilerExportTrace();
+
 	void toggleSidePanel();
 
 	UIMainLayout* getMainLayout() const { return mMainLayout; }
@@ -233,6 +239,8 @@ class App : public UICodeEditorSplitter::Client, public PluginContextProvider {
 		t.setCommand( "debug-draw-boxes-toggle", [this] { debugDrawBoxesToggle(); } );
 		t.setCommand( "debug-draw-highlight-toggle", [this] { debugDrawHighlightToggle(); } );
 		t.setCommand( "debug-draw-debug-data", [this] { debugDrawData(); } );
+		t.setCommand( "debug-profiler-overlay-toggle", [this] { debugProfilerOverlayToggle(); } );
+		t.setCommand( "debug-profiler-export-trace", [this] { debugProfilerExportTrace(); } );
 		t.setCommand( "debug-widget-tree-view", [this] { createWidgetInspector(); } );
 		t.setCommand( "menu-toggle", [this] { toggleSettingsMenu(); } );
 		t.setCommand( "switch-side-panel", [this] { switchSidePanel(); } );
@@ -694,6 +702,7 @@ class App : public UICodeEditorSplitter::Client, public PluginContextProvider {
 	std::string mPidPath;
 	Float mDisplayDPI{ 96 };
 	std::shared_ptr<ThreadPool> mThreadPool;
+	std::shared_ptr<AsyncFileIO> mAsyncFileIO;
 	std::shared_ptr<ProjectDirectoryTree> mDirTree;
 	UITreeViewFS* mProjectTreeView{ nullptr };
 	UILinearLayout* mProjectViewEmptyCont{ nullptr };
@@ -682,7 +682,7 @@ void GlobalSearchController::hideGlobalSearchBar() {
 	mApp->getStatusBar()->updateState();
 	if ( mCurSearch ) {
 		mCurSearch->active = false;
-		mApp->getThreadPool()->removeWithTag( mCurSearch->taskTag );
+		mApp->getAsyncFileIO()->cancel( mCurSearch->taskTag );
 	}
 }
 
@@ -821,7 +821,7 @@ void GlobalSearchController::doGlobalSearch( String text, String filter, bool ca
 	}
 
 	mCurSearch = ProjectSearch::find(
-		mApp->getDirTree()->getFiles(), search, mApp->getThreadPool(),
+		mApp->getDirTree()->getFiles(), search, mApp->getAsyncFileIO(),
 		[this, clock, search, searchReplace, searchAgain, escapeSequence, searchType,
 		 filter]( const ProjectSearch::ConsolidatedResult& res ) {
 			Log::info( "Global search for \"%s\" took %s", search.c_str(),
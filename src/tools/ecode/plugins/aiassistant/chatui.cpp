@@ -13,6 +13,7 @@
 #include <eepp/ui/uidropdownlist.hpp>
 #include <eepp/ui/uidropdownmodellist.hpp>
 #include <eepp/ui/uiicon.hpp>
+#include <eepp/ui/uilayouttemplate.hpp>
 #include <eepp/ui/uiloader.hpp>
 #include <eepp/ui/uimarkdownview.hpp>
 #include <eepp/ui/uimessagebox.hpp>
@@ -2684,8 +2685,7 @@ void LLMChatUI::addPermissionUI( const acp::RequestPermissionRequest& req,
 								 std::function<void( const acp::RequestPermissionResponse& )> cb ) {
 	find( "chat_presentation" )->setVisible( false );
 
-	UIWidget* chat =
-		mChatsList->getUISceneNode()->loadLayoutFromString( DEFAULT_PERMISSION_GLOBE, mChatsList );
+	UIWidget* chat = loadBubbleLayout( DEFAULT_PERMISSION_GLOBE );
 
 	UIMarkdownView* desc = chat->findByClass<UIMarkdownView>( "permission_desc" );
 	std::string descStr =
@@ -2746,12 +2746,23 @@ void LLMChatUI::addPermissionUI( const acp::RequestPermissionRequest& req,
 
 UIWidget* LLMChatUI::addMarkdownBubble( const std::string& layout, const std::string& markdown ) {
 	find( "chat_presentation" )->setVisible( false );
-	UIWidget* chat = mChatsList->getUISceneNode()->loadLayoutFromString( layout, mChatsList );
+	UIWidget* chat = loadBubbleLayout( layout );
 	if ( chat && !markdown.empty() )
 		chat->asType<UIMarkdownView>()->loadFromString( markdown );
 	return chat;
 }
 
+UIWidget* LLMChatUI::loadBubbleLayout( const std::string& layout ) {
+	// Bubbles are created for every message of the conversation, compile their layouts once
+	auto it = mBubbleTemplates.find( layout );
+	if ( it == mBubbleTemplates.end() )
+		it = mBubbleTemplates.insert( { layout, UISceneNode::compileLayoutFromString( layout ) } )
+				 .first;
+	if ( !it->second )
+		return nullptr;
+	return mChatsList->getUISceneNode()->loadLayoutFromTemplate( *it->second, mChatsList );
+}
+
 void LLMChatUI::addPlanBubble( const std::string& markdown ) {
 	if ( markdown.empty() )
 		return;
@@ -2818,11 +2829,9 @@ void LLMChatUI::addToolCallBubble( const std::string& markdown ) {
 		}
 
 		if ( !bubble ) {
-			mCurToolCall = markdown;
-			bubble = addMarkdownBubble( DEFAULT_TOOL_CALL_GLOBE, mCurToolCall );
+			bubble = addMarkdownBubble( DEFAULT_TOOL_CALL_GLOBE, markdown );
 		} else {
-			mCurToolCall += "\n" + markdown;
-			bubble->asType<UIMarkdownView>()->loadFromString( mCurToolCall );
+			bubble->asType<UIMarkdownView>()->appendMarkdown( "\n" + markdown );
 		}
 
 		mChatScrollView->getVerticalScrollBar()->setValue( 1.0f );
@@ -2923,13 +2932,10 @@ void LLMChatUI::updateThinkingBubble( const std::string& chunk ) {
 			}
 		}
 
-		if ( !bubble ) {
-			mCurThinking = "";
-			bubble = addMarkdownBubble( DEFAULT_THINKING_GLOBE, mCurThinking );
-		}
+		if ( !bubble )
+			bubble = addMarkdownBubble( DEFAULT_THINKING_GLOBE, "" );
 
-		mCurThinking += chunk;
-		bubble->asType<UIMarkdownView>()->loadFromString( mCurThinking );
+		bubble->asType<UIMarkdownView>()->appendMarkdown( chunk );
 		mChatScrollView->getVerticalScrollBar()->setValue( 1.0f );
 	} );
 }
@@ -2937,8 +2943,7 @@ void LLMChatUI::updateThinkingBubble( const std::string& chunk ) {
 UIWidget* LLMChatUI::addChatUI( LLMChat::Role role ) {
 	find( "chat_presentation" )->setVisible( false );
 
-	UIWidget* chat =
-		mChatsList->getUISceneNode()->loadLayoutFromString( DEFAULT_CHAT_GLOBE, mChatsList );
+	UIWidget* chat = loadBubbleLayout( DEFAULT_CHAT_GLOBE );
 	auto* roleDDL = chat->findByClass( "role_ui" )->asType<UIDropDownList>();
 	auto* roleListBox = chat->findByClass( "role_ui" )->asType<UIDropDownList>()->getListBox();
 	switch ( role ) {
@@ -151,10 +151,9 @@ class LLMChatUI : public UILinearLayout, public WidgetCommandExecuter {
 
 	UnorderedMap<std::string, UIWidget*> mToolCallBubbles;
 	UnorderedMap<std::string, UIWidget*> mTerminalBubbles;
+	UnorderedMap<std::string, std::shared_ptr<UILayoutTemplate>> mBubbleTemplates;
 	std::unique_ptr<acp::AgentSession> mAgentSession;
 	UIWidget* mThinkingBubble{ nullptr };
-	std::string mCurThinking;
-	std::string mCurToolCall;
 	int mPendingModelsToLoad{ 0 };
 	bool mChatIsPrivate{ false };
 	bool mIsAgentMode{ false };
@@ -195,6 +194,8 @@ class LLMChatUI : public UILinearLayout, public WidgetCommandExecuter {
 
 	UIWidget* addMarkdownBubble( const std::string& layout, const std::string& markdown );
 
+	UIWidget* loadBubbleLayout( const std::string& layout );
+
 	void addPlanBubble( const std::string& markdown );
 
 	void addPlanUpdate( const nlohmann::json& msg );
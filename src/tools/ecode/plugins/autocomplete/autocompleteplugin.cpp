@@ -1043,6 +1043,13 @@ void AutoCompletePlugin::update( UICodeEditor* ) {
 	}
 }
 
+Time AutoCompletePlugin::getUpdateTimeout( UICodeEditor*, const Time& ) {
+	if ( mDirty )
+		return Time::Zero;
+	Time elapsed = mClock.getElapsedTime();
+	return elapsed < mUpdateFreq ? mUpdateFreq - elapsed : Time::Zero;
+}
+
 void AutoCompletePlugin::drawSignatureHelp( UICodeEditor* editor, const Vector2f& startScroll,
 											const Float& /*lineHeight*/, bool drawUp ) {
 	TextDocument& doc = editor->getDocument();
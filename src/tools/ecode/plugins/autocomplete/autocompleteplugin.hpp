@@ -85,6 +85,7 @@ class AutoCompletePlugin : public Plugin {
 	bool onKeyDown( UICodeEditor*, const KeyEvent& ) override;
 	bool onTextInput( UICodeEditor*, const TextInputEvent& ) override;
 	void update( UICodeEditor* ) override;
+	Time getUpdateTimeout( UICodeEditor*, const Time& pollTimeout ) override;
 	void postDraw( UICodeEditor*, const Vector2f& startScroll, const Float& lineHeight,
 				   const TextPosition& cursor ) override;
 	bool onMouseDown( UICodeEditor*, const Vector2i&, const Uint32& ) override;
@@ -743,6 +743,14 @@ void LinterPlugin::onUnregister( UICodeEditor* editor ) {
 	mMatches.erase( doc );
 }
 
+Time LinterPlugin::getUpdateTimeout( UICodeEditor* editor, const Time& ) {
+	auto it = mDirtyDoc.find( editor->getDocumentRef().get() );
+	if ( it == mDirtyDoc.end() )
+		return Time::Infinity;
+	Time elapsed = it->second->getElapsedTime();
+	return elapsed < mDelayTime ? mDelayTime - elapsed : Time::Zero;
+}
+
 void LinterPlugin::update( UICodeEditor* editor ) {
 	std::shared_ptr<TextDocument> doc = editor->getDocumentRef();
 	auto it = mDirtyDoc.find( doc.get() );
@@ -93,6 +93,8 @@ class LinterPlugin : public Plugin {
 
 	void update( UICodeEditor* );
 
+	Time getUpdateTimeout( UICodeEditor* editor, const Time& pollTimeout );
+
 	bool onMouseMove( UICodeEditor*, const Vector2i&, const Uint32& flags );
 
 	bool onMouseLeave( UICodeEditor*, const Vector2i&, const Uint32& );
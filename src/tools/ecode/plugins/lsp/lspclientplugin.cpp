@@ -275,6 +275,10 @@ void LSPClientPlugin::update( UICodeEditor* ) {
 	mClientManager.updateDirty();
 }
 
+Time LSPClientPlugin::getUpdateTimeout( UICodeEditor*, const Time& ) {
+	return mClientManager.getUpdateDirtyTimeout();
+}
+
 struct LSPPositionAndServer {
 	LSPPosition loc;
 	LSPClientServer* server{ nullptr };
@@ -38,6 +38,8 @@ class LSPClientPlugin : public Plugin {
 
 	virtual void update( UICodeEditor* );
 
+	virtual Time getUpdateTimeout( UICodeEditor*, const Time& pollTimeout );
+
 	std::string getId() { return Definition().id; }
 
 	std::string getTitle() { return Definition().name; }
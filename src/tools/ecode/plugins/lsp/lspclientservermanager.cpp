@@ -302,6 +302,18 @@ const std::shared_ptr<ThreadPool>& LSPClientServerManager::getThreadPool() const
 	return mThreadPool;
 }
 
+Time LSPClientServerManager::getUpdateDirtyTimeout() const {
+	{
+		Lock l( mClientsMutex );
+		// Nothing to close
+		if ( mClients.empty() && mLSPsToClose.empty() )
+			return Time::Infinity;
+	}
+
+	Time elapsed = mUpdateClock.getElapsedTime();
+	return elapsed < Seconds( 1 ) ? Seconds( 1 ) - elapsed : Time::Zero;
+}
+
 void LSPClientServerManager::updateDirty() {
 	// Run the check only once per second
 	if ( mUpdateClock.getElapsedTime() < Seconds( 1 ) )
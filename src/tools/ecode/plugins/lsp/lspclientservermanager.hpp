@@ -33,6 +33,9 @@ class LSPClientServerManager {
 
 	void updateDirty();
 
+	/** @return The time left until updateDirty has work to do */
+	Time getUpdateDirtyTimeout() const;
+
 	void didChangeWorkspaceFolders( const std::string& folder );
 
 	const LSPWorkspaceFolder& getLSPWorkspaceFolder() const;
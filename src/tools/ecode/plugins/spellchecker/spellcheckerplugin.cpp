@@ -237,6 +237,14 @@ void SpellCheckerPlugin::setDocDirty( UICodeEditor* editor ) {
 	mDirtyDoc[editor->getDocumentRef().get()] = std::make_unique<Clock>();
 }
 
+Time SpellCheckerPlugin::getUpdateTimeout( UICodeEditor* editor, const Time& ) {
+	auto it = mDirtyDoc.find( editor->getDocumentRef().get() );
+	if ( it == mDirtyDoc.end() )
+		return Time::Infinity;
+	Time elapsed = it->second->getElapsedTime();
+	return elapsed < mDelayTime ? mDelayTime - elapsed : Time::Zero;
+}
+
 void SpellCheckerPlugin::update( UICodeEditor* editor ) {
 	std::shared_ptr<TextDocument> doc = editor->getDocumentRef();
 	auto it = mDirtyDoc.find( doc.get() );
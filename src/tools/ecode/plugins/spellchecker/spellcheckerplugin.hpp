@@ -86,6 +86,8 @@ class SpellCheckerPlugin : public PluginBase {
 
 	void update( UICodeEditor* ) override;
 
+	Time getUpdateTimeout( UICodeEditor* editor, const Time& pollTimeout ) override;
+
 	void setDocDirty( TextDocument* doc );
 
 	void setDocDirty( UICodeEditor* editor );
@@ -46,14 +46,12 @@ static String textLine( const std::string& fileText, const size_t& fromPos, Int6
 }
 
 static std::vector<ProjectSearch::ResultData::Result>
-searchInFileHorspool( const std::string& file, const std::string& text, const bool& caseSensitive,
+searchInFileHorspool( std::string& fileText, const std::string& text, const bool& caseSensitive,
 					  const bool& wholeWord, const String::BMH::OccTable& occ ) {
 	std::vector<ProjectSearch::ResultData::Result> res;
-	std::string fileText;
 	Int64 lSearchRes = 0;
 	Int64 searchRes = 0;
 	size_t totNl = 0;
-	FileSystem::fileGet( file, fileText );
 	std::string fileTextOriginal;
 
 	if ( !caseSensitive ) {
@@ -88,10 +86,8 @@ searchInFileHorspool( const std::string& file, const std::string& text, const bo
 }
 
 static std::vector<ProjectSearch::ResultData::Result>
-searchInFilePatternMatch( const std::string& file, PatternMatcher& pattern,
+searchInFilePatternMatch( std::string& fileText, PatternMatcher& pattern,
 						  const bool& caseSensitive, const bool& wholeWord ) {
-	std::string fileText;
-	FileSystem::fileGet( file, fileText );
 	std::vector<ProjectSearch::ResultData::Result> results;
 	Int64 totNl = 0;
 	bool matched = false;
@@ -143,20 +139,20 @@ searchInFilePatternMatch( const std::string& file, PatternMatcher& pattern,
 }
 
 static std::vector<ProjectSearch::ResultData::Result>
-searchInFileLuaPattern( const std::string& file, const std::string& text, const bool& caseSensitive,
+searchInFileLuaPattern( std::string& fileText, const std::string& text, const bool& caseSensitive,
 						const bool& wholeWord ) {
 	LuaPattern pattern( text );
-	return searchInFilePatternMatch( file, pattern, caseSensitive, wholeWord );
+	return searchInFilePatternMatch( fileText, pattern, caseSensitive, wholeWord );
 }
 
-static std::vector<ProjectSearch::ResultData::Result> searchInFileRegEx( const std::string& file,
+static std::vector<ProjectSearch::ResultData::Result> searchInFileRegEx( std::string& fileText,
 																		 const std::string& text,
 																		 const bool& caseSensitive,
 																		 const bool& wholeWord ) {
 	RegEx pattern( text, static_cast<RegEx::Options>( RegEx::Options::Utf |
 													  ( !caseSensitive ? RegEx::Options::Caseless
 																	   : RegEx::Options::None ) ) );
-	return searchInFilePatternMatch( file, pattern, caseSensitive, wholeWord );
+	return searchInFilePatternMatch( fileText, pattern, caseSensitive, wholeWord );
 }
 
 std::vector<ProjectSearch::ResultData::Result>
@@ -187,7 +183,7 @@ ProjectSearch::fileResFromDoc( const std::string& string, bool caseSensitive, bo
 
 ProjectSearch::FindData*
 ProjectSearch::find( const std::vector<std::string> files, std::string string,
-					 std::shared_ptr<ThreadPool> pool, ResultCb result, bool caseSensitive,
+					 std::shared_ptr<AsyncFileIO> asyncIO, ResultCb result, bool caseSensitive,
 					 bool wholeWord, const TextDocument::FindReplaceType& type,
 					 const std::vector<GlobMatch>& pathFilters, std::string basePath,
 					 std::vector<std::shared_ptr<TextDocument>> openDocs ) {
@@ -203,10 +199,11 @@ ProjectSearch::find( const std::vector<std::string> files, std::string string,
 	findData->taskTag = PROJECT_SEARCH_TASK_TAG_HASH;
 
 	FileSystem::dirAddSlashAtEnd( basePath );
-	pool->run( [findData, files = std::move( files ), string = std::move( string ),
-				pool = std::move( pool ), result = std::move( result ), caseSensitive, wholeWord,
-				type, pathFilters = std::move( pathFilters ), basePath = std::move( basePath ),
-				openDocs = std::move( openDocs )]() mutable {
+	std::shared_ptr<ThreadPool> pool = asyncIO->getThreadPool();
+	pool->run( [findData, files = std::move( files ), string = std::move( string ), pool,
+				asyncIO = std::move( asyncIO ), result = std::move( result ), caseSensitive,
+				wholeWord, type, pathFilters = std::move( pathFilters ),
+				basePath = std::move( basePath ), openDocs = std::move( openDocs )]() mutable {
 		SearchConfig searchConfig( string, caseSensitive, wholeWord, type );
 		findData->resCount = files.size();
 		if ( !caseSensitive )
@@ -320,22 +317,32 @@ ProjectSearch::find( const std::vector<std::string> files, std::string string,
 					},
 					onSearchEnd, PROJECT_SEARCH_TASK_TAG_HASH );
 			} else {
-				pool->run(
-					[findData, file, string, caseSensitive, wholeWord, occ, type]() mutable {
-						auto fileRes = type == TextDocument::FindReplaceType::Normal
-										   ? searchInFileHorspool( file, string, caseSensitive,
-																   wholeWord, occ )
-										   : ( type == TextDocument::FindReplaceType::LuaPattern
-												   ? searchInFileLuaPattern(
-														 file, string, caseSensitive, wholeWord )
-												   : searchInFileRegEx( file, string, caseSensitive,
-																		wholeWord ) );
-						if ( !fileRes.empty() ) {
-							Lock l( findData->resMutex );
-							findData->res.emplace_back( std::string( file ), std::move( fileRes ) );
+				// The reads are batched by the async file I/O, the search runs in the pool once the
+				// file is read
+				asyncIO->readFile(
+					file,
+					[findData, string, caseSensitive, wholeWord, occ, type,
+					 onSearchEnd]( AsyncFileIO::Result& read ) {
+						if ( findData->active && read.success ) {
+							std::string& fileText = read.data;
+							auto fileRes =
+								type == TextDocument::FindReplaceType::Normal
+									? searchInFileHorspool( fileText, string, caseSensitive,
+															wholeWord, occ )
+									: ( type == TextDocument::FindReplaceType::LuaPattern
+											? searchInFileLuaPattern( fileText, string,
+																	  caseSensitive, wholeWord )
+											: searchInFileRegEx( fileText, string, caseSensitive,
+																 wholeWord ) );
+							if ( !fileRes.empty() ) {
+								Lock l( findData->resMutex );
+								findData->res.emplace_back( std::move( read.path ),
+															std::move( fileRes ) );
+							}
 						}
+						onSearchEnd( 0 );
 					},
-					onSearchEnd, PROJECT_SEARCH_TASK_TAG_HASH );
+					PROJECT_SEARCH_TASK_TAG_HASH );
 			}
 		}
 	} );
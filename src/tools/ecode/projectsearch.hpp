@@ -2,6 +2,7 @@
 #define ECODE_PROJECTSEARCH_HPP
 
 #include <eepp/core/string.hpp>
+#include <eepp/system/asyncfileio.hpp>
 #include <eepp/system/threadpool.hpp>
 #include <eepp/ui/doc/textdocument.hpp>
 #include <eepp/ui/models/model.hpp>
@@ -254,7 +255,7 @@ class ProjectSearch {
 
 	static FindData*
 	find( const std::vector<std::string> files, std::string string,
-		  std::shared_ptr<ThreadPool> pool, ResultCb result, bool caseSensitive,
+		  std::shared_ptr<AsyncFileIO> asyncIO, ResultCb result, bool caseSensitive,
 		  bool wholeWord = false,
 		  const TextDocument::FindReplaceType& type = TextDocument::FindReplaceType::Normal,
 		  const std::vector<GlobMatch>& pathFilters = {}, std::string basePath = "",
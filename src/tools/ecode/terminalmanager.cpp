@@ -743,9 +743,9 @@ void TerminalManager::setKeybindings( UITerminal* term ) {
 	// Remove the keybinds that are problematic for a terminal
 	term->getKeyBindings().removeCommandsKeybind(
 		{ "open-file", "download-file-web", "open-folder", "debug-draw-highlight-toggle",
-		  "debug-draw-boxes-toggle", "debug-draw-debug-data", "debug-widget-tree-view",
-		  "open-locatebar", "open-command-palette", "open-global-search", "menu-toggle",
-		  "console-toggle", "go-to-line", "editor-go-back", "editor-go-forward",
+		  "debug-draw-boxes-toggle", "debug-draw-debug-data", "debug-profiler-overlay-toggle",
+		  "debug-widget-tree-view", "open-locatebar", "open-command-palette", "open-global-search",
+		  "menu-toggle", "console-toggle", "go-to-line", "editor-go-back", "editor-go-forward",
 		  "project-run-executable", "project-build-and-run" } );
 }
 
@@ -1,8 +1,11 @@
+#include <algorithm>
 #include <args/args.hxx>
 #include <eepp/graphics/pixeldensity.hpp>
 #include <eepp/graphics/textureatlasloader.hpp>
 #include <eepp/graphics/texturepacker.hpp>
 #include <eepp/system/filesystem.hpp>
+#include <eepp/system/sys.hpp>
+#include <eepp/system/threadpool.hpp>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -64,6 +67,11 @@ EE_MAIN_FUNC int main( int argc, char* argv[] ) {
 		{ 'b', "pixels-border" }, 2, args::Options::Single );
 	args::Flag update( parser, "update", "Update texture atlas if output file already exists.",
 					   { 'u', "update" }, args::Options::Single );
+	args::ValueFlag<Uint32> threads(
+		parser, "threads",
+		"Number of threads used by the streaming pipeline to probe, decode and compose the images "
+		"in parallel. 0 (default value) uses all the CPU cores, 1 disables the pipeline.",
+		{ 't', "threads" }, 0, args::Options::Single );
 	std::unordered_map<std::string, Texture::Filter> textureFilterMap{
 		{ "linear", Texture::Filter::Linear }, { "nearest", Texture::Filter::Nearest } };
 	args::MapFlag<std::string, Texture::Filter> textureFilter(
@@ -87,9 +95,12 @@ EE_MAIN_FUNC int main( int argc, char* argv[] ) {
 		return EXIT_FAILURE;
 	}
 
+	Uint32 numThreads = threads.Get() == 0 ? Sys::getCPUCount() : threads.Get();
+	bool pipeline = numThreads > 1;
 	bool hasImages = false;
 	auto imagesPaths = args::get( images );
 	std::map<std::string, std::unique_ptr<Image>> imagesList;
+	std::vector<std::string> imagesStreamed;
 	if ( !imagesPaths.empty() ) {
 		for ( auto image : images ) {
 			if ( !Image::isImage( image ) ) {
@@ -98,7 +109,12 @@ EE_MAIN_FUNC int main( int argc, char* argv[] ) {
 				return EXIT_FAILURE;
 			}
 
-			if ( imagesList.find( image ) == imagesList.end() ) {
+			if ( pipeline ) {
+				// The pipeline decodes the images only when composing the atlas
+				if ( std::find( imagesStreamed.begin(), imagesStreamed.end(), image ) ==
+					 imagesStreamed.end() )
+					imagesStreamed.push_back( image );
+			} else if ( imagesList.find( image ) == imagesList.end() ) {
 				imagesList[image] = std::make_unique<Image>( image );
 			}
 		}
@@ -141,8 +157,11 @@ EE_MAIN_FUNC int main( int argc, char* argv[] ) {
 		TexturePacker tp( width.Get(), height.Get(), PixelDensity::toFloat( pixelDensity.Get() ),
 						  forcePow2.Get(), scalableSVG.Get(), pixelsBorder.Get(),
 						  textureFilter.Get(), allowChildren.Get() );
+		if ( pipeline )
+			tp.setThreadPool( ThreadPool::createShared( numThreads ) );
 		std::cout << "Packing directory: " << texturesPathSafe << std::endl;
 		tp.addTexturesPath( texturesPathSafe );
+		tp.addTextures( imagesStreamed );
 		for ( auto& image : imagesList ) {
 			tp.addImage( image.second.get(), image.first );
 		}